@@ -0,0 +1,220 @@
+/**
+ * Micro benchmarks for drone_physics.
+ *
+ * build: cmake -DDO_BENCH=ON ... && make bench
+ * run:   ./bench --benchmark_out=bench.json --benchmark_out_format=json
+ * Compare two JSON files with tools/compare.py of google benchmark.
+ */
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <vector>
+#include "drone_physics.hpp"
+
+using namespace hako::drone_physics;
+
+/* inputs that are not trivially constant-folded */
+static const VectorType v1 = {1.1, -2.2, 3.3};
+static const VectorType v2 = {-0.4, 0.5, 0.6};
+static const EulerType angle = {0.1, -0.2, 0.3};
+static const AngularVelocityType omega_body = {0.3, -0.2, 0.1};
+static const EulerRateType euler_rate = {0.01, 0.02, -0.03};
+
+static void BM_cross(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(cross(v1, v2));
+    }
+}
+BENCHMARK(BM_cross);
+
+static void BM_dot(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(dot(v1, v2));
+    }
+}
+BENCHMARK(BM_dot);
+
+static void BM_length(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(length(v1));
+    }
+}
+BENCHMARK(BM_length);
+
+static void BM_ground_vector_from_body(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ground_vector_from_body(v1, angle));
+    }
+}
+BENCHMARK(BM_ground_vector_from_body);
+
+static void BM_body_vector_from_ground(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(body_vector_from_ground(v1, angle));
+    }
+}
+BENCHMARK(BM_body_vector_from_ground);
+
+static void BM_euler_rate_from_body_angular_velocity(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(euler_rate_from_body_angular_velocity(omega_body, angle));
+    }
+}
+BENCHMARK(BM_euler_rate_from_body_angular_velocity);
+
+static void BM_body_angular_velocity_from_euler_rate(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(body_angular_velocity_from_euler_rate(euler_rate, angle));
+    }
+}
+BENCHMARK(BM_body_angular_velocity_from_euler_rate);
+
+static void BM_acceleration_in_ground_frame(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(acceleration_in_ground_frame(v1, angle, 10.0, 1.0, 9.81, 0.1, 0.01));
+    }
+}
+BENCHMARK(BM_acceleration_in_ground_frame);
+
+static void BM_acceleration_in_body_frame(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(acceleration_in_body_frame(v1, angle, omega_body, 10.0, 1.0, 9.81, 0.1, 0.01));
+    }
+}
+BENCHMARK(BM_acceleration_in_body_frame);
+
+static void BM_angular_acceleration_in_body_frame(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(angular_acceleration_in_body_frame(omega_body, 0.1, 0.2, 0.3, 0.01, 0.02, 0.03));
+    }
+}
+BENCHMARK(BM_angular_acceleration_in_body_frame);
+
+static void BM_euler_acceleration_in_ground_frame(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(euler_acceleration_in_ground_frame(euler_rate, angle, 0.1, 0.2, 0.3, 0.01, 0.02, 0.03));
+    }
+}
+BENCHMARK(BM_euler_acceleration_in_ground_frame);
+
+static void BM_velocity_after_contact_with_wall(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(velocity_after_contact_with_wall(v1, v2, 0.5));
+    }
+}
+BENCHMARK(BM_velocity_after_contact_with_wall);
+
+static void BM_velocity_after_contact_with_wall_position(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(velocity_after_contact_with_wall(v1, v2, v1 + v2, 0.5));
+    }
+}
+BENCHMARK(BM_velocity_after_contact_with_wall_position);
+
+static void BM_rotor_omega_acceleration(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(rotor_omega_acceleration(6000.0, 0.1, 1000.0, 0.6));
+    }
+}
+BENCHMARK(BM_rotor_omega_acceleration);
+
+static void BM_rotor_thrust(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(rotor_thrust(1e-6, 1000.0));
+    }
+}
+BENCHMARK(BM_rotor_thrust);
+
+static void BM_rotor_anti_torque(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(rotor_anti_torque(1e-8, 1e-6, 1000.0, 10.0, 1.0));
+    }
+}
+BENCHMARK(BM_rotor_anti_torque);
+
+/* rotor count as the argument */
+static void rotor_setup(unsigned n, VectorType position[], double ccw[], double omega[], double omega_acc[]) {
+    for (unsigned i = 0; i < n; i++) {
+        double rad = 2.0 * M_PI * i / n;
+        position[i] = {0.3 * cos(rad), 0.3 * sin(rad), 0.0};
+        ccw[i] = (i % 2 == 0) ? 1.0 : -1.0;
+        omega[i] = 1000.0 + i;
+        omega_acc[i] = 10.0 * i;
+    }
+}
+
+static void BM_body_thrust(benchmark::State& state) {
+    const unsigned n = (unsigned)state.range(0);
+    VectorType position[8]; double ccw[8], omega[8], omega_acc[8];
+    rotor_setup(n, position, ccw, omega, omega_acc);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(body_thrust(1e-6, n, omega));
+    }
+}
+BENCHMARK(BM_body_thrust)->Arg(4)->Arg(6)->Arg(8);
+
+static void BM_body_torque(benchmark::State& state) {
+    const unsigned n = (unsigned)state.range(0);
+    VectorType position[8]; double ccw[8], omega[8], omega_acc[8];
+    rotor_setup(n, position, ccw, omega, omega_acc);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(body_torque(1e-6, 1e-8, 1e-6, n, position, ccw, omega, omega_acc));
+    }
+}
+BENCHMARK(BM_body_torque)->Arg(4)->Arg(6)->Arg(8);
+
+static void BM_body_thrust_linear(benchmark::State& state) {
+    const unsigned n = (unsigned)state.range(0);
+    VectorType position[8]; double ccw[8], omega[8], omega_acc[8];
+    rotor_setup(n, position, ccw, omega, omega_acc);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(body_thrust_linear(1e-3, n, omega));
+    }
+}
+BENCHMARK(BM_body_thrust_linear)->Arg(4)->Arg(6)->Arg(8);
+
+static void BM_body_torque_linear(benchmark::State& state) {
+    const unsigned n = (unsigned)state.range(0);
+    VectorType position[8]; double ccw[8], omega[8], omega_acc[8];
+    rotor_setup(n, position, ccw, omega, omega_acc);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(body_torque_linear(1e-3, 1e-5, n, position, ccw, omega));
+    }
+}
+BENCHMARK(BM_body_torque_linear)->Arg(4)->Arg(6)->Arg(8);
+
+/* body_thrust() + body_torque() by the precomputed mixer */
+static void BM_rotor_mixer(benchmark::State& state) {
+    const unsigned n = (unsigned)state.range(0);
+    VectorType position[8] = {}; double ccw[8] = {}, omega[8] = {}, omega_acc[8] = {};
+    rotor_setup(n, position, ccw, omega, omega_acc);
+    RotorMixer mixer(1e-6, 1e-8, 1e-6, n, position, ccw);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(mixer.thrust_torque(omega, omega_acc));
+    }
+}
+BENCHMARK(BM_rotor_mixer)->Arg(4)->Arg(6)->Arg(8);
+
+/* 64 vehicles with the same mixer */
+static void BM_rotor_mixer_batch(benchmark::State& state) {
+    const unsigned n = (unsigned)state.range(0);
+    const unsigned m = 64;
+    VectorType position[8] = {}; double ccw[8] = {}, omega[8] = {}, omega_acc[8] = {};
+    rotor_setup(n, position, ccw, omega, omega_acc);
+    RotorMixer mixer(1e-6, 1e-8, 1e-6, n, position, ccw);
+    std::vector<double> omegas(m * n), omega_accs(m * n);
+    for (unsigned k = 0; k < m; k++) {
+        for (unsigned i = 0; i < n; i++) {
+            omegas[k * n + i] = omega[i] + k;
+            omega_accs[k * n + i] = omega_acc[i];
+        }
+    }
+    std::vector<ThrustTorqueType> out(m);
+    for (auto _ : state) {
+        mixer.thrust_torque_batch(m, omegas.data(), omega_accs.data(), out.data());
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * m);
+}
+BENCHMARK(BM_rotor_mixer_batch)->Arg(4)->Arg(6)->Arg(8);
+
+BENCHMARK_MAIN();
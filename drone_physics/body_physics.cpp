@@ -221,6 +221,21 @@ AccelerationType acceleration_in_body_frame(
     double gravity, /* usually 9.8 > 0*/
     double drag1,  /* air friction of 1-st order(-d1*v) counter to velocity */
     double drag2 /* air friction of 2-nd order(-d2*v*v) counter to velocity */)
+{
+    return acceleration_in_body_frame(body_velocity, angle, body_angular_velocity, {0, 0, 0},
+        thrust, mass, gravity, drag1, drag2);
+}
+
+/* the same as above, but the air friction is counter to the airspeed(velocity - wind) */
+AccelerationType acceleration_in_body_frame(
+    const VelocityType& body_velocity,
+    const EulerType& angle,
+    const AngularVelocityType& body_angular_velocity,
+    const VelocityType& body_wind,
+    double thrust, double mass /* 0 is not allowed */,
+    double gravity, /* usually 9.8 > 0*/
+    double drag1,  /* air friction of 1-st order(-d1*v) counter to airspeed */
+    double drag2 /* air friction of 2-nd order(-d2*v*v) counter to airspeed */)
 {
     assert(!is_zero(mass));
     using std::sin; using std::cos;
@@ -230,6 +245,7 @@ AccelerationType acceleration_in_body_frame(
         c_theta = cos(angle.theta), s_theta = sin(angle.theta);
     const auto [u, v, w] = body_velocity;
     const auto [p, q, r] = body_angular_velocity;
+    const auto [ua, va, wa] = body_velocity - body_wind; /* airspeed */
     const auto T = thrust;
     const auto m = mass;
     const auto g = gravity;
@@ -247,9 +263,9 @@ AccelerationType acceleration_in_body_frame(
 
      */
     /*****************************************************************/  
-    double dot_u =       - g * s_theta            - (q*w - r*v) - d1/m * u - d2/m * u * u;
-    double dot_v =       + g * c_theta * s_phi    - (r*u - p*w) - d1/m * v - d2/m * v * v;
-    double dot_w = -T/m  + g * c_theta * c_phi    - (p*v - q*u) - d1/m * w - d2/m * w * w;
+    double dot_u =       - g * s_theta            - (q*w - r*v) - d1/m * ua - d2/m * ua * ua;
+    double dot_v =       + g * c_theta * s_phi    - (r*u - p*w) - d1/m * va - d2/m * va * va;
+    double dot_w = -T/m  + g * c_theta * c_phi    - (p*v - q*u) - d1/m * wa - d2/m * wa * wa;
     /*****************************************************************/  
 
     return {dot_u, dot_v, dot_w};
@@ -295,6 +311,19 @@ AccelerationType acceleration_in_ground_frame(
     double gravity, /* usually 9.8 > 0*/
     double drag1,  /* air friction of 1-st order(-d1*v) counter to velocity */
     double drag2 /* air friction of 2-nd order(-d2*v*v) counter to velocity */)
+{
+    return acceleration_in_ground_frame(ground, angle, {0, 0, 0}, thrust, mass, gravity, drag1, drag2);
+}
+
+/* the same as above, but the air friction is counter to the airspeed(velocity - wind) */
+AccelerationType acceleration_in_ground_frame(
+    const VelocityType& ground,
+    const EulerType& angle,
+    const VelocityType& ground_wind,
+    double thrust, double mass /* 0 is not allowed */,
+    double gravity, /* usually 9.8 > 0*/
+    double drag1,  /* air friction of 1-st order(-d1*v) counter to airspeed */
+    double drag2 /* air friction of 2-nd order(-d2*v*v) counter to airspeed */)
 {
     using std::sin; using std::cos;
 
@@ -303,7 +332,7 @@ AccelerationType acceleration_in_ground_frame(
         c_theta = cos(angle.theta), s_theta = sin(angle.theta),
         c_psi   = cos(angle.psi),   s_psi   = sin(angle.psi);
 
-    const auto [u, v, w] = ground;
+    const auto [u, v, w] = ground - ground_wind; /* airspeed */
     const auto T = thrust;
     const auto m = mass;
     const auto g = gravity;
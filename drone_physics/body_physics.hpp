@@ -116,6 +116,14 @@ AccelerationType acceleration_in_ground_frame(
     double gravity, /* usually 9.8 > 0*/
     double drag1,   /* air friction of 1-st order(-d1*v) counter to velocity */
     double drag2 = 0.0 /* air friction of 2-nd order(-d2*v*v) counter to velocity */);
+AccelerationType acceleration_in_ground_frame(
+    const VelocityType& ground,
+    const EulerType& angle,
+    const VelocityType& ground_wind, /* wind velocity in ground frame */
+    double thrust, double mass /* 0 is not allowed */,
+    double gravity, /* usually 9.8 > 0*/
+    double drag1,   /* air friction of 1-st order(-d1*v) counter to airspeed */
+    double drag2 = 0.0 /* air friction of 2-nd order(-d2*v*v) counter to airspeed */);
 
 
 /* physics for Force/Mass(F= ma) and Torque/Inertia(I dw/dt = T - w x Iw) */
@@ -135,6 +143,17 @@ AccelerationType acceleration_in_body_frame(
     double drag1,   /* air friction of 1-st order(-d1*v) counter to velocity */
     double drag2 = 0.0 /* air friction of 2-nd order(-d2*v*v) counter to velocity */);
 
+/* With wind, the air friction is counter to the velocity relative to the air(velocity - wind) */
+AccelerationType acceleration_in_body_frame(
+    const VelocityType& body_velocity,
+    const EulerType& angle,
+    const AngularVelocityType& body_angular_velocity, /* for Coriolis */
+    const VelocityType& body_wind, /* wind velocity in body frame */
+    double thrust, double mass, /* 0 is not allowed */
+    double gravity, /* usually 9.8 > 0*/
+    double drag1,   /* air friction of 1-st order(-d1*v) counter to airspeed */
+    double drag2 = 0.0 /* air friction of 2-nd order(-d2*v*v) counter to airspeed */);
+
 /* angular acceleration in body frame based on JW' = W x JW =Tb ...eq.(1.137),(2.31) */
 AngularAccelerationType angular_acceleration_in_body_frame(
     const AngularVelocityType& body_angular_velocity,
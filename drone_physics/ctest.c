@@ -60,6 +60,17 @@ void static test_body_acceleration()
         ));
 }
 
+static void test_acceleration_with_wind()
+{
+    dp_velocity_t v = {0, 0, 0};
+    dp_euler_t e = {0, 0, 0};
+    dp_angular_velocity_t a = {0, 0, 0};
+    dp_velocity_t wind = {4, 0, 0};
+    double trust = 10, mass = 2, gravity = 1, drag = 0.1;
+    dp_acceleration_t acc = dp_acceleration_in_body_frame_with_wind(&v, &e, &a, &wind, trust, mass, gravity, drag);
+    assert_almost_equal(acc, ((dp_acceleration_t){drag/mass*4, 0, -trust/mass+gravity}));
+}
+
 static void test_body_angular_acceleration()
 {
     const dp_angular_velocity_t  v = {1, 2, 3};
@@ -75,11 +86,35 @@ static void test_body_angular_acceleration()
     assert_almost_equal(a, expected);
 }
 
+static void test_rotor_mixer()
+{
+    const dp_vector_t position[4] = { /* + shape */
+        {0.3, 0.0, 0}, {0.0, -0.3, 0}, {-0.3, 0.0, 0}, {0.0, 0.3, 0}
+    };
+    const double ccw[4] = {-1, 1, -1, 1};
+    const double omega[4] = {100, 0, 0, 0};
+    const double A = 1, B = 0, Jr = 1;
+
+    dp_rotor_mixer_t* mixer = dp_rotor_mixer_create(A, B, Jr, 4, position, ccw);
+    assert(dp_rotor_mixer_rotor_num(mixer) == 4);
+    dp_thrust_torque_t t = dp_rotor_mixer_thrust_torque(mixer, omega, NULL);
+    assert(fabs(t.thrust - A*100*100) < 0.0001);
+    dp_vector_t expected = {0, (0.3)*A*100*100, 0}; /* only rotor0 torque */
+    assert_almost_equal(t.torque, expected);
+
+    dp_thrust_torque_t out[2];
+    const double omega2[8] = {100, 0, 0, 0, 100, 0, 0, 0};
+    dp_rotor_mixer_thrust_torque_batch(mixer, 2, omega2, NULL, out);
+    assert_almost_equal(out[1].torque, expected);
+    dp_rotor_mixer_destroy(mixer);
+}
 
 int main() {
     T(test_frame_all_unit_vectors_with_some_angles);
     T(test_frame_roundtrip);
     T(test_body_acceleration);
+    T(test_acceleration_with_wind);
     T(test_body_angular_acceleration);
+    T(test_rotor_mixer);
     return 0;
 }
\ No newline at end of file
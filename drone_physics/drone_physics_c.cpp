@@ -1,6 +1,11 @@
 #include "drone_physics_c.h"
 #include "drone_physics.hpp"
 #include <cassert>
+#include <vector>
+
+struct dp_rotor_mixer {
+    hako::drone_physics::RotorMixer mixer;
+};
 
 static hako::drone_physics::VectorType to_Vector(const dp_vector_t* v)
 {
@@ -19,6 +24,11 @@ static dp_vector_t to_dp_vector(const hako::drone_physics::VectorType& v)
     return dp_vector_t{v.x, v.y, v.z};
 }
 
+static dp_thrust_torque_t to_dp_thrust_torque(const hako::drone_physics::ThrustTorqueType& t)
+{
+    return dp_thrust_torque_t{t.thrust, to_dp_vector(t.torque)};
+}
+
 /* not used for now
 static dp_euler_t to_dp_euler(const hako::drone_physics::EulerType& e)
 {
@@ -78,6 +88,29 @@ dp_acceleration_t dp_acceleration_in_body_frame(
         );
 }
 
+dp_acceleration_t dp_acceleration_in_body_frame_with_wind(
+    const dp_vector_t* body_velocity,
+    const dp_euler_t* angle,
+    const dp_angular_velocity_t* body_angular_velocity,
+    const dp_vector_t* body_wind,
+    double thrust, double mass, double gravity, double drag)
+{
+    assert(body_velocity);
+    assert(angle);
+    assert(body_angular_velocity);
+    assert(body_wind);
+
+    return to_dp_vector(
+        hako::drone_physics::acceleration_in_body_frame(
+            to_Vector(body_velocity),
+            to_Euler(angle),
+            to_Vector(body_angular_velocity),
+            to_Vector(body_wind),
+            thrust, mass, gravity, drag
+            )
+        );
+}
+
 dp_angular_acceleration_t dp_angular_acceleration_in_body_frame(
     const dp_angular_velocity_t* body_angular_velocity,
     double torque_x, /* in body frame */
@@ -98,6 +131,72 @@ dp_angular_acceleration_t dp_angular_acceleration_in_body_frame(
         );
 }
 
+dp_rotor_mixer_t* dp_rotor_mixer_create(
+    double A, double B, double Jr, unsigned n,
+    const dp_vector_t position[], const double ccw[])
+{
+    assert(position);
+    assert(ccw);
+
+    std::vector<hako::drone_physics::VectorType> pos(n);
+    for (unsigned i = 0; i < n; i++) {
+        pos[i] = to_Vector(&position[i]);
+    }
+    return new dp_rotor_mixer{
+        hako::drone_physics::RotorMixer(A, B, Jr, n, pos.data(), ccw)
+    };
+}
+
+void dp_rotor_mixer_destroy(dp_rotor_mixer_t* mixer)
+{
+    delete mixer;
+}
+
+unsigned dp_rotor_mixer_rotor_num(const dp_rotor_mixer_t* mixer)
+{
+    assert(mixer);
+    return mixer->mixer.rotor_num();
+}
+
+double dp_rotor_mixer_get(const dp_rotor_mixer_t* mixer, unsigned row, unsigned col)
+{
+    assert(mixer);
+    assert(row < 4 && col < mixer->mixer.rotor_num());
+    return mixer->mixer.get(row, col);
+}
+
+dp_thrust_torque_t dp_rotor_mixer_thrust_torque(
+    const dp_rotor_mixer_t* mixer,
+    const double omega[], const double omega_acceleration[])
+{
+    assert(mixer);
+    assert(omega);
+
+    return to_dp_thrust_torque(
+        mixer->mixer.thrust_torque(omega, omega_acceleration));
+}
 
+void dp_rotor_mixer_thrust_torque_batch(
+    const dp_rotor_mixer_t* mixer, unsigned m,
+    const double omega[], const double omega_acceleration[],
+    dp_thrust_torque_t out[])
+{
+    assert(mixer);
+    assert(omega);
+    assert(out);
+
+    /* forward to RotorMixer::thrust_torque_batch() in chunks, without heap allocation */
+    const unsigned CHUNK = 64;
+    hako::drone_physics::ThrustTorqueType chunk[CHUNK];
+    const unsigned n = mixer->mixer.rotor_num();
+    for (unsigned k = 0; k < m; k += CHUNK) {
+        const unsigned num = (m - k < CHUNK) ? (m - k) : CHUNK;
+        mixer->mixer.thrust_torque_batch(num, &omega[k * n],
+            omega_acceleration != nullptr ? &omega_acceleration[k * n] : nullptr, chunk);
+        for (unsigned i = 0; i < num; i++) {
+            out[k + i] = to_dp_thrust_torque(chunk[i]);
+        }
+    }
+}
 
 } // extern "C"
@@ -54,6 +54,16 @@ dp_acceleration_t dp_acceleration_in_body_frame(
     double mass, /* 0 is not allowed */
     double gravity, double drag);
 
+/* air friction is counter to the airspeed(body_velocity - body_wind) */
+dp_acceleration_t dp_acceleration_in_body_frame_with_wind(
+    const dp_vector_t* body_velocity,
+    const dp_euler_t* angle,
+    const dp_angular_velocity_t* body_angular_velocity,
+    const dp_vector_t* body_wind,
+    double thrust,
+    double mass, /* 0 is not allowed */
+    double gravity, double drag);
+
 dp_angular_acceleration_t dp_angular_acceleration_in_body_frame(
     const dp_angular_velocity_t* body_angular_velocity,
     double torque_x, /* in body frame */
@@ -63,6 +73,46 @@ dp_angular_acceleration_t dp_angular_acceleration_in_body_frame(
     double I_yy, /* in body frame, 0 is not allowed */
     double I_zz /* in body frame, 0 is not allowed */);
 
+/**
+ * Rotor mixer, see RotorMixer in rotor_physics.hpp.
+ * The mixing matrix is built once by dp_rotor_mixer_create(), and freed by dp_rotor_mixer_destroy().
+ */
+typedef struct dp_rotor_mixer dp_rotor_mixer_t; /* opaque */
+
+typedef struct {
+    double thrust;
+    dp_vector_t torque;
+} dp_thrust_torque_t;
+
+dp_rotor_mixer_t* dp_rotor_mixer_create(
+    double A, /* parameter A in Trust = A*(Omega)^2 */
+    double B, /* parameter B in Ta = B*(Omega)^2 + Jr* (d(Omega)/dt) */
+    double Jr,
+    unsigned n, /* number of rotors */
+    const dp_vector_t position[], /* position of each rotor */
+    const double ccw[] /* 1 or -1 */ );
+
+void dp_rotor_mixer_destroy(dp_rotor_mixer_t* mixer);
+
+unsigned dp_rotor_mixer_rotor_num(const dp_rotor_mixer_t* mixer);
+
+/* element of the 4xN matrix, row 0..3(thrust, torque x, y, z), col 0..N-1 */
+double dp_rotor_mixer_get(const dp_rotor_mixer_t* mixer, unsigned row, unsigned col);
+
+/* same as body_thrust() and body_torque() */
+dp_thrust_torque_t dp_rotor_mixer_thrust_torque(
+    const dp_rotor_mixer_t* mixer, /* non-null */
+    const double omega[], /* in rpm */
+    const double omega_acceleration[] /* in rpm/s, nullable */ );
+
+/* dp_rotor_mixer_thrust_torque() of m vehicles, omega and omega_acceleration are m x N arrays */
+void dp_rotor_mixer_thrust_torque_batch(
+    const dp_rotor_mixer_t* mixer, /* non-null */
+    unsigned m,
+    const double omega[],
+    const double omega_acceleration[], /* nullable */
+    dp_thrust_torque_t out[] /* m */ );
+
 #ifdef __cplusplus
 }
 #endif
@@ -166,6 +166,71 @@ double body_thrust_linear(double A2, unsigned n, double omega[])
     return thrust;
 }
 
+/**
+ * The mixing matrix of body_thrust() and body_torque().
+ * The thrust torque of rotor i is (x_i, y_i, z_i) x (0, 0, -A u_i)
+ * = (-A y_i u_i, A x_i u_i, 0), so z_i does not appear in the matrix.
+ */
+RotorMixer::RotorMixer(double A, double B, double Jr, unsigned n,
+    const VectorType position[], const double ccw[])
+    : n_(n), matrix_(4 * n), jr_ccw_(n)
+{
+    for (unsigned i = 0; i < n; i++) {
+        matrix_[4 * i + 0] = A;
+        matrix_[4 * i + 1] = -A * position[i].y;
+        matrix_[4 * i + 2] = A * position[i].x;
+        matrix_[4 * i + 3] = ccw[i] * B;
+        jr_ccw_[i] = Jr * ccw[i];
+    }
+}
+
+ThrustTorqueType RotorMixer::multiply(const double u[]) const
+{
+    /* accumulate column by column, so that the 4 rows go together */
+    double acc[4] = {0, 0, 0, 0};
+    const double* m = matrix_.data();
+    for (unsigned i = 0; i < n_; i++) {
+        for (unsigned r = 0; r < 4; r++) {
+            acc[r] += m[4 * i + r] * u[i];
+        }
+    }
+    return ThrustTorqueType{acc[0], {acc[1], acc[2], acc[3]}};
+}
+
+ThrustTorqueType RotorMixer::thrust_torque(
+    const double omega[], const double omega_acceleration[]) const
+{
+    double acc[4] = {0, 0, 0, 0};
+    const double* m = matrix_.data();
+    for (unsigned i = 0; i < n_; i++) {
+        const double u = omega[i] * omega[i];
+        for (unsigned r = 0; r < 4; r++) {
+            acc[r] += m[4 * i + r] * u;
+        }
+    }
+    if (omega_acceleration != nullptr) {
+        for (unsigned i = 0; i < n_; i++) {
+            acc[3] += jr_ccw_[i] * omega_acceleration[i];
+        }
+    }
+    return ThrustTorqueType{acc[0], {acc[1], acc[2], acc[3]}};
+}
+
+ThrustTorqueType RotorMixer::thrust_torque_linear(const double omega[]) const
+{
+    return multiply(omega);
+}
+
+void RotorMixer::thrust_torque_batch(unsigned m,
+    const double omega[], const double omega_acceleration[],
+    ThrustTorqueType out[]) const
+{
+    for (unsigned k = 0; k < m; k++) {
+        out[k] = thrust_torque(&omega[k * n_],
+            omega_acceleration != nullptr ? &omega_acceleration[k * n_] : nullptr);
+    }
+}
+
 
 
 } /* namespace hako::drone_physics */
\ No newline at end of file
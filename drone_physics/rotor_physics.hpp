@@ -2,6 +2,7 @@
 #define _ROTOR_PHYSICS_HPP_
 
 #include "body_physics.hpp"
+#include <vector>
 
 namespace hako::drone_physics {
 
@@ -64,6 +65,62 @@ TorqueType body_torque_linear(double A2, double B2, unsigned n,
     VectorType position[], double ccw[], double omega[]);
 double body_thrust_linear(double A2, unsigned n, double omega[]);
 
+/**
+ * The sum of thrust and torque from the rotors.
+ */
+struct ThrustTorqueType {
+    double thrust;
+    TorqueType torque;
+};
+
+/**
+ * Precomputed mixing matrix of the rotors, the same as body_thrust() and body_torque().
+ * Build it once from the rotor positions, ccw, A, B and Jr, then
+ *
+ *   (thrust, torque.x, torque.y, torque.z)^T = M u + (0, 0, 0, sum_i Jr ccw_i d(Omega_i)/dt)^T
+ *
+ * where M is 4xN and u_i = (Omega_i)^2. The column i of M is
+ *
+ *   (A, -A y_i, A x_i, ccw_i B)^T
+ *
+ * which is (position_i) x (0, 0, -A (Omega_i)^2) plus the anti-torque eq.(2.60)-(2.62).
+ * M is stored column by column, so that each rotor adds one 4-vector (SIMD friendly).
+ *
+ * For the jMAVsim linear model(body_thrust_linear()/body_torque_linear()),
+ * build it with A2, B2 and Jr=0 and use thrust_torque_linear(), where u_i = Omega_i.
+ */
+class RotorMixer {
+public:
+    RotorMixer() : n_(0) {}
+    RotorMixer(double A, double B, double Jr, unsigned n,
+        const VectorType position[], const double ccw[]);
+
+    unsigned rotor_num() const { return n_; }
+    /* element of M, row 0..3, col 0..N-1 */
+    double get(unsigned row, unsigned col) const { return matrix_[4 * col + row]; }
+
+    /* M u, u is an array of N */
+    ThrustTorqueType multiply(const double u[]) const;
+
+    /* same as body_thrust() and body_torque(), omega_acceleration can be null(zero) */
+    ThrustTorqueType thrust_torque(
+        const double omega[], /* in rpm */
+        const double omega_acceleration[] /* in rpm/s, nullable */ ) const;
+
+    /* same as body_thrust_linear() and body_torque_linear() */
+    ThrustTorqueType thrust_torque_linear(const double omega[] /* in rpm */ ) const;
+
+    /* thrust_torque() of m vehicles with the same rotors.
+     * omega and omega_acceleration are m x N arrays (vehicle by vehicle) */
+    void thrust_torque_batch(unsigned m,
+        const double omega[], const double omega_acceleration[] /* nullable */,
+        ThrustTorqueType out[] /* m */ ) const;
+private:
+    unsigned n_;
+    std::vector<double> matrix_; /* 4 x N, column-major */
+    std::vector<double> jr_ccw_; /* Jr * ccw_i */
+};
+
 
 
 } /* namespace hako::drone_physics */
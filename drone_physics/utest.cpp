@@ -226,6 +226,41 @@ void test_body_acceleration() {
     assert_almost_equal(a, (AccelerationType{-1, 2, -trust/mass+gravity-1}));
 }
 
+void test_acceleration_with_wind() {
+    const VelocityType v{1, 2, 3};
+    const EulerType angle{PI/6, PI/8, PI/3};
+    const double trust = 10, mass = 2, gravity = 1, drag = 0.1;
+
+    /* no wind is the same as without wind */
+    AccelerationType a = acceleration_in_body_frame(v, angle, AngularVelocityType{1, 1, 1}, VelocityType{0, 0, 0},
+        trust, mass, gravity, drag);
+    assert_almost_equal(a, acceleration_in_body_frame(v, angle, AngularVelocityType{1, 1, 1},
+        trust, mass, gravity, drag));
+
+    /* drifting with the wind has no air friction */
+    a = acceleration_in_body_frame(v, angle, AngularVelocityType{0, 0, 0}, v,
+        trust, mass, gravity, drag);
+    assert_almost_equal(a, acceleration_in_body_frame(v, angle, AngularVelocityType{0, 0, 0},
+        trust, mass, gravity, 0));
+
+    /* standing still in the wind is pushed by the wind */
+    a = acceleration_in_body_frame(VelocityType{0, 0, 0}, EulerType{0, 0, 0}, AngularVelocityType{0, 0, 0}, VelocityType{4, 0, 0},
+        trust, mass, gravity, drag);
+    assert_almost_equal(a, (AccelerationType{drag/mass*4, 0, -trust/mass+gravity}));
+
+    /* the same in ground frame */
+    AccelerationType a_g = acceleration_in_ground_frame(v, angle, v,
+        trust, mass, gravity, drag);
+    assert_almost_equal(a_g, acceleration_in_ground_frame(v, angle, trust, mass, gravity, 0));
+
+    /* ground wind and body wind are the same wind */
+    a_g = acceleration_in_ground_frame(VelocityType{0, 0, 0}, angle, v,
+        trust, mass, gravity, drag);
+    a = acceleration_in_body_frame(VelocityType{0, 0, 0}, angle, AngularVelocityType{0, 0, 0}, body_vector_from_ground(v, angle),
+        trust, mass, gravity, drag);
+    assert_almost_equal(a_g, ground_vector_from_body(a, angle));
+}
+
 void test_ground_acceleration() {
     VelocityType v{1, 2, 3};
     EulerType angle{0, 0, 0};
@@ -447,6 +482,53 @@ void test_body_anti_Jr_torque() {
     assert_almost_equal(torque, (TorqueType{0, 0, 10*Jr}));
 }
 
+void test_rotor_mixer() {
+    double A = 1, B = 0.5, Jr = 0.1;
+    unsigned n = 6;
+    VectorType position[6];
+    double ccw[6], omega[6], omega_acceleration[6];
+    for (unsigned i = 0; i < n; i++) { // hexa
+        position[i] = {0.3 * cos(2*PI*i/n), 0.3 * sin(2*PI*i/n), 0.05};
+        ccw[i] = (i % 2 == 0) ? 1 : -1;
+        omega[i] = 100 + 10*i;
+        omega_acceleration[i] = 5.0*i;
+    }
+    RotorMixer mixer(A, B, Jr, n, position, ccw);
+    assert(mixer.rotor_num() == n);
+    assert(mixer.get(0, 1) == A);
+    assert(mixer.get(3, 1) == -B);
+
+    /* the same as body_thrust() and body_torque() */
+    ThrustTorqueType t = mixer.thrust_torque(omega, omega_acceleration);
+    assert(fabs(t.thrust - body_thrust(A, n, omega)) < 1e-9);
+    assert_almost_equal(t.torque, body_torque(A, B, Jr, n, position, ccw, omega, omega_acceleration));
+
+    /* null omega_acceleration is zero */
+    [[maybe_unused]] double zero[6] = {0, 0, 0, 0, 0, 0};
+    t = mixer.thrust_torque(omega, nullptr);
+    assert_almost_equal(t.torque, body_torque(A, B, Jr, n, position, ccw, omega, zero));
+
+    /* linear model */
+    RotorMixer linear(A, B, 0, n, position, ccw);
+    t = linear.thrust_torque_linear(omega);
+    assert(fabs(t.thrust - body_thrust_linear(A, n, omega)) < 1e-9);
+    assert_almost_equal(t.torque, body_torque_linear(A, B, n, position, ccw, omega));
+
+    /* batch of 2 vehicles */
+    double omega2[12], omega_acceleration2[12];
+    for (unsigned i = 0; i < n; i++) {
+        omega2[i] = omega[i];
+        omega2[n+i] = omega[n-1-i];
+        omega_acceleration2[i] = omega_acceleration[i];
+        omega_acceleration2[n+i] = 0;
+    }
+    ThrustTorqueType out[2];
+    mixer.thrust_torque_batch(2, omega2, omega_acceleration2, out);
+    assert_almost_equal(out[0].torque, mixer.thrust_torque(omega, omega_acceleration).torque);
+    assert_almost_equal(out[1].torque, mixer.thrust_torque(&omega2[n], nullptr).torque);
+    assert(fabs(out[1].thrust - out[0].thrust) < 1e-9);
+}
+
 void test_collision()
 {
     VectorType before{10, 10, 10};
@@ -467,6 +549,7 @@ int main() {
     T(test_frame_matrix_is_unitary);
     T(test_frame_roundtrip);
     T(test_body_acceleration);
+    T(test_acceleration_with_wind);
     T(test_ground_acceleration);
     T(test_angular_frame_roundtrip);
     T(test_body_angular_acceleration);
@@ -478,6 +561,7 @@ int main() {
     T(test_body_torque);
     T(test_body_anti_torque);
     T(test_body_anti_Jr_torque);
+    T(test_rotor_mixer);
     T(test_collision);
     std::cerr << "-------all standard test PASSSED!!----\n";
     T(test_issue_89_yaw_angle_bug);
@@ -0,0 +1,19 @@
+#!/bin/bash
+
+OS_TYPE=`uname`
+
+cd cmake-build
+if [ ${OS_TYPE} = "Linux" ]
+then
+    uname -a | grep WSL2 > /dev/null
+    if [ $? -eq 0 ]
+    then
+        cmake .. -D HAKO_CLIENT_OPTION_FILEPATH=`pwd`/../../cmake-options/win-cmake-options.cmake -DDO_BENCH=true
+    else
+        cmake .. -D HAKO_CLIENT_OPTION_FILEPATH=`pwd`/../../cmake-options/linux-cmake-options.cmake -DDO_BENCH=true
+    fi
+else
+    cmake ..  -DDO_BENCH=true
+fi
+make hako-px4sim-bench
+./bench/hako-px4sim-bench --benchmark_out=bench-hako-px4sim.json --benchmark_out_format=json "$@"
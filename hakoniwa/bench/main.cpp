@@ -0,0 +1,29 @@
+#include <benchmark/benchmark.h>
+#include "utils/csv_logger.hpp"
+#include "config/drone_config.hpp"
+bool CsvLogger::enable_flag = false;
+uint64_t CsvLogger::time_usec = 0; 
+class DroneConfig drone_config;
+
+int main(int argc, char *argv[])
+{
+    /*
+     * AirCraft の計測には drone_config.json が必要。
+     * 環境変数 HAKO_BENCH_DRONE_CONFIG で指定できる。
+     */
+    const char* config_path = getenv("HAKO_BENCH_DRONE_CONFIG");
+    if (config_path == nullptr) {
+        config_path = HAKO_BENCH_DEFAULT_DRONE_CONFIG;
+    }
+    if (drone_config.init(config_path) == false) {
+        std::cerr << "ERROR: Failed to load drone config: " << config_path << std::endl;
+        return 1;
+    }
+    ::benchmark::Initialize(&argc, argv);
+    if (::benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    ::benchmark::RunSpecifiedBenchmarks();
+    ::benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,50 @@
+#include <benchmark/benchmark.h>
+#include "aircraft/aircraft_factory.hpp"
+#include "utils/csv_logger.hpp"
+
+using hako::assets::drone::IAirCraft;
+using hako::assets::drone::DroneDynamicsInputType;
+using hako::assets::drone::ROTOR_NUM;
+
+/*
+ * hako-px4sim の1ステップ分の機体計算（ロータ・推力・機体・全センサ）。
+ * drone_config.json の設定で組み立てた機体を使う。
+ * state.range(0) が 0 以外なら CSV ログも出力する（logOutputDirectory に書き込む）。
+ */
+static void BM_AirCraft_run(benchmark::State& state)
+{
+    IAirCraft *drone = hako::assets::drone::create_aircraft("default");
+    DroneDynamicsInputType input = DroneDynamicsInputType();
+    for (int i = 0; i < ROTOR_NUM; i++) {
+        input.controls[i] = 0.6;
+    }
+    if (state.range(0)) {
+        CsvLogger::enable();
+    }
+    for (auto _ : state) {
+        drone->run(input);
+        benchmark::DoNotOptimize(drone->get_drone_dynamics().get_pos());
+    }
+    CsvLogger::disable();
+    delete drone;
+}
+BENCHMARK(BM_AirCraft_run)->Arg(0)->Arg(1);
+
+/*
+ * MAVLink の送信1回分のセンサ値の読み出し
+ */
+static void BM_AirCraft_sensor_values(benchmark::State& state)
+{
+    IAirCraft *drone = hako::assets::drone::create_aircraft("default");
+    DroneDynamicsInputType input = DroneDynamicsInputType();
+    drone->run(input);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(drone->get_acc().sensor_value());
+        benchmark::DoNotOptimize(drone->get_gyro().sensor_value());
+        benchmark::DoNotOptimize(drone->get_mag().sensor_value());
+        benchmark::DoNotOptimize(drone->get_baro().sensor_value());
+        benchmark::DoNotOptimize(drone->get_gps().sensor_value());
+    }
+    delete drone;
+}
+BENCHMARK(BM_AirCraft_sensor_values);
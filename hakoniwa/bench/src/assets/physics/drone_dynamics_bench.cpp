@@ -0,0 +1,302 @@
+#include <benchmark/benchmark.h>
+#include "physics/body_frame/drone_dynamics_body_frame.hpp"
+#include "physics/body_frame_rk4/drone_dynamics_body_frame_rk4.hpp"
+#include "physics/ground_frame/drone_dynamics_ground_frame.hpp"
+#include "physics/rotor/rotor_dynamics.hpp"
+#include "physics/rotor/rotor_dynamics_jmavsim.hpp"
+#include "physics/rotor/rotor_bank.hpp"
+#include "physics/thruster/thrust_dynamics_linear.hpp"
+#include "physics/thruster/thrust_dynamics_nonlinear.hpp"
+#include "physics/thruster/airframe.hpp"
+#include "physics/collision/collision_world.hpp"
+#include "physics/wind/wind_model.hpp"
+#include "physics/battery/battery_model.hpp"
+#include "utils/terrain_heightmap.hpp"
+#include <cstdio>
+#include <fstream>
+#include <vector>
+#include <random>
+
+using hako::assets::drone::IDroneDynamics;
+using hako::assets::drone::DroneDynamicsBodyFrame;
+using hako::assets::drone::DroneDynamicsBodyFrameRK4;
+using hako::assets::drone::DroneDynamicsGroundFrame;
+using hako::assets::drone::DroneDynamicsInputType;
+using hako::assets::drone::DronePositionType;
+using hako::assets::drone::RotorDynamics;
+using hako::assets::drone::RotorDynamicsJmavsim;
+using hako::assets::drone::RotorBank;
+using hako::assets::drone::RotorBankModelType;
+using hako::assets::drone::ThrustDynamicsLinear;
+using hako::assets::drone::ThrustDynamicsNonLinear;
+using hako::assets::drone::DroneRotorSpeedType;
+using hako::assets::drone::RotorConfigType;
+using hako::assets::drone::ROTOR_NUM;
+
+#define BENCH_DELTA_TIME_SEC    0.003
+
+/*
+ * ホバリング付近の推力で空中に置いて、地面との接触処理が入らないようにする
+ */
+static void drone_dynamics_setup(IDroneDynamics& dynamics, DroneDynamicsInputType& input)
+{
+    dynamics.set_drag(0.0001, 0.0);
+    dynamics.set_mass(0.1);
+    dynamics.set_body_size(0.1, 0.1, 0.01);
+    dynamics.set_torque_constants(0.0000625, 0.00003125, 0.00009375);
+    DronePositionType pos;
+    pos.data = { 0, 0, -100.0 };
+    dynamics.set_pos(pos);
+    input = DroneDynamicsInputType();
+    input.thrust.data = 0.1 * 9.81;
+    input.torque.data = { 0.0001, -0.0001, 0.00005 };
+}
+
+template <typename T>
+static void BM_DroneDynamics_run(benchmark::State& state)
+{
+    T dynamics(BENCH_DELTA_TIME_SEC);
+    DroneDynamicsInputType input;
+    drone_dynamics_setup(dynamics, input);
+    for (auto _ : state) {
+        dynamics.run(input);
+        benchmark::DoNotOptimize(dynamics.get_pos());
+    }
+}
+BENCHMARK_TEMPLATE(BM_DroneDynamics_run, DroneDynamicsBodyFrame);
+BENCHMARK_TEMPLATE(BM_DroneDynamics_run, DroneDynamicsBodyFrameRK4);
+BENCHMARK_TEMPLATE(BM_DroneDynamics_run, DroneDynamicsGroundFrame);
+
+template <typename T>
+static void BM_RotorDynamics_run(benchmark::State& state)
+{
+    T rotor(BENCH_DELTA_TIME_SEC);
+    rotor.set_params(6000, 0.1, 6000);
+    for (auto _ : state) {
+        rotor.run(0.6);
+        benchmark::DoNotOptimize(rotor.get_rotor_speed());
+    }
+}
+BENCHMARK_TEMPLATE(BM_RotorDynamics_run, RotorDynamics);
+BENCHMARK_TEMPLATE(BM_RotorDynamics_run, RotorDynamicsJmavsim);
+
+/*
+ * state.range(0) 個のロータをまとめて計算する（state.range(1) は RotorBankModelType）
+ */
+static void BM_RotorBank_run(benchmark::State& state)
+{
+    RotorBank rotors(BENCH_DELTA_TIME_SEC, (int)state.range(0), (RotorBankModelType)state.range(1));
+    rotors.set_params(6000, 0.1, 6000);
+    std::vector<double> controls(state.range(0), 0.6);
+    for (auto _ : state) {
+        rotors.run(controls.data());
+        benchmark::DoNotOptimize(rotors.get_rotor_speeds());
+    }
+}
+BENCHMARK(BM_RotorBank_run)->ArgsProduct({ { 4, 6, 8 }, { 0, 1 } });
+
+/*
+ * モータの電流・電力とバッテリを含めた電源系の1ステップ（state.range(0) 個のロータ）
+ */
+static void BM_RotorBank_run_with_battery(benchmark::State& state)
+{
+    RotorBank rotors(BENCH_DELTA_TIME_SEC, (int)state.range(0));
+    rotors.set_params(6000, 0.1, 6000);
+    hako::assets::drone::RotorMotorParamType motor = { 920.0, 0.1, 0.5, 1e-8, 0.95 };
+    rotors.set_motor_params(motor);
+    hako::assets::drone::BatteryModel battery(BENCH_DELTA_TIME_SEC);
+    std::vector<double> controls(state.range(0), 0.6);
+    for (auto _ : state) {
+        rotors.set_supply_voltage_ratio(battery.get_status().voltage / battery.get_reference_voltage());
+        rotors.run(controls.data());
+        battery.run(rotors.get_load_power());
+        benchmark::DoNotOptimize(battery.get_status());
+    }
+}
+BENCHMARK(BM_RotorBank_run_with_battery)->Arg(4)->Arg(8);
+
+static void thrust_setup(RotorConfigType rotor_config[ROTOR_NUM], DroneRotorSpeedType rotor_speed[ROTOR_NUM])
+{
+    static const double positions[ROTOR_NUM][2] = { { 0.3, 0.3 }, { -0.3, -0.3 }, { 0.3, -0.3 }, { -0.3, 0.3 } };
+    for (int i = 0; i < ROTOR_NUM; i++) {
+        rotor_config[i].ccw = (i < 2) ? -1 : 1;
+        rotor_config[i].data = { positions[i][0], positions[i][1], 0 };
+        rotor_speed[i].data = 3000.0 + i;
+    }
+}
+
+static void BM_ThrustDynamicsLinear_run(benchmark::State& state)
+{
+    ThrustDynamicsLinear thrust(BENCH_DELTA_TIME_SEC);
+    RotorConfigType rotor_config[ROTOR_NUM];
+    DroneRotorSpeedType rotor_speed[ROTOR_NUM];
+    thrust_setup(rotor_config, rotor_speed);
+    thrust.set_params(0.0001, 0.00001);
+    thrust.set_rotor_config(rotor_config);
+    for (auto _ : state) {
+        thrust.run(rotor_speed);
+        benchmark::DoNotOptimize(thrust.get_torque());
+    }
+}
+BENCHMARK(BM_ThrustDynamicsLinear_run);
+
+static void BM_ThrustDynamicsNonLinear_run(benchmark::State& state)
+{
+    ThrustDynamicsNonLinear thrust(BENCH_DELTA_TIME_SEC);
+    RotorConfigType rotor_config[ROTOR_NUM];
+    DroneRotorSpeedType rotor_speed[ROTOR_NUM];
+    thrust_setup(rotor_config, rotor_speed);
+    thrust.set_params(0.0000001, 0.00000001, 0.000001);
+    thrust.set_rotor_config(rotor_config);
+    for (auto _ : state) {
+        thrust.run(rotor_speed);
+        benchmark::DoNotOptimize(thrust.get_torque());
+    }
+}
+BENCHMARK(BM_ThrustDynamicsNonLinear_run);
+
+/*
+ * 機体形状ごとの推力計算（state.range(0): 0=quad_x, 1=hexa_x, 2=octa_x, 3=coaxial_x8）
+ */
+static void BM_ThrustDynamicsNonLinear_airframe_run(benchmark::State& state)
+{
+    static const char* airframes[] = { "quad_x", "hexa_x", "octa_x", "coaxial_x8" };
+    ThrustDynamicsNonLinear thrust(BENCH_DELTA_TIME_SEC);
+    std::vector<RotorConfigType> rotor_config;
+    hako::assets::drone::airframe_rotor_config(airframes[state.range(0)], 0.3, 0.1, rotor_config);
+    std::vector<DroneRotorSpeedType> rotor_speed(rotor_config.size());
+    for (size_t i = 0; i < rotor_speed.size(); i++) {
+        rotor_speed[i].data = 3000.0 + i;
+    }
+    thrust.set_params(0.0000001, 0.00000001, 0.000001);
+    thrust.set_rotor_config(rotor_config.data(), (int)rotor_config.size());
+    state.SetLabel(airframes[state.range(0)]);
+    for (auto _ : state) {
+        thrust.run(rotor_speed.data());
+        benchmark::DoNotOptimize(thrust.get_torque());
+    }
+}
+BENCHMARK(BM_ThrustDynamicsNonLinear_airframe_run)->DenseRange(0, 3);
+
+/*
+ * 衝突判定（1km 四方に state.range(0) 個の柱を置き、その間を飛ぶ）
+ */
+static void BM_CollisionWorld_detect(benchmark::State& state)
+{
+    hako::assets::drone::CollisionWorld world;
+    world.set_body_size(0.3, 0.3, 0.1);
+    world.add_plane({ 0, 0, 0 }, { 0, 0, -1 });
+    const int box_num = (int)state.range(0);
+    std::mt19937 gen(1234);
+    std::uniform_real_distribution<double> dist(-500.0, 500.0);
+    for (int i = 0; i < box_num; i++) {
+        world.add_box({ dist(gen), dist(gen), -5.0 }, { 2.0, 2.0, 10.0 });
+    }
+    world.build();
+    DronePositionType pos;
+    hako::assets::drone::DroneEulerType angle;
+    angle.data = { 0.05, -0.05, 0.3 };
+    hako::assets::drone::DroneVelocityType vel;
+    vel.data = { 5.0, 1.0, 0.0 };
+    hako::assets::drone::DroneDynamicsCollisionType collision;
+    int i = 0;
+    for (auto _ : state) {
+        pos.data = { -500.0 + (i % 1000), -500.0 + ((i / 1000) % 1000), -2.0 };
+        benchmark::DoNotOptimize(world.detect(pos, angle, vel, collision));
+        i++;
+    }
+}
+BENCHMARK(BM_CollisionWorld_detect)->Arg(100)->Arg(10000);
+
+/*
+ * 風（一定の風 + 突風 + 乱流）。乱流は作っておいた表を読むだけなので、init_turbulence() は計測に含めない
+ */
+static hako::assets::drone::WindTurbulenceParamType bench_turbulence_param(int samples)
+{
+    hako::assets::drone::WindTurbulenceParamType param;
+    param.model = hako::assets::drone::WIND_TURBULENCE_VON_KARMAN;
+    param.intensity[0] = 1.0;
+    param.intensity[1] = 1.0;
+    param.intensity[2] = 0.5;
+    param.length_scale[0] = 200.0;
+    param.length_scale[1] = 200.0;
+    param.length_scale[2] = 50.0;
+    param.airspeed = 5.0;
+    param.samples = samples;
+    return param;
+}
+static void BM_WindModel_run(benchmark::State& state)
+{
+    hako::assets::drone::WindModel wind(BENCH_DELTA_TIME_SEC);
+    hako::assets::drone::DroneVelocityType constant;
+    constant.data = { 3.0, 1.0, 0.0 };
+    wind.set_constant(constant);
+    hako::assets::drone::WindGustType gust;
+    gust.start_sec = 10.0;
+    gust.duration_sec = 5.0;
+    gust.amplitude.data = { 0.0, 5.0, 0.0 };
+    wind.add_gust(gust);
+    if (!wind.init_turbulence(bench_turbulence_param(65536), 1234)) {
+        state.SkipWithError("can not init turbulence");
+        return;
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(wind.run());
+    }
+}
+BENCHMARK(BM_WindModel_run);
+
+static void BM_WindModel_init_turbulence(benchmark::State& state)
+{
+    for (auto _ : state) {
+        hako::assets::drone::WindModel wind(BENCH_DELTA_TIME_SEC);
+        benchmark::DoNotOptimize(wind.init_turbulence(bench_turbulence_param((int)state.range(0)), 1234));
+    }
+}
+BENCHMARK(BM_WindModel_init_turbulence)->Arg(65536)->Unit(benchmark::kMillisecond);
+
+/*
+ * 地形（2048 x 2048 の DEM、5m 間隔）の上を 10m/s で飛びながら地面の高さを求める
+ */
+static void BM_TerrainHeightmap_get_ground_z(benchmark::State& state)
+{
+    const std::string filepath = "terrain_bench.raw";
+    const int size = 2048;
+    {
+        std::vector<int16_t> samples(size);
+        std::ofstream ofs(filepath, std::ios::out | std::ios::binary | std::ios::trunc);
+        for (int r = 0; r < size; r++) {
+            for (int c = 0; c < size; c++) {
+                samples[c] = (int16_t)((r * 7 + c * 13) % 1000);
+            }
+            ofs.write(reinterpret_cast<const char*>(samples.data()), samples.size() * sizeof(int16_t));
+        }
+    }
+    hako::assets::drone::TerrainHeightmapParamType param;
+    param.format = hako::assets::drone::TERRAIN_FORMAT_INT16;
+    param.width = size;
+    param.height = size;
+    param.cell_size = 5.0;
+    param.origin_x = 0;
+    param.origin_y = 0;
+    param.height_scale = 1.0;
+    param.base_altitude = 0;
+    param.tile_size = TERRAIN_DEFAULT_TILE_SIZE;
+    param.max_tiles = TERRAIN_DEFAULT_MAX_TILES;
+    hako::assets::drone::TerrainHeightmap terrain;
+    if (!terrain.open(filepath, param)) {
+        state.SkipWithError("can not open terrain");
+        return;
+    }
+    double ground_z = 0;
+    int i = 0;
+    for (auto _ : state) {
+        double t = (i % 300000) * BENCH_DELTA_TIME_SEC;
+        benchmark::DoNotOptimize(terrain.get_ground_z(10.0 + 10.0 * t, 10.0 + 3.0 * t, ground_z));
+        i++;
+    }
+    state.counters["tile_loads"] = (double)terrain.get_tile_load_count();
+    terrain.close();
+    std::remove(filepath.c_str());
+}
+BENCHMARK(BM_TerrainHeightmap_get_ground_z);
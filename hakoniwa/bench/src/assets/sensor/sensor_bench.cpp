@@ -0,0 +1,205 @@
+#include <benchmark/benchmark.h>
+#include "sensors/acc/sensor_acceleration.hpp"
+#include "sensors/baro/sensor_baro.hpp"
+#include "sensors/gps/sensor_gps.hpp"
+#include "sensors/gyro/sensor_gyro.hpp"
+#include "sensors/mag/sensor_mag.hpp"
+#include "sensors/imu/sensor_imu.hpp"
+#include "utils/sensor_noise.hpp"
+#include "utils/atmosphere_model.hpp"
+
+using hako::assets::drone::SensorAcceleration;
+using hako::assets::drone::SensorBaro;
+using hako::assets::drone::SensorGps;
+using hako::assets::drone::GpsParamType;
+using hako::assets::drone::SensorGyro;
+using hako::assets::drone::SensorMag;
+using hako::assets::drone::SensorImu;
+using hako::assets::drone::ImuNoiseParamType;
+using hako::assets::drone::ImuVibrationParamType;
+using hako::assets::drone::DroneAccelerationBodyFrameType;
+using hako::assets::drone::DroneRotorSpeedType;
+using hako::assets::drone::SensorNoise;
+using hako::assets::drone::AtmosphereModel;
+using hako::assets::drone::DronePositionType;
+using hako::assets::drone::DroneVelocityType;
+using hako::assets::drone::DroneVelocityBodyFrameType;
+using hako::assets::drone::DroneAngularVelocityBodyFrameType;
+using hako::assets::drone::DroneEulerType;
+
+#define BENCH_DELTA_TIME_SEC    0.003
+#define BENCH_SAMPLE_NUM        1
+
+/*
+ * state.range(0) が 0 以外ならノイズを加える
+ */
+static SensorNoise bench_noise(0.01);
+
+static void BM_SensorAcceleration_run(benchmark::State& state)
+{
+    SensorAcceleration sensor(BENCH_DELTA_TIME_SEC, BENCH_SAMPLE_NUM);
+    if (state.range(0)) {
+        sensor.set_noise(&bench_noise);
+    }
+    DroneVelocityBodyFrameType value;
+    value.data = { 1, 2, 3 };
+    for (auto _ : state) {
+        value.data.x += 0.001;
+        sensor.run(value);
+        benchmark::DoNotOptimize(sensor.sensor_value());
+    }
+}
+BENCHMARK(BM_SensorAcceleration_run)->Arg(0)->Arg(1);
+
+static void BM_SensorGyro_run(benchmark::State& state)
+{
+    SensorGyro sensor(BENCH_DELTA_TIME_SEC, BENCH_SAMPLE_NUM);
+    if (state.range(0)) {
+        sensor.set_noise(&bench_noise);
+    }
+    DroneAngularVelocityBodyFrameType value;
+    value.data = { 0.1, 0.2, 0.3 };
+    for (auto _ : state) {
+        sensor.run(value);
+        benchmark::DoNotOptimize(sensor.sensor_value());
+    }
+}
+BENCHMARK(BM_SensorGyro_run)->Arg(0)->Arg(1);
+
+/*
+ * state.range(0): IMU のサンプリングレート [Hz]（ノイズ・バイアス・4ロータの振動あり）。
+ * ステップあたりの時間がレートによらないことを見る
+ */
+static void BM_SensorImu_run(benchmark::State& state)
+{
+    SensorImu sensor(BENCH_DELTA_TIME_SEC, (double)state.range(0), 1);
+    ImuNoiseParamType acc = { 0.002, 0.0005, 100.0, 0.0001 };
+    ImuNoiseParamType gyro = { 0.0003, 0.00005, 100.0, 0.00001 };
+    ImuVibrationParamType vibration = { 1.0, 0.05, 6000, 0.5 };
+    (void)sensor.set_params(acc, gyro, vibration);
+    DroneRotorSpeedType rpm[4] = { { 6000 }, { 6100 }, { 5900 }, { 6050 } };
+    DroneAccelerationBodyFrameType force;
+    force.data = { 0.1, 0.2, -9.8 };
+    DroneAngularVelocityBodyFrameType rate;
+    rate.data = { 0.1, 0.2, 0.3 };
+    for (auto _ : state) {
+        sensor.run(force, rate, rpm, 4);
+        benchmark::DoNotOptimize(sensor.acc_value());
+        benchmark::DoNotOptimize(sensor.gyro_value());
+    }
+}
+BENCHMARK(BM_SensorImu_run)->Arg(250)->Arg(1000)->Arg(4000)->Arg(8000);
+
+static void BM_SensorMag_run(benchmark::State& state)
+{
+    SensorMag sensor(BENCH_DELTA_TIME_SEC, BENCH_SAMPLE_NUM);
+    if (state.range(0)) {
+        sensor.set_noise(&bench_noise);
+    }
+    sensor.set_params(53045.1, 1.1, 0.27);
+    DroneEulerType value;
+    value.data = { 0.1, 0.2, 0.3 };
+    for (auto _ : state) {
+        sensor.run(value);
+        benchmark::DoNotOptimize(sensor.sensor_value());
+    }
+}
+BENCHMARK(BM_SensorMag_run)->Arg(0)->Arg(1);
+
+static void BM_SensorBaro_run(benchmark::State& state)
+{
+    SensorBaro sensor(BENCH_DELTA_TIME_SEC, BENCH_SAMPLE_NUM);
+    if (state.range(0)) {
+        sensor.set_noise(&bench_noise);
+    }
+    sensor.init_pos(47.641468, -122.140165, 121.321);
+    DronePositionType value;
+    value.data = { 1, 2, -3 };
+    for (auto _ : state) {
+        sensor.run(value);
+        benchmark::DoNotOptimize(sensor.sensor_value());
+    }
+}
+BENCHMARK(BM_SensorBaro_run)->Arg(0)->Arg(1);
+
+/*
+ * 気圧を大気モデルの表から求める場合
+ */
+static void BM_SensorBaro_atmosphere_run(benchmark::State& state)
+{
+    AtmosphereModel atmosphere;
+    atmosphere.init(-1000.0, 11000.0, 10.0, 0.1);
+    SensorBaro sensor(BENCH_DELTA_TIME_SEC, BENCH_SAMPLE_NUM);
+    if (state.range(0)) {
+        sensor.set_noise(&bench_noise);
+    }
+    sensor.set_atmosphere(&atmosphere);
+    sensor.init_pos(47.641468, -122.140165, 121.321);
+    DronePositionType value;
+    value.data = { 1, 2, -3 };
+    for (auto _ : state) {
+        sensor.run(value);
+        benchmark::DoNotOptimize(sensor.sensor_value());
+    }
+}
+BENCHMARK(BM_SensorBaro_atmosphere_run)->Arg(0)->Arg(1);
+
+/*
+ * state.range(1): 測位のレート [Hz]（0 は毎ステップ）。測位しないステップは時刻を進めるだけ
+ */
+static void BM_SensorGps_run(benchmark::State& state)
+{
+    SensorGps sensor(BENCH_DELTA_TIME_SEC);
+    if (state.range(0)) {
+        sensor.set_noise(&bench_noise);
+    }
+    GpsParamType param = sensor.get_params();
+    param.update_rate_hz = (double)state.range(1);
+    param.latency_sec = 0.2;
+    param.uere = 2.0;
+    param.satellites_min = 8;
+    param.satellites_max = 14;
+    (void)sensor.set_params(param);
+    sensor.init_pos(47.641468, -122.140165, 121.321);
+    DronePositionType pos;
+    pos.data = { 1, 2, -3 };
+    DroneVelocityType vel;
+    vel.data = { 0.1, 0.2, -0.3 };
+    for (auto _ : state) {
+        sensor.run(pos, vel);
+        benchmark::DoNotOptimize(sensor.sensor_value());
+    }
+}
+BENCHMARK(BM_SensorGps_run)->Args({ 0, 0 })->Args({ 1, 0 })->Args({ 0, 10 })->Args({ 1, 10 });
+
+/*
+ * sensor_value() は同じステップで MAVLink の送信とログ出力から呼ばれる。
+ * 2回目以降はキャッシュした値を返すので、その分を単独で計測する
+ */
+static void BM_SensorGps_sensor_value(benchmark::State& state)
+{
+    SensorGps sensor(BENCH_DELTA_TIME_SEC);
+    sensor.init_pos(47.641468, -122.140165, 121.321);
+    DronePositionType pos;
+    pos.data = { 1, 2, -3 };
+    DroneVelocityType vel;
+    vel.data = { 0.1, 0.2, -0.3 };
+    sensor.run(pos, vel);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sensor.sensor_value());
+    }
+}
+BENCHMARK(BM_SensorGps_sensor_value);
+
+static void BM_SensorMag_sensor_value(benchmark::State& state)
+{
+    SensorMag sensor(BENCH_DELTA_TIME_SEC, BENCH_SAMPLE_NUM);
+    sensor.set_params(53045.1, 1.1, 0.27);
+    DroneEulerType value;
+    value.data = { 0.1, 0.2, 0.3 };
+    sensor.run(value);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sensor.sensor_value());
+    }
+}
+BENCHMARK(BM_SensorMag_sensor_value);
@@ -0,0 +1,49 @@
+#include <benchmark/benchmark.h>
+#include <string.h>
+#include "mavlink/mavlink_encoder.hpp"
+#include "mavlink/mavlink_decoder.hpp"
+
+static void hil_sensor_setup(MavlinkDecodedMessage& message)
+{
+    memset(&message, 0, sizeof(message));
+    message.type = MAVLINK_MSG_TYPE_HIL_SENSOR;
+    message.data.sensor.time_usec = 123456789;
+    message.data.sensor.xacc = 0.1f;
+    message.data.sensor.yacc = 0.2f;
+    message.data.sensor.zacc = -9.8f;
+    message.data.sensor.abs_pressure = 1013.25f;
+    message.data.sensor.fields_updated = 0x1FFF;
+}
+
+static void BM_mavlink_encode_hil_sensor(benchmark::State& state)
+{
+    MavlinkDecodedMessage message;
+    hil_sensor_setup(message);
+    char packet[MAVLINK_MAX_PACKET_LEN];
+    for (auto _ : state) {
+        mavlink_message_t msg;
+        mavlink_encode_message(&msg, &message);
+        benchmark::DoNotOptimize(mavlink_get_packet(packet, sizeof(packet), &msg));
+    }
+}
+BENCHMARK(BM_mavlink_encode_hil_sensor);
+
+static void BM_mavlink_decode_hil_sensor(benchmark::State& state)
+{
+    MavlinkDecodedMessage message;
+    hil_sensor_setup(message);
+    char packet[MAVLINK_MAX_PACKET_LEN];
+    mavlink_message_t msg;
+    mavlink_encode_message(&msg, &message);
+    int packet_len = mavlink_get_packet(packet, sizeof(packet), &msg);
+    for (auto _ : state) {
+        mavlink_message_t decoded;
+        bool ret = mavlink_decode(MAVLINK_COMM_0, packet, packet_len, &decoded);
+        if (ret) {
+            MavlinkDecodedMessage decoded_message;
+            ret = mavlink_get_message(&decoded, &decoded_message);
+        }
+        benchmark::DoNotOptimize(ret);
+    }
+}
+BENCHMARK(BM_mavlink_decode_hil_sensor);
@@ -0,0 +1,40 @@
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#include "utils/csv_logger.hpp"
+#include "sensors/acc/sensor_acceleration.hpp"
+
+using hako::assets::drone::SensorAcceleration;
+using hako::assets::drone::DroneVelocityBodyFrameType;
+
+/*
+ * 1ステップ分のログ出力（state.range(0) 個のエントリ）
+ */
+static void BM_CsvLogger_run(benchmark::State& state)
+{
+    const int entry_num = (int)state.range(0);
+    std::vector<SensorAcceleration*> sensors;
+    CsvLogger logger;
+    std::filesystem::path dir = std::filesystem::temp_directory_path();
+    for (int i = 0; i < entry_num; i++) {
+        auto sensor = new SensorAcceleration(0.003, 1);
+        DroneVelocityBodyFrameType value;
+        value.data = { 1.0 + i, 2.0, 3.0 };
+        sensor->run(value);
+        sensors.push_back(sensor);
+        logger.add_entry(*sensor, (dir / ("hako_bench_log_" + std::to_string(i) + ".csv")).string());
+    }
+    CsvLogger::enable();
+    uint64_t time_usec = 0;
+    for (auto _ : state) {
+        time_usec += 3000;
+        CsvLogger::set_time_usec(time_usec);
+        logger.run();
+    }
+    CsvLogger::disable();
+    logger.close();
+    for (int i = 0; i < entry_num; i++) {
+        delete sensors[i];
+        std::filesystem::remove(dir / ("hako_bench_log_" + std::to_string(i) + ".csv"));
+    }
+}
+BENCHMARK(BM_CsvLogger_run)->Arg(1)->Arg(12);
@@ -0,0 +1,47 @@
+import struct
+import sys
+
+import numpy as np
+import pandas as pd
+
+# hako-log-convert が出力した列指向ファイルの読み込み（形式は src/utils/columnar_file.hpp を参照）
+MAGIC = b'HAKOCOL1'
+TYPES = {1: np.dtype('<i8'), 2: np.dtype('<f8')}
+
+
+def read_footer(f):
+    f.seek(-(8 + len(MAGIC)), 2)
+    footer_size, magic = struct.unpack('<Q8s', f.read(8 + len(MAGIC)))
+    if magic != MAGIC:
+        raise ValueError('not a columnar file')
+    f.seek(-(footer_size + 8 + len(MAGIC)), 2)
+    version, column_num, row_num = struct.unpack('<IIQ', f.read(16))
+    columns = []
+    for _ in range(column_num):
+        type_id, name_len = struct.unpack('<II', f.read(8))
+        name = f.read(name_len).decode('utf-8')
+        offset, null_count, vmin, vmax, mean, stddev = struct.unpack('<QQdddd', f.read(48))
+        columns.append({'name': name, 'type': type_id, 'offset': offset, 'null_count': null_count,
+                        'min': vmin, 'max': vmax, 'mean': mean, 'stddev': stddev})
+    return row_num, columns
+
+
+def read_columnar(file_path, names=None):
+    # names を指定した場合は、その列だけを読み込む
+    with open(file_path, 'rb') as f:
+        row_num, columns = read_footer(f)
+        data = {}
+        for column in columns:
+            if names is not None and column['name'] not in names and column['name'] != 'time_usec':
+                continue
+            f.seek(column['offset'])
+            data[column['name']] = np.fromfile(f, dtype=TYPES[column['type']], count=row_num)
+    return pd.DataFrame(data)
+
+
+if __name__ == '__main__':
+    if len(sys.argv) < 2:
+        print("Usage: python hako_columnar.py <columnar_file> [column_name ...]")
+        sys.exit(1)
+    df = read_columnar(sys.argv[1], sys.argv[2:] if len(sys.argv) > 2 else None)
+    print(df.describe().transpose())
@@ -3,17 +3,23 @@
 #include "assets/drone/physics/body_frame/drone_dynamics_body_frame.hpp"
 #include "assets/drone/physics/body_frame_rk4/drone_dynamics_body_frame_rk4.hpp"
 #include "assets/drone/physics/ground_frame/drone_dynamics_ground_frame.hpp"
-#include "assets/drone/physics/rotor/rotor_dynamics.hpp"
-#include "assets/drone/physics/rotor/rotor_dynamics_jmavsim.hpp"
+#include "assets/drone/physics/rotor/rotor_bank.hpp"
 #include "assets/drone/physics/thruster/thrust_dynamics_linear.hpp"
 #include "assets/drone/physics/thruster/thrust_dynamics_nonlinear.hpp"
+#include "assets/drone/physics/thruster/airframe.hpp"
+#include "assets/drone/physics/collision/collision_world.hpp"
+#include "assets/drone/physics/wind/wind_model.hpp"
+#include "assets/drone/physics/battery/battery_model.hpp"
 #include "assets/drone/sensors/acc/sensor_acceleration.hpp"
 #include "assets/drone/sensors/baro/sensor_baro.hpp"
 #include "assets/drone/sensors/gps/sensor_gps.hpp"
 #include "assets/drone/sensors/gyro/sensor_gyro.hpp"
 #include "assets/drone/sensors/mag/sensor_mag.hpp"
+#include "assets/drone/sensors/imu/sensor_imu.hpp"
 #include "assets/drone/aircraft/aricraft.hpp"
 #include "assets/drone/utils/sensor_noise.hpp"
+#include "assets/drone/utils/atmosphere_model.hpp"
+#include "assets/drone/utils/terrain_heightmap.hpp"
 #include "config/drone_config.hpp"
 #include <math.h>
 
@@ -22,13 +28,29 @@ using hako::assets::drone::DroneDynamicsBodyFrame;
 using hako::assets::drone::DroneDynamicsGroundFrame;
 using hako::assets::drone::SensorAcceleration;
 using hako::assets::drone::SensorBaro;
+using hako::assets::drone::AtmosphereModel;
 using hako::assets::drone::SensorGps;
+using hako::assets::drone::GpsParamType;
 using hako::assets::drone::SensorMag;
 using hako::assets::drone::SensorGyro;
-using hako::assets::drone::RotorDynamics;
+using hako::assets::drone::SensorImu;
+using hako::assets::drone::ImuNoiseParamType;
+using hako::assets::drone::ImuVibrationParamType;
+using hako::assets::drone::RotorBank;
+using hako::assets::drone::RotorBankModelType;
+using hako::assets::drone::RotorMotorParamType;
+using hako::assets::drone::BatteryModel;
+using hako::assets::drone::BatteryParamType;
+using hako::assets::drone::ROTOR_BANK_MODEL_FIRST_ORDER;
+using hako::assets::drone::ROTOR_BANK_MODEL_JMAVSIM;
 using hako::assets::drone::ThrustDynamicsLinear;
 using hako::assets::drone::ThrustDynamicsNonLinear;
 using hako::assets::drone::SensorNoise;
+using hako::assets::drone::CollisionWorld;
+using hako::assets::drone::WindModel;
+using hako::assets::drone::TerrainHeightmap;
+using hako::assets::drone::TerrainHeightmapParamType;
+using hako::assets::drone::GroundContactParamType;
 
 #define DELTA_TIME_SEC              drone_config.getSimTimeStep()
 #define REFERENCE_LATITUDE          drone_config.getSimLatitude()
@@ -53,7 +75,25 @@ using hako::assets::drone::SensorNoise;
 
 #define LOGPATH(name)               drone_config.getSimLogFullPath(name)
 
+/*
+ * センサごとに別の乱数列を使う（同じシードだと全センサのノイズが同じ値になる）
+ */
+#define NOISE_SEED_ACC              (noise_seed + 0)
+#define NOISE_SEED_GYRO             (noise_seed + 1)
+#define NOISE_SEED_MAG              (noise_seed + 2)
+#define NOISE_SEED_BARO             (noise_seed + 3)
+#define NOISE_SEED_GPS              (noise_seed + 4)
+#define NOISE_SEED_WIND             (noise_seed + 5)
+#define NOISE_SEED_IMU              (noise_seed + 6)
+#define NOISE_SEED_GPS_FIX          (noise_seed + 7)
+
 IAirCraft* hako::assets::drone::create_aircraft(const char* drone_type)
+{
+    auto deterministic = drone_config.getSimDeterministic();
+    return create_aircraft(drone_type, deterministic.enable ? deterministic.seed : (uint32_t)std::mt19937::default_seed);
+}
+
+IAirCraft* hako::assets::drone::create_aircraft(const char* drone_type, uint32_t noise_seed)
 {
     (void)drone_type;
 
@@ -93,28 +133,187 @@ IAirCraft* hako::assets::drone::create_aircraft(const char* drone_type)
     drone->set_drone_dynamics(drone_dynamics);
     drone->get_logger().add_entry(*drone_dynamics, LOGPATH("drone_dynamics.csv"));
 
+    //collision world
+    auto collision_config = drone_config.getCompCollisionWorld();
+    if (collision_config.enable) {
+        auto world = new CollisionWorld();
+        HAKO_ASSERT(world != nullptr);
+        world->set_body_size(body_size[0], body_size[1], body_size[2]);
+        world->set_restitution_coefficient(collision_config.restitution_coefficient);
+        for (const auto& object : collision_config.objects) {
+            HAKO_ASSERT((object.position.size() == 3) && (object.normal.size() == 3) && (object.size.size() == 3));
+            hako::drone_physics::VectorType position = { object.position[0], object.position[1], object.position[2] };
+            bool ret = false;
+            if (object.type == "plane") {
+                ret = world->add_plane(position, { object.normal[0], object.normal[1], object.normal[2] });
+            }
+            else if (object.type == "box") {
+                ret = world->add_box(position, { object.size[0], object.size[1], object.size[2] });
+            }
+            else if (object.type == "mesh") {
+                ret = world->load_obj(object.filepath, position);
+            }
+            else {
+                std::cerr << "ERROR: unknown collision object type: " << object.type << std::endl;
+            }
+            HAKO_ASSERT(ret);
+        }
+        world->build();
+        std::cout << "INFO: collision world: " << world->get_plane_num() << " planes, "
+                  << world->get_box_num() << " boxes, " << world->get_triangle_num() << " triangles, "
+                  << world->get_node_num() << " BVH nodes" << std::endl;
+        if (!drone_dynamics->has_collision_detection()) {
+            std::cout << "WARNING: collision world is not used because collision_detection is false" << std::endl;
+        }
+        drone->set_collision_world(world);
+    }
+
+    //wind
+    auto wind_config = drone_config.getCompWind();
+    if (wind_config.enable) {
+        auto wind = new WindModel(DELTA_TIME_SEC);
+        HAKO_ASSERT(wind != nullptr);
+        HAKO_ASSERT(wind_config.velocity.size() == 3);
+        DroneVelocityType velocity;
+        velocity.data = { wind_config.velocity[0], wind_config.velocity[1], wind_config.velocity[2] };
+        wind->set_constant(velocity);
+        for (const auto& gust_config : wind_config.gusts) {
+            HAKO_ASSERT(gust_config.velocity.size() == 3);
+            hako::assets::drone::WindGustType gust;
+            gust.start_sec = gust_config.start_sec;
+            gust.duration_sec = gust_config.duration_sec;
+            gust.amplitude.data = { gust_config.velocity[0], gust_config.velocity[1], gust_config.velocity[2] };
+            HAKO_ASSERT(wind->add_gust(gust));
+        }
+        auto& turbulence = wind_config.turbulence;
+        if (turbulence.enable) {
+            HAKO_ASSERT((turbulence.model == "dryden") || (turbulence.model == "von_karman"));
+            HAKO_ASSERT((turbulence.intensity.size() == 3) && (turbulence.length_scale_m.size() == 3));
+            hako::assets::drone::WindTurbulenceParamType param;
+            param.model = (turbulence.model == "dryden") ? hako::assets::drone::WIND_TURBULENCE_DRYDEN : hako::assets::drone::WIND_TURBULENCE_VON_KARMAN;
+            for (int i = 0; i < 3; i++) {
+                param.intensity[i] = turbulence.intensity[i];
+                param.length_scale[i] = turbulence.length_scale_m[i];
+            }
+            param.airspeed = turbulence.airspeed_mps;
+            if (param.airspeed <= 0) {
+                param.airspeed = std::max(1.0, hako::drone_physics::length(velocity));
+            }
+            param.samples = turbulence.samples;
+            HAKO_ASSERT(wind->init_turbulence(param, NOISE_SEED_WIND));
+            std::cout << "INFO: wind turbulence: " << turbulence.model << ", " << param.samples << " samples ("
+                      << param.samples * DELTA_TIME_SEC << " sec)" << std::endl;
+        }
+        drone->set_wind(wind);
+    }
+
+    //terrain
+    auto terrain_config = drone_config.getCompTerrain();
+    if (terrain_config.enable) {
+        auto terrain = new TerrainHeightmap();
+        HAKO_ASSERT(terrain != nullptr);
+        HAKO_ASSERT((terrain_config.format == "int16") || (terrain_config.format == "float32"));
+        HAKO_ASSERT(terrain_config.origin.size() == 2);
+        TerrainHeightmapParamType param;
+        param.format = (terrain_config.format == "int16") ? hako::assets::drone::TERRAIN_FORMAT_INT16 : hako::assets::drone::TERRAIN_FORMAT_FLOAT32;
+        param.width = terrain_config.width;
+        param.height = terrain_config.height;
+        param.cell_size = terrain_config.cell_size_m;
+        param.origin_x = terrain_config.origin[0];
+        param.origin_y = terrain_config.origin[1];
+        param.height_scale = terrain_config.height_scale;
+        param.base_altitude = terrain_config.has_base_altitude ? terrain_config.base_altitude_m : REFERENCE_ALTITUDE;
+        param.tile_size = terrain_config.tile_size;
+        param.max_tiles = terrain_config.max_tiles;
+        HAKO_ASSERT(terrain->open(terrain_config.filepath, param));
+        GroundContactParamType contact = { terrain_config.natural_frequency, terrain_config.damping_ratio, terrain_config.friction };
+        drone_dynamics->set_terrain(terrain, contact);
+        double ground_z = 0;
+        if (terrain->get_ground_z(drone_pos.data.x, drone_pos.data.y, ground_z)) {
+            std::cout << "INFO: terrain: ground z at the initial position is " << ground_z << std::endl;
+            if (drone_pos.data.z > ground_z) {
+                std::cout << "WARNING: initial position is under the terrain" << std::endl;
+            }
+        }
+        else {
+            std::cout << "WARNING: initial position is out of the terrain" << std::endl;
+        }
+    }
+
+    //airframe
+    std::vector<RotorConfigType> rotor_config;
+    auto airframe = drone_config.getCompThrusterAirframe();
+    if (!airframe.type.empty()) {
+        HAKO_ASSERT(airframe_rotor_config(airframe.type, airframe.arm_length_m, airframe.coaxial_height_m, rotor_config));
+        std::cout << "Airframe: " << airframe.type << std::endl;
+    }
+    else {
+        std::vector<RotorPosition> pos = drone_config.getCompThrusterRotorPositions();
+        rotor_config.resize(pos.size());
+        for (size_t i = 0; i < pos.size(); ++i) {
+            rotor_config[i].ccw = pos[i].rotationDirection;
+            rotor_config[i].data.x = pos[i].position[0];
+            rotor_config[i].data.y = pos[i].position[1];
+            rotor_config[i].data.z = pos[i].position[2];
+        }
+    }
+    const int rotor_num = (int)rotor_config.size();
+    HAKO_ASSERT((rotor_num > 0) && (rotor_num <= MAX_ROTOR_NUM));
+    std::cout << "Rotor num: " << rotor_num << std::endl;
+
     //rotor dynamics
-    IRotorDynamics* rotors[hako::assets::drone::ROTOR_NUM];
     auto rotor_vendor = drone_config.getCompRotorVendor();
     std::cout<< "Rotor vendor: " << rotor_vendor << std::endl;
-    for (int i = 0; i < hako::assets::drone::ROTOR_NUM; i++) {
-        IRotorDynamics *rotor = nullptr;
+    RotorBankModelType rotor_model = ROTOR_BANK_MODEL_FIRST_ORDER;
+    if (rotor_vendor == "jmavsim") {
+        rotor_model = ROTOR_BANK_MODEL_JMAVSIM;
+    }
+    auto rotors = new RotorBank(DELTA_TIME_SEC, rotor_num, rotor_model);
+    HAKO_ASSERT(rotors != nullptr);
+    rotors->set_params(RPM_MAX, ROTOR_TAU, ROTOR_K);
+    for (int i = 0; i < rotors->get_rotor_num(); i++) {
         std::string logfilename= "log_rotor_" + std::to_string(i) + ".csv";
-        if (rotor_vendor == "jmavsim") {
-            rotor = new RotorDynamicsJmavsim(DELTA_TIME_SEC);
-            HAKO_ASSERT(rotor != nullptr);
-            static_cast<RotorDynamicsJmavsim*>(rotor)->set_params(RPM_MAX, ROTOR_TAU, ROTOR_K);
-            drone->get_logger().add_entry(*static_cast<RotorDynamicsJmavsim*>(rotor), LOGPATH(logfilename));
-        }
-        else {
-            rotor = new RotorDynamics(DELTA_TIME_SEC);
-            HAKO_ASSERT(rotor != nullptr);
-            static_cast<RotorDynamics*>(rotor)->set_params(RPM_MAX, ROTOR_TAU, ROTOR_K);
-            drone->get_logger().add_entry(*static_cast<RotorDynamics*>(rotor), LOGPATH(logfilename));
+        drone->get_logger().add_entry(rotors->get_rotor_log(i), LOGPATH(logfilename));
+    }
+    drone->set_rotor_bank(rotors);
+
+    //battery
+    auto battery_config = drone_config.getCompBattery();
+    if (battery_config.enable) {
+        auto battery = new BatteryModel(DELTA_TIME_SEC);
+        HAKO_ASSERT(battery != nullptr);
+        if (!battery_config.curve_soc.empty()) {
+            HAKO_ASSERT(battery->set_discharge_curve(battery_config.curve_soc, battery_config.curve_cell_voltage));
         }
-        rotors[i] = rotor;
+        BatteryParamType param = battery->get_params();
+        param.cells = battery_config.cells;
+        param.capacity_mah = battery_config.capacity_mah;
+        param.internal_resistance = battery_config.internal_resistance_ohm;
+        param.resistance_temperature_coefficient = battery_config.resistance_temperature_coefficient;
+        param.reference_temperature = battery_config.ambient_temperature_degc;
+        param.ambient_temperature = battery_config.ambient_temperature_degc;
+        param.heat_capacity = battery_config.heat_capacity_jk;
+        param.heat_transfer = battery_config.heat_transfer_wk;
+        param.initial_remaining = battery_config.initial_remaining;
+        HAKO_ASSERT(battery->set_params(param));
+
+        // 負荷トルクの係数は、ホバリング回転数でのモータ電流から決める
+        double HoveringRpm = drone_config.getCompThrusterParameter("HoveringRpm");
+        HAKO_ASSERT(HoveringRpm != 0);
+        RotorMotorParamType motor;
+        motor.kv = battery_config.motor_kv;
+        motor.resistance = battery_config.motor_resistance_ohm;
+        motor.no_load_current = battery_config.motor_no_load_current_a;
+        motor.esc_efficiency = battery_config.esc_efficiency;
+        HAKO_ASSERT((motor.kv > 0) && (battery_config.motor_hover_current_a >= motor.no_load_current));
+        double kt = 60.0 / (2.0 * M_PI * motor.kv);
+        motor.torque_coefficient = (battery_config.motor_hover_current_a - motor.no_load_current) * kt / (HoveringRpm * HoveringRpm);
+        HAKO_ASSERT(rotors->set_motor_params(motor));
+        std::cout << "INFO: battery: " << param.cells << "S " << param.capacity_mah << " mAh, "
+                  << battery->get_reference_voltage() << " V (full)" << std::endl;
+        drone->set_battery(battery);
+        drone->get_logger().add_entry(*battery, LOGPATH("log_battery.csv"));
     }
-    drone->set_rotor_dynamics(rotors);
 
     //thrust dynamics
     IThrustDynamics *thrust = nullptr;
@@ -126,7 +325,7 @@ IAirCraft* hako::assets::drone::create_aircraft(const char* drone_type)
         double HoveringRpm = drone_config.getCompThrusterParameter("HoveringRpm");
         HAKO_ASSERT(HoveringRpm != 0);
         double mass = drone_dynamics->get_mass();
-        double param_A = (mass * GRAVITY / (HoveringRpm * ROTOR_NUM));
+        double param_A = (mass * GRAVITY / (HoveringRpm * rotor_num));
         double param_B = drone_config.getCompThrusterParameter("parameterB_linear");
         static_cast<ThrustDynamicsLinear*>(thrust)->set_params(
             param_A,
@@ -145,7 +344,7 @@ IAirCraft* hako::assets::drone::create_aircraft(const char* drone_type)
         double param_A = ( 
                             mass * GRAVITY / 
                             (
-                                pow(HoveringRpm, 2) * ROTOR_NUM
+                                pow(HoveringRpm, 2) * rotor_num
                             )
                         );
         std::cout << "param_A: " << param_A << std::endl;
@@ -156,80 +355,118 @@ IAirCraft* hako::assets::drone::create_aircraft(const char* drone_type)
     }
     drone->set_thrus_dynamics(thrust);
 
-    RotorConfigType rotor_config[ROTOR_NUM];
-    std::vector<RotorPosition> pos = drone_config.getCompThrusterRotorPositions();
-    HAKO_ASSERT(pos.size() == ROTOR_NUM);
-    for (size_t i = 0; i < pos.size(); ++i) {
-        rotor_config[i].ccw = pos[i].rotationDirection;
-        rotor_config[i].data.x = pos[i].position[0];
-        rotor_config[i].data.y = pos[i].position[1];
-        rotor_config[i].data.z = pos[i].position[2];
-    }    
-
-    thrust->set_rotor_config(rotor_config);
+    thrust->set_rotor_config(rotor_config.data(), rotor_num);
 
     //sensor acc
     auto acc = new SensorAcceleration(DELTA_TIME_SEC, ACC_SAMPLE_NUM);
     HAKO_ASSERT(acc != nullptr);
     double variance = drone_config.getCompSensorNoise("acc");
     if (variance > 0) {
-        auto noise = new SensorNoise(variance);
+        auto noise = new SensorNoise(variance, NOISE_SEED_ACC);
         HAKO_ASSERT(noise != nullptr);
         acc->set_noise(noise);
     }
     drone->set_acc(acc);
-    drone->get_logger().add_entry(*acc, LOGPATH("log_acc.csv"));
+    if (drone_config.isSimSensorLogEnabled("acc")) {
+        drone->get_logger().add_entry(*acc, LOGPATH("log_acc.csv"));
+    }
 
     //sensor gyro
     auto gyro = new SensorGyro(DELTA_TIME_SEC, ACC_SAMPLE_NUM);
     HAKO_ASSERT(gyro != nullptr);
     variance = drone_config.getCompSensorNoise("gyro");
     if (variance > 0) {
-        auto noise = new SensorNoise(variance);
+        auto noise = new SensorNoise(variance, NOISE_SEED_GYRO);
         HAKO_ASSERT(noise != nullptr);
         gyro->set_noise(noise);
     }
     drone->set_gyro(gyro);
-    drone->get_logger().add_entry(*gyro, LOGPATH("log_gyro.csv"));
+    if (drone_config.isSimSensorLogEnabled("gyro")) {
+        drone->get_logger().add_entry(*gyro, LOGPATH("log_gyro.csv"));
+    }
+
+    //sensor imu（設定があれば HIL_SENSOR の加速度と角速度は acc/gyro の代わりにこちらを使う）
+    auto imu_config = drone_config.getCompImu();
+    if (imu_config.enable) {
+        HAKO_ASSERT(imu_config.rate_hz > 0);
+        auto imu = new SensorImu(DELTA_TIME_SEC, imu_config.rate_hz, NOISE_SEED_IMU);
+        HAKO_ASSERT(imu != nullptr);
+        ImuNoiseParamType acc_param = { imu_config.acc.noise_density, imu_config.acc.bias_instability,
+                                        imu_config.acc.bias_correlation_sec, imu_config.acc.random_walk };
+        ImuNoiseParamType gyro_param = { imu_config.gyro.noise_density, imu_config.gyro.bias_instability,
+                                         imu_config.gyro.bias_correlation_sec, imu_config.gyro.random_walk };
+        ImuVibrationParamType vibration = { imu_config.vibration_acc_amplitude, imu_config.vibration_gyro_amplitude,
+                                            (imu_config.vibration_reference_rpm > 0) ? imu_config.vibration_reference_rpm
+                                                : drone_config.getCompThrusterParameter("HoveringRpm"),
+                                            imu_config.vibration_axial_ratio };
+        HAKO_ASSERT(imu->set_params(acc_param, gyro_param, vibration));
+        std::cout << "INFO: imu: " << imu->get_rate_hz() << " Hz" << std::endl;
+        drone->set_imu(imu);
+        if (drone_config.isSimSensorLogEnabled("imu")) {
+            drone->get_logger().add_entry(*imu, LOGPATH("log_imu.csv"));
+        }
+    }
 
     //sensor mag
     auto mag = new SensorMag(DELTA_TIME_SEC, ACC_SAMPLE_NUM);
     HAKO_ASSERT(mag != nullptr);
     variance = drone_config.getCompSensorNoise("mag");
     if (variance > 0) {
-        auto noise = new SensorNoise(variance);
+        auto noise = new SensorNoise(variance, NOISE_SEED_MAG);
         HAKO_ASSERT(noise != nullptr);
         mag->set_noise(noise);
     }
     mag->set_params(PARAMS_MAG_F, PARAMS_MAG_I, PARAMS_MAG_D);
     drone->set_mag(mag);
-    drone->get_logger().add_entry(*mag, LOGPATH("log_mag.csv"));
+    if (drone_config.isSimSensorLogEnabled("mag")) {
+        drone->get_logger().add_entry(*mag, LOGPATH("log_mag.csv"));
+    }
+
+    //atmosphere
+    auto atmosphere_config = drone_config.getCompAtmosphere();
+    auto atmosphere = new AtmosphereModel();
+    HAKO_ASSERT(atmosphere != nullptr);
+    if (atmosphere->init(atmosphere_config.altitude_min_m, atmosphere_config.altitude_max_m,
+                         atmosphere_config.resolution_m, atmosphere_config.max_error_pa)) {
+        std::cout << "INFO: atmosphere table: " << atmosphere->get_table_size() << " points, "
+                  << atmosphere->get_resolution() << " m, max error " << atmosphere->get_max_error_pa() << " Pa" << std::endl;
+    }
 
     //sensor baro
     auto baro = new SensorBaro(DELTA_TIME_SEC, ACC_SAMPLE_NUM);
     HAKO_ASSERT(baro != nullptr);
+    baro->set_atmosphere(atmosphere);
     baro->init_pos(REFERENCE_LATITUDE, REFERENCE_LONGTITUDE, REFERENCE_ALTITUDE);
     variance = drone_config.getCompSensorNoise("baro");
     if (variance > 0) {
-        auto noise = new SensorNoise(variance);
+        auto noise = new SensorNoise(variance, NOISE_SEED_BARO);
         HAKO_ASSERT(noise != nullptr);
         baro->set_noise(noise);
     }
     drone->set_baro(baro);
-    drone->get_logger().add_entry(*baro, LOGPATH("log_baro.csv"));
+    if (drone_config.isSimSensorLogEnabled("baro")) {
+        drone->get_logger().add_entry(*baro, LOGPATH("log_baro.csv"));
+    }
 
     //sensor gps
-    auto gps = new SensorGps(DELTA_TIME_SEC, ACC_SAMPLE_NUM);
+    auto gps = new SensorGps(DELTA_TIME_SEC, NOISE_SEED_GPS_FIX);
     HAKO_ASSERT(gps != nullptr);
+    auto gps_config = drone_config.getCompGps();
+    GpsParamType gps_param = { gps_config.update_rate_hz, gps_config.latency_sec, gps_config.uere_m,
+                               gps_config.error_correlation_sec, gps_config.hdop, gps_config.vdop,
+                               gps_config.satellites_min, gps_config.satellites_max, gps_config.satellite_change_sec };
+    HAKO_ASSERT(gps->set_params(gps_param));
     variance = drone_config.getCompSensorNoise("gps");
     if (variance > 0) {
-        auto noise = new SensorNoise(variance);
+        auto noise = new SensorNoise(variance, NOISE_SEED_GPS);
         HAKO_ASSERT(noise != nullptr);
         gps->set_noise(noise);
     }
     gps->init_pos(REFERENCE_LATITUDE, REFERENCE_LONGTITUDE, REFERENCE_ALTITUDE);
     drone->set_gps(gps);
-    drone->get_logger().add_entry(*gps, LOGPATH("log_gps.csv"));
+    if (drone_config.isSimSensorLogEnabled("gps")) {
+        drone->get_logger().add_entry(*gps, LOGPATH("log_gps.csv"));
+    }
 
     return drone;
 }
\ No newline at end of file
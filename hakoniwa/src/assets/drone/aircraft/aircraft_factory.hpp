@@ -8,12 +8,17 @@
 #include "isensor_gps.hpp"
 #include "isensor_gyro.hpp"
 #include "isensor_mag.hpp"
-#include "irotor_dynamics.hpp"
+#include "irotor_bank.hpp"
 #include "ithrust_dynamics.hpp"
+#include <cstdint>
 
 namespace hako::assets::drone {
 
 extern IAirCraft* create_aircraft(const char* drone_type);
+/*
+ * noise_seed: センサノイズの乱数のシード（センサごとに noise_seed + 0..4 を使う）
+ */
+extern IAirCraft* create_aircraft(const char* drone_type, uint32_t noise_seed);
 
 }
 
@@ -24,7 +29,7 @@ using hako::assets::drone::ISensorBaro;
 using hako::assets::drone::ISensorGps;
 using hako::assets::drone::ISensorMag;
 using hako::assets::drone::ISensorGyro;
-using hako::assets::drone::IRotorDynamics;
+using hako::assets::drone::IRotorBank;
 using hako::assets::drone::IThrustDynamics;
 
 
@@ -3,6 +3,7 @@
 
 #include "iaircraft.hpp"
 #include "utils/csv_logger.hpp"
+#include "utils/hako_profile.hpp"
 
 namespace hako::assets::drone {
 
@@ -16,29 +17,61 @@ public:
     }
     void run(DroneDynamicsInputType& input) override
     {
+        HAKO_PROFILE_SCOPE("AirCraft::run");
         //actuators
         if (input.no_use_actuator == false) {
-            DroneRotorSpeedType rotor_speed[ROTOR_NUM];
-            for (int i = 0; i < ROTOR_NUM; i++) {
-                rotor_dynamics[i]->run(input.controls[i]);
-                rotor_speed[i] = rotor_dynamics[i]->get_rotor_speed();
+            HAKO_PROFILE_SCOPE("AirCraft::run/actuators");
+            if (battery != nullptr) {
+                // 前のステップの端子電圧で回す
+                rotor_bank->set_supply_voltage_ratio(battery->get_status().voltage / battery->get_reference_voltage());
             }
-            thrust_dynamis->run(rotor_speed);
+            rotor_bank->run(input.controls);
+            thrust_dynamis->run(rotor_bank->get_rotor_speeds());
             input.thrust = thrust_dynamis->get_thrust();
             input.torque = thrust_dynamis->get_torque();
         }
-        drone_dynamics->run(input);
-        if (input.manual.control) {
-            drone_dynamics->set_angle(input.manual.angle);
+        //battery
+        if (battery != nullptr) {
+            battery->run(input.no_use_actuator ? 0.0 : rotor_bank->get_load_power());
+        }
+        //collision（箱庭の PDU で衝突を受け取った場合はそちらを使う）
+        bool world_collision = false;
+        if ((collision_world != nullptr) && !input.collision.collision && drone_dynamics->has_collision_detection()) {
+            HAKO_PROFILE_SCOPE("AirCraft::run/collision");
+            world_collision = collision_world->detect(drone_dynamics->get_pos(), drone_dynamics->get_angle(),
+                                                      drone_dynamics->get_vel(), input.collision);
+        }
+        //wind
+        if (wind != nullptr) {
+            drone_dynamics->set_wind(wind->run());
+        }
+        {
+            HAKO_PROFILE_SCOPE("AirCraft::run/drone_dynamics");
+            drone_dynamics->run(input);
+            if (input.manual.control) {
+                drone_dynamics->set_angle(input.manual.angle);
+            }
+        }
+        if (world_collision) {
+            // 次のステップの入力に残さない
+            input.collision.collision = false;
         }
 
         //sensors
-        acc->run(drone_dynamics->get_vel_body_frame());
-        gyro->run(drone_dynamics->get_angular_vel_body_frame());
-        gps->run(drone_dynamics->get_pos(), drone_dynamics->get_vel());
-        mag->run(drone_dynamics->get_angle());
-        baro->run(drone_dynamics->get_pos());
+        {
+            HAKO_PROFILE_SCOPE("AirCraft::run/sensors");
+            acc->run(drone_dynamics->get_vel_body_frame());
+            gyro->run(drone_dynamics->get_angular_vel_body_frame());
+            gps->run(drone_dynamics->get_pos(), drone_dynamics->get_vel());
+            mag->run(drone_dynamics->get_angle());
+            baro->run(drone_dynamics->get_pos());
+            if (imu != nullptr) {
+                imu->run(drone_dynamics->get_specific_force(), drone_dynamics->get_angular_vel_body_frame(),
+                         rotor_bank->get_rotor_speeds(), rotor_bank->get_rotor_num());
+            }
+        }
 
+        HAKO_PROFILE_SCOPE("AirCraft::run/logger");
         logger.run();
     }
     CsvLogger& get_logger()
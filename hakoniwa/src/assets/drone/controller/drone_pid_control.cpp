@@ -23,6 +23,8 @@ static double pid_control_delta_time;
 
 static double hovering_thrust;
 static double hovering_thrust_range;
+static double current_time = 0;
+static double last_time = 0;
 
 void drone_pid_control_init() 
 {
@@ -100,8 +102,6 @@ static double get_limit_value(double input_value, double base_value, double min_
 }
 void drone_pid_control_run() 
 {
-    static double current_time = 0;
-    static double last_time = 0;
     DronePositionType dpos;
     DroneEulerType dangle;
 
@@ -157,3 +157,22 @@ void drone_pid_control_run()
 
 
 }
+
+void drone_pid_control_save_state(StateSnapshot& snapshot)
+{
+    pid_height->save_state(snapshot);
+    pid_phi->save_state(snapshot);
+    pid_theta->save_state(snapshot);
+    pid_psi->save_state(snapshot);
+    snapshot.put(current_time);
+    snapshot.put(last_time);
+}
+bool drone_pid_control_restore_state(StateSnapshot& snapshot)
+{
+    return pid_height->restore_state(snapshot)
+        && pid_phi->restore_state(snapshot)
+        && pid_theta->restore_state(snapshot)
+        && pid_psi->restore_state(snapshot)
+        && snapshot.get(current_time)
+        && snapshot.get(last_time);
+}
@@ -42,9 +42,19 @@ public:
     void set_setpoint(double setpoint) {
         pid_control.set_setpoint(setpoint);
     }
+
+    // PIDコントローラの状態を保存・復元するメソッド
+    void save_state(StateSnapshot& snapshot) const {
+        pid_control.save_state(snapshot);
+    }
+    bool restore_state(StateSnapshot& snapshot) {
+        return pid_control.restore_state(snapshot);
+    }
 };
 
 extern void drone_pid_control_init();
 extern void drone_pid_control_run();
+extern void drone_pid_control_save_state(StateSnapshot& snapshot);
+extern bool drone_pid_control_restore_state(StateSnapshot& snapshot);
 
 #endif /* _DRONE_PID_CONTROL_HPP_ */
\ No newline at end of file
@@ -303,11 +303,11 @@ typedef struct {
  * Conversion Macros for GPS DOP Data to MAVLink Format
  *
  * - DOP_TO_UINT16: Converts DOP value in double to MAVLink's uint16_t format.
- *   The DOP value is multiplied by 1 and cast to uint16_t.
+ *   The DOP value is multiplied by 100 (MAVLink sends DOP as unitless * 100) and cast to uint16_t.
  *   If the DOP value is unknown, UINT16_MAX is used.
  */
 
-#define DOP_TO_UINT16(dop) ((dop) >= 0 ? static_cast<uint16_t>((dop) * 1) : UINT16_MAX)
+#define DOP_TO_UINT16(dop) ((dop) >= 0 ? static_cast<uint16_t>((dop) * 100) : UINT16_MAX)
 
 // Example usage:
 // uint16_t mavlink_eph = DOP_TO_UINT16(drone_gps_data.eph);
@@ -378,6 +378,31 @@ typedef struct {
  */
 #define NT_TO_G(nT) ((nT) * 1e-5)
 
+/*
+ * Description: Represents the state of the drone's battery pack.
+ *
+ * Fields:
+ *   - voltage: Terminal voltage of the pack in volts (V), including the sag by the internal resistance.
+ *   - current: Current drawn from the pack in amperes (A).
+ *   - remaining: State of charge (0.0 to 1.0).
+ *   - consumed_mah: Charge consumed since the start in milliampere-hours (mAh).
+ *   - consumed_energy: Energy consumed since the start in joules (J).
+ *   - temperature: Pack temperature in degrees Celsius.
+ *   - time_remaining: Estimated time until empty at the average current in seconds (-1 if unknown).
+ *
+ * For the MAVLink representation, refer to the BATTERY_STATUS message specifications:
+ * https://mavlink.io/en/messages/common.html#BATTERY_STATUS
+ */
+typedef struct {
+    double voltage;             // Terminal voltage in V
+    double current;             // Current in A
+    double remaining;           // State of charge (0.0 - 1.0)
+    double consumed_mah;        // Consumed charge in mAh
+    double consumed_energy;     // Consumed energy in J
+    double temperature;         // Temperature in degC
+    double time_remaining;      // Remaining time in sec (-1 if unknown)
+} DroneBatteryStatusType;
+
 typedef struct {
     double cos_phi;
     double cos_theta;
@@ -1,21 +1,27 @@
 #ifndef _IAIRCRAFT_HPP_
 #define _IAIRCRAFT_HPP_
 
+#include "ibattery.hpp"
+#include "icollision_world.hpp"
 #include "idrone_dynamics.hpp"
-#include "irotor_dynamics.hpp"
+#include "irotor_bank.hpp"
 #include "ithrust_dynamics.hpp"
 #include "isensor_acceleration.hpp"
 #include "isensor_baro.hpp"
 #include "isensor_gps.hpp"
 #include "isensor_gyro.hpp"
+#include "isensor_imu.hpp"
 #include "isensor_mag.hpp"
+#include "iwind.hpp"
+#include "utils/state_snapshot.hpp"
+#include <iostream>
 
 namespace hako::assets::drone {
 
-class IAirCraft {
+class IAirCraft : public IStateSnapshot {
 protected:
     IDroneDynamics *drone_dynamics;
-    IRotorDynamics *rotor_dynamics[ROTOR_NUM];
+    IRotorBank *rotor_bank;
     IThrustDynamics *thrust_dynamis;
 
     ISensorAcceleration *acc;
@@ -23,6 +29,11 @@ protected:
     ISensorGps *gps;
     ISensorGyro *gyro;
     ISensorMag *mag;
+
+    ICollisionWorld *collision_world = nullptr;
+    IWind *wind = nullptr;
+    IBattery *battery = nullptr;
+    ISensorImu *imu = nullptr;
 public:
     virtual ~IAirCraft() {}
     virtual void run(DroneDynamicsInputType& input) = 0;
@@ -35,11 +46,13 @@ public:
     {
         return *drone_dynamics;
     }
-    void set_rotor_dynamics(IRotorDynamics *src[ROTOR_NUM])
+    void set_rotor_bank(IRotorBank *src)
     {
-        for (int i = 0; i < ROTOR_NUM; i++) {
-            this->rotor_dynamics[i] = src[i];
-        }
+        this->rotor_bank = src;
+    }
+    IRotorBank& get_rotor_bank()
+    {
+        return *rotor_bank;
     }
     void set_thrus_dynamics(IThrustDynamics *src)
     {
@@ -86,6 +99,115 @@ public:
     {
         return *mag;
     }
+    /*
+     * シミュレータ内の衝突判定（省略可）
+     */
+    void set_collision_world(ICollisionWorld *src)
+    {
+        this->collision_world = src;
+    }
+    ICollisionWorld* get_collision_world()
+    {
+        return collision_world;
+    }
+    /*
+     * 風（省略可）
+     */
+    void set_wind(IWind *src)
+    {
+        this->wind = src;
+    }
+    IWind* get_wind()
+    {
+        return wind;
+    }
+    /*
+     * バッテリ（省略可）
+     */
+    void set_battery(IBattery *src)
+    {
+        this->battery = src;
+    }
+    IBattery* get_battery()
+    {
+        return battery;
+    }
+    /*
+     * IMU（省略可）。設定すると、HIL_SENSOR の加速度と角速度は acc/gyro の代わりにこちらを使う
+     */
+    void set_imu(ISensorImu *src)
+    {
+        this->imu = src;
+    }
+    ISensorImu* get_imu()
+    {
+        return imu;
+    }
+
+    /*
+     * 機体の全コンポーネント（物理モデル・ロータ・推力・センサ・ノイズの乱数・風・バッテリ・IMU）の状態を保存する。
+     * ログファイルは閉じないので、復元後も同じファイルに続けて出力する。
+     */
+    void save_state(StateSnapshot& snapshot) const override
+    {
+        drone_dynamics->save_state(snapshot);
+        rotor_bank->save_state(snapshot);
+        thrust_dynamis->save_state(snapshot);
+        acc->save_state(snapshot);
+        baro->save_state(snapshot);
+        gps->save_state(snapshot);
+        gyro->save_state(snapshot);
+        mag->save_state(snapshot);
+        if (wind != nullptr) {
+            wind->save_state(snapshot);
+        }
+        if (battery != nullptr) {
+            battery->save_state(snapshot);
+        }
+        if (imu != nullptr) {
+            imu->save_state(snapshot);
+        }
+    }
+    bool restore_state(StateSnapshot& snapshot) override
+    {
+        if (!drone_dynamics->restore_state(snapshot)) {
+            return false;
+        }
+        return rotor_bank->restore_state(snapshot)
+            && thrust_dynamis->restore_state(snapshot)
+            && acc->restore_state(snapshot)
+            && baro->restore_state(snapshot)
+            && gps->restore_state(snapshot)
+            && gyro->restore_state(snapshot)
+            && mag->restore_state(snapshot)
+            && ((wind == nullptr) || wind->restore_state(snapshot))
+            && ((battery == nullptr) || battery->restore_state(snapshot))
+            && ((imu == nullptr) || imu->restore_state(snapshot));
+    }
+    /*
+     * snapshot を機体の状態だけのスナップショットにする
+     */
+    void take_snapshot(StateSnapshot& snapshot) const
+    {
+        snapshot.clear();
+        save_state(snapshot);
+    }
+    /*
+     * take_snapshot() で保存した状態に戻す。
+     * 機体の設定が異なるなどで復元できない場合は、元の状態のままで false を返す。
+     */
+    bool restore_snapshot(StateSnapshot& snapshot)
+    {
+        StateSnapshot backup;
+        save_state(backup);
+        snapshot.rewind();
+        if (restore_state(snapshot) && snapshot.is_consumed()) {
+            return true;
+        }
+        std::cerr << "ERROR: snapshot does not match the aircraft configuration" << std::endl;
+        (void)restore_state(backup);
+        return false;
+    }
 
 };
 }
@@ -0,0 +1,24 @@
+#ifndef _IATMOSPHERE_HPP_
+#define _IATMOSPHERE_HPP_
+
+namespace hako::assets::drone {
+
+typedef struct {
+    double pressure;        // [Pa]
+    double temperature;     // [K]
+    double density;         // [kg/m^3]
+} AtmosphereType;
+
+/*
+ * 高度（ジオポテンシャル高度 [m]）から大気の状態を求める
+ */
+class IAtmosphere {
+public:
+    virtual ~IAtmosphere() {}
+    virtual AtmosphereType get_atmosphere(double alt) const = 0;
+    virtual double get_pressure(double alt) const = 0;
+};
+
+}
+
+#endif /* _IATMOSPHERE_HPP_ */
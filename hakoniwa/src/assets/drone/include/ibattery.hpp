@@ -0,0 +1,29 @@
+#ifndef _IBATTERY_HPP_
+#define _IBATTERY_HPP_
+
+#include "drone_primitive_types.hpp"
+#include "utils/state_snapshot.hpp"
+
+namespace hako::assets::drone {
+
+/*
+ * バッテリ（放電曲線・内部抵抗・温度）
+ */
+class IBattery : public IStateSnapshot {
+public:
+    virtual ~IBattery() {}
+    /*
+     * 満充電・無負荷の電圧。ロータの Kr はこの電圧での値とみなす
+     */
+    virtual double get_reference_voltage() const = 0;
+    /*
+     * 負荷（ESC とモータ）が消費する電力 [W] で1ステップ進める
+     */
+    virtual void run(double load_power) = 0;
+
+    virtual const DroneBatteryStatusType& get_status() const = 0;
+};
+
+}
+
+#endif /* _IBATTERY_HPP_ */
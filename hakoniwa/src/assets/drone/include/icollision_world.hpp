@@ -0,0 +1,25 @@
+#ifndef _ICOLLISION_WORLD_HPP_
+#define _ICOLLISION_WORLD_HPP_
+
+#include "drone_primitive_types.hpp"
+#include "idrone_dynamics.hpp"
+
+namespace hako::assets::drone {
+
+/*
+ * シミュレータ内の静的な物体（地形・建物など）との衝突判定
+ */
+class ICollisionWorld {
+public:
+    virtual ~ICollisionWorld() {}
+    /*
+     * 中心 pos、姿勢 angle の機体（body_size の直方体）と物体の接触を調べる。
+     * 機体が近づいている接触があれば、近い順に collision に設定して true を返す。
+     */
+    virtual bool detect(const DronePositionType& pos, const DroneEulerType& angle, const DroneVelocityType& vel,
+                        DroneDynamicsCollisionType& collision) const = 0;
+};
+
+}
+
+#endif /* _ICOLLISION_WORLD_HPP_ */
@@ -2,7 +2,9 @@
 #define _IDRONE_DYNAMICS_HPP_
 
 #include "drone_primitive_types.hpp"
+#include "iterrain.hpp"
 #include "utils/icsv_log.hpp"
+#include "utils/state_snapshot.hpp"
 
 namespace hako::assets::drone {
 
@@ -33,13 +35,103 @@ typedef struct {
     DroneTorqueType torque;
 } DroneDynamicsInputType;
 
+/*
+ * 地形との接触（ばね・ダンパ）のパラメータ。質量によらないように、固有角振動数と減衰比で指定する。
+ */
+typedef struct {
+    double natural_frequency;   // [rad/s]
+    double damping_ratio;
+    double friction;            // 接地中の水平速度の減衰 [1/s]
+} GroundContactParamType;
+
 
-class IDroneDynamics: public ICsvLog {
+class IDroneDynamics: public ICsvLog, public IStateSnapshot {
 protected:
     DronePhysCalcCacheType cache;
+    ITerrain *terrain = nullptr;
+    GroundContactParamType ground_contact = { 30.0, 1.0, 5.0 };
+    DroneVelocityType wind = drone_physics::VectorType{ 0, 0, 0 };
+    DroneAccelerationBodyFrameType specific_force = drone_physics::VectorType{ 0, 0, -GRAVITY };
+
+    /*
+     * run() の最後に呼び出す。このステップの地上座標系の速度の変化（地面や壁との接触による変化を含む）から
+     * 重力の分を除き、ステップ終了時の姿勢で機体座標系に変換して比力とする。
+     */
+    void update_specific_force(const DroneVelocityType& prev_velocity, const DroneVelocityType& velocity,
+                               const DroneEulerType& angle, double dt)
+    {
+        drone_physics::VectorType acc = {
+            (velocity.data.x - prev_velocity.data.x) / dt,
+            (velocity.data.y - prev_velocity.data.y) / dt,
+            (velocity.data.z - prev_velocity.data.z) / dt - GRAVITY
+        };
+        this->specific_force = drone_physics::body_vector_from_ground(acc, angle);
+    }
+
+    /*
+     * 地形にめり込んでいれば、押し戻す加速度で velocity（地上座標系）を更新して true を返す。
+     * position は積分済みなので、更新した速度で積分したのと同じになるように位置も補正する。
+     * 地形の範囲外は z = 0 を地面とする。
+     */
+    bool run_ground_contact(DronePositionType& pos, DroneVelocityType& vel, double dt) const
+    {
+        double ground_z = 0;
+        if (!terrain->get_ground_z(pos.data.x, pos.data.y, ground_z)) {
+            ground_z = 0;
+        }
+        double penetration = pos.data.z - ground_z;
+        if (penetration <= 0) {
+            return false;
+        }
+        double w = ground_contact.natural_frequency;
+        double acc = -((w * w * penetration) + (2.0 * ground_contact.damping_ratio * w * vel.data.z));
+        if (acc > 0) {
+            // 地面は引っ張らない
+            acc = 0;
+        }
+        double k = 1.0 - (ground_contact.friction * dt);
+        k = (k < 0) ? 0 : k;
+        DroneVelocityType dv;
+        dv.data = { (k - 1.0) * vel.data.x, (k - 1.0) * vel.data.y, acc * dt };
+        vel.data = { vel.data.x + dv.data.x, vel.data.y + dv.data.y, vel.data.z + dv.data.z };
+        pos.data = { pos.data.x + dv.data.x * dt, pos.data.y + dv.data.y * dt, pos.data.z + dv.data.z * dt };
+        return true;
+    }
 public:
     virtual ~IDroneDynamics() {}
 
+    /*
+     * 地形を設定すると、z > 0 で止める代わりに地形とのばね・ダンパの接触で支える
+     */
+    void set_terrain(ITerrain *terrain, const GroundContactParamType& param)
+    {
+        this->terrain = terrain;
+        this->ground_contact = param;
+    }
+    ITerrain *get_terrain() const
+    {
+        return terrain;
+    }
+    /*
+     * 風速（地上座標系）。空気抵抗は対気速度（速度 - 風速）に対してかかる
+     */
+    void set_wind(const DroneVelocityType& wind)
+    {
+        this->wind = wind;
+    }
+    DroneVelocityType get_wind() const
+    {
+        return wind;
+    }
+    /*
+     * 直前の run() での比力（加速度計が測る、重力以外の力による加速度。機体座標系）。
+     * 静止していれば (0, 0, -GRAVITY) になる。
+     */
+    DroneAccelerationBodyFrameType get_specific_force() const
+    {
+        return specific_force;
+    }
+
     virtual void set_drag(double drag1, double drag2) = 0;
     virtual void set_collision_detection(bool enable) = 0;
     virtual void set_manual_control(bool enable) = 0;
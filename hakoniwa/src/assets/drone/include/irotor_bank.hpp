@@ -0,0 +1,38 @@
+#ifndef _IROTOR_BANK_HPP_
+#define _IROTOR_BANK_HPP_
+
+#include "drone_primitive_types.hpp"
+#include "utils/state_snapshot.hpp"
+
+namespace hako::assets::drone {
+
+/*
+ * 機体の全ロータをまとめて計算する。
+ * ロータの状態は連続した配列で持ち、1回の run() で全ロータを1ステップ進める。
+ */
+class IRotorBank : public IStateSnapshot {
+public:
+    virtual ~IRotorBank() {}
+
+    virtual int get_rotor_num() const = 0;
+
+    virtual void set_rotor_speed(int index, const DroneRotorSpeedType &rotor_speed) = 0;
+
+    // 全ロータの回転数（get_rotor_num() 個の配列）
+    virtual const DroneRotorSpeedType* get_rotor_speeds() const = 0;
+
+    // controls: 全ロータの制御入力（get_rotor_num() 個の配列）
+    virtual void run(const double *controls) = 0;
+
+    /*
+     * 電源電圧の基準電圧に対する比。ESC の出力は電源電圧に比例するので、目標回転数にかける（既定値 1）
+     */
+    virtual void set_supply_voltage_ratio(double ratio) = 0;
+
+    // 直前の run() でモータ（ESC を含む）が電源から消費した電力 [W]（モータのパラメータがなければ 0）
+    virtual double get_load_power() const = 0;
+};
+
+}
+
+#endif /* _IROTOR_BANK_HPP_ */
@@ -2,11 +2,12 @@
 #define _IROTOR_DYNAMICS_HPP_
 
 #include "drone_primitive_types.hpp"
+#include "utils/state_snapshot.hpp"
 
 namespace hako::assets::drone {
 
 
-class IRotorDynamics {
+class IRotorDynamics : public IStateSnapshot {
 public:
     virtual ~IRotorDynamics() {}
 
@@ -5,21 +5,67 @@
 
 #include "isensor_noise.hpp"
 #include "isensor_data_assembler.hpp"
+#include "utils/state_snapshot.hpp"
+#include <cstdint>
 
 namespace hako::assets::drone {
 
-class ISensor {
+class ISensor : public IStateSnapshot {
 protected:
     ISensorNoise *noise;
+    /*
+     * sensor_value() のキャッシュ。
+     * run() のたびに next_step() で step_stamp を進め、sensor_value() はステップごとに
+     * 最初の呼び出しでだけ値を計算（ノイズの付加を含む）してキャッシュする。
+     * 同じステップの MAVLink の送信とログ出力は同じ値を使う。
+     */
+    uint64_t step_stamp;
+    bool sample_valid;
+    void next_step()
+    {
+        this->step_stamp++;
+        this->sample_valid = false;
+    }
+    /*
+     * 全センサ共通の状態（キャッシュとノイズの乱数の状態）の保存と復元。
+     * 各センサの save_state()/restore_state() の先頭で呼び出す。
+     */
+    void save_sensor_state(StateSnapshot& snapshot) const
+    {
+        snapshot.put(this->step_stamp);
+        snapshot.put(this->sample_valid);
+        snapshot.put(this->noise != nullptr);
+        if (this->noise != nullptr) {
+            this->noise->save_state(snapshot);
+        }
+    }
+    bool restore_sensor_state(StateSnapshot& snapshot)
+    {
+        bool has_noise = false;
+        if (!snapshot.get(this->step_stamp) || !snapshot.get(this->sample_valid) || !snapshot.get(has_noise)) {
+            return false;
+        }
+        // ノイズの有無が異なる設定で保存したスナップショットは復元できない
+        if (has_noise != (this->noise != nullptr)) {
+            return false;
+        }
+        return (this->noise == nullptr) || this->noise->restore_state(snapshot);
+    }
 public:
+    ISensor() : noise(nullptr), step_stamp(0), sample_valid(false) {}
     virtual ~ISensor() {}
     virtual void set_noise(ISensorNoise *n)
     {
         this->noise = n;
+        this->sample_valid = false;
+    }
+    uint64_t get_step_stamp() const
+    {
+        return this->step_stamp;
     }
     virtual void print() = 0;
 };
 
 }
 
-#endif /* _ISENSOR_HPP_ */
\ No newline at end of file
+#endif /* _ISENSOR_HPP_ */
@@ -1,9 +1,11 @@
 #ifndef _ISENSOR_DATA_ASSEMBLER_HPP_
 #define _ISENSOR_DATA_ASSEMBLER_HPP_
 
+#include "utils/state_snapshot.hpp"
+
 namespace hako::assets::drone {
 
-class ISensorDataAssembler {
+class ISensorDataAssembler : public IStateSnapshot {
 protected:
     int sample_num = 0;
 public:
@@ -19,6 +19,10 @@ public:
         this->ref_alt = alt_data;
     }
     virtual void run(const DronePositionType& p, const DroneVelocityType& v) = 0;
+    /*
+     * 直前の run() で新しい測位を出力した場合は true
+     */
+    virtual bool has_new_fix() const = 0;
     virtual DroneGpsDataType sensor_value() = 0;
 };
 
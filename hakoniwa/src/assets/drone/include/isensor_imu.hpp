@@ -0,0 +1,29 @@
+#ifndef _ISENSOR_IMU_HPP_
+#define _ISENSOR_IMU_HPP_
+
+#include "isensor.hpp"
+
+namespace hako::assets::drone {
+
+/*
+ * IMU（加速度計とジャイロを1つのデバイスとしてまとめたもの）。
+ * 物理ステップとは独立したサンプリングレートで計測し、ステップごとに間引いた値を出力する。
+ */
+class ISensorImu : public hako::assets::drone::ISensor {
+public:
+    virtual ~ISensorImu() {}
+    /*
+     * specific_force: 比力（機体座標系、IDroneDynamics::get_specific_force()）
+     * angular_velocity: 機体座標系の角速度
+     * rotor_speeds: 全ロータの回転数（rotor_num 個の配列）。振動の計算に使う
+     */
+    virtual void run(const DroneAccelerationBodyFrameType& specific_force,
+                     const DroneAngularVelocityBodyFrameType& angular_velocity,
+                     const DroneRotorSpeedType* rotor_speeds, int rotor_num) = 0;
+    virtual DroneAccelerationBodyFrameType acc_value() = 0;
+    virtual DroneAngularVelocityBodyFrameType gyro_value() = 0;
+};
+
+}
+
+#endif /* _ISENSOR_IMU_HPP_ */
@@ -1,9 +1,11 @@
 #ifndef _ISENSOR_NOISE_HPP_
 #define _ISENSOR_NOISE_HPP_
 
+#include "utils/state_snapshot.hpp"
+
 namespace hako::assets::drone {
 
-class ISensorNoise {
+class ISensorNoise : public IStateSnapshot {
 public:
     virtual ~ISensorNoise() {}
     virtual double add_random_noise(double data) = 0;
@@ -0,0 +1,21 @@
+#ifndef _ITERRAIN_HPP_
+#define _ITERRAIN_HPP_
+
+namespace hako::assets::drone {
+
+/*
+ * 地形（地面の高さ）
+ */
+class ITerrain {
+public:
+    virtual ~ITerrain() {}
+    /*
+     * 地上座標系（NED）の水平位置 (x, y) の地面の z 座標（下向きが正なので、高い地面ほど小さい）。
+     * 地形の範囲外の場合は false
+     */
+    virtual bool get_ground_z(double x, double y, double& ground_z) = 0;
+};
+
+}
+
+#endif /* _ITERRAIN_HPP_ */
@@ -2,23 +2,32 @@
 #define _ITHRUST_DYNAMICS_HPP_
 
 #include "drone_primitive_types.hpp"
+#include "utils/state_snapshot.hpp"
 
 namespace hako::assets::drone {
 
+// 既定（クアッド）のロータ数。機体のロータ数は set_rotor_config() で決まる
 const int ROTOR_NUM = 4;
 
-class IThrustDynamics {
+class IThrustDynamics : public IStateSnapshot {
 public:
     virtual ~IThrustDynamics() {}
 
-    virtual void set_rotor_config(const RotorConfigType rotor_config[ROTOR_NUM]) = 0;
+    virtual int get_rotor_num() const = 0;
+    // rotor_num 個のロータの位置と回転方向
+    virtual void set_rotor_config(const RotorConfigType rotor_config[], int rotor_num) = 0;
+    void set_rotor_config(const RotorConfigType rotor_config[ROTOR_NUM])
+    {
+        set_rotor_config(rotor_config, ROTOR_NUM);
+    }
     virtual void set_thrust(const DroneThrustType &thrust) = 0;
     virtual void set_torque(const DroneTorqueType &torque) = 0;
 
     virtual DroneThrustType get_thrust() const = 0;
     virtual DroneTorqueType get_torque() const = 0;
 
-    virtual void run(const DroneRotorSpeedType rotor_speed[ROTOR_NUM]) = 0;
+    // rotor_speed: get_rotor_num() 個のロータの回転数
+    virtual void run(const DroneRotorSpeedType rotor_speed[]) = 0;
 
     virtual void print() = 0;
 };
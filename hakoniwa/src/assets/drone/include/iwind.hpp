@@ -0,0 +1,23 @@
+#ifndef _IWIND_HPP_
+#define _IWIND_HPP_
+
+#include "drone_primitive_types.hpp"
+#include "utils/state_snapshot.hpp"
+
+namespace hako::assets::drone {
+
+/*
+ * 風（一定の風・突風・乱流）
+ */
+class IWind : public IStateSnapshot {
+public:
+    virtual ~IWind() {}
+    /*
+     * 1ステップ進めて、風速（地上座標系, NED）を返す
+     */
+    virtual DroneVelocityType run() = 0;
+};
+
+}
+
+#endif /* _IWIND_HPP_ */
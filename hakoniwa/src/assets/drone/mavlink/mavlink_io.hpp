@@ -3,6 +3,8 @@
 
 #include "iaircraft.hpp"
 #include "hako/pdu/hako_pdu_data.hpp"
+#include "mavlink/mavlink_tx_scheduler.hpp"
+#include "utils/hako_profile.hpp"
 #include <iostream>
 
 namespace hako::assets::drone {
@@ -13,12 +15,13 @@ private:
     {
         //TODO 単位変換チェック
         sensor.time_usec = 0;
-        DroneAccelerationBodyFrameType acc = drone.get_acc().sensor_value();
+        ISensorImu *imu = drone.get_imu();
+        DroneAccelerationBodyFrameType acc = (imu != nullptr) ? imu->acc_value() : drone.get_acc().sensor_value();
         sensor.xacc = static_cast<float>(acc.data.x);
         sensor.yacc = static_cast<float>(acc.data.y);
         sensor.zacc = static_cast<float>(acc.data.z);
 
-        DroneAngularVelocityBodyFrameType gyro = drone.get_gyro().sensor_value();
+        DroneAngularVelocityBodyFrameType gyro = (imu != nullptr) ? imu->gyro_value() : drone.get_gyro().sensor_value();
         sensor.xgyro = static_cast<float>(gyro.data.x);
         sensor.ygyro = static_cast<float>(gyro.data.y);
         sensor.zgyro = static_cast<float>(gyro.data.z);
@@ -60,14 +63,58 @@ private:
         sensor.id = 0;
         sensor.yaw = 0;
     }
+    /*
+     * 単位: voltages [mV], current_battery [cA], current_consumed [mAh], energy_consumed [hJ], temperature [cdegC]
+     * セルごとの電圧はないので、パックの電圧を voltages[0]（UINT16_MAX - 1 を超える分は voltages[1]）に入れる。
+     * charge_state のしきい値は PX4 の BAT_LOW_THR, BAT_CRIT_THR, BAT_EMERGEN_THR の既定値に合わせる。
+     */
+    void build_battery_status(const IBattery& battery, mavlink_battery_status_t& msg)
+    {
+        const DroneBatteryStatusType& status = battery.get_status();
+        msg = {};
+        msg.id = 0;
+        msg.battery_function = MAV_BATTERY_FUNCTION_ALL;
+        msg.type = MAV_BATTERY_TYPE_LIPO;
+        msg.temperature = static_cast<int16_t>(status.temperature * 100);
+        uint32_t voltage_mv = static_cast<uint32_t>(status.voltage * 1000);
+        for (int i = 0; i < 10; i++) {
+            msg.voltages[i] = UINT16_MAX;
+        }
+        if (voltage_mv > (UINT16_MAX - 1)) {
+            msg.voltages[0] = UINT16_MAX - 1;
+            msg.voltages[1] = static_cast<uint16_t>(voltage_mv - (UINT16_MAX - 1));
+        }
+        else {
+            msg.voltages[0] = static_cast<uint16_t>(voltage_mv);
+        }
+        msg.current_battery = static_cast<int16_t>(status.current * 100);
+        msg.current_consumed = static_cast<int32_t>(status.consumed_mah);
+        msg.energy_consumed = static_cast<int32_t>(status.consumed_energy * 0.01);
+        msg.battery_remaining = static_cast<int8_t>(status.remaining * 100);
+        msg.time_remaining = (status.time_remaining >= 0) ? static_cast<int32_t>(status.time_remaining) : 0;
+        if (status.remaining > 0.15) {
+            msg.charge_state = MAV_BATTERY_CHARGE_STATE_OK;
+        }
+        else if (status.remaining > 0.07) {
+            msg.charge_state = MAV_BATTERY_CHARGE_STATE_LOW;
+        }
+        else if (status.remaining > 0.05) {
+            msg.charge_state = MAV_BATTERY_CHARGE_STATE_CRITICAL;
+        }
+        else {
+            msg.charge_state = MAV_BATTERY_CHARGE_STATE_EMERGENCY;
+        }
+        msg.mode = MAV_BATTERY_MODE_UNKNOWN;
+        msg.fault_bitmask = 0;
+    }
 public:
     virtual ~MavlinkIO() {}
 
-    bool read_actuator_data(double controls[hako::assets::drone::ROTOR_NUM], Hako_uint64& time_usec)
+    bool read_actuator_data(double controls[MAX_ROTOR_NUM], Hako_uint64& time_usec)
     {
         Hako_HakoHilActuatorControls hil_actuator_controls;
         if (hako_read_hil_actuator_controls(hil_actuator_controls)) {
-            for (int i = 0; i < hako::assets::drone::ROTOR_NUM; i++) {
+            for (int i = 0; i < MAX_ROTOR_NUM; i++) {
                 controls[i] = hil_actuator_controls.controls[i];
             }
             time_usec = hil_actuator_controls.time_usec;
@@ -76,16 +123,27 @@ public:
         return false;
     }
 
-    void write_sensor_data(IAirCraft& drone)
+    /*
+     * このステップで送信するメッセージのセンサ値だけを取得して PDU に書き込む
+     */
+    void write_sensor_data(IAirCraft& drone, const MavlinkTxScheduler& scheduler)
     {
-        Hako_HakoHilSensor hil_sensor;
-        Hako_HakoHilGps hil_gps;
-
-        build_hil_sensor(drone, hil_sensor);
-        build_hil_gps(drone, hil_gps);
-
-        hako_write_hil_sensor(hil_sensor);
-        hako_write_hil_gps(hil_gps);
+        HAKO_PROFILE_SCOPE("MavlinkIO::write_sensor_data");
+        if (scheduler.is_due(MAVLINK_TX_HIL_SENSOR)) {
+            Hako_HakoHilSensor hil_sensor;
+            build_hil_sensor(drone, hil_sensor);
+            hako_write_hil_sensor(hil_sensor);
+        }
+        if (scheduler.is_due(MAVLINK_TX_HIL_GPS)) {
+            Hako_HakoHilGps hil_gps;
+            build_hil_gps(drone, hil_gps);
+            hako_write_hil_gps(hil_gps);
+        }
+        if (scheduler.is_due(MAVLINK_TX_BATTERY_STATUS) && (drone.get_battery() != nullptr)) {
+            mavlink_battery_status_t battery_status;
+            build_battery_status(*drone.get_battery(), battery_status);
+            hako_mavlink_write_battery_status(battery_status);
+        }
     }
 };
 }
@@ -0,0 +1,211 @@
+#ifndef _BATTERY_MODEL_HPP_
+#define _BATTERY_MODEL_HPP_
+
+#include "ibattery.hpp"
+#include "utils/icsv_log.hpp"
+#include "utils/csv_logger.hpp"
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace hako::assets::drone {
+
+/*
+ * 放電曲線・内部抵抗・温度を持つバッテリ。
+ *
+ * 開放電圧は充電率（SOC）に対するセル電圧の放電曲線から求める。放電曲線は set_discharge_curve() で
+ * SOC を等間隔に区切った表にしておき、毎ステップは表の2点の線形補間だけで引く。
+ * 端子電圧 V は負荷の電力 P に対して V = OCV - I R, P = V I を解いて求める
+ * （P が取り出せる最大電力 OCV^2 / 4R を超える場合は V = OCV / 2 とする）。
+ * 内部抵抗は温度が基準より低いほど大きくなり、温度は I^2 R の発熱と周囲への放熱で変わる。
+ */
+#define BATTERY_OCV_TABLE_SIZE          101
+#define BATTERY_CURRENT_FILTER_SEC      10.0    // 残り時間の計算に使う平均電流の時定数
+#define BATTERY_MIN_RESISTANCE_RATIO    0.5
+
+typedef struct {
+    int cells;                              // 直列セル数
+    double capacity_mah;
+    double internal_resistance;             // パックの内部抵抗 [Ohm]（reference_temperature での値）
+    double resistance_temperature_coefficient;  // 基準温度から 1 度下がるごとに内部抵抗が増える割合 [1/degC]
+    double reference_temperature;           // [degC]
+    double ambient_temperature;             // [degC]
+    double heat_capacity;                   // [J/K]
+    double heat_transfer;                   // 周囲への熱伝達 [W/K]
+    double initial_remaining;               // 初期の充電率 (0.0 - 1.0)
+} BatteryParamType;
+
+class BatteryModel : public IBattery, public ICsvLog {
+private:
+    double delta_time_sec;
+    BatteryParamType param;
+    std::vector<double> ocv_table;      // パックの開放電圧（SOC 0, 0.01, ..., 1.0）
+    double current_filter_gain;
+    double soc;
+    double average_current;
+    DroneBatteryStatusType status;
+
+    double resistance() const
+    {
+        double ratio = 1.0 + param.resistance_temperature_coefficient * (param.reference_temperature - status.temperature);
+        return param.internal_resistance * ((ratio > BATTERY_MIN_RESISTANCE_RATIO) ? ratio : BATTERY_MIN_RESISTANCE_RATIO);
+    }
+    void reset_status()
+    {
+        soc = param.initial_remaining;
+        average_current = 0;
+        status.voltage = get_open_circuit_voltage(soc);
+        status.current = 0;
+        status.remaining = soc;
+        status.consumed_mah = 0;
+        status.consumed_energy = 0;
+        status.temperature = param.ambient_temperature;
+        status.time_remaining = -1;
+    }
+
+public:
+    BatteryModel(double dt) : delta_time_sec(dt)
+    {
+        param.cells = 4;
+        param.capacity_mah = 5000;
+        param.internal_resistance = 0.03;
+        param.resistance_temperature_coefficient = 0.01;
+        param.reference_temperature = 25.0;
+        param.ambient_temperature = 25.0;
+        param.heat_capacity = 500.0;
+        param.heat_transfer = 1.0;
+        param.initial_remaining = 1.0;
+        current_filter_gain = 1.0 - std::exp(-dt / BATTERY_CURRENT_FILTER_SEC);
+        // LiPo の代表的な放電曲線
+        (void)set_discharge_curve(
+            { 0.0, 0.05, 0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8, 0.9, 1.0 },
+            { 3.27, 3.61, 3.69, 3.73, 3.77, 3.79, 3.82, 3.87, 3.92, 4.00, 4.08, 4.20 });
+    }
+    virtual ~BatteryModel() {}
+
+    bool set_params(const BatteryParamType& p)
+    {
+        if ((p.cells <= 0) || (p.capacity_mah <= 0) || (p.internal_resistance < 0)
+            || (p.heat_capacity <= 0) || (p.heat_transfer < 0)
+            || (p.initial_remaining < 0) || (p.initial_remaining > 1)) {
+            std::cerr << "ERROR: invalid battery parameter" << std::endl;
+            return false;
+        }
+        // 放電曲線の表はセル数倍しているので、セル数が変わった分を直す
+        for (auto& v : ocv_table) {
+            v = v / param.cells * p.cells;
+        }
+        this->param = p;
+        reset_status();
+        return true;
+    }
+    const BatteryParamType& get_params() const
+    {
+        return param;
+    }
+    /*
+     * soc: 充電率（0.0 から 1.0 まで昇順、両端を含む）
+     * cell_voltage: その充電率での1セルの開放電圧 [V]
+     */
+    bool set_discharge_curve(const std::vector<double>& soc_points, const std::vector<double>& cell_voltage)
+    {
+        if ((soc_points.size() < 2) || (soc_points.size() != cell_voltage.size())
+            || (soc_points.front() != 0.0) || (soc_points.back() != 1.0)) {
+            std::cerr << "ERROR: invalid discharge curve (soc must start at 0 and end at 1)" << std::endl;
+            return false;
+        }
+        for (size_t i = 1; i < soc_points.size(); i++) {
+            if (soc_points[i] <= soc_points[i - 1]) {
+                std::cerr << "ERROR: invalid discharge curve (soc must be increasing)" << std::endl;
+                return false;
+            }
+        }
+        ocv_table.resize(BATTERY_OCV_TABLE_SIZE);
+        size_t k = 1;
+        for (int i = 0; i < BATTERY_OCV_TABLE_SIZE; i++) {
+            double s = (double)i / (BATTERY_OCV_TABLE_SIZE - 1);
+            while ((k < soc_points.size() - 1) && (soc_points[k] < s)) {
+                k++;
+            }
+            double r = (s - soc_points[k - 1]) / (soc_points[k] - soc_points[k - 1]);
+            ocv_table[i] = (cell_voltage[k - 1] + r * (cell_voltage[k] - cell_voltage[k - 1])) * param.cells;
+        }
+        reset_status();
+        return true;
+    }
+    /*
+     * パックの開放電圧 [V]
+     */
+    double get_open_circuit_voltage(double s) const
+    {
+        double index = s * (BATTERY_OCV_TABLE_SIZE - 1);
+        if (index <= 0) {
+            return ocv_table.front();
+        }
+        int i = (int)index;
+        if (i >= BATTERY_OCV_TABLE_SIZE - 1) {
+            return ocv_table.back();
+        }
+        double r = index - i;
+        return ocv_table[i] + r * (ocv_table[i + 1] - ocv_table[i]);
+    }
+    double get_reference_voltage() const override
+    {
+        return ocv_table.back();
+    }
+    void run(double load_power) override
+    {
+        const double dt = this->delta_time_sec;
+        const double ocv = get_open_circuit_voltage(soc);
+        const double r = resistance();
+        const double p = (load_power > 0) ? load_power : 0.0;
+        double disc = ocv * ocv - 4.0 * p * r;
+        double v = (disc > 0) ? 0.5 * (ocv + std::sqrt(disc)) : 0.5 * ocv;
+        double i = (r > 0) ? ((ocv - v) / r) : ((v > 0) ? (p / v) : 0.0);
+
+        soc -= i * dt / (param.capacity_mah * 3.6);
+        soc = (soc > 0) ? soc : 0.0;
+        average_current += (i - average_current) * current_filter_gain;
+        status.temperature += (i * i * r - param.heat_transfer * (status.temperature - param.ambient_temperature)) * dt / param.heat_capacity;
+
+        status.voltage = v;
+        status.current = i;
+        status.remaining = soc;
+        status.consumed_mah += i * dt / 3.6;
+        status.consumed_energy += v * i * dt;
+        status.time_remaining = (average_current > 0.01) ? (soc * param.capacity_mah * 3.6 / average_current) : -1;
+    }
+    const DroneBatteryStatusType& get_status() const override
+    {
+        return status;
+    }
+    void save_state(StateSnapshot& snapshot) const override
+    {
+        snapshot.put(this->soc);
+        snapshot.put(this->average_current);
+        snapshot.put(this->status);
+    }
+    bool restore_state(StateSnapshot& snapshot) override
+    {
+        return snapshot.get(this->soc)
+            && snapshot.get(this->average_current)
+            && snapshot.get(this->status);
+    }
+    const std::vector<std::string> log_head() override
+    {
+        return { "timestamp", "voltage", "current", "remaining", "consumed_mah", "temperature" };
+    }
+    void log_fields(LogRecord& record) override
+    {
+        record.add(CsvLogger::get_time_usec())
+              .add(status.voltage)
+              .add(status.current)
+              .add(status.remaining)
+              .add(status.consumed_mah)
+              .add(status.temperature);
+    }
+};
+
+}
+
+#endif /* _BATTERY_MODEL_HPP_ */
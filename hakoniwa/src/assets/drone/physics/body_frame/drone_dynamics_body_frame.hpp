@@ -160,6 +160,7 @@ public:
     // Implementation for the run function is required
     void run(const DroneDynamicsInputType &input) override 
     {
+        const DroneVelocityType prev_velocity = this->velocity;
         DroneTorqueType torque = input.torque;
         DroneThrustType thrust = input.thrust;
         this->cache = drone_phys_calc_cache(this->angle);
@@ -167,6 +168,7 @@ public:
         DroneAccelerationBodyFrame acc = drone_physics::acceleration_in_body_frame(
                                                             this->velocityBodyFrame, this->angle, 
                                                             this->angularVelocityBodyFrame,
+                                                            drone_physics::body_vector_from_ground(this->wind, this->angle),
                                                             thrust.data, this->param_mass, GRAVITY, this->param_drag1, this->param_drag2);
         DroneAngularAccelerationBodyFrame acc_angular = drone_physics::angular_acceleration_in_body_frame(
                                                             this->angularVelocityBodyFrame,
@@ -209,7 +211,12 @@ public:
         this->angle.data = integral(this->angle.data, this->angularVelocity.data);
 
         //boundary condition
-        if (this->position.data.z > 0) {
+        if (this->terrain != nullptr) {
+            if (this->run_ground_contact(this->position, this->velocity, this->delta_time_sec)) {
+                this->velocityBodyFrame = drone_physics::body_vector_from_ground(this->velocity, angle);
+            }
+        }
+        else if (this->position.data.z > 0) {
             this->position.data.z = 0;
             this->velocity.data.z = 0;
             this->velocityBodyFrame.data.x = 0;
@@ -219,19 +226,44 @@ public:
             //this->angularVelocityBodyFrame.data.y = 0;
             //this->angularVelocityBodyFrame.data.z = 0;
         }
+        this->update_specific_force(prev_velocity, this->velocity, this->angle, this->delta_time_sec);
         this->total_time_sec += this->delta_time_sec;
     }
+    void save_state(StateSnapshot& snapshot) const override
+    {
+        snapshot.put(this->position);
+        snapshot.put(this->velocity);
+        snapshot.put(this->angle);
+        snapshot.put(this->angularVelocity);
+        snapshot.put(this->velocityBodyFrame);
+        snapshot.put(this->angularVelocityBodyFrame);
+        snapshot.put(this->next_velocityBodyFrame);
+        snapshot.put(this->next_angularVelocityBodyFrame);
+        snapshot.put(this->total_time_sec);
+        snapshot.put(this->cache);
+    }
+    bool restore_state(StateSnapshot& snapshot) override
+    {
+        return snapshot.get(this->position)
+            && snapshot.get(this->velocity)
+            && snapshot.get(this->angle)
+            && snapshot.get(this->angularVelocity)
+            && snapshot.get(this->velocityBodyFrame)
+            && snapshot.get(this->angularVelocityBodyFrame)
+            && snapshot.get(this->next_velocityBodyFrame)
+            && snapshot.get(this->next_angularVelocityBodyFrame)
+            && snapshot.get(this->total_time_sec)
+            && snapshot.get(this->cache);
+    }
     const std::vector<std::string> log_head() override
     {
         return { "timestamp", "X", "Y", "Z", "Rx", "Ry", "Rz" };
     }
-    const std::vector<std::string> log_data() override
+    void log_fields(LogRecord& record) override
     {
-        return {
-            std::to_string(CsvLogger::get_time_usec()), 
-            std::to_string(position.data.x), std::to_string(position.data.y), std::to_string(position.data.z),
-            std::to_string(angle.data.x), std::to_string(angle.data.y), std::to_string(angle.data.z)
-            };
+        record.add(CsvLogger::get_time_usec())
+              .add(position.data.x).add(position.data.y).add(position.data.z)
+              .add(angle.data.x).add(angle.data.y).add(angle.data.z);
     }
 
 };
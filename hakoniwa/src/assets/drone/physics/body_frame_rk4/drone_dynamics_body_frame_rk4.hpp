@@ -4,6 +4,7 @@
 #include "idrone_dynamics.hpp"
 #include <math.h>
 #include <iostream>
+#include "utils/csv_logger.hpp"
 
 namespace hako::assets::drone {
 
@@ -71,12 +72,14 @@ private:
         k_rate.data.y = v_rate.data.y + rate * k_acc_angular.data.y * this->delta_time_sec; 
         k_rate.data.z = v_rate.data.z + rate * k_acc_angular.data.z * this->delta_time_sec;
     }
-    DroneAccelerationBodyFrame rungeKutta4_acc(const DroneVelocityBodyFrame &v_vel, const DroneAngularVelocityBodyFrame& v_rate, const DroneThrustType& thrust)
+    DroneAccelerationBodyFrame rungeKutta4_acc(const DroneVelocityBodyFrame &v_vel, const DroneAngularVelocityBodyFrame& v_rate, const DroneThrustType& thrust,
+                                               const drone_physics::VelocityType& body_wind)
     {
         return drone_physics::acceleration_in_body_frame(
                         v_vel, 
                         this->angle, 
                         v_rate, 
+                        body_wind,
                         thrust.data, this->param_mass, GRAVITY, this->param_drag1, this->param_drag2);
     }
     DroneAngularAccelerationBodyFrame rungeKutta4_acc_angular(const DroneAngularVelocityBodyFrame& v_rate, const DroneTorqueType& torque)
@@ -98,26 +101,27 @@ private:
     {
         DroneVelocityBodyFrame v_vel(this->velocityBodyFrame);
         DroneAngularVelocityBodyFrame v_rate(this->angularVelocityBodyFrame);
+        drone_physics::VelocityType body_wind = drone_physics::body_vector_from_ground(this->wind, this->angle);
         //k1
-        DroneAccelerationBodyFrame k1_acc = rungeKutta4_acc(v_vel, v_rate, thrust);
+        DroneAccelerationBodyFrame k1_acc = rungeKutta4_acc(v_vel, v_rate, thrust, body_wind);
         DroneAngularAccelerationBodyFrame k1_acc_angular = rungeKutta4_acc_angular(v_rate, torque);
         //k2
         DroneVelocityBodyFrame k2_vec;
         DroneAngularVelocityBodyFrame k2_rate;
         rungeKutta4_k(v_vel, v_rate, k1_acc, k1_acc_angular, 0.5, k2_vec, k2_rate);
-        DroneAccelerationBodyFrame k2_acc = rungeKutta4_acc(k2_vec, k2_rate, thrust);
+        DroneAccelerationBodyFrame k2_acc = rungeKutta4_acc(k2_vec, k2_rate, thrust, body_wind);
         DroneAngularAccelerationBodyFrame k2_acc_angular = rungeKutta4_acc_angular(k2_rate, torque);
         //k3
         DroneVelocityBodyFrame k3_vec;
         DroneAngularVelocityBodyFrame k3_rate;
         rungeKutta4_k(v_vel, v_rate, k2_acc, k2_acc_angular, 0.5, k3_vec, k3_rate);
-        DroneAccelerationBodyFrame k3_acc = rungeKutta4_acc(k3_vec, k3_rate, thrust);
+        DroneAccelerationBodyFrame k3_acc = rungeKutta4_acc(k3_vec, k3_rate, thrust, body_wind);
         DroneAngularAccelerationBodyFrame k3_acc_angular = rungeKutta4_acc_angular(k3_rate, torque);
         //k4
         DroneVelocityBodyFrame k4_vec;
         DroneAngularVelocityBodyFrame k4_rate;
         rungeKutta4_k(v_vel, v_rate, k3_acc, k3_acc_angular, 1.0, k4_vec, k4_rate);
-        DroneAccelerationBodyFrame k4_acc = rungeKutta4_acc(k4_vec, k4_rate, thrust);
+        DroneAccelerationBodyFrame k4_acc = rungeKutta4_acc(k4_vec, k4_rate, thrust, body_wind);
         DroneAngularAccelerationBodyFrame k4_acc_angular = rungeKutta4_acc_angular(k4_rate, torque);
 
         this->velocityBodyFrame.data = rungeKutta4_sum(v_vel.data, k1_acc.data, k2_acc.data, k3_acc.data, k4_acc.data);
@@ -226,15 +230,34 @@ public:
     // Implementation for the run function is required
     void run(const DroneDynamicsInputType &input) override 
     {
+        const DroneVelocityType prev_velocity = this->velocity;
         this->rungeKutta4(input.thrust, input.torque);
 
         this->velocity = this->convert(this->velocityBodyFrame);
         this->angularVelocity = this->convert(this->angularVelocityBodyFrame);
+
+        //collision detection
+        if (param_collision_detection && input.collision.collision) {
+            hako::drone_physics::VectorType contact_position = {
+                input.collision.contact_position[0].x,
+                input.collision.contact_position[0].y,
+                input.collision.contact_position[0].z
+            };
+            this->velocity = hako::drone_physics::velocity_after_contact_with_wall(
+                    this->velocity, this->position, contact_position, input.collision.restitution_coefficient);
+            this->velocityBodyFrame = drone_physics::body_vector_from_ground(this->velocity, angle);
+        }
+
         this->integral(this->velocity);
         this->integral(this->angularVelocity);
 
         //boundary condition
-        if (this->position.data.z > 0) {
+        if (this->terrain != nullptr) {
+            if (this->run_ground_contact(this->position, this->velocity, this->delta_time_sec)) {
+                this->velocityBodyFrame = drone_physics::body_vector_from_ground(this->velocity, angle);
+            }
+        }
+        else if (this->position.data.z > 0) {
             this->position.data.z = 0;
             this->velocity.data.z = 0;
             this->velocityBodyFrame.data.x = 0;
@@ -244,19 +267,40 @@ public:
             //this->angularVelocityBodyFrame.data.y = 0;
             //this->angularVelocityBodyFrame.data.z = 0;
         }        
+        this->update_specific_force(prev_velocity, this->velocity, this->angle, this->delta_time_sec);
         this->total_time_sec += this->delta_time_sec;
     }
+    void save_state(StateSnapshot& snapshot) const override
+    {
+        snapshot.put(this->position);
+        snapshot.put(this->velocity);
+        snapshot.put(this->angle);
+        snapshot.put(this->angularVelocity);
+        snapshot.put(this->velocityBodyFrame);
+        snapshot.put(this->angularVelocityBodyFrame);
+        snapshot.put(this->total_time_sec);
+        snapshot.put(this->cache);
+    }
+    bool restore_state(StateSnapshot& snapshot) override
+    {
+        return snapshot.get(this->position)
+            && snapshot.get(this->velocity)
+            && snapshot.get(this->angle)
+            && snapshot.get(this->angularVelocity)
+            && snapshot.get(this->velocityBodyFrame)
+            && snapshot.get(this->angularVelocityBodyFrame)
+            && snapshot.get(this->total_time_sec)
+            && snapshot.get(this->cache);
+    }
     const std::vector<std::string> log_head() override
     {
         return { "timestamp", "X", "Y", "Z", "Rx", "Ry", "Rz" };
     }
-    const std::vector<std::string> log_data() override
+    void log_fields(LogRecord& record) override
     {
-        return {
-            std::to_string(total_time_sec), 
-            std::to_string(position.data.x), std::to_string(position.data.y), std::to_string(position.data.z),
-            std::to_string(angle.data.x), std::to_string(angle.data.y), std::to_string(angle.data.z)
-            };
+        record.add(CsvLogger::get_time_usec())
+              .add(position.data.x).add(position.data.y).add(position.data.z)
+              .add(angle.data.x).add(angle.data.y).add(angle.data.z);
     }
 
 };
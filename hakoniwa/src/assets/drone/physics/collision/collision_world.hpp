@@ -0,0 +1,484 @@
+#ifndef _COLLISION_WORLD_HPP_
+#define _COLLISION_WORLD_HPP_
+
+#include "icollision_world.hpp"
+#include "body_physics.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace hako::assets::drone {
+
+#define COLLISION_BVH_LEAF_SIZE     4
+#define COLLISION_BVH_STACK_SIZE    64      // 中央値で分けるので、木の深さは log2(物体数) 程度
+#define COLLISION_EPSILON           1.0e-9
+
+/*
+ * 静的な物体（平面・直方体・三角形メッシュ）と機体の直方体の衝突判定。
+ *
+ * 平面は無限に広がるので毎回すべて調べる。直方体（地上座標系の軸に平行）と三角形は BVH にまとめ、
+ * 機体を囲む AABB と重なるものだけ調べる。物体を追加したら build() で BVH を作ること
+ * （build() 前は全部の物体を調べる）。
+ *
+ * 平面は、機体の直方体の頂点が平面の裏側に入ったら接触とし、機体の中心から平面への垂線の足を接触点とする。
+ * 直方体と三角形は、機体の中心に最も近い物体上の点が機体の直方体の中にあれば接触とし、その点を接触点とする。
+ * 座標は地上座標系（NED）で、単位はメートル。
+ */
+class CollisionWorld : public ICollisionWorld {
+private:
+    typedef hako::drone_physics::VectorType Vector;
+    struct Aabb {
+        Vector min;
+        Vector max;
+    };
+    struct Plane {
+        Vector point;
+        Vector normal;      // 物体の外向きの単位ベクトル
+    };
+    struct Triangle {
+        Vector a;
+        Vector b;
+        Vector c;
+    };
+    typedef enum {
+        ITEM_BOX,
+        ITEM_TRIANGLE,
+    } ItemKind;
+    struct Item {
+        ItemKind kind;
+        int index;
+        Aabb bounds;
+        Vector centroid;
+    };
+    struct Node {
+        Aabb bounds;
+        int left;           // 葉は -1
+        int right;
+        int first;          // 葉の items の範囲
+        int count;
+    };
+    struct Contact {
+        Vector position;
+        double distance;    // 機体の中心から接触点までの距離（めり込んでいる場合は負）
+    };
+    /*
+     * 1回の判定の作業領域
+     */
+    struct Query {
+        Vector center;
+        Vector velocity;
+        Vector axis[3];     // 機体の x, y, z 軸（地上座標系）
+        double half[3];
+        Aabb bounds;
+        Contact contacts[MAX_CONTAT_NUM];
+        int contact_num;
+    };
+
+    Vector half_size;
+    double restitution_coefficient;
+    std::vector<Plane> planes;
+    std::vector<Aabb> boxes;
+    std::vector<Triangle> triangles;
+    std::vector<Item> items;
+    std::vector<Node> nodes;
+
+    static double axis_value(const Vector& v, int axis)
+    {
+        return (axis == 0) ? v.x : ((axis == 1) ? v.y : v.z);
+    }
+    static Aabb merge(const Aabb& a, const Aabb& b)
+    {
+        return Aabb{
+            { std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y), std::min(a.min.z, b.min.z) },
+            { std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y), std::max(a.max.z, b.max.z) }
+        };
+    }
+    static bool overlap(const Aabb& a, const Aabb& b)
+    {
+        return (a.min.x <= b.max.x) && (b.min.x <= a.max.x)
+            && (a.min.y <= b.max.y) && (b.min.y <= a.max.y)
+            && (a.min.z <= b.max.z) && (b.min.z <= a.max.z);
+    }
+    static Vector closest_point_on_box(const Aabb& box, const Vector& p)
+    {
+        Vector q = {
+            std::clamp(p.x, box.min.x, box.max.x),
+            std::clamp(p.y, box.min.y, box.max.y),
+            std::clamp(p.z, box.min.z, box.max.z)
+        };
+        if ((q.x != p.x) || (q.y != p.y) || (q.z != p.z)) {
+            return q;
+        }
+        // 中心が直方体の中にある場合は、一番近い面に出す
+        double d[6] = {
+            p.x - box.min.x, box.max.x - p.x,
+            p.y - box.min.y, box.max.y - p.y,
+            p.z - box.min.z, box.max.z - p.z
+        };
+        int face = (int)(std::min_element(d, d + 6) - d);
+        switch (face) {
+        case 0: q.x = box.min.x; break;
+        case 1: q.x = box.max.x; break;
+        case 2: q.y = box.min.y; break;
+        case 3: q.y = box.max.y; break;
+        case 4: q.z = box.min.z; break;
+        default: q.z = box.max.z; break;
+        }
+        return q;
+    }
+    /*
+     * 三角形上で p に最も近い点
+     * REF: Christer Ericson, Real-Time Collision Detection, 5.1.5
+     */
+    static Vector closest_point_on_triangle(const Triangle& t, const Vector& p)
+    {
+        using hako::drone_physics::dot;
+        const Vector ab = t.b - t.a;
+        const Vector ac = t.c - t.a;
+        const Vector ap = p - t.a;
+        double d1 = dot(ab, ap);
+        double d2 = dot(ac, ap);
+        if ((d1 <= 0) && (d2 <= 0)) {
+            return t.a;
+        }
+        const Vector bp = p - t.b;
+        double d3 = dot(ab, bp);
+        double d4 = dot(ac, bp);
+        if ((d3 >= 0) && (d4 <= d3)) {
+            return t.b;
+        }
+        double vc = d1 * d4 - d3 * d2;
+        if ((vc <= 0) && (d1 >= 0) && (d3 <= 0)) {
+            return t.a + (d1 / (d1 - d3)) * ab;
+        }
+        const Vector cp = p - t.c;
+        double d5 = dot(ab, cp);
+        double d6 = dot(ac, cp);
+        if ((d6 >= 0) && (d5 <= d6)) {
+            return t.c;
+        }
+        double vb = d5 * d2 - d1 * d6;
+        if ((vb <= 0) && (d2 >= 0) && (d6 <= 0)) {
+            return t.a + (d2 / (d2 - d6)) * ac;
+        }
+        double va = d3 * d6 - d5 * d4;
+        if ((va <= 0) && ((d4 - d3) >= 0) && ((d5 - d6) >= 0)) {
+            return t.b + ((d4 - d3) / ((d4 - d3) + (d5 - d6))) * (t.c - t.b);
+        }
+        double denom = 1.0 / (va + vb + vc);
+        return t.a + (vb * denom) * ab + (vc * denom) * ac;
+    }
+    /*
+     * inward: 機体の中心から物体の中に向かう向き
+     */
+    static void add_contact(Query& query, const Vector& position, const Vector& inward, double distance)
+    {
+        // 機体が離れていく接触は跳ね返さない
+        if (hako::drone_physics::dot(query.velocity, inward) <= 0) {
+            return;
+        }
+        // 近い順に MAX_CONTAT_NUM 個まで
+        int i = query.contact_num;
+        if (i == MAX_CONTAT_NUM) {
+            if (query.contacts[i - 1].distance <= distance) {
+                return;
+            }
+            i--;
+        }
+        else {
+            query.contact_num++;
+        }
+        for (; (i > 0) && (query.contacts[i - 1].distance > distance); i--) {
+            query.contacts[i] = query.contacts[i - 1];
+        }
+        query.contacts[i] = Contact{ position, distance };
+    }
+    static bool inside_body(const Query& query, const Vector& p)
+    {
+        const Vector v = p - query.center;
+        for (int i = 0; i < 3; i++) {
+            if (std::fabs(hako::drone_physics::dot(v, query.axis[i])) > query.half[i] + COLLISION_EPSILON) {
+                return false;
+            }
+        }
+        return true;
+    }
+    void test_item(Query& query, ItemKind kind, int index) const
+    {
+        Vector q;
+        bool inside = false;
+        if (kind == ITEM_BOX) {
+            const Aabb& box = boxes[index];
+            q = closest_point_on_box(box, query.center);
+            if ((query.center.x > box.min.x) && (query.center.x < box.max.x)
+                && (query.center.y > box.min.y) && (query.center.y < box.max.y)
+                && (query.center.z > box.min.z) && (query.center.z < box.max.z)) {
+                inside = true;
+            }
+        }
+        else {
+            q = closest_point_on_triangle(triangles[index], query.center);
+        }
+        // 中心が直方体の中にある場合は、機体の大きさによらず接触とし、一番近い面から押し出す
+        if (inside) {
+            add_contact(query, q, query.center - q, -hako::drone_physics::length(q - query.center));
+        }
+        else if (inside_body(query, q)) {
+            add_contact(query, q, q - query.center, hako::drone_physics::length(q - query.center));
+        }
+    }
+    void test_planes(Query& query) const
+    {
+        using hako::drone_physics::dot;
+        for (const auto& plane : planes) {
+            double d = dot(plane.normal, query.center - plane.point);
+            double r = 0;
+            for (int i = 0; i < 3; i++) {
+                r += query.half[i] * std::fabs(dot(query.axis[i], plane.normal));
+            }
+            if (d >= r) {
+                continue;
+            }
+            // 中心が平面上にある場合は、一番深い頂点の方向を接触点にする
+            double depth = (d > COLLISION_EPSILON) ? d : r;
+            add_contact(query, query.center - depth * plane.normal, -1.0 * plane.normal, d);
+        }
+    }
+    int build_node(int first, int count)
+    {
+        Node node;
+        node.bounds = items[first].bounds;
+        Aabb centroid_bounds = { items[first].centroid, items[first].centroid };
+        for (int i = first + 1; i < first + count; i++) {
+            node.bounds = merge(node.bounds, items[i].bounds);
+            centroid_bounds = merge(centroid_bounds, Aabb{ items[i].centroid, items[i].centroid });
+        }
+        node.left = -1;
+        node.right = -1;
+        node.first = first;
+        node.count = count;
+        int index = (int)nodes.size();
+        nodes.push_back(node);
+        if (count <= COLLISION_BVH_LEAF_SIZE) {
+            return index;
+        }
+        // 重心の広がりが最も大きい軸で、重心の中央値で分ける
+        const Vector extent = centroid_bounds.max - centroid_bounds.min;
+        int axis = (extent.x >= extent.y) ? ((extent.x >= extent.z) ? 0 : 2) : ((extent.y >= extent.z) ? 1 : 2);
+        int half = count / 2;
+        std::nth_element(items.begin() + first, items.begin() + first + half, items.begin() + first + count,
+            [axis](const Item& a, const Item& b) {
+                return axis_value(a.centroid, axis) < axis_value(b.centroid, axis);
+            });
+        int left = build_node(first, half);
+        int right = build_node(first + half, count - half);
+        nodes[index].left = left;
+        nodes[index].right = right;
+        nodes[index].count = 0;
+        return index;
+    }
+    void add_item(ItemKind kind, int index, const Aabb& bounds)
+    {
+        Item item;
+        item.kind = kind;
+        item.index = index;
+        item.bounds = bounds;
+        item.centroid = 0.5 * (bounds.min + bounds.max);
+        items.push_back(item);
+    }
+
+public:
+    CollisionWorld() : half_size({ 0.0, 0.0, 0.0 }), restitution_coefficient(0.5) {}
+    virtual ~CollisionWorld() {}
+
+    void set_body_size(double x, double y, double z)
+    {
+        this->half_size = { x / 2.0, y / 2.0, z / 2.0 };
+    }
+    void set_restitution_coefficient(double value)
+    {
+        this->restitution_coefficient = value;
+    }
+    /*
+     * point を通り、normal の向きが物体の外側（機体がいる側）の平面
+     */
+    bool add_plane(const Vector& point, const Vector& normal)
+    {
+        double len = hako::drone_physics::length(normal);
+        if (len < COLLISION_EPSILON) {
+            std::cerr << "ERROR: collision plane has no normal" << std::endl;
+            return false;
+        }
+        planes.push_back(Plane{ point, normal / len });
+        return true;
+    }
+    bool add_box(const Vector& center, const Vector& size)
+    {
+        if ((size.x < 0) || (size.y < 0) || (size.z < 0)) {
+            std::cerr << "ERROR: collision box has negative size" << std::endl;
+            return false;
+        }
+        const Vector half = 0.5 * size;
+        boxes.push_back(Aabb{ center - half, center + half });
+        return true;
+    }
+    void add_triangle(const Vector& a, const Vector& b, const Vector& c)
+    {
+        triangles.push_back(Triangle{ a, b, c });
+    }
+    /*
+     * Wavefront OBJ の頂点(v)と面(f)を読み込み、offset だけずらして三角形として追加する。
+     * 多角形の面は扇形に三角形に分ける。
+     */
+    bool load_obj(const std::string& filepath, const Vector& offset)
+    {
+        std::ifstream ifs(filepath);
+        if (!ifs.is_open()) {
+            std::cerr << "ERROR: can not open collision mesh: " << filepath << std::endl;
+            return false;
+        }
+        std::vector<Vector> vertices;
+        std::string line;
+        int line_no = 0;
+        while (std::getline(ifs, line)) {
+            line_no++;
+            std::istringstream iss(line);
+            std::string tag;
+            iss >> tag;
+            if (tag == "v") {
+                Vector v;
+                if (!(iss >> v.x >> v.y >> v.z)) {
+                    std::cerr << "ERROR: invalid vertex: " << filepath << ":" << line_no << std::endl;
+                    return false;
+                }
+                vertices.push_back(v + offset);
+            }
+            else if (tag == "f") {
+                std::vector<int> face;
+                std::string token;
+                while (iss >> token) {
+                    // "v", "v/vt", "v//vn", "v/vt/vn" の v だけ使う。負の番号は末尾からの位置
+                    int index = std::atoi(token.c_str());
+                    index = (index < 0) ? (int)vertices.size() + index : index - 1;
+                    if ((index < 0) || (index >= (int)vertices.size())) {
+                        std::cerr << "ERROR: invalid face: " << filepath << ":" << line_no << std::endl;
+                        return false;
+                    }
+                    face.push_back(index);
+                }
+                for (size_t i = 2; i < face.size(); i++) {
+                    add_triangle(vertices[face[0]], vertices[face[i - 1]], vertices[face[i]]);
+                }
+            }
+        }
+        return true;
+    }
+    /*
+     * 直方体と三角形の BVH を作る
+     */
+    void build()
+    {
+        items.clear();
+        nodes.clear();
+        for (int i = 0; i < (int)boxes.size(); i++) {
+            add_item(ITEM_BOX, i, boxes[i]);
+        }
+        for (int i = 0; i < (int)triangles.size(); i++) {
+            const Triangle& t = triangles[i];
+            add_item(ITEM_TRIANGLE, i, merge(Aabb{ t.a, t.a }, merge(Aabb{ t.b, t.b }, Aabb{ t.c, t.c })));
+        }
+        if (!items.empty()) {
+            nodes.reserve(2 * items.size() / COLLISION_BVH_LEAF_SIZE + 1);
+            (void)build_node(0, (int)items.size());
+        }
+    }
+    int get_plane_num() const
+    {
+        return (int)planes.size();
+    }
+    int get_box_num() const
+    {
+        return (int)boxes.size();
+    }
+    int get_triangle_num() const
+    {
+        return (int)triangles.size();
+    }
+    int get_node_num() const
+    {
+        return (int)nodes.size();
+    }
+
+    bool detect(const DronePositionType& pos, const DroneEulerType& angle, const DroneVelocityType& vel,
+                DroneDynamicsCollisionType& collision) const override
+    {
+        Query query;
+        query.center = pos;
+        query.velocity = vel;
+        const hako::drone_physics::EulerType euler = angle;
+        query.axis[0] = hako::drone_physics::ground_vector_from_body({ 1, 0, 0 }, euler);
+        query.axis[1] = hako::drone_physics::ground_vector_from_body({ 0, 1, 0 }, euler);
+        query.axis[2] = hako::drone_physics::ground_vector_from_body({ 0, 0, 1 }, euler);
+        query.half[0] = half_size.x;
+        query.half[1] = half_size.y;
+        query.half[2] = half_size.z;
+        Vector extent = { 0, 0, 0 };
+        for (int i = 0; i < 3; i++) {
+            extent.x += std::fabs(query.axis[i].x) * query.half[i];
+            extent.y += std::fabs(query.axis[i].y) * query.half[i];
+            extent.z += std::fabs(query.axis[i].z) * query.half[i];
+        }
+        query.bounds = Aabb{ query.center - extent, query.center + extent };
+        query.contact_num = 0;
+
+        test_planes(query);
+        if (nodes.empty()) {
+            for (int i = 0; i < (int)boxes.size(); i++) {
+                test_item(query, ITEM_BOX, i);
+            }
+            for (int i = 0; i < (int)triangles.size(); i++) {
+                test_item(query, ITEM_TRIANGLE, i);
+            }
+        }
+        else {
+            int stack[COLLISION_BVH_STACK_SIZE];
+            int sp = 0;
+            stack[sp++] = 0;
+            while (sp > 0) {
+                const Node& node = nodes[stack[--sp]];
+                if (!overlap(node.bounds, query.bounds)) {
+                    continue;
+                }
+                if (node.left < 0) {
+                    for (int i = node.first; i < node.first + node.count; i++) {
+                        if (overlap(items[i].bounds, query.bounds)) {
+                            test_item(query, items[i].kind, items[i].index);
+                        }
+                    }
+                }
+                else {
+                    stack[sp++] = node.right;
+                    stack[sp++] = node.left;
+                }
+            }
+        }
+
+        collision.collision = (query.contact_num > 0);
+        collision.contact_num = query.contact_num;
+        collision.relative_velocity = query.velocity;
+        for (int i = 0; i < query.contact_num; i++) {
+            collision.contact_position[i] = query.contacts[i].position;
+        }
+        collision.restitution_coefficient = restitution_coefficient;
+        return collision.collision;
+    }
+};
+
+}
+
+#endif /* _COLLISION_WORLD_HPP_ */
@@ -148,10 +148,11 @@ public:
     void run(const DroneDynamicsInputType &input) override 
     {
         (void)input;
+        const DroneVelocityType prev_velocity = this->velocity;
         DroneTorqueType torque = input.torque;
         DroneThrustType thrust = input.thrust;
         drone_physics::AccelerationType acc = drone_physics::acceleration_in_ground_frame(
-                                                            this->velocity, this->angle, 
+                                                            this->velocity, this->angle, this->wind,
                                                             thrust.data, this->param_mass, GRAVITY, this->param_drag1, this->param_drag2);
         drone_physics::EulerAccelerationType acc_angular_body = drone_physics::euler_acceleration_in_ground_frame(
                                                             this->angularVelocity, this->angle,
@@ -163,27 +164,58 @@ public:
         this->angularVelocity.data = integral(this->angularVelocity.data, 
                                     {acc_angular_body.phi, acc_angular_body.theta, acc_angular_body.psi});
 
+        //collision detection
+        if (param_collision_detection && input.collision.collision) {
+            hako::drone_physics::VectorType contact_position = {
+                input.collision.contact_position[0].x,
+                input.collision.contact_position[0].y,
+                input.collision.contact_position[0].z
+            };
+            this->velocity = hako::drone_physics::velocity_after_contact_with_wall(
+                    this->velocity, this->position, contact_position, input.collision.restitution_coefficient);
+        }
+
         //integral to pos, angle on ground frame
         this->position.data = integral(this->position.data, this->velocity.data);
         this->angle.data = integral(this->angle.data, this->angularVelocity.data);
         //boundary condition
-        if (this->position.data.z > 0) {
+        if (this->terrain != nullptr) {
+            this->run_ground_contact(this->position, this->velocity, this->delta_time_sec);
+        }
+        else if (this->position.data.z > 0) {
             this->position.data.z = 0;
             this->velocity.data.z = 0;
         }        
+        this->update_specific_force(prev_velocity, this->velocity, this->angle, this->delta_time_sec);
         this->total_time_sec += this->delta_time_sec;
     }
+    void save_state(StateSnapshot& snapshot) const override
+    {
+        snapshot.put(this->position);
+        snapshot.put(this->velocity);
+        snapshot.put(this->angle);
+        snapshot.put(this->angularVelocity);
+        snapshot.put(this->total_time_sec);
+        snapshot.put(this->cache);
+    }
+    bool restore_state(StateSnapshot& snapshot) override
+    {
+        return snapshot.get(this->position)
+            && snapshot.get(this->velocity)
+            && snapshot.get(this->angle)
+            && snapshot.get(this->angularVelocity)
+            && snapshot.get(this->total_time_sec)
+            && snapshot.get(this->cache);
+    }
     const std::vector<std::string> log_head() override
     {
         return { "timestamp", "X", "Y", "Z", "Rx", "Ry", "Rz" };
     }
-    const std::vector<std::string> log_data() override
+    void log_fields(LogRecord& record) override
     {
-        return {
-            std::to_string(CsvLogger::get_time_usec()), 
-            std::to_string(position.data.x), std::to_string(position.data.y), std::to_string(position.data.z),
-            std::to_string(angle.data.x), std::to_string(angle.data.y), std::to_string(angle.data.z)
-            };
+        record.add(CsvLogger::get_time_usec())
+              .add(position.data.x).add(position.data.y).add(position.data.z)
+              .add(angle.data.x).add(angle.data.y).add(angle.data.z);
     }
 
 };
@@ -0,0 +1,222 @@
+#ifndef _ROTOR_BANK_HPP_
+#define _ROTOR_BANK_HPP_
+
+#include "drone_primitive_types.hpp"
+#include "irotor_bank.hpp"
+#include "utils/icsv_log.hpp"
+#include "utils/csv_logger.hpp"
+#include <iostream>
+#include <math.h>
+#include <vector>
+
+namespace hako::assets::drone {
+
+typedef enum {
+    ROTOR_BANK_MODEL_FIRST_ORDER = 0,   // RotorDynamics と同じ1次遅れ（オイラー法、回転数を 0〜rpmMax に制限）
+    ROTOR_BANK_MODEL_JMAVSIM,           // RotorDynamicsJmavsim と同じ1次遅れ（厳密な離散化）
+} RotorBankModelType;
+
+/*
+ * ロータを回す DC モータ（set_motor_params() を呼ばなければ使わない）
+ */
+typedef struct {
+    double kv;                  // 回転数定数 [RPM/V]（トルク定数 Kt = 60 / (2 pi Kv) [N m/A]）
+    double resistance;          // 巻線抵抗 [Ohm]
+    double no_load_current;     // 無負荷電流 [A]
+    double torque_coefficient;  // プロペラの負荷トルク = torque_coefficient * RPM^2 [N m]
+    double esc_efficiency;
+} RotorMotorParamType;
+
+/*
+ * 任意の数のロータの1次遅れモデル。
+ *
+ * ロータごとの仮想関数呼び出しをやめ、全ロータの状態を配列に持って1つのループで計算する。
+ * 時定数と刻み幅は一定なので、離散化の係数は set_params() で計算しておく。
+ * ログはロータごとのファイル（timestamp, RPM）に出力する（get_rotor_log()）。
+ *
+ * モータのパラメータがある場合は、回転数から各モータの電流 I = Q / Kt + I0（Q は負荷トルク）と
+ * 電力 (RPM / Kv + I R) I を同じく配列で計算し、ESC の効率で割って電源の負荷とする。
+ * 目標回転数は電源電圧の比（set_supply_voltage_ratio()）に比例させ、電圧が下がると回転数も下がる。
+ */
+class RotorBank : public hako::assets::drone::IRotorBank {
+public:
+    class RotorLog : public ICsvLog {
+    private:
+        const RotorBank *bank;
+        int index;
+    public:
+        RotorLog(const RotorBank *b, int i) : bank(b), index(i) {}
+        virtual ~RotorLog() {}
+        const std::vector<std::string> log_head() override
+        {
+            return { "timestamp", "RPM" };
+        }
+        void log_fields(LogRecord& record) override
+        {
+            record.add(CsvLogger::get_time_usec()).add(bank->speed[index].data);
+        }
+    };
+
+private:
+    RotorBankModelType model;
+    double delta_time_sec;
+    double total_time_sec;
+    double param_rpm_max = 6000.0;
+    double param_tr = 1.0;
+    double param_kr = 1.0;
+    /*
+     * 離散化の係数
+     *   FIRST_ORDER: speed += (kr * control - speed) * gain,  gain = dt / tr
+     *   JMAVSIM:     w += (control - w) * gain,  gain = 1 - exp(-dt / tr),  speed = w * kr
+     */
+    double gain;
+    double supply_voltage_ratio;
+    std::vector<double> state;
+    std::vector<DroneRotorSpeedType> speed;
+    std::vector<RotorLog> logs;
+
+    bool motor_enable;
+    RotorMotorParamType motor;
+    double motor_torque_per_kt;     // torque_coefficient / Kt
+    std::vector<double> motor_current;
+    double load_power;
+
+    void update_gain()
+    {
+        if (this->model == ROTOR_BANK_MODEL_JMAVSIM) {
+            this->gain = 1.0 - exp(-this->delta_time_sec / this->param_tr);
+        }
+        else {
+            this->gain = this->delta_time_sec / this->param_tr;
+        }
+    }
+
+public:
+    RotorBank(double dt, int rotor_num, RotorBankModelType m = ROTOR_BANK_MODEL_FIRST_ORDER)
+        : model(m), delta_time_sec(dt), total_time_sec(0), supply_voltage_ratio(1.0),
+          state(rotor_num, 0.0), speed(rotor_num, DroneRotorSpeedType{ 0.0 }),
+          motor_enable(false), motor(), motor_torque_per_kt(0), motor_current(rotor_num, 0.0), load_power(0)
+    {
+        logs.reserve(rotor_num);
+        for (int i = 0; i < rotor_num; i++) {
+            logs.emplace_back(this, i);
+        }
+        update_gain();
+    }
+    virtual ~RotorBank() {}
+    void set_params(double rpm_max, double tr, double kr)
+    {
+        this->param_rpm_max = rpm_max;
+        this->param_tr = tr;
+        this->param_kr = kr;
+        update_gain();
+    }
+    bool set_motor_params(const RotorMotorParamType& param)
+    {
+        if ((param.kv <= 0) || (param.resistance < 0) || (param.no_load_current < 0)
+            || (param.torque_coefficient < 0) || (param.esc_efficiency <= 0) || (param.esc_efficiency > 1)) {
+            std::cerr << "ERROR: invalid motor parameter" << std::endl;
+            return false;
+        }
+        const double kt = 60.0 / (2.0 * M_PI * param.kv);
+        this->motor = param;
+        this->motor_torque_per_kt = param.torque_coefficient / kt;
+        this->motor_enable = true;
+        return true;
+    }
+    void set_supply_voltage_ratio(double ratio) override
+    {
+        this->supply_voltage_ratio = (ratio > 0) ? ratio : 0.0;
+    }
+    double get_load_power() const override
+    {
+        return this->load_power;
+    }
+    // 各モータの電流 [A]（get_rotor_num() 個の配列）
+    const double* get_motor_currents() const
+    {
+        return this->motor_current.data();
+    }
+    int get_rotor_num() const override
+    {
+        return (int)this->speed.size();
+    }
+    void set_rotor_speed(int index, const DroneRotorSpeedType &rotor_speed) override
+    {
+        this->speed[index] = rotor_speed;
+        this->state[index] = (this->model == ROTOR_BANK_MODEL_JMAVSIM) ? rotor_speed.data / this->param_kr : rotor_speed.data;
+    }
+    const DroneRotorSpeedType* get_rotor_speeds() const override
+    {
+        return this->speed.data();
+    }
+    void run(const double *controls) override
+    {
+        const int n = get_rotor_num();
+        double *w = this->state.data();
+        DroneRotorSpeedType *out = this->speed.data();
+        const double g = this->gain;
+        const double kr = this->param_kr;
+        const double ratio = this->supply_voltage_ratio;
+        if (this->model == ROTOR_BANK_MODEL_JMAVSIM) {
+            for (int i = 0; i < n; i++) {
+                w[i] += (controls[i] * ratio - w[i]) * g;
+                out[i].data = w[i] * kr;
+            }
+        }
+        else {
+            const double rpm_max = this->param_rpm_max;
+            const double kr_ratio = kr * ratio;
+            for (int i = 0; i < n; i++) {
+                double next = w[i] + (kr_ratio * controls[i] - w[i]) * g;
+                next = (next > rpm_max) ? rpm_max : next;
+                next = (next < 0.0) ? 0.0 : next;
+                w[i] = next;
+                out[i].data = next;
+            }
+        }
+        if (this->motor_enable) {
+            double *current = this->motor_current.data();
+            const double q = this->motor_torque_per_kt;
+            const double i0 = this->motor.no_load_current;
+            const double rm = this->motor.resistance;
+            const double inv_kv = 1.0 / this->motor.kv;
+            double power = 0;
+            for (int i = 0; i < n; i++) {
+                double rpm = out[i].data;
+                double c = q * rpm * rpm + ((rpm > 0) ? i0 : 0.0);
+                current[i] = c;
+                power += (rpm * inv_kv + c * rm) * c;
+            }
+            this->load_power = power / this->motor.esc_efficiency;
+        }
+        this->total_time_sec += this->delta_time_sec;
+    }
+    // ロータ index のログ（CsvLogger::add_entry() に渡す）
+    ICsvLog& get_rotor_log(int index)
+    {
+        return this->logs[index];
+    }
+    void save_state(StateSnapshot& snapshot) const override
+    {
+        snapshot.put(this->state);
+        snapshot.put(this->speed);
+        snapshot.put(this->total_time_sec);
+    }
+    bool restore_state(StateSnapshot& snapshot) override
+    {
+        std::vector<double> saved_state;
+        std::vector<DroneRotorSpeedType> saved_speed;
+        if (!snapshot.get(saved_state) || !snapshot.get(saved_speed)
+            || (saved_state.size() != this->state.size()) || (saved_speed.size() != this->speed.size())) {
+            return false;
+        }
+        this->state = saved_state;
+        this->speed = saved_speed;
+        return snapshot.get(this->total_time_sec);
+    }
+};
+
+}
+
+#endif /* _ROTOR_BANK_HPP_ */
@@ -62,14 +62,26 @@ public:
         this->speed.data = this->next_speed.data;
         this->total_time_sec += this->delta_time_sec;
     }
+    void save_state(StateSnapshot& snapshot) const override
+    {
+        snapshot.put(this->speed);
+        snapshot.put(this->next_speed);
+        snapshot.put(this->total_time_sec);
+    }
+    bool restore_state(StateSnapshot& snapshot) override
+    {
+        return snapshot.get(this->speed)
+            && snapshot.get(this->next_speed)
+            && snapshot.get(this->total_time_sec);
+    }
     const std::vector<std::string> log_head() override
     {
         return { "timestamp", "RPM" };
     }
-    const std::vector<std::string> log_data() override
+    void log_fields(LogRecord& record) override
     {
         DroneRotorSpeedType v = get_rotor_speed();
-        return {std::to_string(CsvLogger::get_time_usec()), std::to_string(v.data)};
+        record.add(CsvLogger::get_time_usec()).add(v.data);
     }
 };
 
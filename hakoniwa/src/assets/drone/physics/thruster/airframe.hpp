@@ -0,0 +1,78 @@
+#ifndef _AIRFRAME_HPP_
+#define _AIRFRAME_HPP_
+
+#include "drone_primitive_types.hpp"
+#include <math.h>
+#include <string>
+#include <vector>
+#include <iostream>
+
+namespace hako::assets::drone {
+
+/*
+ * 機体形状（ロータの配置と回転方向）の定義。
+ *
+ * ロータの位置は機体座標系（x: 前, y: 右, z: 下）で、
+ * 角度は機首方向から上から見て時計回り、回転方向は CW: -1, CCW: 1。
+ * 番号順は PX4 の汎用機体（Generic Quadcopter/Hexacopter/Octocopter）のモータ番号に合わせている。
+ */
+typedef struct {
+    double angle_deg;
+    double ccw;
+    int layer;      // 同軸反転の上段: -1, 下段: 1, それ以外: 0
+} AirframeRotorType;
+
+typedef struct {
+    const char *name;
+    int rotor_num;
+    AirframeRotorType rotors[8];
+} AirframeType;
+
+static const AirframeType airframe_table[] = {
+    { "quad_x", 4, {
+        {  45, 1, 0 }, { 225, 1, 0 }, { 315, -1, 0 }, { 135, -1, 0 } } },
+    { "quad_plus", 4, {
+        {  90, 1, 0 }, { 270, 1, 0 }, {   0, -1, 0 }, { 180, -1, 0 } } },
+    { "hexa_x", 6, {
+        {  90, -1, 0 }, { 270, 1, 0 }, { 330, -1, 0 }, { 150, 1, 0 }, {  30, 1, 0 }, { 210, -1, 0 } } },
+    { "hexa_plus", 6, {
+        {   0, -1, 0 }, { 180, 1, 0 }, { 240, -1, 0 }, {  60, 1, 0 }, { 300, 1, 0 }, { 120, -1, 0 } } },
+    { "octa_x", 8, {
+        { 22.5, -1, 0 }, { 202.5, -1, 0 }, { 337.5, 1, 0 }, { 112.5, 1, 0 },
+        { 67.5, 1, 0 }, { 292.5, 1, 0 }, { 157.5, -1, 0 }, { 247.5, -1, 0 } } },
+    { "octa_plus", 8, {
+        {   0, -1, 0 }, { 180, -1, 0 }, { 315, 1, 0 }, { 135, 1, 0 },
+        {  45, 1, 0 }, { 225, 1, 0 }, {  90, -1, 0 }, { 270, -1, 0 } } },
+    // 同軸反転のクアッド X（X8）: 1〜4 が上段、5〜8 がその下の段で、上段と逆向きに回転する
+    { "coaxial_x8", 8, {
+        {  45, 1, -1 }, { 315, -1, -1 }, { 225, 1, -1 }, { 135, -1, -1 },
+        { 315, 1, 1 }, {  45, -1, 1 }, { 135, 1, 1 }, { 225, -1, 1 } } },
+};
+
+/*
+ * name の機体形状のロータ配置を rotor_config に設定する。
+ * arm_length_m: 機体中心からロータまでの水平距離、coaxial_height_m: 同軸反転の上段と下段の間隔
+ */
+static inline bool airframe_rotor_config(const std::string& name, double arm_length_m, double coaxial_height_m,
+                                         std::vector<RotorConfigType>& rotor_config)
+{
+    for (const auto& airframe : airframe_table) {
+        if (name != airframe.name) {
+            continue;
+        }
+        rotor_config.resize(airframe.rotor_num);
+        for (int i = 0; i < airframe.rotor_num; i++) {
+            const AirframeRotorType& rotor = airframe.rotors[i];
+            double rad = rotor.angle_deg * M_PI / 180.0;
+            rotor_config[i].ccw = rotor.ccw;
+            rotor_config[i].data = { arm_length_m * cos(rad), arm_length_m * sin(rad), rotor.layer * coaxial_height_m / 2.0 };
+        }
+        return true;
+    }
+    std::cerr << "ERROR: unknown airframe: " << name << std::endl;
+    return false;
+}
+
+}
+
+#endif /* _AIRFRAME_HPP_ */
@@ -5,8 +5,10 @@
 #include "ithrust_dynamics.hpp"
 #include "utils/icsv_log.hpp"
 #include "rotor_physics.hpp"
+#include "thrust_mixer.hpp"
 #include <glm/glm.hpp>
 #include <iostream>
+#include <vector>
 
 namespace hako::assets::drone {
 
@@ -19,12 +21,11 @@ private:
     double param_Jr;
     DroneThrustType thrust;
     DroneTorqueType torque;
-    DroneRotorSpeedType prev_rotor_speed[ROTOR_NUM];
-    RotorConfigType rotor_config[ROTOR_NUM];
-    double omega[ROTOR_NUM];
-    drone_physics::VectorType position[ROTOR_NUM];
-    double ccw[ROTOR_NUM];
-    double omega_acceleration[ROTOR_NUM];
+    std::vector<RotorConfigType> rotor_config;
+    std::vector<DroneRotorSpeedType> prev_rotor_speed;
+    std::vector<double> omega;
+    std::vector<double> omega_acceleration;
+    ThrustMixer mixer;
 
 public:
     ThrustDynamicsNonLinear(double dt)
@@ -38,15 +39,16 @@ public:
         this->param_B = 1.0 / (ROTOR_NUM * HOVERING_ROTOR_RPM * HOVERING_ROTOR_RPM);
         this->param_Jr = 0.1;
 
-        this->rotor_config[0].ccw = -1;
-        this->rotor_config[0].data = { 0.3, 0.0, 0 };
-        this->rotor_config[1].ccw = 1;
-        this->rotor_config[1].data = { 0.0, -0.3, 0 };
-        this->rotor_config[2].ccw = -1;
-        this->rotor_config[2].data = { -0.3, 0.0, 0 };
-        this->rotor_config[3].ccw = 1;
-        this->rotor_config[3].data = { 0.0, 0.3, 0 };
-        set_rotor_config(rotor_config);
+        RotorConfigType config[ROTOR_NUM];
+        config[0].ccw = -1;
+        config[0].data = { 0.3, 0.0, 0 };
+        config[1].ccw = 1;
+        config[1].data = { 0.0, -0.3, 0 };
+        config[2].ccw = -1;
+        config[2].data = { -0.3, 0.0, 0 };
+        config[3].ccw = 1;
+        config[3].data = { 0.0, 0.3, 0 };
+        set_rotor_config(config);
     }
     virtual ~ThrustDynamicsNonLinear() {}
 
@@ -55,15 +57,21 @@ public:
         this->param_A = a;
         this->param_B = b;
         this->param_Jr = jr;
+        this->mixer.init(this->rotor_config, param_A, param_B, param_Jr);
     }
 
-    void set_rotor_config(const RotorConfigType rotor_config[ROTOR_NUM]) override
+    using IThrustDynamics::set_rotor_config;
+    void set_rotor_config(const RotorConfigType rotor_config[], int rotor_num) override
     {
-        for (int i = 0; i < ROTOR_NUM; i++) {
-            this->rotor_config[i] = rotor_config[i];
-            this->position[i] = {rotor_config[i].data.x, rotor_config[i].data.y, rotor_config[i].data.z};
-            this->ccw[i] = rotor_config[i].ccw;
-        }
+        this->rotor_config.assign(rotor_config, rotor_config + rotor_num);
+        this->prev_rotor_speed.assign(rotor_num, DroneRotorSpeedType{ 0.0 });
+        this->omega.assign(rotor_num, 0.0);
+        this->omega_acceleration.assign(rotor_num, 0.0);
+        this->mixer.init(this->rotor_config, param_A, param_B, param_Jr);
+    }
+    int get_rotor_num() const override
+    {
+        return (int)this->rotor_config.size();
     }
     void set_thrust(const DroneThrustType &thrust) override 
     {
@@ -83,19 +91,16 @@ public:
         return this->torque;
     }
 
-    void run(const DroneRotorSpeedType rotor_speed[ROTOR_NUM]) override
+    void run(const DroneRotorSpeedType rotor_speed[]) override
     {
-        for (int i = 0; i < ROTOR_NUM; i++) {
+        const int n = get_rotor_num();
+        for (int i = 0; i < n; i++) {
             omega[i] = rotor_speed[i].data;
-            omega_acceleration[i] = (rotor_speed[i].data - this->prev_rotor_speed[i].data) / this->delta_time_sec;
-        }
-        this->thrust.data = drone_physics::body_thrust(param_A, ROTOR_NUM, omega);
-        this->torque = drone_physics::body_torque(param_A, param_B, param_Jr, ROTOR_NUM,
-                                            position, ccw, omega, omega_acceleration);
-
-        for (int i = 0; i < ROTOR_NUM; i++) {
+            omega_acceleration[i] = (omega[i] - this->prev_rotor_speed[i].data) / this->delta_time_sec;
             this->prev_rotor_speed[i] = rotor_speed[i];
         }
+        // 推力とトルクは rotor_physics の body_thrust()/body_torque() と同じ式を混合行列で求める
+        mixer.mix(omega.data(), omega_acceleration.data(), this->thrust, this->torque);
 
         total_time_sec += delta_time_sec;
     }
@@ -108,16 +113,41 @@ public:
                   << " , " << this->torque.data.z 
                   << " )" << std::endl;
     }
+    void save_state(StateSnapshot& snapshot) const override
+    {
+        snapshot.put(this->total_time_sec);
+        snapshot.put(this->thrust);
+        snapshot.put(this->torque);
+        snapshot.put(this->prev_rotor_speed);
+        snapshot.put(this->omega_acceleration);
+    }
+    bool restore_state(StateSnapshot& snapshot) override
+    {
+        std::vector<DroneRotorSpeedType> saved_speed;
+        std::vector<double> saved_acceleration;
+        if (!snapshot.get(this->total_time_sec)
+            || !snapshot.get(this->thrust)
+            || !snapshot.get(this->torque)
+            || !snapshot.get(saved_speed)
+            || !snapshot.get(saved_acceleration)
+            || ((int)saved_speed.size() != get_rotor_num())
+            || ((int)saved_acceleration.size() != get_rotor_num())) {
+            return false;
+        }
+        this->prev_rotor_speed = saved_speed;
+        this->omega_acceleration = saved_acceleration;
+        return true;
+    }
     const std::vector<std::string> log_head() override
     {
         return { "timestamp", "Thrust", "Tx", "Ty", "Tz" };
     }
-    const std::vector<std::string> log_data() override
+    void log_fields(LogRecord& record) override
     {
         DroneThrustType thrust = get_thrust();
         DroneTorqueType torque = get_torque();
 
-        return {std::to_string(CsvLogger::get_time_usec()), std::to_string(thrust.data), std::to_string(torque.data.x), std::to_string(torque.data.y), std::to_string(torque.data.z)};
+        record.add(CsvLogger::get_time_usec()).add(thrust.data).add(torque.data.x).add(torque.data.y).add(torque.data.z);
     }
 
 };
@@ -0,0 +1,69 @@
+#ifndef _THRUST_MIXER_HPP_
+#define _THRUST_MIXER_HPP_
+
+#include "drone_primitive_types.hpp"
+#include "rotor_physics.hpp"
+#include <vector>
+
+namespace hako::assets::drone {
+
+/*
+ * ロータの回転数から機体の推力・トルクを求める混合行列。
+ *
+ * 行列は drone_physics の RotorMixer が持ち、ロータの配置とパラメータを設定したときに1回だけ作る。
+ * 列 i は [ A, -A y_i, A x_i, ccw_i B ] で、非線形モデルでは回転数の2乗、線形モデルでは回転数に掛ける。
+ */
+class ThrustMixer {
+private:
+    hako::drone_physics::RotorMixer mixer;
+
+    static void to_thrust_torque(const hako::drone_physics::ThrustTorqueType& result, DroneThrustType& thrust, DroneTorqueType& torque)
+    {
+        thrust.data = result.thrust;
+        torque.data = { result.torque.x, result.torque.y, result.torque.z };
+    }
+
+public:
+    ThrustMixer() {}
+    virtual ~ThrustMixer() {}
+
+    void init(const std::vector<RotorConfigType>& rotor_config, double A, double B, double Jr)
+    {
+        const int rotor_num = (int)rotor_config.size();
+        std::vector<hako::drone_physics::VectorType> position(rotor_num);
+        std::vector<double> ccw(rotor_num);
+        for (int i = 0; i < rotor_num; i++) {
+            position[i] = { rotor_config[i].data.x, rotor_config[i].data.y, rotor_config[i].data.z };
+            ccw[i] = rotor_config[i].ccw;
+        }
+        this->mixer = hako::drone_physics::RotorMixer(A, B, Jr, rotor_num, position.data(), ccw.data());
+    }
+    int get_rotor_num() const
+    {
+        return (int)mixer.rotor_num();
+    }
+    // 行 row, 列 col の要素
+    double get(int row, int col) const
+    {
+        return mixer.get(row, col);
+    }
+    /*
+     * 非線形モデル（body_thrust()/body_torque() と同じ）
+     * omega, omega_acceleration: rotor_num 個の配列（omega_acceleration は省略可）
+     */
+    void mix(const double omega[], const double omega_acceleration[], DroneThrustType& thrust, DroneTorqueType& torque) const
+    {
+        to_thrust_torque(mixer.thrust_torque(omega, omega_acceleration), thrust, torque);
+    }
+    /*
+     * 線形モデル（body_thrust_linear()/body_torque_linear() と同じ）
+     */
+    void mix_linear(const double omega[], DroneThrustType& thrust, DroneTorqueType& torque) const
+    {
+        to_thrust_torque(mixer.thrust_torque_linear(omega), thrust, torque);
+    }
+};
+
+}
+
+#endif /* _THRUST_MIXER_HPP_ */
@@ -0,0 +1,221 @@
+#ifndef _WIND_MODEL_HPP_
+#define _WIND_MODEL_HPP_
+
+#include "iwind.hpp"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace hako::assets::drone {
+
+/*
+ * 風速 = 一定の風 + 突風 + 乱流。
+ *
+ * 突風は 1-cos 型で、start_sec から duration_sec の間に amplitude まで強まって元に戻る。
+ * 乱流は Dryden または von Karman のパワースペクトル（MIL-HDBK-1797）を持つ時系列を、
+ * init_turbulence() で逆 FFT により samples 点（2 のべき乗）まとめて作っておき、
+ * 毎ステップはその表を順に読む（表の終わりで先頭に戻る）。
+ * 乱流は平均風速 airspeed で流れてくる凍結乱流とし、風の軸（縦・横・上下）で作っておく。
+ * 縦は一定の風の水平方向（風が吹いていく向き）で、run() で NED に回転する。一定の風がなければ縦は x とする。
+ * 表の長さで切れる低い周波数の分だけ分散が小さくなるので、各成分の標準偏差が intensity になるように補正する。
+ */
+#define WIND_TURBULENCE_MAX_SAMPLES     (1 << 22)
+
+typedef enum {
+    WIND_TURBULENCE_DRYDEN = 0,
+    WIND_TURBULENCE_VON_KARMAN,
+} WindTurbulenceModel;
+
+typedef struct {
+    WindTurbulenceModel model;
+    double intensity[3];        // 標準偏差 [m/s]
+    double length_scale[3];     // スケール長 [m]
+    double airspeed;            // 乱流が流れてくる速さ [m/s]
+    int samples;
+} WindTurbulenceParamType;
+
+typedef struct {
+    double start_sec;
+    double duration_sec;
+    DroneVelocityType amplitude;
+} WindGustType;
+
+class WindModel : public IWind {
+private:
+    double delta_time_sec;
+    uint64_t step;
+    DroneVelocityType constant;
+    std::vector<WindGustType> gusts;
+    std::vector<drone_physics::VectorType> turbulence;     // 風の軸（縦・横・上下）
+    size_t turbulence_mask;
+    double heading_cos;     // 一定の風の向き（風の軸から NED への回転）
+    double heading_sin;
+
+    /*
+     * 片側パワースペクトル密度（空間周波数 Omega [rad/m]）
+     */
+    static double psd(WindTurbulenceModel model, bool longitudinal, double sigma, double L, double Omega)
+    {
+        double x = L * Omega;
+        if (model == WIND_TURBULENCE_DRYDEN) {
+            if (longitudinal) {
+                return sigma * sigma * (2.0 * L / M_PI) / (1.0 + x * x);
+            }
+            return sigma * sigma * (L / M_PI) * (1.0 + 3.0 * x * x) / ((1.0 + x * x) * (1.0 + x * x));
+        }
+        double a = 1.339 * x;
+        if (longitudinal) {
+            return sigma * sigma * (2.0 * L / M_PI) / std::pow(1.0 + a * a, 5.0 / 6.0);
+        }
+        return sigma * sigma * (L / M_PI) * (1.0 + (8.0 / 3.0) * a * a) / std::pow(1.0 + a * a, 11.0 / 6.0);
+    }
+    static void inverse_fft(std::vector<std::complex<double>>& a)
+    {
+        const size_t n = a.size();
+        for (size_t i = 1, j = 0; i < n; i++) {
+            size_t bit = n >> 1;
+            for (; j & bit; bit >>= 1) {
+                j ^= bit;
+            }
+            j ^= bit;
+            if (i < j) {
+                std::swap(a[i], a[j]);
+            }
+        }
+        for (size_t len = 2; len <= n; len <<= 1) {
+            double angle = 2.0 * M_PI / (double)len;
+            std::complex<double> wlen(std::cos(angle), std::sin(angle));
+            for (size_t i = 0; i < n; i += len) {
+                std::complex<double> w(1.0, 0.0);
+                for (size_t j = 0; j < len / 2; j++) {
+                    std::complex<double> u = a[i + j];
+                    std::complex<double> v = a[i + j + len / 2] * w;
+                    a[i + j] = u + v;
+                    a[i + j + len / 2] = u - v;
+                    w *= wlen;
+                }
+            }
+        }
+    }
+
+public:
+    WindModel(double dt) : delta_time_sec(dt), step(0), turbulence_mask(0), heading_cos(1.0), heading_sin(0.0)
+    {
+        constant.data = { 0, 0, 0 };
+    }
+    virtual ~WindModel() {}
+
+    void set_constant(const DroneVelocityType& wind)
+    {
+        this->constant = wind;
+        double horizontal = std::hypot(wind.data.x, wind.data.y);
+        if (horizontal > 0) {
+            heading_cos = wind.data.x / horizontal;
+            heading_sin = wind.data.y / horizontal;
+        }
+        else {
+            heading_cos = 1.0;
+            heading_sin = 0.0;
+        }
+    }
+    bool add_gust(const WindGustType& gust)
+    {
+        if (gust.duration_sec <= 0) {
+            std::cerr << "ERROR: invalid gust duration: " << gust.duration_sec << std::endl;
+            return false;
+        }
+        this->gusts.push_back(gust);
+        return true;
+    }
+    size_t get_turbulence_samples() const
+    {
+        return turbulence.size();
+    }
+    bool init_turbulence(const WindTurbulenceParamType& param, uint32_t seed)
+    {
+        const int n = param.samples;
+        if ((n < 2) || (n > WIND_TURBULENCE_MAX_SAMPLES) || ((n & (n - 1)) != 0) || (param.airspeed <= 0)) {
+            std::cerr << "ERROR: invalid turbulence parameter (samples must be a power of 2)" << std::endl;
+            return false;
+        }
+        for (int axis = 0; axis < 3; axis++) {
+            if ((param.intensity[axis] < 0) || (param.length_scale[axis] <= 0)) {
+                std::cerr << "ERROR: invalid turbulence intensity or length scale" << std::endl;
+                return false;
+            }
+        }
+        std::mt19937 gen(seed);
+        std::uniform_real_distribution<double> phase(0.0, 2.0 * M_PI);
+        const double d_omega = 2.0 * M_PI / (n * delta_time_sec);
+        std::vector<std::complex<double>> spectrum(n);
+        std::vector<double> series[3];
+        for (int axis = 0; axis < 3; axis++) {
+            std::fill(spectrum.begin(), spectrum.end(), std::complex<double>(0.0, 0.0));
+            // x(t) = sum(A_k cos(w_k t + phi_k)), A_k = sqrt(2 S(w_k) dw), S(w) = Phi(w / V) / V
+            for (int k = 1; k < n / 2; k++) {
+                double omega = k * d_omega;
+                double s = psd(param.model, axis == 0, param.intensity[axis], param.length_scale[axis],
+                               omega / param.airspeed) / param.airspeed;
+                spectrum[k] = std::polar(std::sqrt(2.0 * s * d_omega), phase(gen));
+            }
+            inverse_fft(spectrum);
+            series[axis].resize(n);
+            double sum2 = 0;
+            for (int i = 0; i < n; i++) {
+                series[axis][i] = spectrum[i].real();
+                sum2 += series[axis][i] * series[axis][i];
+            }
+            double rms = std::sqrt(sum2 / n);
+            double scale = (rms > 0) ? (param.intensity[axis] / rms) : 0.0;
+            for (int i = 0; i < n; i++) {
+                series[axis][i] *= scale;
+            }
+        }
+        turbulence.resize(n);
+        for (int i = 0; i < n; i++) {
+            turbulence[i] = { series[0][i], series[1][i], series[2][i] };
+        }
+        turbulence_mask = (size_t)n - 1;
+        return true;
+    }
+    DroneVelocityType run() override
+    {
+        drone_physics::VectorType wind = constant;
+        if (!gusts.empty()) {
+            double t = step * delta_time_sec;
+            for (const auto& gust : gusts) {
+                double r = (t - gust.start_sec) / gust.duration_sec;
+                if ((r > 0) && (r < 1)) {
+                    double k = 0.5 * (1.0 - std::cos(2.0 * M_PI * r));
+                    wind.x += k * gust.amplitude.data.x;
+                    wind.y += k * gust.amplitude.data.y;
+                    wind.z += k * gust.amplitude.data.z;
+                }
+            }
+        }
+        if (!turbulence.empty()) {
+            const auto& v = turbulence[step & turbulence_mask];
+            wind.x += heading_cos * v.x - heading_sin * v.y;
+            wind.y += heading_sin * v.x + heading_cos * v.y;
+            wind.z += v.z;
+        }
+        step++;
+        return DroneVelocityType(wind);
+    }
+    void save_state(StateSnapshot& snapshot) const override
+    {
+        snapshot.put(this->step);
+    }
+    bool restore_state(StateSnapshot& snapshot) override
+    {
+        return snapshot.get(this->step);
+    }
+};
+
+}
+
+#endif /* _WIND_MODEL_HPP_ */
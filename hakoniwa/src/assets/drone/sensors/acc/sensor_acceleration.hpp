@@ -16,6 +16,22 @@ private:
     hako::assets::drone::SensorDataAssembler acc_x;
     hako::assets::drone::SensorDataAssembler acc_y;
     hako::assets::drone::SensorDataAssembler acc_z;
+    DroneAccelerationBodyFrameType sample;
+    DroneAccelerationBodyFrameType calculate_value()
+    {
+        DroneAccelerationBodyFrameType value;
+        value.data.x = this->acc_x.get_calculated_value() / this->delta_time_sec;
+        value.data.y = this->acc_y.get_calculated_value() / this->delta_time_sec;
+        value.data.z = this->acc_z.get_calculated_value() / this->delta_time_sec;
+        value.data.z -= GRAVITY;
+        if (this->noise != nullptr) {
+            value.data.x = this->noise->add_random_noise(value.data.x);
+            value.data.y = this->noise->add_random_noise(value.data.y);
+            value.data.z = this->noise->add_random_noise(value.data.z);
+        }
+        return value;
+    }
+
 public:
     SensorAcceleration(double dt, int sample_num) : delta_time_sec(dt), acc_x(sample_num), acc_y(sample_num), acc_z(sample_num) 
     {
@@ -35,20 +51,15 @@ public:
         }
         this->prev_data = data;
         total_time_sec += delta_time_sec;
+        next_step();
     }
     DroneAccelerationBodyFrameType sensor_value() override
     {
-        DroneAccelerationBodyFrameType value;
-        value.data.x = this->acc_x.get_calculated_value() / this->delta_time_sec;
-        value.data.y = this->acc_y.get_calculated_value() / this->delta_time_sec;
-        value.data.z = this->acc_z.get_calculated_value() / this->delta_time_sec;
-        value.data.z -= GRAVITY;
-        if (this->noise != nullptr) {
-            value.data.x = this->noise->add_random_noise(value.data.x);
-            value.data.y = this->noise->add_random_noise(value.data.y);
-            value.data.z = this->noise->add_random_noise(value.data.z);
+        if (!this->sample_valid) {
+            this->sample = calculate_value();
+            this->sample_valid = true;
         }
-        return value;
+        return this->sample;
     }
 
     void print() override
@@ -63,15 +74,37 @@ public:
                     << " )" 
                     << std::endl;
     }
+    void save_state(StateSnapshot& snapshot) const override
+    {
+        save_sensor_state(snapshot);
+        snapshot.put(this->total_time_sec);
+        snapshot.put(this->sample);
+        snapshot.put(this->has_prev_data);
+        snapshot.put(this->prev_data);
+        this->acc_x.save_state(snapshot);
+        this->acc_y.save_state(snapshot);
+        this->acc_z.save_state(snapshot);
+    }
+    bool restore_state(StateSnapshot& snapshot) override
+    {
+        return restore_sensor_state(snapshot)
+            && snapshot.get(this->total_time_sec)
+            && snapshot.get(this->sample)
+            && snapshot.get(this->has_prev_data)
+            && snapshot.get(this->prev_data)
+            && this->acc_x.restore_state(snapshot)
+            && this->acc_y.restore_state(snapshot)
+            && this->acc_z.restore_state(snapshot);
+    }
     const std::vector<std::string> log_head() override
     {
         return { "timestamp", "X", "Y", "Z" };
     }
-    const std::vector<std::string> log_data() override
+    void log_fields(LogRecord& record) override
     {
         DroneAccelerationBodyFrameType v = sensor_value();
 
-        return {std::to_string(CsvLogger::get_time_usec()), std::to_string(v.data.x), std::to_string(v.data.y), std::to_string(v.data.z)};
+        record.add(CsvLogger::get_time_usec()).add(v.data.x).add(v.data.y).add(v.data.z);
     }
 
 };
@@ -4,6 +4,7 @@
 
 #include "isensor_baro.hpp"
 #include "../../utils/sensor_data_assembler.hpp"
+#include "../../utils/atmosphere_model.hpp"
 #include "utils/icsv_log.hpp"
 #include "utils/csv_logger.hpp"
 #include <iostream>
@@ -14,48 +15,56 @@ class SensorBaro : public hako::assets::drone::ISensorBaro, public ICsvLog {
 private:
     double delta_time_sec;
     double total_time_sec;
-    double Pb = 101325.0;  // static pressure at sea level [Pa]
-    double Tb = 288.15;    // standard temperature at sea level [K]
-    double Lb = -0.0065;   // standard temperature lapse rate [K/m]
-    double M = 0.0289644;  // molar mass of Earth's air [kg/mol]
-    double G = GRAVITY;    // gravity
-    double R = 8.31432;    // universal gas constant
+    const IAtmosphere *atmosphere;
 
     hako::assets::drone::SensorDataAssembler asm_alt;
     double alt2baro(double alt) {
-        if (alt <= 11000.0) {
-            return Pb * pow(Tb / (Tb + (Lb * alt)), (G * M) / (R * Lb));
-        } else if (alt <= 20000.0) {
-            double f = 11000.0;
-            double a = alt2baro(f);
-            double c = Tb + (f * Lb);
-            return a * exp(((-G) * M * (alt - f)) / (R * c));
+        if (this->atmosphere != nullptr) {
+            return this->atmosphere->get_pressure(alt);
         }
-        return 0.0;
+        return AtmosphereModel::isa_pressure(alt);
     } 
+    DroneBarometricPressureType sample;
+    DroneBarometricPressureType calculate_value()
+    {
+        DroneBarometricPressureType value;
+        value.diff_pressure = 0;
+        value.pressure_alt = asm_alt.get_calculated_value();
+        value.abs_pressure = alt2baro(value.pressure_alt);
+        if (this->noise != nullptr) {
+            value.abs_pressure = this->noise->add_random_noise(value.abs_pressure);
+            value.diff_pressure = this->noise->add_random_noise(value.diff_pressure);
+            value.pressure_alt = this->noise->add_random_noise(value.pressure_alt);
+        }
+        return value;
+    }
+
 public:
-    SensorBaro(double dt, int sample_num) : delta_time_sec(dt), asm_alt(sample_num)
+    SensorBaro(double dt, int sample_num) : delta_time_sec(dt), atmosphere(nullptr), asm_alt(sample_num)
     {
         this->noise = nullptr;
     }
     virtual ~SensorBaro() {}
+    /*
+     * 気圧を大気モデル（表の補間）から求める。未設定の場合は毎回計算する
+     */
+    void set_atmosphere(const IAtmosphere *src)
+    {
+        this->atmosphere = src;
+    }
     void run(const DronePositionType& data) override
     {
         asm_alt.add_data(ref_alt - data.data.z);
         total_time_sec += delta_time_sec;
+        next_step();
     }
     DroneBarometricPressureType sensor_value() override
     {
-        DroneBarometricPressureType value;
-        value.diff_pressure = 0;
-        value.pressure_alt = asm_alt.get_calculated_value();
-        value.abs_pressure = alt2baro(value.pressure_alt);
-        if (this->noise != nullptr) {
-            value.abs_pressure = this->noise->add_random_noise(value.abs_pressure);
-            value.diff_pressure = this->noise->add_random_noise(value.diff_pressure);
-            value.pressure_alt = this->noise->add_random_noise(value.pressure_alt);
+        if (!this->sample_valid) {
+            this->sample = calculate_value();
+            this->sample_valid = true;
         }
-        return value;
+        return this->sample;
     }
     void print() override
     {
@@ -69,15 +78,29 @@ public:
                     << " )" 
                     << std::endl;
     }
+    void save_state(StateSnapshot& snapshot) const override
+    {
+        save_sensor_state(snapshot);
+        snapshot.put(this->total_time_sec);
+        snapshot.put(this->sample);
+        this->asm_alt.save_state(snapshot);
+    }
+    bool restore_state(StateSnapshot& snapshot) override
+    {
+        return restore_sensor_state(snapshot)
+            && snapshot.get(this->total_time_sec)
+            && snapshot.get(this->sample)
+            && this->asm_alt.restore_state(snapshot);
+    }
     const std::vector<std::string> log_head() override
     {
         return { "timestamp", "abs_p", "diff_p", "p_alt" };
     }
-    const std::vector<std::string> log_data() override
+    void log_fields(LogRecord& record) override
     {
         DroneBarometricPressureType v = sensor_value();
 
-        return {std::to_string(CsvLogger::get_time_usec()), std::to_string(v.abs_pressure), std::to_string(v.diff_pressure), std::to_string(v.pressure_alt)};
+        record.add(CsvLogger::get_time_usec()).add(v.abs_pressure).add(v.diff_pressure).add(v.pressure_alt);
     }
 
 };
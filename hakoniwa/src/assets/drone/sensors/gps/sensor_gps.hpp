@@ -3,116 +3,246 @@
 
 
 #include "isensor_gps.hpp"
-#include "../../utils/sensor_data_assembler.hpp"
+#include "../../utils/sensor_noise.hpp"
 #include "utils/icsv_log.hpp"
 #include "utils/csv_logger.hpp"
+#include <cmath>
 #include <iostream>
+#include <vector>
 
 namespace hako::assets::drone {
 
+/*
+ * GPS 受信機のモデル。
+ *
+ * 受信機は update_rate_hz で測位し、測位しないステップは何も計算しない（run() は時刻を進めるだけ）。
+ * 測位した値は latency_sec 分の固定長のリングバッファ（遅延線）に入れ、遅延線から出てきた測位を出力する。
+ * has_new_fix() はこのステップで新しい測位を出力した場合に true になり、HIL_GPS はそのステップだけ送信する。
+ *
+ * 位置は基準点（init_pos()）の局所接平面（NED）から WGS84 の ECEF を経て緯度・経度に厳密に変換する。
+ * 基準点の三角関数と ECEF 座標は init_pos() で1回だけ計算しておく。
+ * 高度は気圧センサと同じく、基準高度 - z とする（シミュレーションの地面は平面なので）。
+ *
+ * 測位の誤差は、擬似距離誤差（UERE）に HDOP/VDOP をかけた標準偏差の1次 Gauss-Markov 過程とする。
+ * 捕捉衛星数は satellites_min から satellites_max の間で変わり、HDOP/VDOP は衛星数の平方根に反比例する。
+ */
+#define GPS_WGS84_A         6378137.0
+#define GPS_WGS84_F         (1.0 / 298.257223563)
+#define GPS_WGS84_B         (GPS_WGS84_A * (1.0 - GPS_WGS84_F))
+#define GPS_WGS84_E2        (GPS_WGS84_F * (2.0 - GPS_WGS84_F))
+#define GPS_WGS84_EP2       (GPS_WGS84_E2 / (1.0 - GPS_WGS84_E2))
+
+typedef struct {
+    double update_rate_hz;          // 測位のレート（0 の場合は毎ステップ）
+    double latency_sec;             // 測位してから出力するまでの遅れ
+    double uere;                    // 擬似距離誤差の標準偏差 [m]（0 の場合は誤差なし）
+    double error_correlation_sec;   // 位置の誤差の相関時間
+    double hdop;                    // satellites_max のときの HDOP
+    double vdop;                    // satellites_max のときの VDOP
+    int satellites_min;
+    int satellites_max;
+    double satellite_change_sec;    // 捕捉衛星数が変わる平均の間隔
+} GpsParamType;
+
 class SensorGps : public hako::assets::drone::ISensorGps, public ICsvLog {
 private:
+    typedef struct {
+        double error[3];            // 位置の誤差（NED）[m]
+        int satellites;
+        double fraction;            // 次の測位までの端数（測位の回数）
+        bool new_fix;
+    } GpsStateType;
+
     double delta_time_sec;
     double total_time_sec;
-    hako::assets::drone::SensorDataAssembler asm_lat;
-    hako::assets::drone::SensorDataAssembler asm_lon;
-    hako::assets::drone::SensorDataAssembler asm_alt;
-    hako::assets::drone::SensorDataAssembler asm_vel;
-    hako::assets::drone::SensorDataAssembler asm_vn;
-    hako::assets::drone::SensorDataAssembler asm_ve;
-    hako::assets::drone::SensorDataAssembler asm_vd;
-    hako::assets::drone::SensorDataAssembler asm_cog;
+    GpsParamType param;
+    // 基準点のキャッシュ
+    double sin_lat0;
+    double cos_lat0;
+    double sin_lon0;
+    double cos_lon0;
+    double ecef0[3];
+    // 遅延線（latency 分の測位）
+    std::vector<DroneGpsDataType> delay_line;
+    int delay_head;
+    int delay_count;
+    GpsStateType state;
+    GaussianRandom random;
+    DroneGpsDataType sample;
 
-    void run_pos(const DronePositionType& p)
+    void init_reference()
     {
-        double lat = this->ref_lat + (p.data.x / 111000.0);
-        double lon = this->ref_lon + (p.data.y / 111000.0);
-        //高度はプラス
-        double alt = this->ref_alt - p.data.z;
-
-        this->asm_lat.add_data(lat);
-        this->asm_lon.add_data(lon);
-        this->asm_alt.add_data(alt);
+        double lat0 = this->ref_lat * M_PI / 180.0;
+        double lon0 = this->ref_lon * M_PI / 180.0;
+        sin_lat0 = std::sin(lat0);
+        cos_lat0 = std::cos(lat0);
+        sin_lon0 = std::sin(lon0);
+        cos_lon0 = std::cos(lon0);
+        double n = GPS_WGS84_A / std::sqrt(1.0 - GPS_WGS84_E2 * sin_lat0 * sin_lat0);
+        ecef0[0] = (n + this->ref_alt) * cos_lat0 * cos_lon0;
+        ecef0[1] = (n + this->ref_alt) * cos_lat0 * sin_lon0;
+        ecef0[2] = (n * (1.0 - GPS_WGS84_E2) + this->ref_alt) * sin_lat0;
     }
-
-    void run_velocity(const DroneVelocityType& v)
+    /*
+     * 局所接平面の北・東の位置 [m] から緯度・経度 [deg]。
+     * 高度は別に扱うので、基準高度の接平面上の点を変換する。
+     * ECEF から緯度への変換は Bowring の式（地表付近の誤差は 1mm 未満）。
+     */
+    void ned_to_lat_lon(double north, double east, double& lat, double& lon) const
     {
-        double vn = v.data.x;
-        double ve = v.data.y;
-        double vd = v.data.z;
-        double vel = sqrt(vn * vn + ve * ve /* +  vd * vd */);
-        this->asm_vn.add_data(vn);
-        this->asm_ve.add_data(ve);
-        this->asm_vd.add_data(vd);
-        this->asm_vel.add_data(vel);
+        double x = ecef0[0] - sin_lat0 * cos_lon0 * north - sin_lon0 * east;
+        double y = ecef0[1] - sin_lat0 * sin_lon0 * north + cos_lon0 * east;
+        double z = ecef0[2] + cos_lat0 * north;
+        double p = std::sqrt(x * x + y * y);
+        double theta = std::atan2(z * GPS_WGS84_A, p * GPS_WGS84_B);
+        double st = std::sin(theta);
+        double ct = std::cos(theta);
+        lat = std::atan2(z + GPS_WGS84_EP2 * GPS_WGS84_B * st * st * st,
+                         p - GPS_WGS84_E2 * GPS_WGS84_A * ct * ct * ct) * 180.0 / M_PI;
+        lon = std::atan2(y, x) * 180.0 / M_PI;
+    }
+    int delay_fixes() const
+    {
+        double rate = (param.update_rate_hz > 0) ? param.update_rate_hz : (1.0 / delta_time_sec);
+        return (int)std::lround(param.latency_sec * rate);
+    }
+    void reset_delay_line()
+    {
+        delay_line.assign(delay_fixes() + 1, DroneGpsDataType{});
+        delay_head = 0;
+        delay_count = 0;
+    }
+    void update_satellites(double fix_dt)
+    {
+        if (param.satellites_min >= param.satellites_max) {
+            state.satellites = param.satellites_max;
+            return;
+        }
+        if ((param.satellite_change_sec > 0) && (random.next_uniform() < (fix_dt / param.satellite_change_sec))) {
+            int step = (random.next_uniform() < 0.5) ? -1 : 1;
+            int next = state.satellites + step;
+            if ((next < param.satellites_min) || (next > param.satellites_max)) {
+                next = state.satellites - step;
+            }
+            state.satellites = next;
+        }
     }
-    void run_cog(const DroneVelocityType& v)
+    DroneGpsDataType measure(const DronePositionType& p, const DroneVelocityType& v, double fix_dt)
     {
+        update_satellites(fix_dt);
+        double dop_scale = std::sqrt((double)param.satellites_max / state.satellites);
+        double hdop = param.hdop * dop_scale;
+        double vdop = param.vdop * dop_scale;
+        if (param.uere > 0) {
+            double decay = (param.error_correlation_sec > 0) ? std::exp(-fix_dt / param.error_correlation_sec) : 0.0;
+            double diffusion = std::sqrt(1.0 - decay * decay);
+            for (int i = 0; i < 3; i++) {
+                double sigma = param.uere * ((i < 2) ? hdop : vdop);
+                state.error[i] = state.error[i] * decay + sigma * diffusion * random.next();
+            }
+        }
+        double north = p.data.x + state.error[0];
+        double east = p.data.y + state.error[1];
+        double down = p.data.z + state.error[2];
         double vn = v.data.x;
         double ve = v.data.y;
-
-        // 角度を-πからπで範囲で返す
-        double angleRadians = atan2(ve, vn);
-
-        // ラジアンから度に変換
-        double angleDegrees = angleRadians * (180.0 / M_PI);
-
-        // 角度を0〜360度の範囲に正規化
-        if (angleDegrees < 0.0) {
-            angleDegrees += 360.0;
+        double vd = v.data.z;
+        if (this->noise != nullptr) {
+            north = this->noise->add_random_noise(north);
+            east = this->noise->add_random_noise(east);
+            down = this->noise->add_random_noise(down);
+            vn = this->noise->add_random_noise(vn);
+            ve = this->noise->add_random_noise(ve);
+            vd = this->noise->add_random_noise(vd);
         }
-        this->asm_cog.add_data(angleDegrees);
+        DroneGpsDataType value;
+        ned_to_lat_lon(north, east, value.lat, value.lon);
+        //高度はプラス
+        value.alt = this->ref_alt - down;
+        value.vn = vn;
+        value.ve = ve;
+        value.vd = vd;
+        value.vel = std::sqrt(vn * vn + ve * ve);
+        // 0〜360度
+        value.cog = std::atan2(ve, vn) * (180.0 / M_PI);
+        if (value.cog < 0.0) {
+            value.cog += 360.0;
+        }
+        value.num_satelites_visible = state.satellites;
+        value.eph = hdop;
+        value.epv = vdop;
+        return value;
     }
+
 public:
-    SensorGps(double dt, int sample_num) 
-        : delta_time_sec(dt), asm_lat(sample_num), asm_lon(sample_num), asm_alt(sample_num),
-            asm_vel(sample_num), asm_vn(sample_num), asm_ve(sample_num), asm_vd(sample_num), asm_cog(sample_num)
+    SensorGps(double dt, uint32_t seed = std::mt19937::default_seed)
+        : delta_time_sec(dt), total_time_sec(0), delay_head(0), delay_count(0), state(), random(seed)
     {
         this->noise = nullptr;
+        param = { 0.0, 0.0, 0.0, 60.0, 0.8, 1.2, 10, 10, 30.0 };
+        state.satellites = param.satellites_max;
+        init_pos(0, 0, 0);
+        reset_delay_line();
+        sample = {};
+        sample.cog = -1;
     }
     virtual ~SensorGps() {}
-    void run(const DronePositionType& p, const DroneVelocityType& v) override
+
+    bool set_params(const GpsParamType& p)
     {
-        run_pos(p);
-        run_velocity(v);
-        run_cog(v);
-        total_time_sec += delta_time_sec;
+        if ((p.update_rate_hz < 0) || (p.latency_sec < 0) || (p.uere < 0) || (p.error_correlation_sec < 0)
+            || (p.hdop <= 0) || (p.vdop <= 0) || (p.satellites_min <= 0) || (p.satellites_min > p.satellites_max)) {
+            std::cerr << "ERROR: invalid gps parameter" << std::endl;
+            return false;
+        }
+        this->param = p;
+        state.satellites = p.satellites_max;
+        reset_delay_line();
+        return true;
     }
-    DroneGpsDataType sensor_value() override
+    const GpsParamType& get_params() const
     {
-        DroneGpsDataType value;
-        value.lat = this->asm_lat.get_calculated_value();
-        value.lon = this->asm_lon.get_calculated_value();
-        value.alt = this->asm_alt.get_calculated_value();
-
-        value.vel = this->asm_vel.get_calculated_value();
-        value.vn = this->asm_vn.get_calculated_value();
-        value.ve = this->asm_ve.get_calculated_value();
-        value.vd = this->asm_vd.get_calculated_value();
-
-        if (this->asm_cog.size() > 0) {
-            value.cog = this->asm_cog.get_calculated_value();
+        return param;
+    }
+    void init_pos(double lat_data, double lon_data, double alt_data) override
+    {
+        ISensorGps::init_pos(lat_data, lon_data, alt_data);
+        init_reference();
+    }
+    void run(const DronePositionType& p, const DroneVelocityType& v) override
+    {
+        total_time_sec += delta_time_sec;
+        next_step();
+        state.new_fix = false;
+        double fix_dt = this->delta_time_sec;
+        if (param.update_rate_hz > 0) {
+            state.fraction += param.update_rate_hz * delta_time_sec;
+            if (state.fraction < 1.0) {
+                return;
+            }
+            state.fraction -= (int)state.fraction;
+            fix_dt = 1.0 / param.update_rate_hz;
         }
-        else {
-            value.cog = -1;
+        const int size = (int)delay_line.size();
+        delay_line[delay_head] = measure(p, v, fix_dt);
+        delay_head = (delay_head + 1) % size;
+        if (delay_count < size) {
+            delay_count++;
         }
-        if (this->noise != nullptr) {
-            value.lat= this->noise->add_random_noise(value.lat);
-            value.lon= this->noise->add_random_noise(value.lon);
-            value.alt= this->noise->add_random_noise(value.alt);
-
-            value.vel = this->noise->add_random_noise(value.vel);
-            value.vn = this->noise->add_random_noise(value.vn);
-            value.ve = this->noise->add_random_noise(value.ve);
-            value.vd = this->noise->add_random_noise(value.vd);
-            if (value.cog >= 0) {
-                value.cog = this->noise->add_random_noise(value.cog);
-            }
+        if (delay_count == size) {
+            // 一番古い測位（latency 前）を出力する
+            this->sample = delay_line[delay_head];
+            state.new_fix = true;
         }
-        value.eph = 10;
-        value.epv = 10;
-        value.num_satelites_visible = 10;
-        return value;
+    }
+    bool has_new_fix() const override
+    {
+        return state.new_fix;
+    }
+    DroneGpsDataType sensor_value() override
+    {
+        this->sample_valid = true;
+        return this->sample;
     }
     void print() override
     {
@@ -123,7 +253,7 @@ public:
                     << result.lon
                     << ", alt: "
                     << result.alt
-                    << " )" 
+                    << " )"
                     << std::endl;
         std::cout << "gps.velocity( vel: "
                     << result.vel
@@ -135,21 +265,49 @@ public:
                     << result.vd
                     << ", cog: "
                     << result.cog
-                    << " )" 
+                    << " )"
                     << std::endl;
     }
+    void save_state(StateSnapshot& snapshot) const override
+    {
+        save_sensor_state(snapshot);
+        snapshot.put(this->total_time_sec);
+        snapshot.put(this->sample);
+        snapshot.put(this->delay_line);
+        snapshot.put(this->delay_head);
+        snapshot.put(this->delay_count);
+        snapshot.put(this->state);
+        this->random.save_state(snapshot);
+    }
+    bool restore_state(StateSnapshot& snapshot) override
+    {
+        std::vector<DroneGpsDataType> saved_delay_line;
+        if (!restore_sensor_state(snapshot)
+            || !snapshot.get(this->total_time_sec)
+            || !snapshot.get(this->sample)
+            || !snapshot.get(saved_delay_line)
+            || (saved_delay_line.size() != this->delay_line.size())) {
+            return false;
+        }
+        this->delay_line = saved_delay_line;
+        return snapshot.get(this->delay_head)
+            && snapshot.get(this->delay_count)
+            && snapshot.get(this->state)
+            && this->random.restore_state(snapshot);
+    }
     const std::vector<std::string> log_head() override
     {
-        return { "timestamp", "lat", "lon", "alt", "vel", "vn", "ve", "vd", "cog" };
+        return { "timestamp", "lat", "lon", "alt", "vel", "vn", "ve", "vd", "cog", "satellites", "eph", "epv" };
     }
-    const std::vector<std::string> log_data() override
+    void log_fields(LogRecord& record) override
     {
         DroneGpsDataType v = sensor_value();
 
-        return {std::to_string(CsvLogger::get_time_usec()), 
-                std::to_string(v.lat), std::to_string(v.lon), std::to_string(v.alt),
-                std::to_string(v.vel), std::to_string(v.vn), std::to_string(v.ve), std::to_string(v.vd),
-                std::to_string(v.cog)};
+        record.add(CsvLogger::get_time_usec())
+              .add(v.lat).add(v.lon).add(v.alt)
+              .add(v.vel).add(v.vn).add(v.ve).add(v.vd)
+              .add(v.cog)
+              .add(v.num_satelites_visible).add(v.eph).add(v.epv);
     }
 
 };
@@ -157,4 +315,4 @@ public:
 }
 
 
-#endif /* _SENSOR_GPS_HPP_ */
\ No newline at end of file
+#endif /* _SENSOR_GPS_HPP_ */
@@ -17,6 +17,21 @@ private:
     hako::assets::drone::SensorDataAssembler gyro_x;
     hako::assets::drone::SensorDataAssembler gyro_y;
     hako::assets::drone::SensorDataAssembler gyro_z;
+    DroneAngularVelocityBodyFrameType sample;
+    DroneAngularVelocityBodyFrameType calculate_value()
+    {
+        DroneAngularVelocityBodyFrameType value;
+        value.data.x = this->gyro_x.get_calculated_value();
+        value.data.y = this->gyro_y.get_calculated_value();
+        value.data.z = this->gyro_z.get_calculated_value();
+        if (this->noise != nullptr) {
+            value.data.x = this->noise->add_random_noise(value.data.x);
+            value.data.y = this->noise->add_random_noise(value.data.y);
+            value.data.z = this->noise->add_random_noise(value.data.z);
+        }
+        return value;
+    }
+
 public:
     SensorGyro(double dt, int sample_num) : delta_time_sec(dt), gyro_x(sample_num), gyro_y(sample_num), gyro_z(sample_num) 
     {
@@ -29,19 +44,15 @@ public:
         this->gyro_y.add_data(data.data.y);
         this->gyro_z.add_data(data.data.z);
         total_time_sec += delta_time_sec;
+        next_step();
     }
     DroneAngularVelocityBodyFrameType sensor_value() override
     {
-        DroneAngularVelocityBodyFrameType value;
-        value.data.x = this->gyro_x.get_calculated_value();
-        value.data.y = this->gyro_y.get_calculated_value();
-        value.data.z = this->gyro_z.get_calculated_value();
-        if (this->noise != nullptr) {
-            value.data.x = this->noise->add_random_noise(value.data.x);
-            value.data.y = this->noise->add_random_noise(value.data.y);
-            value.data.z = this->noise->add_random_noise(value.data.z);
+        if (!this->sample_valid) {
+            this->sample = calculate_value();
+            this->sample_valid = true;
         }
-        return value;
+        return this->sample;
     }
     void print() override
     {
@@ -55,15 +66,33 @@ public:
                     << " )" 
                     << std::endl;
     }
+    void save_state(StateSnapshot& snapshot) const override
+    {
+        save_sensor_state(snapshot);
+        snapshot.put(this->total_time_sec);
+        snapshot.put(this->sample);
+        this->gyro_x.save_state(snapshot);
+        this->gyro_y.save_state(snapshot);
+        this->gyro_z.save_state(snapshot);
+    }
+    bool restore_state(StateSnapshot& snapshot) override
+    {
+        return restore_sensor_state(snapshot)
+            && snapshot.get(this->total_time_sec)
+            && snapshot.get(this->sample)
+            && this->gyro_x.restore_state(snapshot)
+            && this->gyro_y.restore_state(snapshot)
+            && this->gyro_z.restore_state(snapshot);
+    }
     const std::vector<std::string> log_head() override
     {
         return { "timestamp", "X", "Y", "Z" };
     }
-    const std::vector<std::string> log_data() override
+    void log_fields(LogRecord& record) override
     {
         auto v = sensor_value();
 
-        return {std::to_string(CsvLogger::get_time_usec()), std::to_string(v.data.x), std::to_string(v.data.y), std::to_string(v.data.z)};
+        record.add(CsvLogger::get_time_usec()).add(v.data.x).add(v.data.y).add(v.data.z);
     }
 
 };
@@ -0,0 +1,282 @@
+#ifndef _SENSOR_IMU_HPP_
+#define _SENSOR_IMU_HPP_
+
+#include "isensor_imu.hpp"
+#include "utils/icsv_log.hpp"
+#include "utils/csv_logger.hpp"
+#include "../../utils/sensor_noise.hpp"
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+namespace hako::assets::drone {
+
+/*
+ * IMU のモデル。
+ *
+ * 加速度計は物理モデルの比力（地上座標系の加速度から重力を除き、姿勢で機体座標系に変換したもの）を、
+ * ジャイロは機体座標系の角速度を計測する。
+ * IMU は rate_hz でサンプリングし、ステップの間に取ったサンプルの平均（デシメーション）を出力する。
+ * サンプルが1つもないステップは前の出力を保持する。
+ *
+ * サンプルごとの計算はしない。ステップの間は真値が一定なので、窓の合計は真値 x サンプル数になり、
+ * ロータの振動（回転数の2乗に比例する振幅で、ロータ1回転を周期とする正弦波）の合計は
+ * 等間隔の位相の cos の和の公式で閉じた形で求める。ノイズとバイアスは値を読み出すときに1回だけ計算する
+ * （平均したホワイトノイズの標準偏差は noise_density * sqrt(rate_hz / サンプル数)）。
+ * そのため 4kHz の IMU でも、ステップごとの計算量はサンプリングレートによらない。
+ *
+ * バイアスは1次の Gauss-Markov 過程（バイアス不安定性）とランダムウォークの和で、
+ * 前回読み出してからの経過時間について厳密に進める。
+ */
+#define IMU_BIAS_INSTABILITY_TO_GAUSS_MARKOV_SIGMA  1.071   // Allan 偏差のフロア 0.664 B と Gauss-Markov 過程のピーク 0.620 sigma を合わせる
+
+typedef struct {
+    double noise_density;           // ホワイトノイズの密度 [unit/sqrt(Hz)]
+    double bias_instability;        // バイアス不安定性 [unit]（Allan 偏差のフロアから求めた値）
+    double bias_correlation_sec;    // バイアス不安定性の相関時間 [sec]
+    double random_walk;             // バイアスのランダムウォーク [unit/sqrt(sec)]
+} ImuNoiseParamType;
+
+typedef struct {
+    double acc_amplitude;           // reference_rpm での加速度の振幅 [m/s^2]（ロータ1つあたり）
+    double gyro_amplitude;          // reference_rpm での角速度の振幅 [rad/s]（ロータ1つあたり）
+    double reference_rpm;
+    double axial_ratio;             // z 軸の振幅の x, y 軸に対する比
+} ImuVibrationParamType;
+
+class SensorImu : public hako::assets::drone::ISensorImu, public ICsvLog {
+private:
+    typedef struct {
+        double acc_sum[3];
+        double gyro_sum[3];
+        int count;
+    } ImuWindowType;
+    typedef struct {
+        double gauss_markov[3];
+        double random_walk[3];
+    } ImuBiasType;
+
+    double delta_time_sec;
+    double total_time_sec;
+    double rate_hz;
+    double sample_fraction;         // 次のサンプルまでの端数（サンプル数）
+    ImuNoiseParamType acc_param;
+    ImuNoiseParamType gyro_param;
+    ImuVibrationParamType vibration;
+    std::vector<double> rotor_phase;
+    ImuWindowType window;
+    ImuBiasType acc_bias;
+    ImuBiasType gyro_bias;
+    double bias_time_sec;
+    DroneAccelerationBodyFrameType acc_sample;
+    DroneAngularVelocityBodyFrameType gyro_sample;
+    GaussianRandom random;
+
+    void update_bias(ImuBiasType& bias, const ImuNoiseParamType& param, double dt)
+    {
+        double decay = 0;
+        double diffusion = 0;
+        if (param.bias_correlation_sec > 0) {
+            decay = std::exp(-dt / param.bias_correlation_sec);
+            diffusion = IMU_BIAS_INSTABILITY_TO_GAUSS_MARKOV_SIGMA * param.bias_instability * std::sqrt(1.0 - decay * decay);
+        }
+        double walk = param.random_walk * std::sqrt(dt);
+        for (int i = 0; i < 3; i++) {
+            bias.gauss_markov[i] = bias.gauss_markov[i] * decay + ((diffusion > 0) ? diffusion * random.next() : 0.0);
+            bias.random_walk[i] += (walk > 0) ? walk * random.next() : 0.0;
+        }
+    }
+    void calculate_value()
+    {
+        if (window.count == 0) {
+            // このステップはサンプルがないので前の出力を保持する
+            return;
+        }
+        double elapsed = this->total_time_sec - this->bias_time_sec;
+        if (elapsed > 0) {
+            update_bias(acc_bias, acc_param, elapsed);
+            update_bias(gyro_bias, gyro_param, elapsed);
+            this->bias_time_sec = this->total_time_sec;
+        }
+        double scale = 1.0 / window.count;
+        double acc_white = acc_param.noise_density * std::sqrt(rate_hz * scale);
+        double gyro_white = gyro_param.noise_density * std::sqrt(rate_hz * scale);
+        double acc[3];
+        double gyro[3];
+        for (int i = 0; i < 3; i++) {
+            acc[i] = window.acc_sum[i] * scale + acc_bias.gauss_markov[i] + acc_bias.random_walk[i]
+                   + ((acc_white > 0) ? acc_white * random.next() : 0.0);
+            gyro[i] = window.gyro_sum[i] * scale + gyro_bias.gauss_markov[i] + gyro_bias.random_walk[i]
+                    + ((gyro_white > 0) ? gyro_white * random.next() : 0.0);
+        }
+        acc_sample.data = { acc[0], acc[1], acc[2] };
+        gyro_sample.data = { gyro[0], gyro[1], gyro[2] };
+    }
+    void finalize()
+    {
+        if (!this->sample_valid) {
+            calculate_value();
+            this->sample_valid = true;
+        }
+    }
+
+public:
+    SensorImu(double dt, double rate, uint32_t seed = std::mt19937::default_seed)
+        : delta_time_sec(dt), total_time_sec(0), rate_hz((rate > 0) ? rate : (1.0 / dt)), sample_fraction(0),
+          window(), acc_bias(), gyro_bias(), bias_time_sec(0), random(seed)
+    {
+        this->noise = nullptr;
+        acc_param = { 0, 0, 0, 0 };
+        gyro_param = { 0, 0, 0, 0 };
+        vibration = { 0, 0, HOVERING_ROTOR_RPM, 1.0 };
+        acc_sample.data = { 0, 0, -GRAVITY };
+        gyro_sample.data = { 0, 0, 0 };
+    }
+    virtual ~SensorImu() {}
+
+    bool set_params(const ImuNoiseParamType& acc, const ImuNoiseParamType& gyro, const ImuVibrationParamType& vib)
+    {
+        for (const ImuNoiseParamType *p : { &acc, &gyro }) {
+            if ((p->noise_density < 0) || (p->bias_instability < 0) || (p->bias_correlation_sec < 0) || (p->random_walk < 0)) {
+                std::cerr << "ERROR: invalid imu noise parameter" << std::endl;
+                return false;
+            }
+        }
+        if ((vib.acc_amplitude < 0) || (vib.gyro_amplitude < 0) || (vib.reference_rpm <= 0) || (vib.axial_ratio < 0)) {
+            std::cerr << "ERROR: invalid imu vibration parameter" << std::endl;
+            return false;
+        }
+        this->acc_param = acc;
+        this->gyro_param = gyro;
+        this->vibration = vib;
+        this->sample_valid = false;
+        return true;
+    }
+    double get_rate_hz() const
+    {
+        return rate_hz;
+    }
+    // 直前のステップで取ったサンプル数
+    int get_sample_count() const
+    {
+        return window.count;
+    }
+
+    void run(const DroneAccelerationBodyFrameType& specific_force,
+             const DroneAngularVelocityBodyFrameType& angular_velocity,
+             const DroneRotorSpeedType* rotor_speeds, int rotor_num) override
+    {
+        total_time_sec += delta_time_sec;
+        next_step();
+        sample_fraction += rate_hz * delta_time_sec;
+        const int n = (int)sample_fraction;
+        sample_fraction -= n;
+        window.count = n;
+        if (n == 0) {
+            return;
+        }
+        window.acc_sum[0] = specific_force.data.x * n;
+        window.acc_sum[1] = specific_force.data.y * n;
+        window.acc_sum[2] = specific_force.data.z * n;
+        window.gyro_sum[0] = angular_velocity.data.x * n;
+        window.gyro_sum[1] = angular_velocity.data.y * n;
+        window.gyro_sum[2] = angular_velocity.data.z * n;
+        if ((vibration.acc_amplitude == 0) && (vibration.gyro_amplitude == 0)) {
+            return;
+        }
+        if ((int)rotor_phase.size() != rotor_num) {
+            // ロータの位相はずらしておく
+            rotor_phase.resize(rotor_num);
+            for (int i = 0; i < rotor_num; i++) {
+                rotor_phase[i] = M_PI * 2.0 * i / rotor_num;
+            }
+        }
+        for (int i = 0; i < rotor_num; i++) {
+            const double ratio = rotor_speeds[i].data / vibration.reference_rpm;
+            const double delta = M_PI * 2.0 * (rotor_speeds[i].data / 60.0) / rate_hz;  // 1サンプルあたりの位相
+            // sum_{k=0}^{n-1} cos(phase + k delta) = cos(phase + (n-1) delta / 2) * sin(n delta / 2) / sin(delta / 2)
+            const double half = 0.5 * delta;
+            const double s = std::sin(half);
+            const double kernel = (std::fabs(s) > 1e-9) ? (std::sin(n * half) / s) : (n * std::cos(n * half) / std::cos(half));
+            const double center = rotor_phase[i] + (n - 1) * half;
+            const double sum_cos = std::cos(center) * kernel;
+            const double sum_sin = std::sin(center) * kernel;
+            const double a = vibration.acc_amplitude * ratio * ratio;
+            const double g = vibration.gyro_amplitude * ratio * ratio;
+            window.acc_sum[0] += a * sum_cos;
+            window.acc_sum[1] += a * sum_sin;
+            window.acc_sum[2] += a * vibration.axial_ratio * sum_cos;
+            window.gyro_sum[0] += g * sum_sin;
+            window.gyro_sum[1] += g * sum_cos;
+            window.gyro_sum[2] += g * vibration.axial_ratio * sum_sin;
+            rotor_phase[i] = std::remainder(rotor_phase[i] + n * delta, M_PI * 2.0);
+        }
+    }
+    DroneAccelerationBodyFrameType acc_value() override
+    {
+        finalize();
+        return acc_sample;
+    }
+    DroneAngularVelocityBodyFrameType gyro_value() override
+    {
+        finalize();
+        return gyro_sample;
+    }
+
+    void print() override
+    {
+        auto acc = acc_value();
+        auto gyro = gyro_value();
+        std::cout << "imu( acc( "
+                    << acc.data.x << ", " << acc.data.y << ", " << acc.data.z
+                    << " ) gyro( "
+                    << gyro.data.x << ", " << gyro.data.y << ", " << gyro.data.z
+                    << " ) )"
+                    << std::endl;
+    }
+    void save_state(StateSnapshot& snapshot) const override
+    {
+        save_sensor_state(snapshot);
+        snapshot.put(this->total_time_sec);
+        snapshot.put(this->sample_fraction);
+        snapshot.put(this->rotor_phase);
+        snapshot.put(this->window);
+        snapshot.put(this->acc_bias);
+        snapshot.put(this->gyro_bias);
+        snapshot.put(this->bias_time_sec);
+        snapshot.put(this->acc_sample);
+        snapshot.put(this->gyro_sample);
+        this->random.save_state(snapshot);
+    }
+    bool restore_state(StateSnapshot& snapshot) override
+    {
+        return restore_sensor_state(snapshot)
+            && snapshot.get(this->total_time_sec)
+            && snapshot.get(this->sample_fraction)
+            && snapshot.get(this->rotor_phase)
+            && snapshot.get(this->window)
+            && snapshot.get(this->acc_bias)
+            && snapshot.get(this->gyro_bias)
+            && snapshot.get(this->bias_time_sec)
+            && snapshot.get(this->acc_sample)
+            && snapshot.get(this->gyro_sample)
+            && this->random.restore_state(snapshot);
+    }
+    const std::vector<std::string> log_head() override
+    {
+        return { "timestamp", "acc_x", "acc_y", "acc_z", "gyro_x", "gyro_y", "gyro_z" };
+    }
+    void log_fields(LogRecord& record) override
+    {
+        DroneAccelerationBodyFrameType acc = acc_value();
+        DroneAngularVelocityBodyFrameType gyro = gyro_value();
+        record.add(CsvLogger::get_time_usec())
+              .add(acc.data.x).add(acc.data.y).add(acc.data.z)
+              .add(gyro.data.x).add(gyro.data.y).add(gyro.data.z);
+    }
+};
+
+}
+
+#endif /* _SENSOR_IMU_HPP_ */
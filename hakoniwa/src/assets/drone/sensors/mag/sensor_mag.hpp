@@ -82,6 +82,21 @@ private:
         this->mag_y.add_data(y);
         this->mag_z.add_data(z);
     }
+    DroneMagDataType sample;
+    DroneMagDataType calculate_value()
+    {
+        DroneMagDataType value;
+        value.data.x = this->mag_x.get_calculated_value();
+        value.data.y = this->mag_y.get_calculated_value();
+        value.data.z = this->mag_z.get_calculated_value();
+        if (this->noise != nullptr) {
+            value.data.x = this->noise->add_random_noise(value.data.x);
+            value.data.y = this->noise->add_random_noise(value.data.y);
+            value.data.z = this->noise->add_random_noise(value.data.z);
+        }
+        return value;
+    }
+
 public:
     SensorMag(double dt, int sample_num) : delta_time_sec(dt), mag_x(sample_num), mag_y(sample_num), mag_z(sample_num) 
     {
@@ -93,19 +108,15 @@ public:
     {
         run_new(angle);
         total_time_sec += delta_time_sec;
+        next_step();
     }
     DroneMagDataType sensor_value() override
     {
-        DroneMagDataType value;
-        value.data.x = this->mag_x.get_calculated_value();
-        value.data.y = this->mag_y.get_calculated_value();
-        value.data.z = this->mag_z.get_calculated_value();
-        if (this->noise != nullptr) {
-            value.data.x = this->noise->add_random_noise(value.data.x);
-            value.data.y = this->noise->add_random_noise(value.data.y);
-            value.data.z = this->noise->add_random_noise(value.data.z);
+        if (!this->sample_valid) {
+            this->sample = calculate_value();
+            this->sample_valid = true;
         }
-        return value;
+        return this->sample;
     }
     void print() override
     {
@@ -119,15 +130,33 @@ public:
                     << " )" 
                     << std::endl;
     }
+    void save_state(StateSnapshot& snapshot) const override
+    {
+        save_sensor_state(snapshot);
+        snapshot.put(this->total_time_sec);
+        snapshot.put(this->sample);
+        this->mag_x.save_state(snapshot);
+        this->mag_y.save_state(snapshot);
+        this->mag_z.save_state(snapshot);
+    }
+    bool restore_state(StateSnapshot& snapshot) override
+    {
+        return restore_sensor_state(snapshot)
+            && snapshot.get(this->total_time_sec)
+            && snapshot.get(this->sample)
+            && this->mag_x.restore_state(snapshot)
+            && this->mag_y.restore_state(snapshot)
+            && this->mag_z.restore_state(snapshot);
+    }
     const std::vector<std::string> log_head() override
     {
         return { "timestamp", "X", "Y", "Z" };
     }
-    const std::vector<std::string> log_data() override
+    void log_fields(LogRecord& record) override
     {
         auto v = sensor_value();
 
-        return {std::to_string(CsvLogger::get_time_usec()), std::to_string(v.data.x), std::to_string(v.data.y), std::to_string(v.data.z)};
+        record.add(CsvLogger::get_time_usec()).add(v.data.x).add(v.data.y).add(v.data.z);
     }
 
 };
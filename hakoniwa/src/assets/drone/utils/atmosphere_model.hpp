@@ -0,0 +1,173 @@
+#ifndef _ATMOSPHERE_MODEL_HPP_
+#define _ATMOSPHERE_MODEL_HPP_
+
+#include "iatmosphere.hpp"
+#include "drone_primitive_types.hpp"
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <cstddef>
+
+namespace hako::assets::drone {
+
+/*
+ * 国際標準大気（20km まで）の気圧・気温・密度。
+ *
+ * init() で指定した高度範囲の値を等間隔の表にしておき、線形補間で求める。
+ * 表の範囲外の高度は毎回計算する。
+ * 補間の誤差（各区間の中点での気圧の誤差の最大値）が max_error_pa を超える場合は、
+ * 超えなくなるまで（または表が ATMOSPHERE_TABLE_MAX_SIZE 点になるまで）間隔を半分にする。
+ */
+#define ATMOSPHERE_TABLE_MAX_SIZE   (1024 * 1024)
+
+class AtmosphereModel : public hako::assets::drone::IAtmosphere {
+private:
+    std::vector<AtmosphereType> table;
+    double alt_min;
+    double alt_max;
+    double resolution;
+    double inv_resolution;
+    double max_error_pa;
+
+public:
+    static constexpr double Pb = 101325.0;   // static pressure at sea level [Pa]
+    static constexpr double Tb = 288.15;     // standard temperature at sea level [K]
+    static constexpr double Lb = -0.0065;    // standard temperature lapse rate [K/m]
+    static constexpr double M = 0.0289644;   // molar mass of Earth's air [kg/mol]
+    static constexpr double R = 8.31432;     // universal gas constant
+    static constexpr double TROPOPAUSE_ALT = 11000.0;
+    static constexpr double STRATOSPHERE_ALT = 20000.0;
+
+    static double isa_pressure(double alt)
+    {
+        if (alt <= TROPOPAUSE_ALT) {
+            return Pb * pow(Tb / (Tb + (Lb * alt)), (GRAVITY * M) / (R * Lb));
+        } else if (alt <= STRATOSPHERE_ALT) {
+            double f = TROPOPAUSE_ALT;
+            double a = isa_pressure(f);
+            double c = Tb + (f * Lb);
+            return a * exp(((-GRAVITY) * M * (alt - f)) / (R * c));
+        }
+        return 0.0;
+    }
+    static double isa_temperature(double alt)
+    {
+        if (alt <= TROPOPAUSE_ALT) {
+            return Tb + (Lb * alt);
+        }
+        return Tb + (Lb * TROPOPAUSE_ALT);
+    }
+    static AtmosphereType isa_atmosphere(double alt)
+    {
+        AtmosphereType value;
+        value.pressure = isa_pressure(alt);
+        value.temperature = isa_temperature(alt);
+        value.density = (value.pressure * M) / (R * value.temperature);
+        return value;
+    }
+
+    AtmosphereModel() : alt_min(0), alt_max(0), resolution(0), inv_resolution(0), max_error_pa(0) {}
+    virtual ~AtmosphereModel() {}
+
+    bool init(double min_alt, double max_alt, double resolution_m, double error_pa)
+    {
+        table.clear();
+        if (!(max_alt > min_alt) || !(resolution_m > 0) || !(error_pa > 0)) {
+            std::cerr << "ERROR: invalid atmosphere table: altitude " << min_alt << " - " << max_alt
+                      << " m, resolution " << resolution_m << " m, max error " << error_pa << " Pa" << std::endl;
+            return false;
+        }
+        this->alt_min = min_alt;
+        this->alt_max = max_alt;
+        while (true) {
+            size_t num = static_cast<size_t>(std::ceil((max_alt - min_alt) / resolution_m)) + 1;
+            if (num > ATMOSPHERE_TABLE_MAX_SIZE) {
+                std::cerr << "WARNING: atmosphere table is limited to " << ATMOSPHERE_TABLE_MAX_SIZE << " points" << std::endl;
+                break;
+            }
+            build(resolution_m, num);
+            if (this->max_error_pa <= error_pa) {
+                break;
+            }
+            resolution_m /= 2.0;
+        }
+        return !table.empty();
+    }
+    AtmosphereType get_atmosphere(double alt) const override
+    {
+        size_t i;
+        double t;
+        if (!locate(alt, i, t)) {
+            return isa_atmosphere(alt);
+        }
+        const AtmosphereType& a = table[i];
+        const AtmosphereType& b = table[i + 1];
+        AtmosphereType value;
+        value.pressure = a.pressure + (b.pressure - a.pressure) * t;
+        value.temperature = a.temperature + (b.temperature - a.temperature) * t;
+        value.density = a.density + (b.density - a.density) * t;
+        return value;
+    }
+    double get_pressure(double alt) const override
+    {
+        size_t i;
+        double t;
+        if (!locate(alt, i, t)) {
+            return isa_pressure(alt);
+        }
+        return table[i].pressure + (table[i + 1].pressure - table[i].pressure) * t;
+    }
+    size_t get_table_size() const
+    {
+        return table.size();
+    }
+    double get_resolution() const
+    {
+        return resolution;
+    }
+    // 表の補間の誤差（気圧）の最大値 [Pa]
+    double get_max_error_pa() const
+    {
+        return max_error_pa;
+    }
+
+private:
+    void build(double resolution_m, size_t num)
+    {
+        this->resolution = resolution_m;
+        this->inv_resolution = 1.0 / resolution_m;
+        table.resize(num);
+        for (size_t i = 0; i < num; i++) {
+            table[i] = isa_atmosphere(alt_min + resolution_m * (double)i);
+        }
+        this->max_error_pa = 0;
+        for (size_t i = 0; i + 1 < num; i++) {
+            double mid = alt_min + resolution_m * ((double)i + 0.5);
+            double interpolated = (table[i].pressure + table[i + 1].pressure) * 0.5;
+            double error = std::fabs(interpolated - isa_pressure(mid));
+            if (error > this->max_error_pa) {
+                this->max_error_pa = error;
+            }
+        }
+    }
+    /*
+     * alt を含む区間 [table[i], table[i + 1]] と区間内の位置 t (0..1) を求める
+     */
+    bool locate(double alt, size_t& i, double& t) const
+    {
+        if (table.size() < 2 || !(alt >= alt_min) || !(alt <= alt_max)) {
+            return false;
+        }
+        double x = (alt - alt_min) * inv_resolution;
+        i = static_cast<size_t>(x);
+        if (i >= table.size() - 1) {
+            i = table.size() - 2;
+        }
+        t = x - (double)i;
+        return true;
+    }
+};
+
+}
+
+#endif /* _ATMOSPHERE_MODEL_HPP_ */
@@ -0,0 +1,259 @@
+#ifndef _INPUT_JOURNAL_HPP_
+#define _INPUT_JOURNAL_HPP_
+
+#include "idrone_dynamics.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace hako::assets::drone {
+
+/*
+ * 機体への入力（アクチュエータ・衝突・手動操作）のジャーナル。
+ *
+ * hako-px4sim は IAirCraft::run() に渡す入力を1ステップごとに記録する。
+ * 同じノイズのシードで機体を生成し、記録した入力を順に IAirCraft::run() に渡すと、
+ * PX4 や箱庭なしで同じ物理計算とログ出力を再現できる（resim モード）。
+ *
+ *   file   := header | record ...
+ *   header := magic "HAKOJNL1" | version(u32) | rotor_num(u32) | noise_seed(u32) | reserved(u32) | delta_time_usec(u64)
+ *             | record_count(u64)
+ *   record := InputJournalRecordType | controls(double x rotor_num) | [DroneDynamicsCollisionType] | [DroneDynamicsManualControlType]
+ *
+ * 衝突と手動操作は、そのステップで発生した場合だけ記録するので、通常は1ステップ 16 + 8 x rotor_num バイトになる。
+ * 値はメモリ上の表現のまま書き込むので、記録と再生は同じビルドで行うこと。
+ *
+ * バッファが一杯になるか、INPUT_JOURNAL_FLUSH_RECORDS ステップごとにファイルへ書き出し、
+ * そのたびにヘッダの record_count を書き出し済みのレコード数に更新する。
+ * プロセスが途中で落ちても、読み込み側は record_count までの完全なレコードだけを再生する。
+ */
+#define INPUT_JOURNAL_MAGIC         "HAKOJNL1"
+#define INPUT_JOURNAL_MAGIC_LEN     8
+#define INPUT_JOURNAL_VERSION       2
+#define INPUT_JOURNAL_BUFFER_SIZE   (1024 * 1024)
+#define INPUT_JOURNAL_FLUSH_RECORDS 1000
+
+typedef enum {
+    INPUT_JOURNAL_STEP = 1,     // IAirCraft::run() の入力
+    INPUT_JOURNAL_RESET,        // 箱庭のリセット（スナップショットの復元）
+} InputJournalRecordKind;
+
+#define INPUT_JOURNAL_FLAG_LOG_ENABLED  0x01    // CsvLogger が有効
+#define INPUT_JOURNAL_FLAG_COLLISION    0x02
+#define INPUT_JOURNAL_FLAG_MANUAL       0x04
+
+typedef struct {
+    uint32_t kind;
+    uint32_t flags;
+    uint64_t time_usec;         // CsvLogger の時刻
+} InputJournalRecordType;
+
+typedef struct {
+    uint32_t version;
+    uint32_t rotor_num;
+    uint32_t noise_seed;
+    uint32_t reserved;
+    uint64_t delta_time_usec;
+    uint64_t record_count;      // ファイルに書き出し済みのレコード数
+} InputJournalHeaderType;
+
+class InputJournalWriter {
+private:
+    std::ofstream ofs;
+    std::vector<char> buffer;
+    uint64_t record_count;
+    uint64_t flushed_count;
+    uint64_t flush_interval;
+    int rotor_num;
+
+    template <typename T>
+    void append(const T& value)
+    {
+        const char* p = reinterpret_cast<const char*>(&value);
+        buffer.insert(buffer.end(), p, p + sizeof(T));
+    }
+    void end_record()
+    {
+        record_count++;
+        if ((buffer.size() >= INPUT_JOURNAL_BUFFER_SIZE)
+            || ((flush_interval > 0) && ((record_count - flushed_count) >= flush_interval))) {
+            flush();
+        }
+    }
+
+public:
+    InputJournalWriter() : record_count(0), flushed_count(0), flush_interval(INPUT_JOURNAL_FLUSH_RECORDS), rotor_num(0) {}
+    virtual ~InputJournalWriter()
+    {
+        close();
+    }
+    bool open(const std::string& filepath, int rotor_num, uint32_t noise_seed, uint64_t delta_time_usec)
+    {
+        if ((rotor_num <= 0) || (rotor_num > MAX_ROTOR_NUM)) {
+            std::cerr << "ERROR: invalid rotor num for input journal: " << rotor_num << std::endl;
+            return false;
+        }
+        ofs.open(filepath, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!ofs.is_open()) {
+            std::cerr << "ERROR: can not open input journal: " << filepath << std::endl;
+            return false;
+        }
+        buffer.clear();
+        buffer.reserve(INPUT_JOURNAL_BUFFER_SIZE + sizeof(DroneDynamicsInputType));
+        record_count = 0;
+        flushed_count = 0;
+        this->rotor_num = rotor_num;
+        InputJournalHeaderType header = { INPUT_JOURNAL_VERSION, (uint32_t)rotor_num, noise_seed, 0, delta_time_usec, 0 };
+        ofs.write(INPUT_JOURNAL_MAGIC, INPUT_JOURNAL_MAGIC_LEN);
+        ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        return ofs.good();
+    }
+    bool is_open() const
+    {
+        return ofs.is_open();
+    }
+    void write_step(const DroneDynamicsInputType& input, uint64_t time_usec, bool log_enabled)
+    {
+        InputJournalRecordType record;
+        record.kind = INPUT_JOURNAL_STEP;
+        record.flags = log_enabled ? INPUT_JOURNAL_FLAG_LOG_ENABLED : 0;
+        record.flags |= input.collision.collision ? INPUT_JOURNAL_FLAG_COLLISION : 0;
+        record.flags |= input.manual.control ? INPUT_JOURNAL_FLAG_MANUAL : 0;
+        record.time_usec = time_usec;
+        append(record);
+        for (int i = 0; i < rotor_num; i++) {
+            append(input.controls[i]);
+        }
+        if (input.collision.collision) {
+            append(input.collision);
+        }
+        if (input.manual.control) {
+            append(input.manual);
+        }
+        end_record();
+    }
+    void write_reset(uint64_t time_usec)
+    {
+        InputJournalRecordType record;
+        record.kind = INPUT_JOURNAL_RESET;
+        record.flags = 0;
+        record.time_usec = time_usec;
+        append(record);
+        end_record();
+    }
+    uint64_t get_record_count() const
+    {
+        return record_count;
+    }
+    /*
+     * 何レコードごとにファイルへ書き出すか。0 ならバッファが一杯になるまで書き出さない
+     */
+    void set_flush_interval(uint64_t records)
+    {
+        flush_interval = records;
+    }
+    void flush()
+    {
+        if (!ofs.is_open() || buffer.empty()) {
+            return;
+        }
+        ofs.write(buffer.data(), buffer.size());
+        buffer.clear();
+        // レコードを書き終えてから、ヘッダのレコード数を更新する
+        std::streampos end = ofs.tellp();
+        ofs.seekp(INPUT_JOURNAL_MAGIC_LEN + offsetof(InputJournalHeaderType, record_count));
+        ofs.write(reinterpret_cast<const char*>(&record_count), sizeof(record_count));
+        ofs.seekp(end);
+        ofs.flush();
+        flushed_count = record_count;
+    }
+    void close()
+    {
+        if (ofs.is_open()) {
+            flush();
+            ofs.close();
+        }
+    }
+};
+
+class InputJournalReader {
+private:
+    std::ifstream ifs;
+    InputJournalHeaderType header;
+    uint64_t read_count;
+
+    template <typename T>
+    bool read(T& value)
+    {
+        ifs.read(reinterpret_cast<char*>(&value), sizeof(T));
+        return ifs.gcount() == (std::streamsize)sizeof(T);
+    }
+
+public:
+    InputJournalReader() : read_count(0)
+    {
+        memset(&header, 0, sizeof(header));
+    }
+    virtual ~InputJournalReader() {}
+    bool open(const std::string& filepath)
+    {
+        ifs.open(filepath, std::ios::in | std::ios::binary);
+        if (!ifs.is_open()) {
+            std::cerr << "ERROR: can not open input journal: " << filepath << std::endl;
+            return false;
+        }
+        char magic[INPUT_JOURNAL_MAGIC_LEN];
+        ifs.read(magic, INPUT_JOURNAL_MAGIC_LEN);
+        if (!ifs.good() || (memcmp(magic, INPUT_JOURNAL_MAGIC, INPUT_JOURNAL_MAGIC_LEN) != 0) || !read(header)) {
+            std::cerr << "ERROR: not an input journal: " << filepath << std::endl;
+            return false;
+        }
+        if ((header.version != INPUT_JOURNAL_VERSION) || (header.rotor_num == 0) || (header.rotor_num > MAX_ROTOR_NUM)) {
+            std::cerr << "ERROR: unsupported input journal: " << filepath << std::endl;
+            return false;
+        }
+        read_count = 0;
+        return true;
+    }
+    const InputJournalHeaderType& get_header() const
+    {
+        return header;
+    }
+    /*
+     * 次のレコードを読み込む。INPUT_JOURNAL_STEP の場合は input に入力を設定する。
+     * ヘッダの record_count まで読んだか、ファイルの終わりに達した場合は false
+     */
+    bool next(InputJournalRecordType& record, DroneDynamicsInputType& input)
+    {
+        if ((read_count >= header.record_count) || !read(record)) {
+            return false;
+        }
+        read_count++;
+        if (record.kind != INPUT_JOURNAL_STEP) {
+            return true;
+        }
+        input.no_use_actuator = false;
+        for (uint32_t i = 0; i < header.rotor_num; i++) {
+            if (!read(input.controls[i])) {
+                return false;
+            }
+        }
+        input.collision.collision = false;
+        input.manual.control = false;
+        if ((record.flags & INPUT_JOURNAL_FLAG_COLLISION) && !read(input.collision)) {
+            return false;
+        }
+        if ((record.flags & INPUT_JOURNAL_FLAG_MANUAL) && !read(input.manual)) {
+            return false;
+        }
+        return true;
+    }
+};
+
+}
+
+#endif /* _INPUT_JOURNAL_HPP_ */
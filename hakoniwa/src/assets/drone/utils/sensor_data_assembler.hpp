@@ -44,6 +44,14 @@ public:
     {
         return data_vector.size();
     }
+    void save_state(StateSnapshot& snapshot) const override
+    {
+        snapshot.put(this->data_vector);
+    }
+    bool restore_state(StateSnapshot& snapshot) override
+    {
+        return snapshot.get(this->data_vector);
+    }
 };
 
 }
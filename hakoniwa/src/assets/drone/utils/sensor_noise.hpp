@@ -4,31 +4,33 @@
 #include "isensor_noise.hpp"
 #include <random>
 #include <cmath>
-#include <cstdlib>
-#include <limits>
+#include <cstdint>
 
 namespace hako::assets::drone {
 
+/*
+ * 正規分布のノイズ（Box-Muller 法）。
+ * センサごとに乱数生成器を持つので、乱数の状態をスナップショットで保存・復元できる。
+ */
 class SensorNoise : public hako::assets::drone::ISensorNoise {
 private:
     double stdDev;
+    std::mt19937 engine;
     SensorNoise() {}
+    // (0, 1) の一様乱数
+    double uniform()
+    {
+        return (static_cast<double>(engine()) + 0.5) / 4294967296.0;
+    }
 public:
-    SensorNoise(double v) : stdDev(v) {}
+    SensorNoise(double v, uint32_t seed = std::mt19937::default_seed) : stdDev(v), engine(seed) {}
     virtual ~SensorNoise() {}
 
     double add_random_noise(double data) override
     {
-
-        double x0;
-        double b0, b1;
-
-        do {
-            b0 = static_cast<double>(rand()) / RAND_MAX;
-            b1 = static_cast<double>(rand()) / RAND_MAX;
-        } while (b0 <= std::numeric_limits<float>::min());
-
-        x0 = sqrt(-2.0 * log(b0)) * cos(M_PI * 2.0 * b1);
+        double b0 = uniform();
+        double b1 = uniform();
+        double x0 = sqrt(-2.0 * log(b0)) * cos(M_PI * 2.0 * b1);
 
         if (std::isinf(x0) || std::isnan(x0)) {
             x0 = 0.0;
@@ -36,7 +38,63 @@ public:
 
         return data + (x0 * stdDev);
     }
+    void save_state(StateSnapshot& snapshot) const override
+    {
+        snapshot.put(this->engine);
+    }
+    bool restore_state(StateSnapshot& snapshot) override
+    {
+        return snapshot.get(this->engine);
+    }
+
+};
 
+/*
+ * 標準正規分布の乱数列（Box-Muller 法で2つずつ作る）。
+ * 標準偏差が時間とともに変わる誤差（バイアスなど）を複数持つセンサが使う。
+ */
+class GaussianRandom {
+private:
+    std::mt19937 engine;
+    bool has_spare;
+    double spare;
+    // (0, 1) の一様乱数
+    double uniform()
+    {
+        return (static_cast<double>(engine()) + 0.5) / 4294967296.0;
+    }
+public:
+    GaussianRandom(uint32_t seed = std::mt19937::default_seed) : engine(seed), has_spare(false), spare(0) {}
+
+    double next()
+    {
+        if (has_spare) {
+            has_spare = false;
+            return spare;
+        }
+        double r = std::sqrt(-2.0 * std::log(uniform()));
+        double t = M_PI * 2.0 * uniform();
+        spare = r * std::sin(t);
+        has_spare = true;
+        return r * std::cos(t);
+    }
+    // [0, 1) の一様乱数
+    double next_uniform()
+    {
+        return static_cast<double>(engine()) / 4294967296.0;
+    }
+    void save_state(StateSnapshot& snapshot) const
+    {
+        snapshot.put(this->engine);
+        snapshot.put(this->has_spare);
+        snapshot.put(this->spare);
+    }
+    bool restore_state(StateSnapshot& snapshot)
+    {
+        return snapshot.get(this->engine)
+            && snapshot.get(this->has_spare)
+            && snapshot.get(this->spare);
+    }
 };
 
 }
@@ -0,0 +1,305 @@
+#ifndef _TERRAIN_HEIGHTMAP_HPP_
+#define _TERRAIN_HEIGHTMAP_HPP_
+
+#include "iterrain.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+#ifdef _WIN32
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace hako::assets::drone {
+
+/*
+ * 標高データ（ヘッダなしの raw DEM）による地形。
+ *
+ * ファイルは height 行 x width 列のサンプルを行優先で並べたもの（リトルエンディアン）。
+ * 行 r、列 c のサンプルは地上座標系の (x, y) = (origin_x + r * cell_size, origin_y + c * cell_size) の標高で、
+ * 標高が base_altitude の地面が z = 0 になる。サンプルの間は双線形補間する。
+ *
+ * ファイルはメモリマップし、参照した位置を含むタイル（tile_size x tile_size サンプル）だけを
+ * float に変換してキャッシュする。キャッシュは max_tiles 個までで、超えた場合は最も長く使っていない
+ * タイルを捨てるので、地図の大きさに関係なく使うメモリは一定になる。
+ * 隣のタイルとの境界でも補間できるように、各タイルは右と下に1サンプルずつ余分に持つ。
+ */
+#define TERRAIN_DEFAULT_TILE_SIZE   256
+#define TERRAIN_DEFAULT_MAX_TILES   16
+#define TERRAIN_INT16_NODATA        (-32768)
+
+typedef enum {
+    TERRAIN_FORMAT_INT16 = 0,
+    TERRAIN_FORMAT_FLOAT32,
+} TerrainFormat;
+
+typedef struct {
+    TerrainFormat format;
+    int width;                  // 列数（y 方向）
+    int height;                 // 行数（x 方向）
+    double cell_size;           // サンプルの間隔 [m]
+    double origin_x;            // 行 0 列 0 のサンプルの位置 [m]
+    double origin_y;
+    double height_scale;        // サンプルの値から標高 [m] への倍率
+    double base_altitude;       // z = 0 の標高 [m]
+    int tile_size;
+    int max_tiles;
+} TerrainHeightmapParamType;
+
+class TerrainHeightmap : public ITerrain {
+private:
+    struct Tile {
+        int row;
+        int col;
+        uint64_t last_used;
+        std::vector<float> data;    // (tile_size + 1) x (tile_size + 1)、データなしは NaN
+    };
+    TerrainHeightmapParamType param;
+    size_t sample_bytes;
+    int stride;
+    std::vector<Tile> tiles;
+    int last_tile;
+    uint64_t clock;
+    uint64_t load_count;
+#ifdef _WIN32
+    std::ifstream ifs;
+    std::vector<char> row_buffer;
+#else
+    const unsigned char *map_addr;
+    size_t map_size;
+#endif
+
+    float decode(const unsigned char *p) const
+    {
+        if (param.format == TERRAIN_FORMAT_INT16) {
+            int16_t v;
+            memcpy(&v, p, sizeof(v));
+            if (v == TERRAIN_INT16_NODATA) {
+                return std::numeric_limits<float>::quiet_NaN();
+            }
+            return (float)v;
+        }
+        float v;
+        memcpy(&v, p, sizeof(v));
+        return v;
+    }
+    void load(Tile& tile, int tile_row, int tile_col)
+    {
+        tile.row = tile_row;
+        tile.col = tile_col;
+        int row0 = tile_row * param.tile_size;
+        int col0 = tile_col * param.tile_size;
+        int rows = std::min(stride, param.height - row0);
+        int cols = std::min(stride, param.width - col0);
+        tile.data.assign((size_t)stride * stride, std::numeric_limits<float>::quiet_NaN());
+        for (int r = 0; r < rows; r++) {
+            size_t offset = ((size_t)(row0 + r) * param.width + col0) * sample_bytes;
+#ifdef _WIN32
+            ifs.clear();
+            ifs.seekg((std::streamoff)offset);
+            ifs.read(row_buffer.data(), (std::streamsize)(cols * sample_bytes));
+            const unsigned char *p = reinterpret_cast<const unsigned char*>(row_buffer.data());
+#else
+            const unsigned char *p = map_addr + offset;
+#endif
+            for (int c = 0; c < cols; c++) {
+                tile.data[(size_t)r * stride + c] = decode(p + c * sample_bytes);
+            }
+        }
+#ifndef _WIN32
+        // 変換し終わったファイルのページは手放す（行が飛び飛びなので、行の範囲全体を対象にする）
+        long page = sysconf(_SC_PAGESIZE);
+        size_t begin = ((size_t)row0 * param.width) * sample_bytes;
+        size_t end = ((size_t)(row0 + rows) * param.width) * sample_bytes;
+        begin -= begin % page;
+        madvise(const_cast<unsigned char*>(map_addr) + begin, end - begin, MADV_DONTNEED);
+#endif
+        load_count++;
+    }
+    const Tile& get_tile(int tile_row, int tile_col)
+    {
+        clock++;
+        if ((last_tile >= 0) && (tiles[last_tile].row == tile_row) && (tiles[last_tile].col == tile_col)) {
+            tiles[last_tile].last_used = clock;
+            return tiles[last_tile];
+        }
+        int lru = -1;
+        for (int i = 0; i < (int)tiles.size(); i++) {
+            if ((tiles[i].row == tile_row) && (tiles[i].col == tile_col)) {
+                tiles[i].last_used = clock;
+                last_tile = i;
+                return tiles[i];
+            }
+            if ((lru < 0) || (tiles[i].last_used < tiles[lru].last_used)) {
+                lru = i;
+            }
+        }
+        if ((int)tiles.size() < param.max_tiles) {
+            tiles.emplace_back();
+            lru = (int)tiles.size() - 1;
+        }
+        load(tiles[lru], tile_row, tile_col);
+        tiles[lru].last_used = clock;
+        last_tile = lru;
+        return tiles[lru];
+    }
+
+public:
+    TerrainHeightmap() : sample_bytes(0), stride(0), last_tile(-1), clock(0), load_count(0)
+#ifndef _WIN32
+        , map_addr(nullptr), map_size(0)
+#endif
+    {
+        memset(&param, 0, sizeof(param));
+    }
+    virtual ~TerrainHeightmap()
+    {
+        close();
+    }
+    bool open(const std::string& filepath, const TerrainHeightmapParamType& p)
+    {
+        close();
+        if ((p.width < 2) || (p.height < 2) || (p.cell_size <= 0) || (p.tile_size <= 0) || (p.max_tiles <= 0)) {
+            std::cerr << "ERROR: invalid terrain parameter: " << filepath << std::endl;
+            return false;
+        }
+        size_t bytes = (p.format == TERRAIN_FORMAT_INT16) ? sizeof(int16_t) : sizeof(float);
+        size_t expected = (size_t)p.width * p.height * bytes;
+#ifdef _WIN32
+        ifs.open(filepath, std::ios::in | std::ios::binary);
+        if (!ifs.is_open()) {
+            std::cerr << "ERROR: can not open terrain: " << filepath << std::endl;
+            return false;
+        }
+        ifs.seekg(0, std::ios::end);
+        size_t file_size = (size_t)ifs.tellg();
+        row_buffer.resize((size_t)(p.tile_size + 1) * bytes);
+#else
+        int fd = ::open(filepath.c_str(), O_RDONLY);
+        if (fd < 0) {
+            std::cerr << "ERROR: can not open terrain: " << filepath << std::endl;
+            return false;
+        }
+        struct stat st;
+        size_t file_size = (fstat(fd, &st) == 0) ? (size_t)st.st_size : 0;
+#endif
+        if (file_size < expected) {
+            std::cerr << "ERROR: terrain file is too small: " << filepath << " (" << file_size
+                      << " bytes, expected " << expected << " bytes)" << std::endl;
+#ifdef _WIN32
+            ifs.close();
+#else
+            ::close(fd);
+#endif
+            return false;
+        }
+#ifndef _WIN32
+        void *addr = mmap(nullptr, expected, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (addr == MAP_FAILED) {
+            std::cerr << "ERROR: can not map terrain: " << filepath << std::endl;
+            return false;
+        }
+        map_addr = static_cast<const unsigned char*>(addr);
+        map_size = expected;
+#endif
+        param = p;
+        sample_bytes = bytes;
+        stride = p.tile_size + 1;
+        tiles.clear();
+        tiles.reserve(p.max_tiles);
+        last_tile = -1;
+        clock = 0;
+        load_count = 0;
+        return true;
+    }
+    void close()
+    {
+#ifdef _WIN32
+        if (ifs.is_open()) {
+            ifs.close();
+        }
+#else
+        if (map_addr != nullptr) {
+            munmap(const_cast<unsigned char*>(map_addr), map_size);
+            map_addr = nullptr;
+            map_size = 0;
+        }
+#endif
+        stride = 0;
+        tiles.clear();
+        last_tile = -1;
+    }
+    bool is_open() const
+    {
+        return stride > 0;
+    }
+    const TerrainHeightmapParamType& get_param() const
+    {
+        return param;
+    }
+    int get_loaded_tile_num() const
+    {
+        return (int)tiles.size();
+    }
+    uint64_t get_tile_load_count() const
+    {
+        return load_count;
+    }
+    /*
+     * 標高 [m]。地形の範囲外またはデータなしの場合は false
+     */
+    bool get_altitude(double x, double y, double& altitude)
+    {
+        if (stride == 0) {
+            return false;
+        }
+        double fr = (x - param.origin_x) / param.cell_size;
+        double fc = (y - param.origin_y) / param.cell_size;
+        if (!(fr >= 0) || !(fc >= 0) || (fr > param.height - 1) || (fc > param.width - 1)) {
+            return false;
+        }
+        int r = std::min((int)fr, param.height - 2);
+        int c = std::min((int)fc, param.width - 2);
+        double tr = fr - r;
+        double tc = fc - c;
+        const Tile& tile = get_tile(r / param.tile_size, c / param.tile_size);
+        const float *p = &tile.data[(size_t)(r % param.tile_size) * stride + (c % param.tile_size)];
+        // 重みが 0 のサンプルは使わない（隣がデータなしでもサンプルの位置ちょうどなら求まる）
+        const double w[4] = { (1.0 - tr) * (1.0 - tc), (1.0 - tr) * tc, tr * (1.0 - tc), tr * tc };
+        const float v[4] = { p[0], p[1], p[stride], p[stride + 1] };
+        double h = 0;
+        for (int i = 0; i < 4; i++) {
+            if (w[i] > 0) {
+                h += w[i] * v[i];
+            }
+        }
+        if (std::isnan(h)) {
+            return false;
+        }
+        altitude = h * param.height_scale;
+        return true;
+    }
+    bool get_ground_z(double x, double y, double& ground_z) override
+    {
+        double altitude;
+        if (!get_altitude(x, y, altitude)) {
+            return false;
+        }
+        ground_z = -(altitude - param.base_altitude);
+        return true;
+    }
+};
+
+}
+
+#endif /* _TERRAIN_HEIGHTMAP_HPP_ */
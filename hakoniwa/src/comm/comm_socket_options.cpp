@@ -0,0 +1,88 @@
+#include "comm_socket_options.hpp"
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <string.h>
+#include <errno.h>
+#include <iostream>
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace hako::px4::comm {
+
+static bool comm_setsockopt(int sockfd, int level, int optname, int optval, const char* name)
+{
+    if (setsockopt(sockfd, level, optname, &optval, sizeof(optval)) < 0) {
+        std::cout << "WARNING: Failed to set " << name << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool comm_socket_options_apply(int sockfd, const CommSocketOptionsType& options, bool is_stream)
+{
+    bool ret = true;
+    if (is_stream && options.tcp_nodelay) {
+        ret &= comm_setsockopt(sockfd, IPPROTO_TCP, TCP_NODELAY, 1, "TCP_NODELAY");
+    }
+    if (is_stream && options.tcp_quickack) {
+        ret &= comm_socket_quickack(sockfd);
+    }
+    if (options.rcvbuf_size > 0) {
+        ret &= comm_setsockopt(sockfd, SOL_SOCKET, SO_RCVBUF, options.rcvbuf_size, "SO_RCVBUF");
+    }
+    if (options.sndbuf_size > 0) {
+        ret &= comm_setsockopt(sockfd, SOL_SOCKET, SO_SNDBUF, options.sndbuf_size, "SO_SNDBUF");
+    }
+#ifdef SO_BUSY_POLL
+    if (options.busy_poll_usec > 0) {
+        ret &= comm_setsockopt(sockfd, SOL_SOCKET, SO_BUSY_POLL, options.busy_poll_usec, "SO_BUSY_POLL");
+    }
+#endif
+#ifdef SO_PRIORITY
+    if (options.priority >= 0) {
+        ret &= comm_setsockopt(sockfd, SOL_SOCKET, SO_PRIORITY, options.priority, "SO_PRIORITY");
+    }
+#endif
+    return ret;
+}
+
+/*
+ * TCP_QUICKACK は一度設定しても受信処理の中で解除されることがあるため、
+ * 受信のたびに設定し直す必要がある。
+ */
+bool comm_socket_quickack(int sockfd)
+{
+#ifdef TCP_QUICKACK
+    int optval = 1;
+    return setsockopt(sockfd, IPPROTO_TCP, TCP_QUICKACK, &optval, sizeof(optval)) == 0;
+#else
+    (void)sockfd;
+    return true;
+#endif
+}
+
+bool comm_thread_set_cpu_affinity(int cpu)
+{
+    if (cpu < 0) {
+        return true;
+    }
+#ifdef __linux__
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(cpu, &cpuset);
+    int err = pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset);
+    if (err != 0) {
+        std::cout << "WARNING: Failed to set cpu affinity(" << cpu << "): " << strerror(err) << std::endl;
+        return false;
+    }
+    return true;
+#else
+    std::cout << "WARNING: cpu affinity is not supported on this platform" << std::endl;
+    return false;
+#endif
+}
+
+} // namespace hako::px4::comm
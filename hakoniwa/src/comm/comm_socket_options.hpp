@@ -0,0 +1,32 @@
+#ifndef _COMM_SOCKET_OPTIONS_HPP_
+#define _COMM_SOCKET_OPTIONS_HPP_
+
+namespace hako::px4::comm {
+
+    /*
+     * 低遅延向けのソケットオプション。
+     * 0 や -1 の項目は OS のデフォルトのままとする。
+     */
+    typedef struct {
+        bool tcp_nodelay;       // Nagle アルゴリズムを無効化する (TCP のみ)
+        bool tcp_quickack;      // 遅延 ACK を無効化する (TCP かつ Linux のみ)
+        int rcvbuf_size;        // SO_RCVBUF [byte]
+        int sndbuf_size;        // SO_SNDBUF [byte]
+        int busy_poll_usec;     // SO_BUSY_POLL [usec] (Linux のみ)
+        int priority;           // SO_PRIORITY (Linux のみ, -1: 未設定)
+        int io_cpu_affinity;    // 通信スレッドを固定する CPU 番号 (Linux のみ, -1: 未設定)
+    } CommSocketOptionsType;
+
+    static inline CommSocketOptionsType comm_socket_options_default()
+    {
+        CommSocketOptionsType options = { false, false, 0, 0, 0, -1, -1 };
+        return options;
+    }
+
+    extern bool comm_socket_options_apply(int sockfd, const CommSocketOptionsType& options, bool is_stream);
+    extern bool comm_socket_quickack(int sockfd);
+    extern bool comm_thread_set_cpu_affinity(int cpu);
+
+}
+
+#endif /* _COMM_SOCKET_OPTIONS_HPP_ */
@@ -1,6 +1,8 @@
 #ifndef _ICOMM_CONNECTOR_HPP_
 #define _ICOMM_CONNECTOR_HPP_
 
+#include "comm_socket_options.hpp"
+
 namespace hako::px4::comm {
 
     typedef struct {
@@ -14,18 +16,59 @@ namespace hako::px4::comm {
         virtual bool send(const char* data, int datalen, int* send_datalen) = 0;
         virtual bool recv(char* data, int datalen, int* recv_datalen) = 0;
         virtual bool close() = 0;
+        virtual bool is_connected() = 0;
+        /*
+         * poll() で待つためのディスクリプタ。待てない実装は -1 を返す。
+         */
+        virtual int get_fd() { return -1; }
+        /*
+         * 内部バッファに受信済みのフレームが残っているか。
+         * true の間は、ディスクリプタが readable にならなくても recv() がブロックしない。
+         */
+        virtual bool recv_pending() { return false; }
+        /*
+         * poll() で待つ側が使う。true にすると recv() は受信済みのデータだけでフレームを返し、
+         * そろっていなければ待たずに false を返す（is_connected() は true のまま）。
+         * 対応していない実装は false を返す。
+         */
+        virtual bool set_nonblocking(bool enable) { (void)enable; return false; }
+        /*
+         * 他のスレッドから接続を止める。recv() で待っているスレッドは切断として戻る。
+         * ディスクリプタは閉じないので、解放は close() で行う。
+         */
+        virtual void shutdown() {}
+        /*
+         * 複数のフレームをまとめて送信する。
+         * 実装がまとめて送信できない場合は、1フレームずつ send() する。
+         */
+        virtual bool send_batch(const char* const data[], const int datalen[], int num, int* sent_num)
+        {
+            int i;
+            for (i = 0; i < num; i++) {
+                int send_datalen = 0;
+                if (!send(data[i], datalen[i], &send_datalen)) {
+                    break;
+                }
+            }
+            if (sent_num != nullptr) {
+                *sent_num = i;
+            }
+            return i == num;
+        }
     };
 
     class ICommServer {
     public:
         virtual ~ICommServer() = default;
         virtual ICommIO* server_open(IcommEndpointType *endpoint) = 0;
+        virtual void set_socket_options(const CommSocketOptionsType& options) { (void)options; }
     };
 
     class ICommClient {
     public:
         virtual ~ICommClient() = default;
         virtual ICommIO* client_open(IcommEndpointType *src, IcommEndpointType *dst) = 0;
+        virtual void set_socket_options(const CommSocketOptionsType& options) { (void)options; }
     };
 
 }
@@ -0,0 +1,375 @@
+#include "shm_connector.hpp"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <string.h>
+#include <errno.h>
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#endif
+
+#define SHM_FRAME_HEADER_LEN    2
+#define SHM_CONNECT_TIMEOUT_MSEC    (1800 * 1000)
+#define SHM_RETRY_INTERVAL_MSEC     10
+
+namespace hako::px4::comm {
+
+static uint64_t shm_now_usec()
+{
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::microseconds>(now).count();
+}
+
+/*
+ * futex は別プロセスと共有するため FUTEX_PRIVATE_FLAG は付けない
+ */
+static void shm_futex_wait(std::atomic<uint32_t> *addr, uint32_t expected, int timeout_msec)
+{
+#ifdef __linux__
+    struct timespec timeout;
+    timeout.tv_sec = timeout_msec / 1000;
+    timeout.tv_nsec = (long)(timeout_msec % 1000) * 1000000L;
+    (void)syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), FUTEX_WAIT, expected, &timeout, nullptr, 0);
+#else
+    (void)timeout_msec;
+    if (addr->load(std::memory_order_acquire) == expected) {
+        usleep(50);
+    }
+#endif
+}
+
+static void shm_futex_wake(std::atomic<uint32_t> *addr)
+{
+#ifdef __linux__
+    (void)syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), FUTEX_WAKE, INT32_MAX, nullptr, nullptr, 0);
+#else
+    (void)addr;
+#endif
+}
+
+static void shm_ring_init(ShmRingType *ring)
+{
+    ring->head.store(0, std::memory_order_relaxed);
+    ring->tail.store(0, std::memory_order_relaxed);
+    ring->seq.store(0, std::memory_order_relaxed);
+    ring->waiting.store(0, std::memory_order_relaxed);
+}
+
+static void shm_ring_copy_in(ShmRingType *ring, uint32_t pos, const uint8_t *src, uint32_t len)
+{
+    uint32_t offset = pos & (SHM_RING_SIZE - 1);
+    uint32_t first = std::min(len, (uint32_t)SHM_RING_SIZE - offset);
+    memcpy(&ring->data[offset], src, first);
+    memcpy(&ring->data[0], src + first, len - first);
+}
+
+static void shm_ring_copy_out(const ShmRingType *ring, uint32_t pos, uint8_t *dst, uint32_t len)
+{
+    uint32_t offset = pos & (SHM_RING_SIZE - 1);
+    uint32_t first = std::min(len, (uint32_t)SHM_RING_SIZE - offset);
+    memcpy(dst, &ring->data[offset], first);
+    memcpy(dst + first, &ring->data[0], len - first);
+}
+
+// 書き手: 空きがなければ false
+static bool shm_ring_push(ShmRingType *ring, const char *data, int datalen)
+{
+    uint32_t head = ring->head.load(std::memory_order_relaxed);
+    uint32_t tail = ring->tail.load(std::memory_order_acquire);
+    uint32_t need = SHM_FRAME_HEADER_LEN + (uint32_t)datalen;
+    if ((SHM_RING_SIZE - (head - tail)) < need) {
+        return false;
+    }
+    uint8_t header[SHM_FRAME_HEADER_LEN] = { (uint8_t)(datalen & 0xFF), (uint8_t)((datalen >> 8) & 0xFF) };
+    shm_ring_copy_in(ring, head, header, SHM_FRAME_HEADER_LEN);
+    shm_ring_copy_in(ring, head + SHM_FRAME_HEADER_LEN, (const uint8_t*)data, (uint32_t)datalen);
+    ring->head.store(head + need, std::memory_order_seq_cst);
+    // 読み手が寝ているときだけ seq を進めて起こす。
+    // 読み手は waiting を立ててから head を見直すので、この push を見落とすことはない。
+    if (ring->waiting.load(std::memory_order_seq_cst) != 0) {
+        ring->seq.fetch_add(1, std::memory_order_release);
+        shm_futex_wake(&ring->seq);
+    }
+    return true;
+}
+
+// 読み手: フレームがなければ 0, バッファ不足なら -1
+static int shm_ring_pop(ShmRingType *ring, char *data, int datalen)
+{
+    uint32_t tail = ring->tail.load(std::memory_order_relaxed);
+    uint32_t head = ring->head.load(std::memory_order_acquire);
+    if (head == tail) {
+        return 0;
+    }
+    uint8_t header[SHM_FRAME_HEADER_LEN];
+    shm_ring_copy_out(ring, tail, header, SHM_FRAME_HEADER_LEN);
+    int len = (int)header[0] | ((int)header[1] << 8);
+    if (len > datalen) {
+        ring->tail.store(tail + SHM_FRAME_HEADER_LEN + len, std::memory_order_release);
+        return -1;
+    }
+    shm_ring_copy_out(ring, tail + SHM_FRAME_HEADER_LEN, (uint8_t*)data, (uint32_t)len);
+    ring->tail.store(tail + SHM_FRAME_HEADER_LEN + len, std::memory_order_release);
+    return len;
+}
+
+std::string shm_segment_name(int portno)
+{
+    return "/hako_px4sim_" + std::to_string(portno);
+}
+
+bool shm_segment_exists(int portno)
+{
+    int fd = shm_open(shm_segment_name(portno).c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        return false;
+    }
+    ::close(fd);
+    return true;
+}
+
+static ShmSegmentType *shm_segment_map(int fd, size_t size)
+{
+    void *addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        std::cout << "Failed to mmap shared memory: " << strerror(errno) << std::endl;
+        return nullptr;
+    }
+    return static_cast<ShmSegmentType*>(addr);
+}
+
+/*
+ * ShmCommIO
+ */
+ShmCommIO::ShmCommIO(ShmSegmentType *segment, bool is_server, size_t unmap_size)
+    : segment(segment), is_server(is_server), connected(true), unmap_size(unmap_size),
+      peer_check_time_usec(0), dropped(0)
+{
+    tx_ring = is_server ? &segment->to_client : &segment->to_server;
+    rx_ring = is_server ? &segment->to_server : &segment->to_client;
+}
+
+ShmCommIO::~ShmCommIO() {
+    close();
+}
+
+bool ShmCommIO::peer_alive() {
+    if (segment->state.load(std::memory_order_acquire) != SHM_STATE_CONNECTED) {
+        return false;
+    }
+    // kill() はシステムコールなので SHM_WAIT_TIMEOUT_MSEC に1回だけ確認する
+    uint64_t now_usec = shm_now_usec();
+    if ((now_usec - peer_check_time_usec.load(std::memory_order_relaxed)) < (uint64_t)SHM_WAIT_TIMEOUT_MSEC * 1000) {
+        return true;
+    }
+    peer_check_time_usec.store(now_usec, std::memory_order_relaxed);
+    int32_t pid = is_server ? segment->client_pid.load() : segment->server_pid.load();
+    if ((pid > 0) && (kill(pid, 0) < 0) && (errno == ESRCH)) {
+        return false;
+    }
+    return true;
+}
+
+bool ShmCommIO::send(const char* data, int datalen, int* send_datalen) {
+    if (!connected || data == nullptr || datalen <= 0 || datalen > 0xFFFF) {
+        return false;
+    }
+    // 相手が読まずにリングが一杯の場合は、待たずにこのフレームを破棄する
+    if (!shm_ring_push(tx_ring, data, datalen)) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        if (!peer_alive()) {
+            connected = false;
+        }
+        return false;
+    }
+    if (send_datalen != nullptr) {
+        *send_datalen = datalen;
+    }
+    return true;
+}
+
+bool ShmCommIO::recv(char* data, int datalen, int* recv_datalen) {
+    if (!connected || data == nullptr || datalen <= 0) {
+        return false;
+    }
+    uint64_t spin_begin_usec = 0;
+    while (true) {
+        uint32_t seq = rx_ring->seq.load(std::memory_order_acquire);
+        int len = shm_ring_pop(rx_ring, data, datalen);
+        if (len < 0) {
+            std::cout << "Provided data buffer is too small to hold the MAVLink message." << std::endl;
+            return false;
+        }
+        if (len > 0) {
+            if (recv_datalen != nullptr) {
+                *recv_datalen = len;
+            }
+            return true;
+        }
+        // CPU の速さによらず、同じ時間だけスピンする
+        uint64_t now_usec = shm_now_usec();
+        if (spin_begin_usec == 0) {
+            spin_begin_usec = now_usec;
+        }
+        if ((now_usec - spin_begin_usec) < SHM_SPIN_USEC) {
+            continue;
+        }
+        rx_ring->waiting.store(1, std::memory_order_seq_cst);
+        if (rx_ring->head.load(std::memory_order_seq_cst) == rx_ring->tail.load(std::memory_order_relaxed)) {
+            shm_futex_wait(&rx_ring->seq, seq, SHM_WAIT_TIMEOUT_MSEC);
+        }
+        rx_ring->waiting.store(0, std::memory_order_relaxed);
+        if (!peer_alive()) {
+            connected = false;
+            return false;
+        }
+        spin_begin_usec = 0;
+    }
+}
+
+bool ShmCommIO::close() {
+    if (segment == nullptr) {
+        return true;
+    }
+    connected = false;
+    if (dropped.load(std::memory_order_relaxed) > 0) {
+        std::cout << "INFO: shm send dropped " << dropped.load(std::memory_order_relaxed) << " frames (ring full)" << std::endl;
+    }
+    segment->state.store(SHM_STATE_CLOSED, std::memory_order_release);
+    shm_futex_wake(&segment->state);
+    // 相手が recv() で待っている場合に起こす
+    segment->to_client.seq.fetch_add(1);
+    segment->to_server.seq.fetch_add(1);
+    shm_futex_wake(&segment->to_client.seq);
+    shm_futex_wake(&segment->to_server.seq);
+    if (unmap_size > 0) {
+        munmap(segment, unmap_size);
+    }
+    segment = nullptr;
+    return true;
+}
+
+bool ShmCommIO::is_connected() {
+    return connected;
+}
+
+/*
+ * ShmClient
+ */
+ShmClient::ShmClient() {}
+
+ShmClient::~ShmClient() {}
+
+/*
+ * サーバが共有メモリを作成してから ftruncate() と初期化を終えるまでの間に開くことがあるので、
+ * サイズが ShmSegmentType と一致し、magic が見えるまで SHM_CONNECT_TIMEOUT_MSEC の範囲でリトライする。
+ */
+ICommIO* ShmClient::client_open(IcommEndpointType *src, IcommEndpointType *dst) {
+    (void)src;
+    std::string name = shm_segment_name(dst->portno);
+    size_t segment_size = sizeof(ShmSegmentType);
+    ShmSegmentType *segment = nullptr;
+    int elapsed_msec = 0;
+    while (true) {
+        int fd = shm_open(name.c_str(), O_RDWR, 0);
+        if (fd >= 0) {
+            struct stat st;
+            if ((fstat(fd, &st) == 0) && ((size_t)st.st_size == segment_size)) {
+                segment = shm_segment_map(fd, segment_size);
+            }
+            ::close(fd);
+        }
+        if (segment != nullptr) {
+            if (segment->magic.load(std::memory_order_acquire) == SHM_SEGMENT_MAGIC) {
+                break;
+            }
+            munmap(segment, segment_size);
+            segment = nullptr;
+        }
+        if (elapsed_msec >= SHM_CONNECT_TIMEOUT_MSEC) {
+            std::cout << "Failed to open shared memory " << name << ": "
+                      << ((fd < 0) ? strerror(errno) : "segment is not initialized") << std::endl;
+            return nullptr;
+        }
+        usleep(SHM_RETRY_INTERVAL_MSEC * 1000);
+        elapsed_msec += SHM_RETRY_INTERVAL_MSEC;
+    }
+    // version は magic より前に書かれているので、magic が見えていれば正しい値が読める
+    if (segment->version != SHM_SEGMENT_VERSION) {
+        std::cout << "Invalid shared memory segment: " << name << " (version " << segment->version << ")" << std::endl;
+        munmap(segment, segment_size);
+        return nullptr;
+    }
+    uint32_t expected = SHM_STATE_WAITING;
+    if (!segment->state.compare_exchange_strong(expected, SHM_STATE_CONNECTED)) {
+        std::cout << "Shared memory " << name << " is already in use" << std::endl;
+        munmap(segment, segment_size);
+        return nullptr;
+    }
+    segment->client_pid.store((int32_t)getpid());
+    shm_futex_wake(&segment->state);
+    return new ShmCommIO(segment, false, segment_size);
+}
+
+/*
+ * ShmServer
+ */
+ShmServer::ShmServer() : segment(nullptr), segment_size(sizeof(ShmSegmentType)) {}
+
+ShmServer::~ShmServer() {
+    server_close();
+}
+
+ICommIO* ShmServer::server_open(IcommEndpointType *endpoint) {
+    if (segment == nullptr) {
+        name = shm_segment_name(endpoint->portno);
+        int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0600);
+        if (fd < 0) {
+            std::cout << "Failed to create shared memory " << name << ": " << strerror(errno) << std::endl;
+            return nullptr;
+        }
+        if (ftruncate(fd, (off_t)segment_size) < 0) {
+            std::cout << "Failed to resize shared memory: " << strerror(errno) << std::endl;
+            ::close(fd);
+            return nullptr;
+        }
+        segment = shm_segment_map(fd, segment_size);
+        ::close(fd);
+        if (segment == nullptr) {
+            return nullptr;
+        }
+    }
+    // 前の接続の残りを捨てて、次のクライアントを待つ。初期化が終わるまでクライアントには見せない
+    segment->magic.store(0, std::memory_order_release);
+    segment->version = SHM_SEGMENT_VERSION;
+    shm_ring_init(&segment->to_client);
+    shm_ring_init(&segment->to_server);
+    segment->client_pid.store(0);
+    segment->server_pid.store((int32_t)getpid());
+    segment->state.store(SHM_STATE_WAITING, std::memory_order_release);
+    segment->magic.store(SHM_SEGMENT_MAGIC, std::memory_order_release);
+    while (segment->state.load(std::memory_order_acquire) != SHM_STATE_CONNECTED) {
+        shm_futex_wait(&segment->state, SHM_STATE_WAITING, SHM_WAIT_TIMEOUT_MSEC);
+    }
+    return new ShmCommIO(segment, true);
+}
+
+bool ShmServer::server_close() {
+    if (segment == nullptr) {
+        return true;
+    }
+    segment->state.store(SHM_STATE_CLOSED, std::memory_order_release);
+    munmap(segment, segment_size);
+    segment = nullptr;
+    shm_unlink(name.c_str());
+    return true;
+}
+
+} // namespace hako::px4::comm
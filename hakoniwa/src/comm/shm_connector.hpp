@@ -0,0 +1,115 @@
+#ifndef _SHMCONNECTOR_HPP_
+#define _SHMCONNECTOR_HPP_
+
+#include "icomm_connector.hpp"
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace hako::px4::comm {
+
+/*
+ * 同一ホスト上の PX4 SITL と共有メモリで通信する。
+ *
+ * POSIX 共有メモリ上に、方向ごとに1本ずつ SPSC (single producer single consumer) の
+ * バイトリングを置き、[長さ(2byte)][MAVLink フレーム] の形式で書き込む。
+ * 読み手は SHM_SPIN_USEC だけスピンしてから futex で待つので、書き手が futex_wake を呼ぶのは
+ * 読み手が寝ているときだけになる。定常状態ではステップごとのシステムコールは発生しない。
+ * futex のない環境では短い usleep によるポーリングになる。
+ * 相手プロセスの生存確認(kill(pid, 0))は SHM_WAIT_TIMEOUT_MSEC に1回だけ行う。
+ *
+ * 書き手はリングが一杯のときは待たずに送信を失敗させ、破棄数を数える。
+ *
+ * 共有メモリ名は、エンドポイントのポート番号から "/hako_px4sim_<port>" とする。
+ */
+#define SHM_RING_SIZE           (64 * 1024)     /* 2のべき乗 */
+#define SHM_SEGMENT_MAGIC       0x48414B4FU     /* "HAKO" */
+#define SHM_SEGMENT_VERSION     1
+#define SHM_SPIN_USEC           50
+#define SHM_WAIT_TIMEOUT_MSEC   100
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "shared memory requires lock-free atomics");
+
+typedef struct {
+    alignas(64) std::atomic<uint32_t> head;     // 書き手が進める
+    alignas(64) std::atomic<uint32_t> tail;     // 読み手が進める
+    alignas(64) std::atomic<uint32_t> seq;      // futex ワード（読み手が待っているときの書き込みで加算）
+    std::atomic<uint32_t> waiting;              // 読み手が futex で待っているか
+    alignas(64) uint8_t data[SHM_RING_SIZE];
+} ShmRingType;
+
+/*
+ * サーバはリングを初期化し終えてから magic を release で書き込む。
+ * クライアントは magic を acquire で読み、正しい値が見えるまで接続しない。
+ */
+typedef struct {
+    std::atomic<uint32_t> magic;
+    uint32_t version;
+    std::atomic<uint32_t> state;                // futex ワード（ShmStateType）
+    std::atomic<int32_t> server_pid;
+    std::atomic<int32_t> client_pid;
+    ShmRingType to_client;                      // hako-px4sim => PX4
+    ShmRingType to_server;                      // PX4 => hako-px4sim
+} ShmSegmentType;
+
+typedef enum {
+    SHM_STATE_WAITING = 0,  // サーバがクライアントの接続を待っている
+    SHM_STATE_CONNECTED,
+    SHM_STATE_CLOSED,
+} ShmStateType;
+
+class ShmCommIO : public ICommIO {
+private:
+    ShmSegmentType *segment;
+    ShmRingType *tx_ring;
+    ShmRingType *rx_ring;
+    bool is_server;
+    bool connected;
+    size_t unmap_size;  // 0 以外ならクローズ時にこのサイズで munmap する
+    std::atomic<uint64_t> peer_check_time_usec;   // send/recv の両スレッドから参照する
+    std::atomic<uint64_t> dropped;
+    bool peer_alive();
+
+public:
+    ShmCommIO(ShmSegmentType *segment, bool is_server, size_t unmap_size = 0);
+    ~ShmCommIO() override;
+
+    bool send(const char* data, int datalen, int* send_datalen) override;
+    bool recv(char* data, int datalen, int* recv_datalen) override;
+    bool close() override;
+    bool is_connected() override;
+    uint64_t get_dropped() const { return dropped.load(std::memory_order_relaxed); }
+};
+
+class ShmClient : public ICommClient {
+public:
+    ShmClient();
+    ~ShmClient() override;
+
+    ICommIO* client_open(IcommEndpointType *src, IcommEndpointType *dst) override;
+};
+
+/*
+ * server_open() のたびに共有メモリのリングを初期化し、次のクライアントの接続を待つ。
+ * 同時に接続できるクライアントは1つだけ。
+ */
+class ShmServer : public ICommServer {
+private:
+    std::string name;
+    ShmSegmentType *segment;
+    size_t segment_size;
+
+public:
+    ShmServer();
+    ~ShmServer() override;
+
+    ICommIO* server_open(IcommEndpointType *endpoint) override;
+    bool server_close();
+};
+
+extern std::string shm_segment_name(int portno);
+extern bool shm_segment_exists(int portno);
+
+} // namespace hako::px4::comm
+
+#endif /* _SHMCONNECTOR_HPP_ */
@@ -0,0 +1,70 @@
+#include "shm_px4_shim.h"
+#include "shm_connector.hpp"
+#include "tcp_connector.hpp"
+#include <iostream>
+
+using hako::px4::comm::ICommIO;
+using hako::px4::comm::IcommEndpointType;
+
+struct hako_px4_link {
+    ICommIO *comm_io;
+    bool is_shm;
+};
+
+hako_px4_link_t* hako_px4_link_open(const char* ipaddr, int portno)
+{
+    IcommEndpointType endpoint = { ipaddr, portno };
+    ICommIO *comm_io = nullptr;
+    bool is_shm = hako::px4::comm::shm_segment_exists(portno);
+    if (is_shm) {
+        hako::px4::comm::ShmClient client;
+        comm_io = client.client_open(nullptr, &endpoint);
+    }
+    if (comm_io == nullptr) {
+        // 共有メモリが使えない場合（リモート接続など）は TCP で接続する
+        is_shm = false;
+        hako::px4::comm::TcpClient client;
+        hako::px4::comm::CommSocketOptionsType options = hako::px4::comm::comm_socket_options_default();
+        options.tcp_nodelay = true;
+        client.set_socket_options(options);
+        comm_io = client.client_open(nullptr, &endpoint);
+    }
+    if (comm_io == nullptr) {
+        return nullptr;
+    }
+    std::cout << "INFO: hako px4 link opened: " << (is_shm ? "shm" : "tcp") << std::endl;
+    return new hako_px4_link{ comm_io, is_shm };
+}
+
+int hako_px4_link_send(hako_px4_link_t* link, const void* data, int datalen)
+{
+    int send_datalen = 0;
+    if ((link == nullptr) || !link->comm_io->send(static_cast<const char*>(data), datalen, &send_datalen)) {
+        return -1;
+    }
+    return send_datalen;
+}
+
+int hako_px4_link_recv(hako_px4_link_t* link, void* buffer, int buflen)
+{
+    int recv_datalen = 0;
+    if ((link == nullptr) || !link->comm_io->recv(static_cast<char*>(buffer), buflen, &recv_datalen)) {
+        return -1;
+    }
+    return recv_datalen;
+}
+
+int hako_px4_link_is_shm(const hako_px4_link_t* link)
+{
+    return ((link != nullptr) && link->is_shm) ? 1 : 0;
+}
+
+void hako_px4_link_close(hako_px4_link_t* link)
+{
+    if (link == nullptr) {
+        return;
+    }
+    link->comm_io->close();
+    delete link->comm_io;
+    delete link;
+}
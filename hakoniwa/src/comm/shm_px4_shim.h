@@ -0,0 +1,27 @@
+#ifndef _SHM_PX4_SHIM_H_
+#define _SHM_PX4_SHIM_H_
+
+/*
+ * PX4 側から hako-px4sim と通信するための小さな C インタフェース。
+ *
+ * 同一ホストで hako-px4sim が共有メモリ(transport: "shm")で待ち受けていれば共有メモリで、
+ * そうでなければ TCP で接続する。呼び出し側は通信方式を意識する必要はない。
+ * 送受信の単位は MAVLink フレーム1つ。
+ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct hako_px4_link hako_px4_link_t;
+
+extern hako_px4_link_t* hako_px4_link_open(const char* ipaddr, int portno);
+extern int hako_px4_link_send(hako_px4_link_t* link, const void* data, int datalen);
+extern int hako_px4_link_recv(hako_px4_link_t* link, void* buffer, int buflen);
+extern int hako_px4_link_is_shm(const hako_px4_link_t* link);
+extern void hako_px4_link_close(hako_px4_link_t* link);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _SHM_PX4_SHIM_H_ */
@@ -5,28 +5,52 @@
 #include <iostream>  // Added for error output
 #include <arpa/inet.h>  // for inet_pton
 #include <unistd.h>
+#include <algorithm>
+#include <sys/uio.h>
+#include "../utils/hako_profile.hpp"
 
-#define MAX_ATTEMPTS 600
-#define RETRY_INTERVAL 3
+/*
+ * 接続リトライは短い間隔から始めて倍々で延ばす（上限 RETRY_INTERVAL_MAX_MSEC）。
+ * PX4 の再起動直後でも素早く再接続できるようにするため。
+ */
+#define CONNECT_TIMEOUT_MSEC        (1800 * 1000)
+#define RETRY_INTERVAL_MIN_MSEC     10
+#define RETRY_INTERVAL_MAX_MSEC     1000
+#define LISTEN_BACKLOG              16
+
+/*
+ * 切断済みソケットへの書き込みで SIGPIPE によりプロセスが落ちないようにする
+ */
+#ifdef MSG_NOSIGNAL
+#define TCP_SEND_FLAGS  MSG_NOSIGNAL
+#else
+#define TCP_SEND_FLAGS  0
+#endif
 
 namespace hako::px4::comm {
 
-TcpCommIO::TcpCommIO(int sockfd) : sockfd(sockfd) {}
+TcpCommIO::TcpCommIO(int sockfd, const CommSocketOptionsType& options) 
+    : sockfd(sockfd), connected(true), quickack(options.tcp_quickack), nonblocking(false),
+      recv_head(0), recv_tail(0) {
+#ifdef SO_NOSIGPIPE
+    int optval = 1;
+    (void)setsockopt(sockfd, SOL_SOCKET, SO_NOSIGPIPE, &optval, sizeof(optval));
+#endif
+}
 
 TcpCommIO::~TcpCommIO() {
     close();
 }
 
-TcpClient::TcpClient() {}
+TcpClient::TcpClient() : options(comm_socket_options_default()) {}
 
 TcpClient::~TcpClient() {}
 
+void TcpClient::set_socket_options(const CommSocketOptionsType& opts) {
+    options = opts;
+}
+
 ICommIO* TcpClient::client_open(IcommEndpointType *src, IcommEndpointType *dst) {
-    int sockfd = socket(AF_INET, SOCK_STREAM, 0);
-    if (sockfd < 0) {
-        std::cout << "Failed to create socket: " << strerror(errno) << std::endl;
-        return nullptr;
-    }
     if (src != nullptr) {
         //nothing to do
     }
@@ -37,35 +61,57 @@ ICommIO* TcpClient::client_open(IcommEndpointType *src, IcommEndpointType *dst)
     remote_addr.sin_addr.s_addr = inet_addr(dst->ipaddr);
     remote_addr.sin_port = htons(dst->portno);
     int attempt = 0;
-    while (connect(sockfd, (struct sockaddr*)&remote_addr, sizeof(remote_addr)) < 0) {
-        if (++attempt >= MAX_ATTEMPTS) {
-            std::cout << "Failed to connect after " << MAX_ATTEMPTS << " attempts: " << strerror(errno) << std::endl;
-            ::close(sockfd);
+    int elapsed_msec = 0;
+    int interval_msec = RETRY_INTERVAL_MIN_MSEC;
+    while (true) {
+        // connect() に失敗したソケットは再利用できないので、試行ごとに作り直す
+        int sockfd = socket(AF_INET, SOCK_STREAM, 0);
+        if (sockfd < 0) {
+            std::cout << "Failed to create socket: " << strerror(errno) << std::endl;
             return nullptr;
         }
-
-        std::cout << "Connection attempt " << attempt << " failed, retrying..." << std::endl;
-        sleep(RETRY_INTERVAL); // リトライ間隔（秒単位）
+        (void)comm_socket_options_apply(sockfd, options, true);
+        if (connect(sockfd, (struct sockaddr*)&remote_addr, sizeof(remote_addr)) == 0) {
+            return new TcpCommIO(sockfd, options);
+        }
+        int err = errno;
+        ::close(sockfd);
+        ++attempt;
+        if (elapsed_msec >= CONNECT_TIMEOUT_MSEC) {
+            std::cout << "Failed to connect after " << attempt << " attempts: " << strerror(err) << std::endl;
+            return nullptr;
+        }
+        if (interval_msec >= RETRY_INTERVAL_MAX_MSEC) {
+            std::cout << "Connection attempt " << attempt << " failed, retrying..." << std::endl;
+        }
+        usleep(interval_msec * 1000); // リトライ間隔（ミリ秒単位）
+        elapsed_msec += interval_msec;
+        interval_msec = std::min(interval_msec * 2, RETRY_INTERVAL_MAX_MSEC);
     }
-    return new TcpCommIO(sockfd);
 }
 
-TcpServer::TcpServer() {}
+TcpServer::TcpServer() : listen_sockfd(-1), options(comm_socket_options_default()) {}
 
-TcpServer::~TcpServer() {}
+TcpServer::~TcpServer() {
+    server_close();
+}
 
-ICommIO* TcpServer::server_open(IcommEndpointType *endpoint) {
+void TcpServer::set_socket_options(const CommSocketOptionsType& opts) {
+    options = opts;
+}
+
+bool TcpServer::listen_open(IcommEndpointType *endpoint) {
     int sockfd = socket(AF_INET, SOCK_STREAM, 0);
     if (sockfd < 0) {
         std::cout << "Failed to create socket: " << strerror(errno) << std::endl;
-        return nullptr;
+        return false;
     }
     // SO_REUSEADDR オプションを設定
     int optval = 1;
     if (setsockopt(sockfd, SOL_SOCKET, SO_REUSEADDR, &optval, sizeof(optval)) < 0) {
         std::cout << "Failed to set SO_REUSEADDR: " << strerror(errno) << std::endl;
         ::close(sockfd);
-        return nullptr;
+        return false;
     }
     struct sockaddr_in local_addr;
     memset(&local_addr, 0, sizeof(local_addr));
@@ -75,75 +121,143 @@ ICommIO* TcpServer::server_open(IcommEndpointType *endpoint) {
     if (bind(sockfd, (struct sockaddr*)&local_addr, sizeof(local_addr)) < 0) {
         std::cout << "Failed to bind socket: " << strerror(errno) << std::endl;
         ::close(sockfd);
-        return nullptr;
+        return false;
     }
 
-    if (listen(sockfd, 1) < 0) {
+    if (listen(sockfd, LISTEN_BACKLOG) < 0) {
         std::cout << "Failed to listen on socket: " << strerror(errno) << std::endl;
         ::close(sockfd);
+        return false;
+    }
+    listen_sockfd = sockfd;
+    return true;
+}
+
+ICommIO* TcpServer::server_open(IcommEndpointType *endpoint) {
+    if ((listen_sockfd < 0) && !listen_open(endpoint)) {
         return nullptr;
     }
 
     struct sockaddr_in remote_addr;
     socklen_t addr_len = sizeof(remote_addr);
-    int client_sockfd = accept(sockfd, (struct sockaddr*)&remote_addr, &addr_len);
+    int client_sockfd;
+    do {
+        addr_len = sizeof(remote_addr);
+        client_sockfd = accept(listen_sockfd, (struct sockaddr*)&remote_addr, &addr_len);
+    } while ((client_sockfd < 0) && (errno == EINTR || errno == ECONNABORTED));
     if (client_sockfd < 0) {
         std::cout << "Failed to accept connection: " << strerror(errno) << std::endl;
-        ::close(sockfd);
         return nullptr;
     }
 
-    return new TcpCommIO(client_sockfd);
+    (void)comm_socket_options_apply(client_sockfd, options, true);
+    return new TcpCommIO(client_sockfd, options);
 }
 
+bool TcpServer::server_close() {
+    if (listen_sockfd < 0) {
+        return true;
+    }
+    int sockfd = listen_sockfd;
+    listen_sockfd = -1;
+    if (::close(sockfd) < 0) {
+        std::cout << "Failed to close socket: " << strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+}
 
-#define MAVLINK_HEADER_LEN  9
-bool TcpCommIO::recv(char* data, int datalen, int* recv_datalen) {
-    // see: http://mavlink.io/en/guide/serialization.html
-
-    char header[MAVLINK_HEADER_LEN];
-    int received = 0;
 
-    // Receive header
-    while (received < MAVLINK_HEADER_LEN) {
-        int len = read(sockfd, header + received, MAVLINK_HEADER_LEN - received);
-        if (len > 0) {
-            received += len;
-        } else if (len == 0 || (errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK)) {
-            //std::cout << "Failed to receive MAVLink header: " << strerror(errno) << std::endl;
-            return false;
-        }
-    }
-#if 0
-    for (int i = 0; i < 10; i++) {
-        printf("header[%d] = 0x%x\n", i, header[i]);
+#define MAVLINK_HEADER_LEN  9
+/*
+ * バッファの先頭にそろっているフレームの長さ。そろっていなければ 0 を返す。
+ * see: http://mavlink.io/en/guide/serialization.html
+ */
+int TcpCommIO::recv_frame_length() {
+    int buffered = recv_tail - recv_head;
+    if (buffered < MAVLINK_HEADER_LEN) {
+        return 0;
     }
-#endif
     // Parse header to get packet length (assuming packet length is at offset 1)
-    int packetlen = static_cast<unsigned char>(header[1]) + 2 /* CRC */ + 1 /* Signature */;
+    int packetlen = static_cast<unsigned char>(recv_buffer[recv_head + 1]) + 2 /* CRC */ + 1 /* Signature */;
+    if (buffered < MAVLINK_HEADER_LEN + packetlen) {
+        return 0;
+    }
+    return MAVLINK_HEADER_LEN + packetlen;
+}
 
-    // Check if datalen is sufficient to hold header and packet data
-    if (datalen < MAVLINK_HEADER_LEN + packetlen) {
-        std::cout << "Provided data buffer is too small to hold the MAVLink message." << std::endl;
+/*
+ * ソケットから受信できるだけバッファに追加する。切断またはエラーなら false を返す。
+ * ノンブロッキングの場合、受信するデータがなければ何も追加せずに true を返す。
+ */
+bool TcpCommIO::recv_fill() {
+    if (recv_head > 0) {
+        memmove(recv_buffer, recv_buffer + recv_head, recv_tail - recv_head);
+        recv_tail -= recv_head;
+        recv_head = 0;
+    }
+    while (true) {
+        int len = ::recv(sockfd, recv_buffer + recv_tail, TCP_RECV_BUFFER_SIZE - recv_tail,
+                         nonblocking ? MSG_DONTWAIT : 0);
+        if (len > 0) {
+            recv_tail += len;
+            if (quickack) {
+                (void)comm_socket_quickack(sockfd);
+            }
+            return true;
+        }
+        if (len < 0 && errno == EINTR) {
+            continue;
+        }
+        if (len < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            if (nonblocking) {
+                return true;
+            }
+            continue;
+        }
+        //std::cout << "Failed to receive MAVLink data: " << strerror(errno) << std::endl;
+        connected = false;
         return false;
     }
+}
 
-    // Copy header data to output buffer
-    memcpy(data, header, MAVLINK_HEADER_LEN);
-
-    // Receive packet data
-    received = 0;
-    while (received < packetlen) {
-        int len = read(sockfd, data + MAVLINK_HEADER_LEN + received, packetlen - received);
-        if (len > 0) {
-            received += len;
-        } else if (len == 0 || (errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK)) {
-            std::cout << "Failed to receive MAVLink data: " << strerror(errno) << std::endl;
+bool TcpCommIO::recv(char* data, int datalen, int* recv_datalen) {
+    HAKO_PROFILE_SCOPE("TcpCommIO::recv");
+    while (true) {
+        int framelen = recv_frame_length();
+        if (framelen > 0) {
+            const char* frame = recv_buffer + recv_head;
+            recv_head += framelen;
+            if (recv_head == recv_tail) {
+                recv_head = 0;
+                recv_tail = 0;
+            }
+            // Check if datalen is sufficient to hold header and packet data
+            if (datalen < framelen) {
+                std::cout << "Provided data buffer is too small to hold the MAVLink message." << std::endl;
+                continue;
+            }
+            memcpy(data, frame, framelen);
+            *recv_datalen = framelen;
+            return true;
+        }
+        int buffered = recv_tail - recv_head;
+        if (sockfd < 0 || !recv_fill()) {
+            return false;
+        }
+        if (nonblocking && (recv_tail - recv_head) == buffered) {
+            // 受信するデータがない。途中までのフレームは次の recv() まで保持する
             return false;
         }
     }
+}
+
+bool TcpCommIO::recv_pending() {
+    return recv_frame_length() > 0;
+}
 
-    *recv_datalen = MAVLINK_HEADER_LEN + packetlen;
+bool TcpCommIO::set_nonblocking(bool enable) {
+    nonblocking = enable;
     return true;
 }
 
@@ -151,11 +265,12 @@ bool TcpCommIO::recv(char* data, int datalen, int* recv_datalen) {
 bool TcpCommIO::send(const char* data, int datalen, int* send_datalen) {
     int total_sent = 0;
     while (total_sent < datalen) {
-        int sent = write(sockfd, data + total_sent, datalen - total_sent);
+        int sent = ::send(sockfd, data + total_sent, datalen - total_sent, TCP_SEND_FLAGS);
         if (sent > 0) {
             total_sent += sent;
         } else if (sent == 0 || (errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK)) {
             std::cout << "Failed to send data: " << strerror(errno) << std::endl;
+            connected = false;
             break;
         }
     }
@@ -163,12 +278,80 @@ bool TcpCommIO::send(const char* data, int datalen, int* send_datalen) {
     return total_sent == datalen;
 }
 
+/*
+ * 複数フレームを sendmsg() 1回で送信する。送り切れなかった分は send() で送る。
+ */
+#define TCP_BATCH_NUM   16
+bool TcpCommIO::send_batch(const char* const data[], const int datalen[], int num, int* sent_num) {
+    if (num <= 0 || num > TCP_BATCH_NUM) {
+        return ICommIO::send_batch(data, datalen, num, sent_num);
+    }
+    struct iovec iovecs[TCP_BATCH_NUM];
+    for (int i = 0; i < num; i++) {
+        iovecs[i].iov_base = const_cast<char*>(data[i]);
+        iovecs[i].iov_len = datalen[i];
+    }
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iovecs;
+    msg.msg_iovlen = num;
+    int sent;
+    do {
+        sent = sendmsg(sockfd, &msg, TCP_SEND_FLAGS);
+    } while (sent < 0 && errno == EINTR);
+    if (sent < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+        std::cout << "Failed to send data: " << strerror(errno) << std::endl;
+        connected = false;
+        if (sent_num != nullptr) {
+            *sent_num = 0;
+        }
+        return false;
+    }
+    if (sent < 0) {
+        sent = 0;
+    }
+    int done = 0;
+    for (int i = 0; i < num; i++) {
+        if (sent >= datalen[i]) {
+            sent -= datalen[i];
+            done++;
+            continue;
+        }
+        int send_datalen = 0;
+        if (!send(data[i] + sent, datalen[i] - sent, &send_datalen)) {
+            break;
+        }
+        sent = 0;
+        done++;
+    }
+    if (sent_num != nullptr) {
+        *sent_num = done;
+    }
+    return done == num;
+}
+
 bool TcpCommIO::close() {
-    if (::close(sockfd) < 0) {
+    if (sockfd < 0) {
+        return true;
+    }
+    int fd = sockfd;
+    sockfd = -1;
+    if (::close(fd) < 0) {
         std::cout << "Failed to close socket: " << strerror(errno) << std::endl;
         return false;
     }
     return true;
 }
 
+void TcpCommIO::shutdown() {
+    connected = false;
+    if (sockfd >= 0) {
+        (void)::shutdown(sockfd, SHUT_RDWR);
+    }
+}
+
+bool TcpCommIO::is_connected() {
+    return connected && (sockfd >= 0);
+}
+
 }  // namespace hako::px4::comm
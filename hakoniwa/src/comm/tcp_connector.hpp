@@ -4,40 +4,74 @@
 #include "icomm_connector.hpp"
 #include <sys/socket.h>
 #include <netinet/in.h>
+#include <atomic>
 
 namespace hako::px4::comm {
 
+/*
+ * 受信したバイト列は接続ごとのバッファに溜め、MAVLink のフレーム単位で取り出す。
+ * ノンブロッキングにした場合、recv() はフレームがそろっていなければ待たずに false を返し、
+ * 途中まで受信したフレームは次の recv() まで保持する。
+ */
+#define TCP_RECV_BUFFER_SIZE    4096
+
 class TcpCommIO : public ICommIO {
 private:
     int sockfd; // ソケットのディスクリプタ
+    std::atomic<bool> connected; // 相手側の切断を検出したら false（送信スレッドと受信スレッドの両方から更新する）
+    bool quickack;
+    bool nonblocking;
+    char recv_buffer[TCP_RECV_BUFFER_SIZE];
+    int recv_head;
+    int recv_tail;
+    int recv_frame_length();
+    bool recv_fill();
 
 public:
-    TcpCommIO(int sockfd);
+    TcpCommIO(int sockfd, const CommSocketOptionsType& options = comm_socket_options_default());
     ~TcpCommIO() override;
 
     bool send(const char* data, int datalen, int* send_datalen) override;
     bool recv(char* data, int datalen, int* recv_datalen) override;
     bool close() override;
+    bool is_connected() override;
+    bool send_batch(const char* const data[], const int datalen[], int num, int* sent_num) override;
+    int get_fd() override { return sockfd; }
+    bool recv_pending() override;
+    bool set_nonblocking(bool enable) override;
+    void shutdown() override;
 };
 
 class TcpClient : public ICommClient {
 private:
+    CommSocketOptionsType options;
 
 public:
     TcpClient();
     ~TcpClient() override;
 
     ICommIO* client_open(IcommEndpointType *src, IcommEndpointType *dst) override;
+    void set_socket_options(const CommSocketOptionsType& options) override;
 };
 
+/*
+ * TcpServer はリッスンソケットを保持し続ける。
+ * server_open() を呼ぶたびに次のクライアントを accept するため、
+ * 複数の PX4 の接続や、PX4 再起動時の再接続を受け付けることができる。
+ */
 class TcpServer : public ICommServer {
 private:
+    int listen_sockfd; // リッスンソケットのディスクリプタ
+    CommSocketOptionsType options;
+    bool listen_open(IcommEndpointType *endpoint);
 
 public:
     TcpServer();
     ~TcpServer() override;
 
     ICommIO* server_open(IcommEndpointType *endpoint) override;
+    void set_socket_options(const CommSocketOptionsType& options) override;
+    bool server_close();
 };
 
 } // namespace hako::px4::comm
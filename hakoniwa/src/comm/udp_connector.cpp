@@ -2,24 +2,102 @@
 #include <cstring>      // for std::memset
 #include <unistd.h>     // for close
 #include <arpa/inet.h>  // for inet_pton
+#include <errno.h>
+#include <sys/uio.h>
+#include <iostream>
 
 namespace hako::px4::comm {
 
-UdpCommIO::UdpCommIO(int sockfd, const sockaddr_in& remote_addr) : sockfd(sockfd), remote_addr(remote_addr) {}
+UdpCommIO::UdpCommIO(int sockfd, const sockaddr_in& remote_addr, bool has_remote_addr) 
+    : sockfd(sockfd), remote_addr(remote_addr), has_remote_addr(has_remote_addr) 
+{
+#ifdef __linux__
+    recv_num = 0;
+    recv_index = 0;
+#endif
+}
 
 UdpCommIO::~UdpCommIO() {
     close();
 }
 
+void UdpCommIO::set_remote_addr(const struct sockaddr_in& addr) {
+    std::lock_guard<std::mutex> lock(remote_mutex);
+    remote_addr = addr;
+    has_remote_addr = true;
+}
+
+bool UdpCommIO::get_remote_addr(struct sockaddr_in& addr) {
+    std::lock_guard<std::mutex> lock(remote_mutex);
+    addr = remote_addr;
+    return has_remote_addr;
+}
+
+#ifdef __linux__
+bool UdpCommIO::recv_batch() {
+    struct mmsghdr msgs[UDP_BATCH_NUM];
+    struct iovec iovecs[UDP_BATCH_NUM];
+    std::memset(msgs, 0, sizeof(msgs));
+    for (int i = 0; i < UDP_BATCH_NUM; i++) {
+        iovecs[i].iov_base = recv_buffers[i];
+        iovecs[i].iov_len = UDP_BATCH_BUFFER_SIZE;
+        msgs[i].msg_hdr.msg_iov = &iovecs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        msgs[i].msg_hdr.msg_name = &recv_addrs[i];
+        msgs[i].msg_hdr.msg_namelen = sizeof(recv_addrs[i]);
+    }
+    // 少なくとも1つ受信するまで待ち、その時点で届いている分をまとめて受け取る
+    // MSG_TRUNC を付けると msg_len はバッファに収まらなかった分も含めた本来の長さになる
+    int num = recvmmsg(sockfd, msgs, UDP_BATCH_NUM, MSG_WAITFORONE | MSG_TRUNC, nullptr);
+    if (num <= 0) {
+        return false;
+    }
+    for (int i = 0; i < num; i++) {
+        recv_lens[i] = (int)msgs[i].msg_len;
+        recv_truncated[i] = ((msgs[i].msg_hdr.msg_flags & MSG_TRUNC) != 0) || (recv_lens[i] > UDP_BATCH_BUFFER_SIZE);
+    }
+    recv_num = num;
+    recv_index = 0;
+    return true;
+}
+#endif
 
 bool UdpCommIO::recv(char* data, int datalen, int* recv_datalen) {
     if(sockfd < 0 || !data || datalen <= 0) return false;
 
-    socklen_t addr_len = sizeof(remote_addr);
-    int bytes_received = recvfrom(sockfd, data, datalen, 0, (struct sockaddr*)&remote_addr, &addr_len);
+#ifdef __linux__
+    if ((recv_index >= recv_num) && !recv_batch()) {
+        return false;
+    }
+    int index = recv_index++;
+    int bytes_received = recv_lens[index];
+    if (recv_truncated[index] || (bytes_received > datalen)) {
+        std::cout << "WARNING: dropped oversized UDP datagram: " << bytes_received << " bytes" << std::endl;
+        return false;
+    }
+    std::memcpy(data, recv_buffers[index], bytes_received);
+    set_remote_addr(recv_addrs[index]);
+#else
+    struct sockaddr_in addr;
+    struct iovec iov;
+    iov.iov_base = data;
+    iov.iov_len = datalen;
+    struct msghdr msg;
+    std::memset(&msg, 0, sizeof(msg));
+    msg.msg_name = &addr;
+    msg.msg_namelen = sizeof(addr);
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    int bytes_received = recvmsg(sockfd, &msg, 0);
     if(bytes_received < 0) {
         return false;
     }
+    if ((msg.msg_flags & MSG_TRUNC) != 0) {
+        std::cout << "WARNING: dropped oversized UDP datagram: more than " << datalen << " bytes" << std::endl;
+        return false;
+    }
+    set_remote_addr(addr);
+#endif
 
     if(recv_datalen) {
         *recv_datalen = bytes_received;
@@ -30,8 +108,10 @@ bool UdpCommIO::recv(char* data, int datalen, int* recv_datalen) {
 
 bool UdpCommIO::send(const char* data, int datalen, int* send_datalen) {
     if(sockfd < 0 || !data || datalen <= 0) return false;
+    struct sockaddr_in addr;
+    if (!get_remote_addr(addr)) return false;
 
-    int bytes_sent = sendto(sockfd, data, datalen, 0, (struct sockaddr*)&remote_addr, sizeof(remote_addr));
+    int bytes_sent = sendto(sockfd, data, datalen, 0, (struct sockaddr*)&addr, sizeof(addr));
     if(bytes_sent < 0) {
         return false;
     }
@@ -42,6 +122,44 @@ bool UdpCommIO::send(const char* data, int datalen, int* send_datalen) {
 
     return true;
 }
+
+bool UdpCommIO::send_batch(const char* const data[], const int datalen[], int num, int* sent_num) {
+#ifdef __linux__
+    struct sockaddr_in addr;
+    if (sockfd < 0 || !get_remote_addr(addr) || num <= 0 || num > UDP_BATCH_NUM) {
+        return ICommIO::send_batch(data, datalen, num, sent_num);
+    }
+    struct mmsghdr msgs[UDP_BATCH_NUM];
+    struct iovec iovecs[UDP_BATCH_NUM];
+    std::memset(msgs, 0, sizeof(msgs));
+    for (int i = 0; i < num; i++) {
+        iovecs[i].iov_base = const_cast<char*>(data[i]);
+        iovecs[i].iov_len = datalen[i];
+        msgs[i].msg_hdr.msg_iov = &iovecs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        msgs[i].msg_hdr.msg_name = &addr;
+        msgs[i].msg_hdr.msg_namelen = sizeof(addr);
+    }
+    int sent = 0;
+    while (sent < num) {
+        int ret = sendmmsg(sockfd, &msgs[sent], num - sent, 0);
+        if (ret < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        sent += ret;
+    }
+    if (sent_num != nullptr) {
+        *sent_num = sent;
+    }
+    return sent == num;
+#else
+    return ICommIO::send_batch(data, datalen, num, sent_num);
+#endif
+}
+
 bool UdpCommIO::close() {
     if(sockfd >= 0) {
         ::close(sockfd);
@@ -50,12 +168,28 @@ bool UdpCommIO::close() {
     return true;
 }
 
-UdpClient::UdpClient() {
+bool UdpCommIO::is_connected() {
+    return sockfd >= 0;
+}
+
+bool UdpCommIO::recv_pending() {
+#ifdef __linux__
+    return recv_index < recv_num;
+#else
+    return false;
+#endif
+}
+
+UdpClient::UdpClient() : options(comm_socket_options_default()) {
     std::memset(&local_addr, 0, sizeof(local_addr));
 }
 
 UdpClient::~UdpClient() {}
 
+void UdpClient::set_socket_options(const CommSocketOptionsType& opts) {
+    options = opts;
+}
+
 ICommIO* UdpClient::client_open(IcommEndpointType *src, IcommEndpointType *dst) {
     int sockfd = socket(AF_INET, SOCK_DGRAM, 0);
     if(sockfd < 0) {
@@ -67,10 +201,12 @@ ICommIO* UdpClient::client_open(IcommEndpointType *src, IcommEndpointType *dst)
     inet_pton(AF_INET, src->ipaddr, &(local_addr.sin_addr));
 
     struct sockaddr_in remote_addr;
+    std::memset(&remote_addr, 0, sizeof(remote_addr));
     remote_addr.sin_family = AF_INET;
     remote_addr.sin_port = htons(dst->portno);
     inet_pton(AF_INET, dst->ipaddr, &(remote_addr.sin_addr));
 
+    (void)comm_socket_options_apply(sockfd, options, false);
     if(bind(sockfd, (struct sockaddr *)&local_addr, sizeof(local_addr)) < 0) {
         ::close(sockfd);
         return nullptr;
@@ -79,12 +215,16 @@ ICommIO* UdpClient::client_open(IcommEndpointType *src, IcommEndpointType *dst)
     return new UdpCommIO(sockfd, remote_addr);
 }
 
-UdpServer::UdpServer() {
+UdpServer::UdpServer() : options(comm_socket_options_default()) {
     std::memset(&local_addr, 0, sizeof(local_addr));
 }
 
 UdpServer::~UdpServer() {}
 
+void UdpServer::set_socket_options(const CommSocketOptionsType& opts) {
+    options = opts;
+}
+
 ICommIO* UdpServer::server_open(IcommEndpointType *endpoint) {
     int sockfd = socket(AF_INET, SOCK_DGRAM, 0);
     if(sockfd < 0) {
@@ -95,13 +235,15 @@ ICommIO* UdpServer::server_open(IcommEndpointType *endpoint) {
     local_addr.sin_port = htons(endpoint->portno);
     inet_pton(AF_INET, endpoint->ipaddr, &(local_addr.sin_addr));
 
+    (void)comm_socket_options_apply(sockfd, options, false);
     if(bind(sockfd, (struct sockaddr *)&local_addr, sizeof(local_addr)) < 0) {
         ::close(sockfd);
         return nullptr;
     }
 
     struct sockaddr_in remote_addr;  // このアドレスは、recvfromで設定される
-    return new UdpCommIO(sockfd, remote_addr);
+    std::memset(&remote_addr, 0, sizeof(remote_addr));
+    return new UdpCommIO(sockfd, remote_addr, false);
 }
 
 } // namespace hako::px4::comm
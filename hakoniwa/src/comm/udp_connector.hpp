@@ -4,43 +4,75 @@
 #include "icomm_connector.hpp"
 #include <sys/socket.h>
 #include <netinet/in.h>
+#include <mutex>
 
 namespace hako::px4::comm {
 
+/*
+ * Linux では recvmmsg/sendmmsg で複数のデータグラムを1回のシステムコールで送受信する。
+ * recv() は受信済みのデータグラムを1つずつ返し、なくなったら次のバーストをまとめて受信する。
+ */
+#define UDP_BATCH_NUM           16
+#define UDP_BATCH_BUFFER_SIZE   2048
+
 class UdpCommIO : public ICommIO {
 private:
     int sockfd; // ソケットのディスクリプタ
+    /*
+     * 送信先は受信スレッドが更新し、送信スレッドが読むので remote_mutex で排他する
+     */
+    std::mutex remote_mutex;
     struct sockaddr_in remote_addr; // リモートのアドレス情報
+    bool has_remote_addr; // 送信先が確定しているか（サーバ側は最初の受信で確定する）
+    void set_remote_addr(const struct sockaddr_in& addr);
+    bool get_remote_addr(struct sockaddr_in& addr);
+#ifdef __linux__
+    char recv_buffers[UDP_BATCH_NUM][UDP_BATCH_BUFFER_SIZE];
+    struct sockaddr_in recv_addrs[UDP_BATCH_NUM];
+    int recv_lens[UDP_BATCH_NUM];
+    bool recv_truncated[UDP_BATCH_NUM];
+    int recv_num;
+    int recv_index;
+    bool recv_batch();
+#endif
 
 public:
-    UdpCommIO(int sockfd, const sockaddr_in& remote_addr);
+    UdpCommIO(int sockfd, const sockaddr_in& remote_addr, bool has_remote_addr = true);
     ~UdpCommIO() override;
 
     bool send(const char* data, int datalen, int* send_datalen) override;
     bool recv(char* data, int datalen, int* recv_datalen) override;
     bool close() override;
+    bool is_connected() override;
+    bool send_batch(const char* const data[], const int datalen[], int num, int* sent_num) override;
+    int get_fd() override { return sockfd; }
+    bool recv_pending() override;
 };
 
 class UdpClient : public ICommClient {
 private:
     struct sockaddr_in local_addr; // ローカルのアドレス情報
+    CommSocketOptionsType options;
 
 public:
     UdpClient();
     ~UdpClient() override;
 
     ICommIO* client_open(IcommEndpointType *src, IcommEndpointType *dst) override;
+    void set_socket_options(const CommSocketOptionsType& options) override;
 };
 
 class UdpServer : public ICommServer {
 private:
     struct sockaddr_in local_addr; // ローカルのアドレス情報
+    CommSocketOptionsType options;
 
 public:
     UdpServer();
     ~UdpServer() override;
 
     ICommIO* server_open(IcommEndpointType *endpoint) override;
+    void set_socket_options(const CommSocketOptionsType& options) override;
 };
 
 } // namespace hako::px4::comm
@@ -2,13 +2,16 @@
 #define _DRONE_CONFIG_HPP_
 
 #include <nlohmann/json.hpp>
+#include "../comm/comm_socket_options.hpp"
 #include <fstream>
 #include <iostream>
+#include <random>
 #include <vector>
 
 using json = nlohmann::json;
 //#define DRONE_PX4_RX_DEBUG_ENABLE
 //DRONE_PX4_TX_DEBUG_ENABLE
+//#define DRONE_COLLISION_DEBUG_ENABLE
 //DRONE_PID_CONTROL_CPP
 struct RotorPosition {
     std::vector<double> position;
@@ -72,7 +75,7 @@ public:
 
     // Log Output for Sensors
     bool isSimSensorLogEnabled(const std::string& sensorName) const {
-        return configJson["simulation"]["logOutput"]["sensors"][sensorName].get<bool>();
+        return configJson["simulation"]["logOutput"]["sensors"].value(sensorName, false);
     }
 
     // Log Output for MAVLINK
@@ -80,9 +83,111 @@ public:
         return configJson["simulation"]["logOutput"]["mavlink"][mavlinkMessage].get<bool>();
     }
 
-    // MAVLINK Transmission Period
+    // MAVLINK Transmission Period (0: every step)
     int getSimMavlinkTransmissionPeriod(const std::string& mavlinkMessage) const {
-        return configJson["simulation"]["mavlink_tx_period_msec"][mavlinkMessage].get<int>();
+        if (configJson["simulation"].contains("mavlink_tx_period_msec") && configJson["simulation"]["mavlink_tx_period_msec"].contains(mavlinkMessage)) {
+            return configJson["simulation"]["mavlink_tx_period_msec"][mavlinkMessage].get<int>();
+        } else {
+            return 0;
+        }
+    }
+
+    // PX4 system id (MAV_SYS_ID) mapped to this aircraft
+    int getSimPx4SystemId() const {
+        if (configJson["simulation"].contains("px4_system_id")) {
+            return configJson["simulation"]["px4_system_id"].get<int>();
+        } else {
+            return 1;
+        }
+    }
+
+    // Transport of the PX4 link: "tcp", "udp" or "shm"
+    std::string getSimCommTransport() const {
+        if (configJson["simulation"].contains("comm") && configJson["simulation"]["comm"].contains("transport")) {
+            return configJson["simulation"]["comm"]["transport"].get<std::string>();
+        } else {
+            return "tcp";
+        }
+    }
+
+    // Serve each tcp/udp connection from a single poll()-driven I/O thread
+    bool getSimCommIoReactor() const {
+        if (configJson["simulation"].contains("comm") && configJson["simulation"]["comm"].contains("io_reactor")) {
+            return configJson["simulation"]["comm"]["io_reactor"].get<bool>();
+        } else {
+            return false;
+        }
+    }
+
+    // Socket options for the PX4 link (simulation.comm.socket)
+    hako::px4::comm::CommSocketOptionsType getSimCommSocketOptions() const {
+        hako::px4::comm::CommSocketOptionsType options = hako::px4::comm::comm_socket_options_default();
+        if (!configJson["simulation"].contains("comm") || !configJson["simulation"]["comm"].contains("socket")) {
+            return options;
+        }
+        const json& socket = configJson["simulation"]["comm"]["socket"];
+        options.tcp_nodelay = socket.value("tcp_nodelay", options.tcp_nodelay);
+        options.tcp_quickack = socket.value("tcp_quickack", options.tcp_quickack);
+        options.rcvbuf_size = socket.value("rcvbuf_size", options.rcvbuf_size);
+        options.sndbuf_size = socket.value("sndbuf_size", options.sndbuf_size);
+        options.busy_poll_usec = socket.value("busy_poll_usec", options.busy_poll_usec);
+        options.priority = socket.value("priority", options.priority);
+        options.io_cpu_affinity = socket.value("io_cpu_affinity", options.io_cpu_affinity);
+        return options;
+    }
+
+    // Per-step timing statistics (simulation.step_stats)
+    struct StepStatsConfig {
+        bool enable;
+        double dump_period_sec;
+        std::string filename;
+    };
+    StepStatsConfig getSimStepStats() const {
+        StepStatsConfig config = { false, 0.0, "" };
+        if (!configJson["simulation"].contains("step_stats")) {
+            return config;
+        }
+        const json& stats = configJson["simulation"]["step_stats"];
+        config.enable = stats.value("enable", config.enable);
+        config.dump_period_sec = stats.value("dump_period_sec", config.dump_period_sec);
+        config.filename = stats.value("filename", config.filename);
+        return config;
+    }
+
+    // State snapshot (simulation.snapshot)
+    struct SnapshotConfig {
+        std::string filename;
+        bool restore;
+    };
+    SnapshotConfig getSimSnapshot() const {
+        SnapshotConfig config = { "", false };
+        if (!configJson["simulation"].contains("snapshot")) {
+            return config;
+        }
+        const json& snapshot = configJson["simulation"]["snapshot"];
+        config.filename = snapshot.value("filename", config.filename);
+        config.restore = snapshot.value("restore", config.restore);
+        return config;
+    }
+
+    // Deterministic run and input journal (simulation.deterministic)
+    struct DeterministicConfig {
+        bool enable;
+        uint32_t seed;
+        uint64_t epoch_usec;
+        bool journal;
+    };
+    DeterministicConfig getSimDeterministic() const {
+        DeterministicConfig config = { false, std::mt19937::default_seed, 0, false };
+        if (!configJson["simulation"].contains("deterministic")) {
+            return config;
+        }
+        const json& deterministic = configJson["simulation"]["deterministic"];
+        config.enable = deterministic.value("enable", config.enable);
+        config.seed = deterministic.value("seed", config.seed);
+        config.epoch_usec = deterministic.value("epoch_usec", config.epoch_usec);
+        config.journal = deterministic.value("journal", config.journal);
+        return config;
     }
 
     // Location parameters
@@ -195,6 +300,23 @@ public:
         }
         return positions;
     }
+    // Airframe preset (components.thruster.airframe). An empty type means rotorPositions is used
+    struct AirframeConfig {
+        std::string type;
+        double arm_length_m;
+        double coaxial_height_m;
+    };
+    AirframeConfig getCompThrusterAirframe() const {
+        AirframeConfig config = { "", 0.0, 0.0 };
+        if (!configJson["components"]["thruster"].contains("airframe")) {
+            return config;
+        }
+        const json& airframe = configJson["components"]["thruster"]["airframe"];
+        config.type = airframe.value("type", config.type);
+        config.arm_length_m = airframe.value("arm_length_m", config.arm_length_m);
+        config.coaxial_height_m = airframe.value("coaxial_height_m", config.coaxial_height_m);
+        return config;
+    }
     double getCompThrusterParameter(const std::string& param_name) const {
         // 指定されたパスにパラメータが存在するかチェック
         if (configJson["components"]["thruster"].contains(param_name)) {
@@ -213,6 +335,284 @@ public:
             return "None";
         }
     }
+    // Atmosphere table (components.atmosphere)
+    struct AtmosphereConfig {
+        double altitude_min_m;
+        double altitude_max_m;
+        double resolution_m;
+        double max_error_pa;
+    };
+    AtmosphereConfig getCompAtmosphere() const {
+        AtmosphereConfig config = { -1000.0, 11000.0, 10.0, 0.1 };
+        if (!configJson["components"].contains("atmosphere")) {
+            return config;
+        }
+        const json& atmosphere = configJson["components"]["atmosphere"];
+        config.altitude_min_m = atmosphere.value("altitude_min_m", config.altitude_min_m);
+        config.altitude_max_m = atmosphere.value("altitude_max_m", config.altitude_max_m);
+        config.resolution_m = atmosphere.value("resolution_m", config.resolution_m);
+        config.max_error_pa = atmosphere.value("max_error_pa", config.max_error_pa);
+        return config;
+    }
+    // Static objects of the in-simulator collision detection (components.collision_world)
+    struct CollisionObjectConfig {
+        std::string type;               // "plane", "box" or "mesh"
+        std::vector<double> position;   // plane: a point on it, box: center, mesh: offset
+        std::vector<double> normal;     // plane
+        std::vector<double> size;       // box
+        std::string filepath;           // mesh (Wavefront OBJ)
+    };
+    struct CollisionWorldConfig {
+        bool enable;
+        bool use_pdu;                   // also read Hako_Collision PDU
+        double restitution_coefficient;
+        std::vector<CollisionObjectConfig> objects;
+    };
+    CollisionWorldConfig getCompCollisionWorld() const {
+        CollisionWorldConfig config = { false, false, 0.5, {} };
+        if (!configJson["components"].contains("collision_world")) {
+            return config;
+        }
+        const json& world = configJson["components"]["collision_world"];
+        config.enable = world.value("enable", true);
+        config.use_pdu = world.value("use_pdu", config.use_pdu);
+        config.restitution_coefficient = world.value("restitution_coefficient", config.restitution_coefficient);
+        if (!world.contains("objects")) {
+            return config;
+        }
+        for (const auto& item : world["objects"]) {
+            CollisionObjectConfig object;
+            object.type = item.value("type", std::string(""));
+            object.position = item.value("position", std::vector<double>{ 0.0, 0.0, 0.0 });
+            object.normal = item.value("normal", std::vector<double>{ 0.0, 0.0, -1.0 });
+            object.size = item.value("size", std::vector<double>{ 0.0, 0.0, 0.0 });
+            object.filepath = item.value("filepath", std::string(""));
+            config.objects.push_back(object);
+        }
+        return config;
+    }
+    // Wind, gusts and turbulence (components.wind)
+    struct WindGustConfig {
+        double start_sec;
+        double duration_sec;
+        std::vector<double> velocity;   // peak of the gust (NED, m/s)
+    };
+    struct WindTurbulenceConfig {
+        bool enable;
+        std::string model;              // "dryden" or "von_karman"
+        std::vector<double> intensity;  // standard deviation (x, y, z) [m/s]
+        std::vector<double> length_scale_m;
+        double airspeed_mps;            // 0: speed of the constant wind (at least 1 m/s)
+        int samples;                    // power of 2
+    };
+    struct WindConfig {
+        bool enable;
+        std::vector<double> velocity;   // constant wind (NED, m/s)
+        std::vector<WindGustConfig> gusts;
+        WindTurbulenceConfig turbulence;
+    };
+    WindConfig getCompWind() const {
+        WindConfig config = { false, { 0.0, 0.0, 0.0 }, {},
+                              { false, "dryden", { 1.0, 1.0, 1.0 }, { 200.0, 200.0, 50.0 }, 0.0, 65536 } };
+        if (!configJson["components"].contains("wind")) {
+            return config;
+        }
+        const json& wind = configJson["components"]["wind"];
+        config.enable = wind.value("enable", true);
+        config.velocity = wind.value("velocity", config.velocity);
+        if (wind.contains("gusts")) {
+            for (const auto& item : wind["gusts"]) {
+                WindGustConfig gust;
+                gust.start_sec = item.value("start_sec", 0.0);
+                gust.duration_sec = item.value("duration_sec", 0.0);
+                gust.velocity = item.value("velocity", std::vector<double>{ 0.0, 0.0, 0.0 });
+                config.gusts.push_back(gust);
+            }
+        }
+        if (wind.contains("turbulence")) {
+            const json& turbulence = wind["turbulence"];
+            config.turbulence.enable = turbulence.value("enable", true);
+            config.turbulence.model = turbulence.value("model", config.turbulence.model);
+            config.turbulence.intensity = turbulence.value("intensity", config.turbulence.intensity);
+            config.turbulence.length_scale_m = turbulence.value("length_scale_m", config.turbulence.length_scale_m);
+            config.turbulence.airspeed_mps = turbulence.value("airspeed_mps", config.turbulence.airspeed_mps);
+            config.turbulence.samples = turbulence.value("samples", config.turbulence.samples);
+        }
+        return config;
+    }
+    // Terrain heightmap for the ground contact (components.terrain)
+    struct TerrainConfig {
+        bool enable;
+        std::string filepath;           // raw DEM (no header, row-major, little endian)
+        std::string format;             // "int16" or "float32"
+        int width;                      // columns (y direction)
+        int height;                     // rows (x direction)
+        double cell_size_m;
+        std::vector<double> origin;     // position (x, y) of the sample at row 0, column 0
+        double height_scale;
+        bool has_base_altitude;
+        double base_altitude_m;         // altitude of z = 0 (default: simulation.location.altitude)
+        int tile_size;
+        int max_tiles;
+        double natural_frequency;       // ground contact [rad/s]
+        double damping_ratio;
+        double friction;                // [1/s]
+    };
+    TerrainConfig getCompTerrain() const {
+        TerrainConfig config = { false, "", "int16", 0, 0, 1.0, { 0.0, 0.0 }, 1.0, false, 0.0, 256, 16, 30.0, 1.0, 5.0 };
+        if (!configJson["components"].contains("terrain")) {
+            return config;
+        }
+        const json& terrain = configJson["components"]["terrain"];
+        config.enable = terrain.value("enable", true);
+        config.filepath = terrain.value("filepath", config.filepath);
+        config.format = terrain.value("format", config.format);
+        config.width = terrain.value("width", config.width);
+        config.height = terrain.value("height", config.height);
+        config.cell_size_m = terrain.value("cell_size_m", config.cell_size_m);
+        config.origin = terrain.value("origin", config.origin);
+        config.height_scale = terrain.value("height_scale", config.height_scale);
+        config.has_base_altitude = terrain.contains("base_altitude_m");
+        config.base_altitude_m = terrain.value("base_altitude_m", config.base_altitude_m);
+        config.tile_size = terrain.value("tile_size", config.tile_size);
+        config.max_tiles = terrain.value("max_tiles", config.max_tiles);
+        if (terrain.contains("contact")) {
+            const json& contact = terrain["contact"];
+            config.natural_frequency = contact.value("natural_frequency", config.natural_frequency);
+            config.damping_ratio = contact.value("damping_ratio", config.damping_ratio);
+            config.friction = contact.value("friction", config.friction);
+        }
+        return config;
+    }
+    // Battery pack and the motors driven by it (components.battery)
+    struct BatteryConfig {
+        bool enable;
+        int cells;
+        double capacity_mah;
+        double internal_resistance_ohm;
+        double initial_remaining;
+        std::vector<double> curve_soc;              // discharge curve: state of charge (0.0 - 1.0)
+        std::vector<double> curve_cell_voltage;     // discharge curve: open circuit voltage of a cell [V]
+        double ambient_temperature_degc;
+        double heat_capacity_jk;
+        double heat_transfer_wk;
+        double resistance_temperature_coefficient;  // [1/degC]
+        double motor_kv;                            // [RPM/V]
+        double motor_resistance_ohm;
+        double motor_no_load_current_a;
+        double motor_hover_current_a;               // current of a motor at HoveringRpm
+        double esc_efficiency;
+    };
+    BatteryConfig getCompBattery() const {
+        BatteryConfig config = { false, 4, 5000.0, 0.03, 1.0, {}, {}, 25.0, 500.0, 1.0, 0.01, 920.0, 0.1, 0.5, 5.0, 0.95 };
+        if (!configJson["components"].contains("battery")) {
+            return config;
+        }
+        const json& battery = configJson["components"]["battery"];
+        config.enable = battery.value("enable", true);
+        config.cells = battery.value("cells", config.cells);
+        config.capacity_mah = battery.value("capacity_mah", config.capacity_mah);
+        config.internal_resistance_ohm = battery.value("internal_resistance_ohm", config.internal_resistance_ohm);
+        config.initial_remaining = battery.value("initial_remaining", config.initial_remaining);
+        if (battery.contains("discharge_curve")) {
+            const json& curve = battery["discharge_curve"];
+            config.curve_soc = curve.value("soc", config.curve_soc);
+            config.curve_cell_voltage = curve.value("cell_voltage", config.curve_cell_voltage);
+        }
+        if (battery.contains("thermal")) {
+            const json& thermal = battery["thermal"];
+            config.ambient_temperature_degc = thermal.value("ambient_temperature_degc", config.ambient_temperature_degc);
+            config.heat_capacity_jk = thermal.value("heat_capacity_jk", config.heat_capacity_jk);
+            config.heat_transfer_wk = thermal.value("heat_transfer_wk", config.heat_transfer_wk);
+            config.resistance_temperature_coefficient = thermal.value("resistance_temperature_coefficient", config.resistance_temperature_coefficient);
+        }
+        if (battery.contains("motor")) {
+            const json& motor = battery["motor"];
+            config.motor_kv = motor.value("kv", config.motor_kv);
+            config.motor_resistance_ohm = motor.value("resistance_ohm", config.motor_resistance_ohm);
+            config.motor_no_load_current_a = motor.value("no_load_current_a", config.motor_no_load_current_a);
+            config.motor_hover_current_a = motor.value("hover_current_a", config.motor_hover_current_a);
+            config.esc_efficiency = motor.value("esc_efficiency", config.esc_efficiency);
+        }
+        return config;
+    }
+    // IMU replacing the acc/gyro sensors (components.imu)
+    struct ImuNoiseConfig {
+        double noise_density;           // [unit/sqrt(Hz)]
+        double bias_instability;        // [unit]
+        double bias_correlation_sec;
+        double random_walk;             // [unit/sqrt(s)]
+    };
+    struct ImuConfig {
+        bool enable;
+        double rate_hz;
+        ImuNoiseConfig acc;             // unit: m/s^2
+        ImuNoiseConfig gyro;            // unit: rad/s
+        double vibration_acc_amplitude;     // [m/s^2] per rotor at vibration_reference_rpm
+        double vibration_gyro_amplitude;    // [rad/s] per rotor at vibration_reference_rpm
+        double vibration_reference_rpm;     // 0: HoveringRpm
+        double vibration_axial_ratio;
+    };
+    ImuConfig getCompImu() const {
+        ImuConfig config = { false, 1000.0, { 0.002, 0.0005, 100.0, 0.0 }, { 0.0003, 0.00005, 100.0, 0.0 }, 0.0, 0.0, 0.0, 1.0 };
+        if (!configJson["components"].contains("imu")) {
+            return config;
+        }
+        const json& imu = configJson["components"]["imu"];
+        config.enable = imu.value("enable", true);
+        config.rate_hz = imu.value("rate_hz", config.rate_hz);
+        for (auto& entry : { std::make_pair("acc", &config.acc), std::make_pair("gyro", &config.gyro) }) {
+            if (!imu.contains(entry.first)) {
+                continue;
+            }
+            const json& noise = imu[entry.first];
+            ImuNoiseConfig& c = *entry.second;
+            c.noise_density = noise.value("noise_density", c.noise_density);
+            c.bias_instability = noise.value("bias_instability", c.bias_instability);
+            c.bias_correlation_sec = noise.value("bias_correlation_sec", c.bias_correlation_sec);
+            c.random_walk = noise.value("random_walk", c.random_walk);
+        }
+        if (imu.contains("vibration")) {
+            const json& vibration = imu["vibration"];
+            config.vibration_acc_amplitude = vibration.value("acc_amplitude", config.vibration_acc_amplitude);
+            config.vibration_gyro_amplitude = vibration.value("gyro_amplitude", config.vibration_gyro_amplitude);
+            config.vibration_reference_rpm = vibration.value("reference_rpm", config.vibration_reference_rpm);
+            config.vibration_axial_ratio = vibration.value("axial_ratio", config.vibration_axial_ratio);
+        }
+        return config;
+    }
+    // GPS receiver (components.sensors.gps, in addition to sampleCount/noise)
+    struct GpsConfig {
+        double update_rate_hz;          // 0: every step
+        double latency_sec;
+        double uere_m;
+        double error_correlation_sec;
+        double hdop;                    // at satellites_max
+        double vdop;                    // at satellites_max
+        int satellites_min;
+        int satellites_max;
+        double satellite_change_sec;
+    };
+    GpsConfig getCompGps() const {
+        GpsConfig config = { 0.0, 0.0, 0.0, 60.0, 0.8, 1.2, 10, 10, 30.0 };
+        if (!configJson["components"]["sensors"].contains("gps")) {
+            return config;
+        }
+        const json& gps = configJson["components"]["sensors"]["gps"];
+        config.update_rate_hz = gps.value("update_rate_hz", config.update_rate_hz);
+        config.latency_sec = gps.value("latency_sec", config.latency_sec);
+        config.uere_m = gps.value("uere_m", config.uere_m);
+        config.error_correlation_sec = gps.value("error_correlation_sec", config.error_correlation_sec);
+        config.hdop = gps.value("hdop", config.hdop);
+        config.vdop = gps.value("vdop", config.vdop);
+        if (gps.contains("satellites")) {
+            const json& satellites = gps["satellites"];
+            config.satellites_min = satellites.value("min", config.satellites_min);
+            config.satellites_max = satellites.value("max", config.satellites_max);
+            config.satellite_change_sec = satellites.value("change_sec", config.satellite_change_sec);
+        }
+        return config;
+    }
     double getCompSensorSampleCount(const std::string& sensor_name) const {
         return configJson["components"]["sensors"][sensor_name]["sampleCount"].get<double>();
     }
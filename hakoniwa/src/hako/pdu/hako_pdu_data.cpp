@@ -1,5 +1,7 @@
 #include "hako_pdu_data.hpp"
+#include "utils/hako_profile.hpp"
 #include <atomic>
+#include <mutex>
 #include <unistd.h>
 
 typedef struct {
@@ -7,15 +9,31 @@ typedef struct {
     std::atomic<bool>  hil_sensor_is_dirty;
     std::atomic<bool>  hil_gps_is_dirty;
     std::atomic<bool>  hil_state_quaternion_is_dirty;
+    std::atomic<bool>  battery_status_is_dirty;
     Hako_HakoHilSensor          hil_sensor;
     Hako_HakoHilGps             hil_gps;
     Hako_HakoHilStateQuaternion hil_state_quaternion;
+    mavlink_battery_status_t    battery_status;
 } HakoPduSensorDataType;
 
+/*
+ * HIL_ACTUATOR_CONTROLS は通信スレッドからシミュレーションスレッドへ最新値のメールボックス（トリプルバッファ）で渡す。
+ * 書き込みは空いているバッファに書いてから中央のバッファと交換するだけなので、読み出しを待たず、最新の値が捨てられることもない。
+ * シミュレーションスレッドは待たされることなく最新の値を取り出す。
+ * 通信スレッドが複数になる場合（PX4 の再接続直後など）に備えて、書き込み側だけ排他する。
+ */
+#define HAKO_PDU_ACTUATOR_MAILBOX_DIRTY 0x4U
+#define HAKO_PDU_ACTUATOR_MAILBOX_INDEX 0x3U
 typedef struct {
-    std::atomic<bool>  is_busy;
-    std::atomic<bool>  hil_actuator_controls_is_dirty;
-    Hako_HakoHilActuatorControls hil_actuator_controls;
+    std::mutex writer_mutex;
+    Hako_HakoHilActuatorControls buffer[3];
+    uint32_t back_index = 0;            // 書き込み側だけが使う
+    uint32_t front_index = 1;           // 読み出し側だけが使う
+    std::atomic<uint32_t> middle { 2 }; // 中央のバッファの番号 | 未読フラグ
+    std::atomic<uint64_t> pending_count;
+    std::atomic<uint64_t> write_count;
+    std::atomic<uint64_t> coalesced_count;
+    std::atomic<uint64_t> max_queue_depth;
 } HakoPduActuatorDataType;
 
 static HakoPduSensorDataType hako_pdu_sensor_data;
@@ -51,6 +69,7 @@ void hako_write_data(std::atomic<bool> &is_busy, std::atomic<bool> &is_dirty, T
     unset_busy(is_busy);
 }
 bool hako_read_hil_sensor(Hako_HakoHilSensor &hil_sensor) {
+    HAKO_PROFILE_SCOPE("pdu_read:hil_sensor");
     return hako_read_data(
         hako_pdu_sensor_data.is_busy, 
         hako_pdu_sensor_data.hil_sensor_is_dirty, 
@@ -58,6 +77,7 @@ bool hako_read_hil_sensor(Hako_HakoHilSensor &hil_sensor) {
 }
 
 void hako_write_hil_sensor(const Hako_HakoHilSensor &hil_sensor) {
+    HAKO_PROFILE_SCOPE("pdu_write:hil_sensor");
     hako_write_data(
         hako_pdu_sensor_data.is_busy, 
         hako_pdu_sensor_data.hil_sensor_is_dirty, 
@@ -65,6 +85,7 @@ void hako_write_hil_sensor(const Hako_HakoHilSensor &hil_sensor) {
         hil_sensor);
 }
 bool hako_read_hil_gps(Hako_HakoHilGps &hil_gps) {
+    HAKO_PROFILE_SCOPE("pdu_read:hil_gps");
     return hako_read_data(
         hako_pdu_sensor_data.is_busy, 
         hako_pdu_sensor_data.hil_gps_is_dirty, 
@@ -73,6 +94,7 @@ bool hako_read_hil_gps(Hako_HakoHilGps &hil_gps) {
 }
 
 void hako_write_hil_gps(const Hako_HakoHilGps &hil_gps) {
+    HAKO_PROFILE_SCOPE("pdu_write:hil_gps");
     hako_write_data(
         hako_pdu_sensor_data.is_busy, 
         hako_pdu_sensor_data.hil_gps_is_dirty, 
@@ -96,18 +118,58 @@ void hako_write_hil_state_quaternion(const Hako_HakoHilStateQuaternion &hil_stat
         hil_state_quaternion);
 }
 
-bool hako_read_hil_actuator_controls(Hako_HakoHilActuatorControls &hil_actuator_controls) {
+bool hako_mavlink_read_battery_status(mavlink_battery_status_t &battery_status) {
+    HAKO_PROFILE_SCOPE("pdu_read:battery_status");
     return hako_read_data(
-        hako_pdu_actuator_data.is_busy, 
-        hako_pdu_actuator_data.hil_actuator_controls_is_dirty, 
-        hako_pdu_actuator_data.hil_actuator_controls, 
-        hil_actuator_controls);
+        hako_pdu_sensor_data.is_busy, 
+        hako_pdu_sensor_data.battery_status_is_dirty, 
+        hako_pdu_sensor_data.battery_status, 
+        battery_status);
 }
 
-void hako_write_hil_actuator_controls(const Hako_HakoHilActuatorControls &hil_actuator_controls) {
+void hako_mavlink_write_battery_status(const mavlink_battery_status_t &battery_status) {
+    HAKO_PROFILE_SCOPE("pdu_write:battery_status");
     hako_write_data(
-        hako_pdu_actuator_data.is_busy, 
-        hako_pdu_actuator_data.hil_actuator_controls_is_dirty, 
-        hako_pdu_actuator_data.hil_actuator_controls, 
-        hil_actuator_controls);
+        hako_pdu_sensor_data.is_busy, 
+        hako_pdu_sensor_data.battery_status_is_dirty, 
+        hako_pdu_sensor_data.battery_status, 
+        battery_status);
+}
+
+bool hako_read_hil_actuator_controls(Hako_HakoHilActuatorControls &hil_actuator_controls) {
+    HAKO_PROFILE_SCOPE("pdu_read:hil_actuator_controls");
+    auto& mailbox = hako_pdu_actuator_data;
+    if ((mailbox.middle.load(std::memory_order_acquire) & HAKO_PDU_ACTUATOR_MAILBOX_DIRTY) == 0) {
+        return false;
+    }
+    // 読み終えたバッファを中央に戻し、最新の値が入った中央のバッファを受け取る
+    uint32_t prev = mailbox.middle.exchange(mailbox.front_index, std::memory_order_acq_rel);
+    mailbox.front_index = prev & HAKO_PDU_ACTUATOR_MAILBOX_INDEX;
+    hil_actuator_controls = mailbox.buffer[mailbox.front_index];
+    // 前回の読み出しから上書きされた数を統計に残す
+    uint64_t num = mailbox.pending_count.exchange(0, std::memory_order_relaxed);
+    if (num > mailbox.max_queue_depth.load(std::memory_order_relaxed)) {
+        mailbox.max_queue_depth.store(num, std::memory_order_relaxed);
+    }
+    if (num > 1) {
+        mailbox.coalesced_count.fetch_add(num - 1, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+void hako_write_hil_actuator_controls(const Hako_HakoHilActuatorControls &hil_actuator_controls) {
+    HAKO_PROFILE_SCOPE("pdu_write:hil_actuator_controls");
+    auto& mailbox = hako_pdu_actuator_data;
+    std::lock_guard<std::mutex> lock(mailbox.writer_mutex);
+    mailbox.buffer[mailbox.back_index] = hil_actuator_controls;
+    mailbox.pending_count.fetch_add(1, std::memory_order_relaxed);
+    uint32_t prev = mailbox.middle.exchange(mailbox.back_index | HAKO_PDU_ACTUATOR_MAILBOX_DIRTY, std::memory_order_acq_rel);
+    mailbox.back_index = prev & HAKO_PDU_ACTUATOR_MAILBOX_INDEX;
+    mailbox.write_count.fetch_add(1, std::memory_order_relaxed);
+}
+
+void hako_get_hil_actuator_controls_stats(HakoPduQueueStatsType &stats) {
+    stats.write_count = hako_pdu_actuator_data.write_count.load(std::memory_order_relaxed);
+    stats.coalesced_count = hako_pdu_actuator_data.coalesced_count.load(std::memory_order_relaxed);
+    stats.max_queue_depth = hako_pdu_actuator_data.max_queue_depth.load(std::memory_order_relaxed);
 }
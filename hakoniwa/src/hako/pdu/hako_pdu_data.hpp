@@ -19,6 +19,19 @@ extern void hako_write_hil_gps(const Hako_HakoHilGps &hil_gps);
 extern void hako_write_hil_state_quaternion(const Hako_HakoHilStateQuaternion &hil_state_quaternion);
 extern void hako_write_hil_actuator_controls(const Hako_HakoHilActuatorControls &hil_actuator_controls);
 
+/*
+ * BATTERY_STATUS は箱庭の PDU 型がないので、MAVLink のメッセージのままプロセス内で受け渡す
+ */
+extern bool hako_mavlink_read_battery_status(mavlink_battery_status_t &battery_status);
+extern void hako_mavlink_write_battery_status(const mavlink_battery_status_t &battery_status);
+
+typedef struct {
+    uint64_t write_count;       // 書き込まれた数
+    uint64_t coalesced_count;   // 読み出される前に新しい値で上書きされた数
+    uint64_t max_queue_depth;   // 読み出しまでに書き込まれた最大数
+} HakoPduQueueStatsType;
+extern void hako_get_hil_actuator_controls_stats(HakoPduQueueStatsType &stats);
+
 
 static inline bool hako_mavlink_read_hil_sensor(mavlink_hil_sensor_t &dst)
 {
@@ -1,12 +1,14 @@
 #include "hako_px4_master.hpp"
 #include "hako_capi.h"
 #include "hako_asset_runner.h"
+#include "utils/hako_profile.hpp"
 
 void* hako_px4_master_thread_run(void* arg)
 {
     if (arg) {
         //nothing to do
     }
+    HAKO_PROFILE_THREAD_NAME("hako master");
     while (true) {
         (void)hako_master_execute();
     }
@@ -0,0 +1,166 @@
+/*
+ * 1回の実行で出力されたログディレクトリの CSV を、1つの列指向ファイルに変換するツール。
+ *
+ * ディレクトリ直下の *.csv（drone_dynamics.csv, log_rotor_*.csv, log_comm_*.csv, センサの CSV など）を
+ * 並列に読み込み、全ファイルの時刻の和集合を time_usec 列として各列の値を揃える（ゼロ次ホールド）。
+ * 列名は "<ファイル名（拡張子なし）>.<列名>" とする。
+ * 変換後、ファイルごとの行数・時刻の範囲と、列ごとの統計値を出力する。
+ */
+#include "utils/columnar_file.hpp"
+#include "utils/log_table.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#define HAKO_LOG_CONVERT_TIME_COLUMN    "time_usec"
+#define HAKO_LOG_CONVERT_THREADS_MAX    1024
+
+static double hako_log_convert_elapsed_sec(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static std::vector<std::filesystem::path> hako_log_convert_find_csv(const std::string& log_dir)
+{
+    std::vector<std::filesystem::path> files;
+    std::error_code ec;
+    for (auto& entry : std::filesystem::directory_iterator(log_dir, ec)) {
+        if (entry.is_regular_file() && (entry.path().extension() == ".csv")) {
+            files.push_back(entry.path());
+        }
+    }
+    if (ec) {
+        std::cerr << "ERROR: can not read log directory: " << log_dir << ": " << ec.message() << std::endl;
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+static void hako_log_convert_print_tables(const std::vector<LogTableType>& tables)
+{
+    std::cout << "INFO: streams" << std::endl;
+    for (auto& table : tables) {
+        std::cout << "  " << std::left << std::setw(32) << table.name << std::right
+                  << " rows=" << table.time_usec.size()
+                  << " columns=" << table.columns.size()
+                  << " bad_lines=" << table.bad_lines;
+        if (!table.time_usec.empty()) {
+            int64_t span = table.time_usec.back() - table.time_usec.front();
+            std::cout << " time_usec=[" << table.time_usec.front() << ", " << table.time_usec.back() << "]";
+            if (table.time_usec.size() > 1) {
+                std::cout << " mean_interval=" << std::fixed << std::setprecision(1)
+                          << (double)span / (double)(table.time_usec.size() - 1) << " usec";
+            }
+        }
+        std::cout << std::endl;
+    }
+}
+
+static void hako_log_convert_print_columns(const std::vector<ColumnarColumnInfoType>& columns)
+{
+    std::cout << "INFO: columns" << std::endl;
+    std::cout << "  " << std::left << std::setw(40) << "name" << std::right
+              << std::setw(10) << "count" << std::setw(10) << "null"
+              << std::setw(16) << "min" << std::setw(16) << "max"
+              << std::setw(16) << "mean" << std::setw(16) << "stddev" << std::endl;
+    for (auto& column : columns) {
+        std::cout << "  " << std::left << std::setw(40) << column.name << std::right
+                  << std::setw(10) << column.stats.count << std::setw(10) << column.stats.null_count
+                  << std::setprecision(6) << std::defaultfloat
+                  << std::setw(16) << column.stats.min << std::setw(16) << column.stats.max
+                  << std::setw(16) << column.stats.mean << std::setw(16) << column.stats.stddev << std::endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if ((argc < 3) || (argc > 4)) {
+        std::cerr << "Usage: " << argv[0] << " <log_dir> <output_file> [threads]" << std::endl;
+        return -1;
+    }
+    std::string log_dir = argv[1];
+    std::string output_file = argv[2];
+    unsigned threads = 0;
+    if (argc > 3) {
+        char* end = nullptr;
+        errno = 0;
+        long value = std::strtol(argv[3], &end, 10);
+        if ((end == argv[3]) || (*end != '\0') || (errno != 0) || (value <= 0) || (value > HAKO_LOG_CONVERT_THREADS_MAX)) {
+            std::cerr << "ERROR: invalid threads: " << argv[3] << std::endl;
+            return -1;
+        }
+        threads = (unsigned)value;
+    }
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::filesystem::path> files = hako_log_convert_find_csv(log_dir);
+    if (files.empty()) {
+        std::cerr << "ERROR: no csv files in " << log_dir << std::endl;
+        return -1;
+    }
+
+    // ファイル単位で並列に読み込む。ファイル数がスレッド数より少なければ、ファイル内も分割して解析する
+    std::vector<LogTableType> tables(files.size());
+    // std::vector<bool> はビット単位で詰められ、別の要素への書き込みが競合するので char にする
+    std::vector<char> loaded(files.size(), 0);
+    unsigned threads_per_file = std::max(1u, threads / (unsigned)files.size());
+    log_table_parallel_for(files.size(), threads, [&](size_t i) {
+        loaded[i] = log_table_load(files[i].string(), tables[i], threads_per_file);
+        tables[i].name = files[i].stem().string();
+    });
+    for (size_t i = 0; i < files.size(); i++) {
+        if (!loaded[i]) {
+            return -1;
+        }
+    }
+    double load_sec = hako_log_convert_elapsed_sec(start);
+
+    // 時刻を揃える
+    std::vector<int64_t> timeline = log_table_timeline(tables);
+    std::vector<std::pair<size_t, size_t>> sources;
+    std::vector<std::string> names;
+    for (size_t t = 0; t < tables.size(); t++) {
+        for (size_t c = 0; c < tables[t].columns.size(); c++) {
+            sources.emplace_back(t, c);
+            names.push_back(tables[t].name + "." + tables[t].columns[c]);
+        }
+    }
+    std::vector<std::vector<double>> aligned(sources.size());
+    log_table_parallel_for(sources.size(), threads, [&](size_t i) {
+        aligned[i] = log_table_align(tables[sources[i].first], sources[i].second, timeline);
+    });
+    double align_sec = hako_log_convert_elapsed_sec(start) - load_sec;
+
+    ColumnarFileWriter writer;
+    if (!writer.open(output_file)) {
+        return -1;
+    }
+    bool ok = writer.write_column(HAKO_LOG_CONVERT_TIME_COLUMN, timeline);
+    for (size_t i = 0; ok && (i < aligned.size()); i++) {
+        ok = writer.write_column(names[i], aligned[i]);
+    }
+    std::vector<ColumnarColumnInfoType> columns = writer.get_columns();
+    if (!writer.close() || !ok) {
+        std::cerr << "ERROR: can not write columnar file: " << output_file << std::endl;
+        return -1;
+    }
+
+    hako_log_convert_print_tables(tables);
+    hako_log_convert_print_columns(columns);
+    std::cout << "INFO: converted " << files.size() << " files into " << output_file
+              << ": rows=" << timeline.size() << " columns=" << columns.size()
+              << " threads=" << threads
+              << std::fixed << std::setprecision(3)
+              << " load=" << load_sec << " sec align=" << align_sec << " sec total="
+              << hako_log_convert_elapsed_sec(start) << " sec" << std::endl;
+    return 0;
+}
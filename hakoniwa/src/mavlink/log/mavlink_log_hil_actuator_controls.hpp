@@ -29,16 +29,13 @@ public:
                  "controls[12]", "controls[13]", "controls[14]", "controls[15]", 
         };
     }
-    const std::vector<std::string> log_data() override
+    void log_fields(LogRecord& record) override
     {
-        return {
-            std::to_string(CsvLogger::get_time_usec()), 
-            std::to_string(msg.mode), std::to_string(msg.flags), 
-            std::to_string(msg.controls[0]), std::to_string(msg.controls[1]), std::to_string(msg.controls[2]), std::to_string(msg.controls[3]),
-            std::to_string(msg.controls[4]), std::to_string(msg.controls[5]), std::to_string(msg.controls[6]), std::to_string(msg.controls[7]),
-            std::to_string(msg.controls[8]), std::to_string(msg.controls[9]), std::to_string(msg.controls[10]), std::to_string(msg.controls[11]),
-            std::to_string(msg.controls[12]), std::to_string(msg.controls[13]), std::to_string(msg.controls[14]), std::to_string(msg.controls[15])
-        };
+        record.add(CsvLogger::get_time_usec())
+              .add(msg.mode).add(msg.flags);
+        for (int i = 0; i < 16; i++) {
+            record.add(msg.controls[i]);
+        }
     }
 
 };
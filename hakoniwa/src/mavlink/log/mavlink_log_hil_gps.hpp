@@ -29,16 +29,14 @@ public:
                  "yaw"
         };
     }
-    const std::vector<std::string> log_data() override
+    void log_fields(LogRecord& record) override
     {
-        return {
-            std::to_string(CsvLogger::get_time_usec()), 
-            std::to_string(msg.lat), std::to_string(msg.lon), std::to_string(msg.alt),
-            std::to_string(msg.eph), std::to_string(msg.epv), std::to_string(msg.vel),
-            std::to_string(msg.vn), std::to_string(msg.ve), std::to_string(msg.vd),
-            std::to_string(msg.cog), std::to_string(msg.satellites_visible), std::to_string(msg.id),
-            std::to_string(msg.yaw)
-        };
+        record.add(CsvLogger::get_time_usec())
+              .add(msg.lat).add(msg.lon).add(msg.alt)
+              .add(msg.eph).add(msg.epv).add(msg.vel)
+              .add(msg.vn).add(msg.ve).add(msg.vd)
+              .add(msg.cog).add(msg.satellites_visible).add(msg.id)
+              .add(msg.yaw);
     }
 
 };
@@ -29,16 +29,14 @@ public:
                  "temperature"
         };
     }
-    const std::vector<std::string> log_data() override
+    void log_fields(LogRecord& record) override
     {
-        return {
-            std::to_string(CsvLogger::get_time_usec()), 
-            std::to_string(msg.xacc), std::to_string(msg.yacc), std::to_string(msg.zacc),
-            std::to_string(msg.xgyro), std::to_string(msg.ygyro), std::to_string(msg.zgyro),
-            std::to_string(msg.xmag), std::to_string(msg.ymag), std::to_string(msg.zmag),
-            std::to_string(msg.abs_pressure), std::to_string(msg.diff_pressure), std::to_string(msg.pressure_alt),
-            std::to_string(msg.temperature)
-        };
+        record.add(CsvLogger::get_time_usec())
+              .add(msg.xacc).add(msg.yacc).add(msg.zacc)
+              .add(msg.xgyro).add(msg.ygyro).add(msg.zgyro)
+              .add(msg.xmag).add(msg.ymag).add(msg.zmag)
+              .add(msg.abs_pressure).add(msg.diff_pressure).add(msg.pressure_alt)
+              .add(msg.temperature);
     }
 
 };
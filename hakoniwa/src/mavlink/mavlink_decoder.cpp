@@ -54,7 +54,13 @@ bool mavlink_get_message(mavlink_message_t *msg, MavlinkDecodedMessage *message)
             message->type = MAVLINK_MSG_TYPE_HIL_GPS;
             mavlink_msg_hil_gps_decode(msg, &message->data.hil_gps);
             return true;
-        }        
+        }
+        case MAVLINK_MSG_ID_BATTERY_STATUS:
+        {
+            message->type = MAVLINK_MSG_TYPE_BATTERY_STATUS;
+            mavlink_msg_battery_status_decode(msg, &message->data.battery_status);
+            return true;
+        }
         default:
             message->type = MAVLINK_MSG_TYPE_UNKNOWN;
             return false;
@@ -122,6 +122,17 @@ void mavlink_message_dump(MavlinkDecodedMessage &message)
             std::cout << "  yacc: " << message.data.hil_state_quaternion.yacc << std::endl;
             std::cout << "  zacc: " << message.data.hil_state_quaternion.zacc << std::endl;
             break;
+        case MAVLINK_MSG_TYPE_BATTERY_STATUS:
+            std::cout << "  Type: BATTERY_STATUS" << std::endl;
+            std::cout << "  voltage[0]: " << message.data.battery_status.voltages[0] << std::endl;
+            std::cout << "  current_battery: " << message.data.battery_status.current_battery << std::endl;
+            std::cout << "  current_consumed: " << message.data.battery_status.current_consumed << std::endl;
+            std::cout << "  energy_consumed: " << message.data.battery_status.energy_consumed << std::endl;
+            std::cout << "  temperature: " << message.data.battery_status.temperature << std::endl;
+            std::cout << "  battery_remaining: " << (int)message.data.battery_status.battery_remaining << std::endl;
+            std::cout << "  time_remaining: " << message.data.battery_status.time_remaining << std::endl;
+            std::cout << "  charge_state: " << (int)message.data.battery_status.charge_state << std::endl;
+            break;
         default:
             std::cout << "  Unknown or unsupported MAVLink message type received." << std::endl;
             break;
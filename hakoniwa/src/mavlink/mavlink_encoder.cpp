@@ -18,6 +18,11 @@ int mavlink_get_packet(char* packet, int packet_len, const mavlink_message_t *ms
 }
 
 bool mavlink_encode_message(mavlink_message_t *msg, const MavlinkDecodedMessage *message) 
+{
+    return mavlink_encode_message(msg, message, MAVLINK_CONFIG_SYSTEM_ID, MAVLINK_CONFIG_COMPONENT_ID);
+}
+
+bool mavlink_encode_message(mavlink_message_t *msg, const MavlinkDecodedMessage *message, uint8_t system_id, uint8_t component_id)
 {
     if (!msg || !message) {
         return false;
@@ -26,8 +31,8 @@ bool mavlink_encode_message(mavlink_message_t *msg, const MavlinkDecodedMessage
     switch (message->type) {
         case MAVLINK_MSG_TYPE_HEARTBEAT:
             mavlink_msg_heartbeat_pack(
-                MAVLINK_CONFIG_SYSTEM_ID, 
-                MAVLINK_CONFIG_COMPONENT_ID, 
+                system_id,
+                component_id,
                 msg, 
                 message->data.heartbeat.type,
                 message->data.heartbeat.autopilot, 
@@ -39,8 +44,8 @@ bool mavlink_encode_message(mavlink_message_t *msg, const MavlinkDecodedMessage
         
         case MAVLINK_MSG_TYPE_LONG:
             mavlink_msg_command_long_pack(
-                MAVLINK_CONFIG_SYSTEM_ID, 
-                MAVLINK_CONFIG_COMPONENT_ID, 
+                system_id,
+                component_id,
                 msg, 
                 message->data.command_long.target_system,
                 message->data.command_long.target_component, 
@@ -57,8 +62,8 @@ bool mavlink_encode_message(mavlink_message_t *msg, const MavlinkDecodedMessage
             return true;
         case MAVLINK_MSG_TYPE_ACK:
             mavlink_msg_command_ack_pack(
-                MAVLINK_CONFIG_SYSTEM_ID, 
-                MAVLINK_CONFIG_COMPONENT_ID, 
+                system_id,
+                component_id,
                 msg, 
                 message->data.ack.command,
                 message->data.ack.result,
@@ -70,8 +75,8 @@ bool mavlink_encode_message(mavlink_message_t *msg, const MavlinkDecodedMessage
             return true;
         case MAVLINK_MSG_TYPE_HIL_SENSOR:
             mavlink_msg_hil_sensor_pack(
-                MAVLINK_CONFIG_SYSTEM_ID, 
-                MAVLINK_CONFIG_COMPONENT_ID, 
+                system_id,
+                component_id,
                 msg, 
                 message->data.sensor.time_usec,
                 message->data.sensor.xacc,
@@ -93,8 +98,8 @@ bool mavlink_encode_message(mavlink_message_t *msg, const MavlinkDecodedMessage
             return true;
         case MAVLINK_MSG_TYPE_HIL_STATE_QUATERNION:
             mavlink_msg_hil_state_quaternion_pack(
-                MAVLINK_CONFIG_SYSTEM_ID, 
-                MAVLINK_CONFIG_COMPONENT_ID, 
+                system_id,
+                component_id,
                 msg, 
                 message->data.hil_state_quaternion.time_usec,
                 message->data.hil_state_quaternion.attitude_quaternion,
@@ -116,8 +121,8 @@ bool mavlink_encode_message(mavlink_message_t *msg, const MavlinkDecodedMessage
             return true;
         case MAVLINK_MSG_TYPE_SYSTEM_TIME:
             mavlink_msg_system_time_pack(
-                MAVLINK_CONFIG_SYSTEM_ID,
-                MAVLINK_CONFIG_COMPONENT_ID,
+                system_id,
+                component_id,
                 msg,
                 message->data.system_time.time_unix_usec,
                 message->data.system_time.time_boot_ms
@@ -125,8 +130,8 @@ bool mavlink_encode_message(mavlink_message_t *msg, const MavlinkDecodedMessage
             return true;
         case MAVLINK_MSG_TYPE_HIL_GPS:
             mavlink_msg_hil_gps_pack(
-                MAVLINK_CONFIG_SYSTEM_ID,
-                MAVLINK_CONFIG_COMPONENT_ID,
+                system_id,
+                component_id,
                 msg,
                 message->data.hil_gps.time_usec,
                 message->data.hil_gps.fix_type,
@@ -145,6 +150,38 @@ bool mavlink_encode_message(mavlink_message_t *msg, const MavlinkDecodedMessage
                 message->data.hil_gps.yaw  // Assuming yaw field is present in your struct
             );
             return true;
+        case MAVLINK_MSG_TYPE_HIL_ACTUATOR_CONTROLS:
+            mavlink_msg_hil_actuator_controls_pack(
+                system_id,
+                component_id,
+                msg,
+                message->data.hil_actuator_controls.time_usec,
+                message->data.hil_actuator_controls.controls,
+                message->data.hil_actuator_controls.mode,
+                message->data.hil_actuator_controls.flags
+            );
+            return true;
+        case MAVLINK_MSG_TYPE_BATTERY_STATUS:
+            mavlink_msg_battery_status_pack(
+                system_id,
+                component_id,
+                msg,
+                message->data.battery_status.id,
+                message->data.battery_status.battery_function,
+                message->data.battery_status.type,
+                message->data.battery_status.temperature,
+                message->data.battery_status.voltages,
+                message->data.battery_status.current_battery,
+                message->data.battery_status.current_consumed,
+                message->data.battery_status.energy_consumed,
+                message->data.battery_status.battery_remaining,
+                message->data.battery_status.time_remaining,
+                message->data.battery_status.charge_state,
+                message->data.battery_status.voltages_ext,
+                message->data.battery_status.mode,
+                message->data.battery_status.fault_bitmask
+            );
+            return true;
         default:
             std::cerr << "Unsupported message type for encoding: " << message->type << std::endl;
             return false;
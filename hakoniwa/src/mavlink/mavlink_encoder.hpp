@@ -7,5 +7,9 @@
 
 extern int mavlink_get_packet(char* packet, int packet_len, const mavlink_message_t *msg);
 extern bool mavlink_encode_message(mavlink_message_t *msg, const MavlinkDecodedMessage *message);
+/*
+ * 送信元の system id / component id を指定してエンコードする（PX4 の代わりに送信する場合など）
+ */
+extern bool mavlink_encode_message(mavlink_message_t *msg, const MavlinkDecodedMessage *message, uint8_t system_id, uint8_t component_id);
 
 #endif /* _MAVLINK_ENCODER_HPP_ */
@@ -14,6 +14,7 @@ typedef enum {
     MAVLINK_MSG_TYPE_SYSTEM_TIME,
     MAVLINK_MSG_TYPE_HIL_GPS,
     MAVLINK_MSG_TYPE_HIL_ACTUATOR_CONTROLS,
+    MAVLINK_MSG_TYPE_BATTERY_STATUS,
     MAVLINK_MSG_TYPE_NUM,
 } MavlinkMsgType;
 
@@ -28,6 +29,7 @@ typedef struct {
         mavlink_system_time_t system_time;
         mavlink_hil_gps_t hil_gps;
         mavlink_hil_actuator_controls_t hil_actuator_controls;
+        mavlink_battery_status_t battery_status;
     } data;
 } MavlinkDecodedMessage;
 
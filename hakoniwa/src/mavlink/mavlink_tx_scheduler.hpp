@@ -0,0 +1,121 @@
+#ifndef _MAVLINK_TX_SCHEDULER_HPP_
+#define _MAVLINK_TX_SCHEDULER_HPP_
+
+#include <cstdint>
+
+/*
+ * PX4 に送信する MAVLink メッセージごとの送信周期の管理。
+ *
+ * シミュレーションの各ステップの始めに update() を呼び出し、そのステップで送信する
+ * メッセージを決める。送信しないメッセージは、センサ値の取得・PDU への書き込み・エンコード・送信を行わない。
+ * 周期が 0 のメッセージは毎ステップ送信する。
+ * イベント駆動のメッセージ（GPS の測位など）は周期によらず、update() の後に trigger() を呼び出したステップだけ送信する。
+ */
+typedef enum {
+    MAVLINK_TX_HIL_SENSOR = 0,
+    MAVLINK_TX_HIL_GPS,
+    MAVLINK_TX_BATTERY_STATUS,
+    MAVLINK_TX_NUM,
+} MavlinkTxMessageType;
+
+class MavlinkTxScheduler {
+private:
+    uint64_t period_usec[MAVLINK_TX_NUM];
+    uint64_t next_usec[MAVLINK_TX_NUM];
+    bool started[MAVLINK_TX_NUM];
+    bool due[MAVLINK_TX_NUM];
+    bool event_driven[MAVLINK_TX_NUM];
+    uint64_t due_count[MAVLINK_TX_NUM];
+
+public:
+    MavlinkTxScheduler()
+    {
+        for (int i = 0; i < MAVLINK_TX_NUM; i++) {
+            period_usec[i] = 0;
+            event_driven[i] = false;
+        }
+        reset();
+    }
+    static const char* message_name(MavlinkTxMessageType msg)
+    {
+        static const char* names[MAVLINK_TX_NUM] = {
+            "hil_sensor",
+            "hil_gps",
+            "battery_status",
+        };
+        return names[msg];
+    }
+    void set_period_usec(MavlinkTxMessageType msg, uint64_t usec)
+    {
+        period_usec[msg] = usec;
+    }
+    uint64_t get_period_usec(MavlinkTxMessageType msg) const
+    {
+        return period_usec[msg];
+    }
+    void set_event_driven(MavlinkTxMessageType msg, bool enable)
+    {
+        event_driven[msg] = enable;
+    }
+    bool is_event_driven(MavlinkTxMessageType msg) const
+    {
+        return event_driven[msg];
+    }
+    /*
+     * シミュレーションの開始（または再開）時に呼び出す。最初の update() では全メッセージを送信する。
+     */
+    void reset()
+    {
+        for (int i = 0; i < MAVLINK_TX_NUM; i++) {
+            next_usec[i] = 0;
+            started[i] = false;
+            due[i] = false;
+            due_count[i] = 0;
+        }
+    }
+    /*
+     * time_usec: このステップのシミュレーション時刻
+     */
+    void update(uint64_t time_usec)
+    {
+        for (int i = 0; i < MAVLINK_TX_NUM; i++) {
+            if (event_driven[i]) {
+                due[i] = false;
+                continue;
+            }
+            due[i] = !started[i] || (time_usec >= next_usec[i]);
+            if (!due[i]) {
+                continue;
+            }
+            // 処理が遅れて周期を飛ばした場合はまとめて送らず、今回の時刻から数え直す
+            if (started[i] && ((next_usec[i] + period_usec[i]) > time_usec)) {
+                next_usec[i] += period_usec[i];
+            }
+            else {
+                next_usec[i] = time_usec + period_usec[i];
+            }
+            started[i] = true;
+            due_count[i]++;
+        }
+    }
+    /*
+     * イベント駆動のメッセージを、このステップで送信する（update() の後に呼び出す）
+     */
+    void trigger(MavlinkTxMessageType msg)
+    {
+        if (event_driven[msg] && !due[msg]) {
+            due[msg] = true;
+            due_count[msg]++;
+        }
+    }
+    bool is_due(MavlinkTxMessageType msg) const
+    {
+        return due[msg];
+    }
+    uint64_t get_due_count(MavlinkTxMessageType msg) const
+    {
+        return due_count[msg];
+    }
+};
+
+#endif /* _MAVLINK_TX_SCHEDULER_HPP_ */
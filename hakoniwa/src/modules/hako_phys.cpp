@@ -8,6 +8,7 @@
 #include "config/drone_config.hpp"
 #include "utils/hako_params.hpp"
 #include "utils/csv_logger.hpp"
+#include "utils/state_snapshot.hpp"
 
 #include <unistd.h>
 #include <memory.h>
@@ -23,6 +24,11 @@
 static void asset_runner();
 
 static IAirCraft *drone;
+/*
+ * 箱庭のリセットで戻す setup 直後の状態（機体と PID コントローラ）
+ */
+static StateSnapshot reset_snapshot;
+static StateSnapshot reset_pid_snapshot;
 
 void hako_phys_main()
 {
@@ -50,6 +56,8 @@ static void my_setup()
     std::cout << "INFO: setup start" << std::endl;
     drone = hako::assets::drone::create_aircraft("default");
     drone_pid_control_init();
+    drone->take_snapshot(reset_snapshot);
+    drone_pid_control_save_state(reset_pid_snapshot);
 
     std::cout << "INFO: setup done" << std::endl;
     return;
@@ -100,7 +108,11 @@ static void my_task()
 
 static void my_reset()
 {
-    //nothing to do
+    (void)drone->restore_snapshot(reset_snapshot);
+    reset_pid_snapshot.rewind();
+    if (!drone_pid_control_restore_state(reset_pid_snapshot)) {
+        std::cerr << "ERROR: can not restore pid control state" << std::endl;
+    }
 }
 
 static hako_asset_runner_callback_t my_callbacks = {
@@ -0,0 +1,86 @@
+#include "hako_resim.hpp"
+#include "assets/drone/aircraft/aircraft_factory.hpp"
+#include "assets/drone/utils/input_journal.hpp"
+#include "config/drone_config.hpp"
+#include "utils/hako_params.hpp"
+#include "utils/csv_logger.hpp"
+#include "utils/state_snapshot.hpp"
+
+#include <iostream>
+#include <chrono>
+
+using hako::assets::drone::InputJournalHeaderType;
+using hako::assets::drone::InputJournalRecordType;
+
+/*
+ * 入力ジャーナルの再生（resim モード）。
+ * PX4 と箱庭を使わずに、記録した入力を順に IAirCraft::run() に渡して物理計算とログ出力をやり直す。
+ * 機体は記録時と同じ drone_config.json とノイズのシードで生成するので、ログは記録時と同じ値になる。
+ */
+void hako_resim_main()
+{
+    const char* filepath = hako_param_env_get_string(HAKO_JOURNAL_FILEPATH);
+    hako::assets::drone::InputJournalReader journal;
+    if (!journal.open(filepath)) {
+        return;
+    }
+    const InputJournalHeaderType& header = journal.get_header();
+    uint64_t delta_time_usec = static_cast<uint64_t>(drone_config.getSimTimeStep() * 1000000.0);
+    if (header.delta_time_usec != delta_time_usec) {
+        std::cerr << "ERROR: timeStep mismatch: journal " << header.delta_time_usec
+                  << " usec, config " << delta_time_usec << " usec" << std::endl;
+        return;
+    }
+    IAirCraft *drone = hako::assets::drone::create_aircraft("default", header.noise_seed);
+    if ((int)header.rotor_num != drone->get_rotor_bank().get_rotor_num()) {
+        std::cerr << "ERROR: rotor num mismatch: journal " << header.rotor_num
+                  << ", config " << drone->get_rotor_bank().get_rotor_num() << std::endl;
+        delete drone;
+        return;
+    }
+    /*
+     * hako_sim と同じく、setup 直後（またはファイルから復元した後）の状態をリセットで戻す
+     */
+    DroneConfig::SnapshotConfig snapshot_config = drone_config.getSimSnapshot();
+    if (!snapshot_config.filename.empty() && snapshot_config.restore) {
+        StateSnapshot snapshot;
+        std::string snapshot_filepath = drone_config.getSimLogFullPath(snapshot_config.filename);
+        if (snapshot.load_file(snapshot_filepath) && drone->restore_snapshot(snapshot)) {
+            std::cout << "INFO: restored snapshot: " << snapshot_filepath << std::endl;
+        }
+    }
+    StateSnapshot reset_snapshot;
+    drone->take_snapshot(reset_snapshot);
+
+    std::cout << "INFO: resim start: " << filepath << " (seed " << header.noise_seed << ")" << std::endl;
+    auto start = std::chrono::steady_clock::now();
+    uint64_t step_count = 0;
+    uint64_t reset_count = 0;
+    InputJournalRecordType record;
+    hako::assets::drone::DroneDynamicsInputType drone_input;
+    while (journal.next(record, drone_input)) {
+        if (record.kind == hako::assets::drone::INPUT_JOURNAL_STEP) {
+            if (record.flags & INPUT_JOURNAL_FLAG_LOG_ENABLED) {
+                CsvLogger::enable();
+            }
+            else {
+                CsvLogger::disable();
+            }
+            CsvLogger::set_time_usec(record.time_usec);
+            drone->run(drone_input);
+            step_count++;
+        }
+        else if (record.kind == hako::assets::drone::INPUT_JOURNAL_RESET) {
+            (void)drone->restore_snapshot(reset_snapshot);
+            reset_count++;
+        }
+        else {
+            std::cerr << "ERROR: unknown journal record kind: " << record.kind << std::endl;
+            break;
+        }
+    }
+    // ログファイルを閉じる
+    delete drone;
+    auto msec = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "INFO: resim done: " << step_count << " steps, " << reset_count << " resets in " << msec << " msec" << std::endl;
+}
@@ -0,0 +1,6 @@
+#ifndef _HAKO_RESIM_HPP_
+#define _HAKO_RESIM_HPP_
+
+extern void hako_resim_main();
+
+#endif /* _HAKO_RESIM_HPP_ */
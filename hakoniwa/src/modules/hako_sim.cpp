@@ -1,6 +1,7 @@
 #include "hako_sim.hpp"
 #include "hako_capi.h"
 #include "assets/drone/mavlink/mavlink_io.hpp"
+#include "mavlink/mavlink_tx_scheduler.hpp"
 #include "assets/drone/aircraft/aircraft_factory.hpp"
 #include "utils/hako_params.hpp"
 #include "hako_asset_runner.h"
@@ -8,11 +9,21 @@
 #include "hako/runner/hako_px4_master.hpp"
 #include "threads/px4sim_thread_sender.hpp"
 #include "threads/px4sim_thread_receiver.hpp"
+#include "threads/px4sim_thread_reactor.hpp"
 #include "config/drone_config.hpp"
+#include "utils/step_stats.hpp"
+#include "utils/hako_profile.hpp"
+#include "utils/state_snapshot.hpp"
+#include "utils/csv_logger.hpp"
+#include "assets/drone/utils/input_journal.hpp"
 
+#include <signal.h>
 #include <unistd.h>
 #include <memory.h>
 #include <iostream>
+#include <atomic>
+#include <chrono>
+#include <list>
 
 #define HAKO_RUNNER_MASTER_MAX_DELAY_USEC       1000 /* usec*/
 #define HAKO_AVATOR_CHANNLE_ID_MOTOR        0
@@ -26,9 +37,48 @@ static void* asset_runner(void*);
 
 static IAirCraft *drone;
 
+/*
+ * PX4 との1つの接続と、その接続の I/O スレッド。
+ * スレッドが終了したら finished を立て、待ち受けループが join して解放する。
+ */
+typedef struct {
+    pthread_t thread;
+    hako::px4::comm::ICommIO *comm_io;
+    void *(*io_thread)(void *);
+    std::atomic<bool> finished;
+} Px4IoSessionType;
+
+static void* px4_io_session_run(void* arg)
+{
+    Px4IoSessionType *session = static_cast<Px4IoSessionType*>(arg);
+    (void)session->io_thread(session->comm_io);
+    session->finished.store(true, std::memory_order_release);
+    return nullptr;
+}
+
+static void px4_io_session_release(Px4IoSessionType *session)
+{
+    pthread_join(session->thread, NULL);
+    session->comm_io->close();
+    delete session->comm_io;
+    delete session;
+}
+
+static void px4_io_session_reap(std::list<Px4IoSessionType*> &sessions)
+{
+    for (auto it = sessions.begin(); it != sessions.end(); ) {
+        if ((*it)->finished.load(std::memory_order_acquire)) {
+            px4_io_session_release(*it);
+            it = sessions.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+}
+
 void hako_sim_main(bool master, hako::px4::comm::IcommEndpointType serverEndpoint)
 {
-    hako::px4::comm::TcpServer server;
     pthread_t thread;
     if (master) {
         if (!hako_master_init()) {
@@ -50,27 +100,186 @@ void hako_sim_main(bool master, hako::px4::comm::IcommEndpointType serverEndpoin
         return;
     }
 
-    auto comm_io = server.server_open(&serverEndpoint);
-    if (comm_io == nullptr) 
-    {
-        std::cerr << "Failed to open TCP server" << std::endl;
+    hako::px4::comm::CommSocketOptionsType options = drone_config.getSimCommSocketOptions();
+
+    px4sim_sender_init((uint8_t)drone_config.getSimPx4SystemId());
+    px4sim_receiver_init(options.io_cpu_affinity);
+
+    /*
+     * リアクタを使う場合は、1つの I/O スレッドがソケットの送受信をすべて行い、
+     * アセットスレッドは送信キューに積むだけになる。
+     */
+    void *(*io_thread)(void *) = px4sim_thread_receiver;
+    if (drone_config.getSimCommIoReactor()) {
+        io_thread = px4sim_thread_reactor;
+    }
+    std::string transport = drone_config.getSimCommTransport();
+    if (transport == "udp") {
+        /*
+         * UDP は接続の概念がないので、ソケットを1つ開いて受信し続ける。
+         * 送信先は最後に受信したデータグラムの送信元になる。
+         */
+        hako::px4::comm::UdpServer udp_server;
+        udp_server.set_socket_options(options);
+        auto comm_io = udp_server.server_open(&serverEndpoint);
+        if (comm_io == nullptr) 
+        {
+            std::cerr << "Failed to open UDP server" << std::endl;
+            return;
+        }
+        std::cout << "INFO: PX4 link: UDP" << std::endl;
+        io_thread(comm_io);
+        comm_io->close();
+        delete comm_io;
         return;
     }
-    px4sim_sender_init(comm_io);
-    px4sim_thread_receiver(comm_io);
-    //not reached
+    else if ((transport != "tcp") && (transport != "shm")) {
+        std::cerr << "ERROR: unknown comm transport: " << transport << std::endl;
+        return;
+    }
+    hako::px4::comm::TcpServer tcp_server;
+    hako::px4::comm::ShmServer shm_server;
+    hako::px4::comm::ICommServer *server = &tcp_server;
+    if (transport == "shm") {
+        // 同一ホストの PX4 とは共有メモリで通信する（同時に接続できるのは1つ）
+        server = &shm_server;
+    }
+    server->set_socket_options(options);
+    std::cout << "INFO: PX4 link: " << transport << std::endl;
+    /*
+     * PX4 の接続を待ち受け続ける。TCP は接続ごとに I/O スレッドを起動するので、
+     * PX4 を再起動しても hako-px4sim を再起動せずに再接続できる。
+     * 新しい接続を受け付けても、前の接続はそのまま動かしておく。
+     * 新しい接続が同じシステムIDの HEARTBEAT を送ってきて attach した時点で前の接続を止め、
+     * どの機体にも対応付かないシステムIDの接続はその接続のスレッドが閉じる（1プロセス1機体）。
+     * 終了したスレッドは、次の接続を受け付けたときに join して解放する。
+     */
+    std::list<Px4IoSessionType*> sessions;
+    while (true) {
+        auto comm_io = server->server_open(&serverEndpoint);
+        if (comm_io == nullptr) 
+        {
+            std::cerr << "Failed to open " << transport << " server" << std::endl;
+            break;
+        }
+        std::cout << "INFO: PX4 connected" << std::endl;
+        if (server == &shm_server) {
+            // 共有メモリは接続が終わるまで次の接続を待ち受けられない
+            px4sim_thread_receiver(comm_io);
+            comm_io->close();
+            delete comm_io;
+            continue;
+        }
+        px4_io_session_reap(sessions);
+        Px4IoSessionType *session = new Px4IoSessionType();
+        session->comm_io = comm_io;
+        session->io_thread = io_thread;
+        session->finished.store(false, std::memory_order_relaxed);
+        if (pthread_create(&session->thread, NULL, px4_io_session_run, session) != 0) {
+            std::cerr << "Failed to create px4 I/O thread!" << std::endl;
+            comm_io->close();
+            delete comm_io;
+            delete session;
+            continue;
+        }
+        sessions.push_back(session);
+    }
+    for (auto session : sessions) {
+        session->comm_io->shutdown();
+        px4_io_session_release(session);
+    }
     return;
 }
 
 
+/*
+ * 箱庭のリセットで戻す機体の状態。
+ * setup 直後（simulation.snapshot.restore が true の場合はファイルから復元した後）の状態を保存しておき、
+ * リセット時は JSON の読み込み・機体の生成・ログファイルのオープンをやり直さずに、この状態に戻す。
+ */
+static StateSnapshot reset_snapshot;
+static std::string snapshot_filepath;
+static std::atomic<bool> snapshot_save_requested(false);
+
+static void snapshot_signal_handler(int)
+{
+    snapshot_save_requested.store(true, std::memory_order_relaxed);
+}
+static void snapshot_init()
+{
+    DroneConfig::SnapshotConfig config = drone_config.getSimSnapshot();
+    if (!config.filename.empty()) {
+        snapshot_filepath = drone_config.getSimLogFullPath(config.filename);
+        // kill -USR2 <pid> で現在の機体の状態をファイルに保存する
+        signal(SIGUSR2, snapshot_signal_handler);
+        if (config.restore) {
+            StateSnapshot snapshot;
+            if (snapshot.load_file(snapshot_filepath) && drone->restore_snapshot(snapshot)) {
+                std::cout << "INFO: restored snapshot: " << snapshot_filepath << std::endl;
+            }
+        }
+    }
+    drone->take_snapshot(reset_snapshot);
+}
+/*
+ * シグナルハンドラでは保存せず、アセットスレッドのステップの区切りで保存する
+ */
+static void snapshot_poll_save()
+{
+    if (!snapshot_save_requested.exchange(false, std::memory_order_relaxed)) {
+        return;
+    }
+    StateSnapshot snapshot;
+    drone->take_snapshot(snapshot);
+    if (snapshot.save_file(snapshot_filepath)) {
+        std::cout << "INFO: saved snapshot: " << snapshot_filepath << " (" << snapshot.size() << " bytes)" << std::endl;
+    }
+}
+
+/*
+ * 機体への入力のジャーナル（simulation.deterministic.journal）。
+ * resim モードで同じ入力を再生すると、同じ drone_dynamics.csv などのログが得られる。
+ */
+static hako::assets::drone::InputJournalWriter input_journal;
+static void journal_init()
+{
+    DroneConfig::DeterministicConfig config = drone_config.getSimDeterministic();
+    if (!config.journal) {
+        return;
+    }
+    // create_aircraft() と同じシードを記録する
+    uint32_t noise_seed = config.enable ? config.seed : (uint32_t)std::mt19937::default_seed;
+    Hako_uint64 delta_time_usec = static_cast<Hako_uint64>(drone_config.getSimTimeStep() * 1000000.0);
+    const char* filepath = hako_param_env_get_string(HAKO_JOURNAL_FILEPATH);
+    if (input_journal.open(filepath, drone->get_rotor_bank().get_rotor_num(), noise_seed, delta_time_usec)) {
+        std::cout << "INFO: input journal: " << filepath << std::endl;
+    }
+}
+
+/*
+ * シミュレータ内の衝突判定がある場合は、Unity の Hako_Collision PDU は use_pdu の指定時だけ読む
+ */
+static bool collision_pdu_enabled = true;
+static void collision_pdu_init()
+{
+    if (drone->get_collision_world() != nullptr) {
+        collision_pdu_enabled = drone_config.getCompCollisionWorld().use_pdu;
+    }
+    std::cout << "INFO: collision pdu: " << (collision_pdu_enabled ? "enabled" : "disabled") << std::endl;
+}
+
 static void my_setup()
 {
     std::cout << "INFO: setup start" << std::endl;
     drone = hako::assets::drone::create_aircraft("default");
+    snapshot_init();
+    journal_init();
+    collision_pdu_init();
 
     std::cout << "INFO: setup done" << std::endl;
     return;
 }
+#ifdef DRONE_COLLISION_DEBUG_ENABLE
 static void debug_print(hako::assets::drone::DroneDynamicsCollisionType& drone_collision)
 {
     std::cout << "Collision: " << (drone_collision.collision ? "Yes" : "No") << std::endl;
@@ -90,9 +299,11 @@ static void debug_print(hako::assets::drone::DroneDynamicsCollisionType& drone_c
     }
     std::cout << "Restitution Coefficient: " << drone_collision.restitution_coefficient << std::endl;
 }
+#endif
 
 static void do_io_read_collision(hako::assets::drone::DroneDynamicsCollisionType& drone_collision)
 {
+    HAKO_PROFILE_SCOPE("pdu_read:collision");
     Hako_Collision hako_collision;
     memset(&drone_collision, 0, sizeof(drone_collision));
     if (!hako_asset_runner_pdu_read(HAKO_ROBO_NAME, HAKO_AVATOR_CHANNLE_ID_COLLISION, (char*)&hako_collision, sizeof(hako_collision))) {
@@ -111,7 +322,9 @@ static void do_io_read_collision(hako::assets::drone::DroneDynamicsCollisionType
             drone_collision.contact_position[i].y = -hako_collision.contact_position[i].y;
             drone_collision.contact_position[i].z = -hako_collision.contact_position[i].z;
         }
+#ifdef DRONE_COLLISION_DEBUG_ENABLE
         debug_print(drone_collision);
+#endif
         /*
          * Unityのシミュレーションは20msec周期で動作する。
          * 一方、こちらは 3msec周期で動作するので、衝突データを打ち消しておかないと、次のタイミングで拾ってしまう。
@@ -124,6 +337,7 @@ static void do_io_read_collision(hako::assets::drone::DroneDynamicsCollisionType
 }
 static void do_io_read_manual(hako::assets::drone::DroneDynamicsManualControlType& drone_manual)
 {
+    HAKO_PROFILE_SCOPE("pdu_read:manual");
     Hako_ManualPosAttControl hako_manual;
     memset(&hako_manual, 0, sizeof(hako_manual));
     if (!hako_asset_runner_pdu_read(HAKO_ROBO_NAME, HAKO_AVATOR_CHANNLE_ID_MANUAL, (char*)&hako_manual, sizeof(hako_manual))) {
@@ -144,13 +358,14 @@ static void do_io_read_manual(hako::assets::drone::DroneDynamicsManualControlTyp
         }
     }
 }
-static void do_io_write(double controls[hako::assets::drone::ROTOR_NUM])
+static void do_io_write(double controls[MAX_ROTOR_NUM])
 {
+    HAKO_PROFILE_SCOPE("pdu_write:motor_pos");
     Hako_HakoHilActuatorControls hil_actuator_controls;
     Hako_Twist pos;
 
     memset(&hil_actuator_controls, 0, sizeof(hil_actuator_controls));
-    for (int i = 0; i < hako::assets::drone::ROTOR_NUM; i++) {
+    for (int i = 0; i < MAX_ROTOR_NUM; i++) {
         hil_actuator_controls.controls[i] = controls[i];
     }
     if (!hako_asset_runner_pdu_write(HAKO_ROBO_NAME, HAKO_AVATOR_CHANNLE_ID_MOTOR, (const char*)&hil_actuator_controls, sizeof(hil_actuator_controls))) {
@@ -171,30 +386,47 @@ static void do_io_write(double controls[hako::assets::drone::ROTOR_NUM])
 }
 
 
-static double controls[hako::assets::drone::ROTOR_NUM] = { 0, 0, 0, 0};
+static double controls[MAX_ROTOR_NUM] = {};
 static hako::assets::drone::MavlinkIO mavlink_io;
 static void my_task()
 {
     hako::assets::drone::DroneDynamicsInputType drone_input;
     drone_input.no_use_actuator = false;
     drone_input.manual.control = false;
-    if (drone->get_drone_dynamics().has_collision_detection()) {
+    drone_input.collision.collision = false;
+    if (drone->get_drone_dynamics().has_collision_detection() && collision_pdu_enabled) {
         do_io_read_collision(drone_input.collision);
     }
     if (drone->get_drone_dynamics().has_manual_control()) {
         do_io_read_manual(drone_input.manual);
     }
-    for (int i = 0; i < hako::assets::drone::ROTOR_NUM; i++) {
+    for (int i = 0; i < MAX_ROTOR_NUM; i++) {
         drone_input.controls[i] = controls[i];
     }
-    drone->run(drone_input);
+    if (input_journal.is_open()) {
+        input_journal.write_step(drone_input, CsvLogger::get_time_usec(), CsvLogger::is_enabled());
+    }
+    {
+        StepStatsScope scope(STEP_PHASE_AIRCRAFT_RUN);
+        drone->run(drone_input);
+    }
     do_io_write(controls);
     return;
 }
 
 static void my_reset()
 {
-    //nothing to do
+    if (input_journal.is_open()) {
+        input_journal.write_reset(CsvLogger::get_time_usec());
+    }
+    auto start = std::chrono::steady_clock::now();
+    if (drone->restore_snapshot(reset_snapshot)) {
+        auto usec = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "INFO: reset aircraft state in " << usec << " usec" << std::endl;
+    }
+    for (int i = 0; i < MAX_ROTOR_NUM; i++) {
+        controls[i] = 0;
+    }
 }
 
 static hako_asset_runner_callback_t my_callbacks = {
@@ -208,14 +440,77 @@ static hako_asset_runner_callback_t my_callbacks = {
 bool CsvLogger::enable_flag = false;
 uint64_t CsvLogger::time_usec = 0; 
 static hako_time_t hako_sim_asset_time = 0;
+
+static void step_stats_signal_handler(int)
+{
+    StepStats::instance().request_dump();
+}
+static void step_stats_init(Hako_uint64 delta_time_usec)
+{
+    DroneConfig::StepStatsConfig config = drone_config.getSimStepStats();
+    if (!config.enable) {
+        return;
+    }
+    std::string filepath;
+    if (!config.filename.empty()) {
+        filepath = drone_config.getSimLogFullPath(config.filename);
+    }
+    StepStats::instance().init(delta_time_usec, config.dump_period_sec, filepath);
+    // kill -USR1 <pid> で計測結果を出力する
+    signal(SIGUSR1, step_stats_signal_handler);
+}
+
+static void mavlink_tx_scheduler_init(MavlinkTxScheduler &scheduler, Hako_uint64 delta_time_usec, bool lockstep)
+{
+    for (int i = 0; i < MAVLINK_TX_NUM; i++) {
+        MavlinkTxMessageType msg = static_cast<MavlinkTxMessageType>(i);
+        int period_msec = drone_config.getSimMavlinkTransmissionPeriod(MavlinkTxScheduler::message_name(msg));
+        scheduler.set_period_usec(msg, (period_msec > 0) ? (uint64_t)period_msec * 1000 : 0);
+    }
+    // GPS の測位のレートを設定した場合は、HIL_GPS は測位したステップだけ送信する
+    if (drone_config.getCompGps().update_rate_hz > 0) {
+        scheduler.set_event_driven(MAVLINK_TX_HIL_GPS, true);
+    }
+    /*
+     * ロックステップでは PX4 は HIL_SENSOR を受信するたびに HIL_ACTUATOR_CONTROLS を返すので、
+     * HIL_SENSOR を送らないステップがあると PX4 を待ち続けてしまう。
+     */
+    if (lockstep && (scheduler.get_period_usec(MAVLINK_TX_HIL_SENSOR) > delta_time_usec)) {
+        std::cout << "WARNING: mavlink_tx_period_msec.hil_sensor is longer than timeStep, "
+                  << "HIL_SENSOR is sent every step in lockstep mode" << std::endl;
+        scheduler.set_period_usec(MAVLINK_TX_HIL_SENSOR, 0);
+    }
+    for (int i = 0; i < MAVLINK_TX_NUM; i++) {
+        MavlinkTxMessageType msg = static_cast<MavlinkTxMessageType>(i);
+        if (scheduler.is_event_driven(msg)) {
+            std::cout << "INFO: mavlink tx period " << MavlinkTxScheduler::message_name(msg)
+                      << ": on update" << std::endl;
+            continue;
+        }
+        std::cout << "INFO: mavlink tx period " << MavlinkTxScheduler::message_name(msg)
+                  << ": " << scheduler.get_period_usec(msg) << " usec" << std::endl;
+    }
+}
+
 static void* asset_runner(void*)
 {
     auto now = std::chrono::system_clock::now();
     auto duration = now.time_since_epoch();
     auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
-    //microseconds = 0;
+    DroneConfig::DeterministicConfig deterministic = drone_config.getSimDeterministic();
+    if (deterministic.enable) {
+        // 起動時刻によらず、PX4 に送る時刻を毎回同じにする
+        microseconds = deterministic.epoch_usec;
+        std::cout << "INFO: deterministic mode: seed " << deterministic.seed << " epoch " << microseconds << " usec" << std::endl;
+    }
     Hako_uint64 delta_time_usec = static_cast<Hako_uint64>(drone_config.getSimTimeStep() * 1000000.0);
     bool lockstep = drone_config.getSimLockStep();
+    HAKO_PROFILE_THREAD_NAME("asset runner");
+    HAKO_PROFILE_SIGNAL_INIT();
+    StepStats& step_stats = StepStats::instance();
+    step_stats_init(delta_time_usec);
+    MavlinkTxScheduler tx_scheduler;
+    mavlink_tx_scheduler_init(tx_scheduler, delta_time_usec, lockstep);
     hako_asset_runner_register_callback(&my_callbacks);
     const char* config_path = hako_param_env_get_string(HAKO_CUSTOM_JSON_PATH);
     if (hako_asset_runner_init(HAKO_ROBO_NAME, config_path, delta_time_usec) == false) {
@@ -227,14 +522,33 @@ static void* asset_runner(void*)
         Hako_uint64 px4_time_usec;
         hako_sim_asset_time = 0;
         bool isRecvControl = false;
+        uint32_t px4_session_id = 0;
+        uint64_t step_start_usec = 0;
+        step_stats.reset(hako_asset_time_usec);
+        tx_scheduler.reset();
         std::cout << "INFO: start simulation" << std::endl;
         while (true) {
+            if (step_stats.is_enabled() && (step_start_usec == 0)) {
+                step_start_usec = StepStats::now_usec();
+            }
+            /*
+             * PX4 が再接続した場合は、HIL_SENSOR の送信から再開する。
+             * 切断中は PX4 を待たずにシミュレーションを進める。
+             */
+            uint32_t session_id = px4sim_sender_session_id();
+            if (session_id != px4_session_id) {
+                px4_session_id = session_id;
+                isRecvControl = false;
+            }
             //read Mavlink Message
             //std::cout << "lockstep: " << lockstep << " isRecvControl: " << isRecvControl << std::endl;
             if (mavlink_io.read_actuator_data(controls, px4_time_usec) == false) {
-                if (lockstep && isRecvControl) {
+                if (lockstep && isRecvControl && px4sim_sender_is_connected()) {
                     //std::cout << "waiting .... " << std::endl;
                     usleep(delta_time_usec); //1msec sleep
+                    step_stats.poll_dump();
+                    snapshot_poll_save();
+                    HAKO_PROFILE_SIGNAL_POLL();
                     continue;
                 }
                 else {
@@ -252,17 +566,45 @@ static void* asset_runner(void*)
                 //std::cout << "recv HIL_ACTUATOR_CONTROLS: " << px4_time_usec << std::endl;
             }
 
-            if (hako_asset_runner_step(1) == false) {
+            if (step_start_usec != 0) {
+                step_stats.record(STEP_PHASE_WAIT_ACTUATOR, StepStats::now_usec() - step_start_usec);
+            }
+            bool is_running;
+            {
+                HAKO_PROFILE_SCOPE("hako_asset_runner_step");
+                StepStatsScope scope(STEP_PHASE_RUNNER_STEP);
+                is_running = hako_asset_runner_step(1);
+            }
+            if (is_running == false) {
                 std::cout << "INFO: stopped simulation" << std::endl;
+                input_journal.flush();
+                HAKO_PROFILE_DUMP();
                 break;
             }
             else {
                 hako_asset_time_usec += delta_time_usec;
+                tx_scheduler.update(hako_asset_time_usec);
+                if (tx_scheduler.is_event_driven(MAVLINK_TX_HIL_GPS) && drone->get_gps().has_new_fix()) {
+                    tx_scheduler.trigger(MAVLINK_TX_HIL_GPS);
+                }
                 //write Mavlink Message
-                mavlink_io.write_sensor_data(*drone);
-                px4sim_send_sensor_data(hako_asset_time_usec, microseconds);
+                {
+                    StepStatsScope scope(STEP_PHASE_SENSOR_BUILD);
+                    mavlink_io.write_sensor_data(*drone, tx_scheduler);
+                }
+                px4sim_send_sensor_data(hako_asset_time_usec, microseconds, tx_scheduler);
                 hako_sim_asset_time += delta_time_usec;
             }
+            if (step_start_usec != 0) {
+                step_stats.end_step(StepStats::now_usec() - step_start_usec, hako_asset_time_usec);
+                step_start_usec = 0;
+            }
+            step_stats.poll_dump();
+            snapshot_poll_save();
+            HAKO_PROFILE_SIGNAL_POLL();
+        }
+        if (step_stats.is_enabled()) {
+            step_stats.dump();
         }
     }
     std::cout << "INFO: end simulation" << std::endl;
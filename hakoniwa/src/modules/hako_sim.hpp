@@ -2,6 +2,8 @@
 #define _HAKO_SIM_HPP_
 
 #include "comm/tcp_connector.hpp"
+#include "comm/udp_connector.hpp"
+#include "comm/shm_connector.hpp"
 
 extern void hako_sim_main(bool master, hako::px4::comm::IcommEndpointType serverEndpoint);
 
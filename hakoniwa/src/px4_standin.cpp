@@ -0,0 +1,268 @@
+/*
+ * PX4 の代わりに hako-px4sim に TCP 接続し、HIL の往復を計測するツール。
+ *
+ * 接続後に HEARTBEAT と COMMAND_LONG を送信し、以降は HIL_SENSOR を受信するたびに
+ * reply_delay_usec だけ待ってから HIL_ACTUATOR_CONTROLS を返す（PX4 の lockstep の代わり）。
+ * duration_sec が経過するか接続が切れたら、以下を出力して終了する。
+ *   - turnaround: HIL_ACTUATOR_CONTROLS を送信してから次の HIL_SENSOR を受信するまでの時間
+ *   - interval  : HIL_SENSOR の受信間隔
+ *   - steps/sec と実時間比（HIL_SENSOR の time_usec の進み/実時間）
+ * HIL_SENSOR を1つも受信できなかった場合は終了コード 1 を返す。
+ */
+#include "comm/tcp_connector.hpp"
+#include "mavlink/mavlink_encoder.hpp"
+#include "mavlink/mavlink_decoder.hpp"
+#include "utils/latency_histogram.hpp"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <cstdlib>
+#include <cstring>
+#include <poll.h>
+
+#define PX4_STANDIN_DEFAULT_DURATION_SEC    10
+#define PX4_STANDIN_DEFAULT_SYSTEM_ID       1
+#define PX4_STANDIN_COMPONENT_ID            1
+#define PX4_STANDIN_HEARTBEAT_PERIOD_USEC   1000000
+#define PX4_STANDIN_REPORT_PERIOD_USEC      1000000
+#define PX4_STANDIN_POLL_TIMEOUT_MSEC       100
+#define PX4_STANDIN_CHAN                    MAVLINK_CONFIG_CHAN_0
+
+typedef struct {
+    uint8_t system_id;
+    uint64_t reply_delay_usec;
+    uint64_t duration_usec;
+} Px4StandinConfigType;
+
+typedef struct {
+    LatencyHistogram turnaround;
+    LatencyHistogram interval;
+    uint64_t steps;
+    uint64_t acks;
+    uint64_t send_errors;
+    uint64_t start_usec;
+    uint64_t first_sensor_time_usec;
+    uint64_t last_sensor_time_usec;
+    uint64_t last_recv_usec;
+    uint64_t last_reply_usec;
+    uint64_t last_report_usec;
+    uint64_t last_report_steps;
+} Px4StandinStatsType;
+
+static uint64_t px4_standin_now_usec(void)
+{
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::microseconds>(now).count();
+}
+
+static bool px4_standin_send(hako::px4::comm::ICommIO &comm_io, const Px4StandinConfigType &config, const MavlinkDecodedMessage &message)
+{
+    mavlink_message_t msg;
+    if (!mavlink_encode_message(&msg, &message, config.system_id, PX4_STANDIN_COMPONENT_ID)) {
+        return false;
+    }
+    char packet[MAVLINK_MAX_PACKET_LEN];
+    int packetLen = mavlink_get_packet(packet, sizeof(packet), &msg);
+    if (packetLen <= 0) {
+        return false;
+    }
+    int sentDataLen = 0;
+    return comm_io.send(packet, packetLen, &sentDataLen);
+}
+
+static bool px4_standin_send_heartbeat(hako::px4::comm::ICommIO &comm_io, const Px4StandinConfigType &config)
+{
+    MavlinkDecodedMessage message;
+    memset(&message, 0, sizeof(message));
+    message.type = MAVLINK_MSG_TYPE_HEARTBEAT;
+    message.data.heartbeat.type = MAV_TYPE_QUADROTOR;
+    message.data.heartbeat.autopilot = MAV_AUTOPILOT_PX4;
+    message.data.heartbeat.base_mode = MAV_MODE_FLAG_SAFETY_ARMED | MAV_MODE_FLAG_HIL_ENABLED;
+    message.data.heartbeat.custom_mode = 0;
+    message.data.heartbeat.system_status = MAV_STATE_ACTIVE;
+    return px4_standin_send(comm_io, config, message);
+}
+
+static bool px4_standin_send_command_long(hako::px4::comm::ICommIO &comm_io, const Px4StandinConfigType &config)
+{
+    MavlinkDecodedMessage message;
+    memset(&message, 0, sizeof(message));
+    message.type = MAVLINK_MSG_TYPE_LONG;
+    message.data.command_long.target_system = 0;
+    message.data.command_long.target_component = 0;
+    message.data.command_long.command = MAV_CMD_SET_MESSAGE_INTERVAL;
+    message.data.command_long.param1 = MAVLINK_MSG_ID_HIL_SENSOR;
+    return px4_standin_send(comm_io, config, message);
+}
+
+static bool px4_standin_send_actuator_controls(hako::px4::comm::ICommIO &comm_io, const Px4StandinConfigType &config, uint64_t time_usec)
+{
+    MavlinkDecodedMessage message;
+    memset(&message, 0, sizeof(message));
+    message.type = MAVLINK_MSG_TYPE_HIL_ACTUATOR_CONTROLS;
+    message.data.hil_actuator_controls.time_usec = time_usec;
+    message.data.hil_actuator_controls.mode = MAV_MODE_FLAG_SAFETY_ARMED;
+    message.data.hil_actuator_controls.flags = 0;
+    return px4_standin_send(comm_io, config, message);
+}
+
+static void px4_standin_wait(uint64_t delay_usec)
+{
+    if (delay_usec > 0) {
+        std::this_thread::sleep_for(std::chrono::microseconds(delay_usec));
+    }
+}
+
+static double px4_standin_rate(uint64_t count, uint64_t usec)
+{
+    return (usec == 0) ? 0.0 : (double)count * 1000000.0 / (double)usec;
+}
+
+static void px4_standin_report(Px4StandinStatsType &stats, uint64_t now)
+{
+    std::cout << "INFO: px4-standin: steps=" << stats.steps
+              << " steps/sec=" << std::fixed << std::setprecision(1)
+              << px4_standin_rate(stats.steps - stats.last_report_steps, now - stats.last_report_usec)
+              << " turnaround(p50/p99)=" << stats.turnaround.percentile(50.0) << "/" << stats.turnaround.percentile(99.0) << " usec"
+              << std::endl;
+    stats.last_report_usec = now;
+    stats.last_report_steps = stats.steps;
+}
+
+static void px4_standin_print_summary(const Px4StandinStatsType &stats, const Px4StandinConfigType &config, uint64_t now)
+{
+    uint64_t wall_usec = now - stats.start_usec;
+    uint64_t sim_usec = stats.last_sensor_time_usec - stats.first_sensor_time_usec;
+    std::cout << "INFO: px4-standin summary: steps=" << stats.steps
+              << " acks=" << stats.acks
+              << " send_errors=" << stats.send_errors
+              << " reply_delay=" << config.reply_delay_usec << " usec"
+              << " wall_time=" << std::fixed << std::setprecision(3) << (double)wall_usec / 1000000.0
+              << " steps/sec=" << std::setprecision(1) << px4_standin_rate(stats.steps, wall_usec)
+              << " rtf=" << std::setprecision(3) << ((wall_usec == 0) ? 0.0 : (double)sim_usec / (double)wall_usec)
+              << std::endl;
+    stats.turnaround.print(std::cout, "turnaround");
+    stats.interval.print(std::cout, "interval");
+    stats.turnaround.print_distribution(std::cout);
+}
+
+static void px4_standin_process(hako::px4::comm::ICommIO &comm_io, const Px4StandinConfigType &config,
+                                Px4StandinStatsType &stats, const char *data, int datalen)
+{
+    mavlink_message_t msg;
+    if (!mavlink_decode(PX4_STANDIN_CHAN, data, datalen, &msg)) {
+        return;
+    }
+    MavlinkDecodedMessage message;
+    if (!mavlink_get_message(&msg, &message)) {
+        return;
+    }
+    switch (message.type) {
+        case MAVLINK_MSG_TYPE_HIL_SENSOR:
+        {
+            uint64_t recv_usec = px4_standin_now_usec();
+            if (stats.last_reply_usec != 0) {
+                stats.turnaround.record(recv_usec - stats.last_reply_usec);
+            }
+            if (stats.last_recv_usec != 0) {
+                stats.interval.record(recv_usec - stats.last_recv_usec);
+            }
+            else {
+                stats.first_sensor_time_usec = message.data.sensor.time_usec;
+            }
+            stats.last_recv_usec = recv_usec;
+            stats.last_sensor_time_usec = message.data.sensor.time_usec;
+            stats.steps++;
+            px4_standin_wait(config.reply_delay_usec);
+            if (!px4_standin_send_actuator_controls(comm_io, config, message.data.sensor.time_usec)) {
+                stats.send_errors++;
+            }
+            stats.last_reply_usec = px4_standin_now_usec();
+            break;
+        }
+        case MAVLINK_MSG_TYPE_LONG:
+            // hako-px4sim は COMMAND_LONG への応答を COMMAND_LONG で返す（px4sim_send_dummy_command_long_ack）
+            stats.acks++;
+            break;
+        default:
+            break;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if ((argc < 3) || (argc > 6)) {
+        std::cerr << "Usage: " << argv[0] << " <server_ip> <server_port> [reply_delay_usec] [duration_sec] [system_id]" << std::endl;
+        return -1;
+    }
+    const char* serverIp = argv[1];
+    int serverPort = std::atoi(argv[2]);
+    Px4StandinConfigType config;
+    config.reply_delay_usec = (argc > 3) ? std::strtoull(argv[3], nullptr, 10) : 0;
+    config.duration_usec = ((argc > 4) ? std::strtoull(argv[4], nullptr, 10) : PX4_STANDIN_DEFAULT_DURATION_SEC) * 1000000ULL;
+    config.system_id = (uint8_t)((argc > 5) ? std::atoi(argv[5]) : PX4_STANDIN_DEFAULT_SYSTEM_ID);
+
+    hako::px4::comm::IcommEndpointType serverEndpoint = { serverIp, serverPort };
+    hako::px4::comm::TcpClient client;
+    hako::px4::comm::CommSocketOptionsType options = hako::px4::comm::comm_socket_options_default();
+    options.tcp_nodelay = true;
+    client.set_socket_options(options);
+    hako::px4::comm::ICommIO *comm_io = client.client_open(nullptr, &serverEndpoint);
+    if (comm_io == nullptr) {
+        std::cerr << "ERROR: can not connect to " << serverIp << ":" << serverPort << std::endl;
+        return -1;
+    }
+    std::cout << "INFO: px4-standin connected: system_id=" << (int)config.system_id
+              << " reply_delay=" << config.reply_delay_usec << " usec" << std::endl;
+
+    Px4StandinStatsType stats = {};
+    stats.start_usec = px4_standin_now_usec();
+    stats.last_report_usec = stats.start_usec;
+    if (!px4_standin_send_heartbeat(*comm_io, config) || !px4_standin_send_command_long(*comm_io, config)) {
+        std::cerr << "ERROR: can not send initial messages" << std::endl;
+        comm_io->close();
+        delete comm_io;
+        return -1;
+    }
+    uint64_t last_heartbeat_usec = stats.start_usec;
+
+    // poll() で待つので、途中までのフレームで recv() が止まらないようにする
+    (void)comm_io->set_nonblocking(true);
+    struct pollfd fds[1];
+    fds[0].fd = comm_io->get_fd();
+    fds[0].events = POLLIN;
+    while (comm_io->is_connected()) {
+        uint64_t now = px4_standin_now_usec();
+        if ((now - stats.start_usec) >= config.duration_usec) {
+            break;
+        }
+        if ((now - last_heartbeat_usec) >= PX4_STANDIN_HEARTBEAT_PERIOD_USEC) {
+            (void)px4_standin_send_heartbeat(*comm_io, config);
+            last_heartbeat_usec = now;
+        }
+        if ((now - stats.last_report_usec) >= PX4_STANDIN_REPORT_PERIOD_USEC) {
+            px4_standin_report(stats, now);
+        }
+        int ret = ::poll(fds, 1, PX4_STANDIN_POLL_TIMEOUT_MSEC);
+        if ((ret <= 0) || !(fds[0].revents & (POLLIN | POLLHUP | POLLERR))) {
+            continue;
+        }
+        /*
+         * hako-px4sim は HIL_SENSOR, HIL_GPS などを1回の sendmsg でまとめて送るので、
+         * 受信バッファに残ったフレームもここで処理する（残したままだとソケットは readable にならない）。
+         */
+        do {
+            char recvBuffer[1024];
+            int recvDataLen;
+            if (!comm_io->recv(recvBuffer, sizeof(recvBuffer), &recvDataLen)) {
+                break;
+            }
+            px4_standin_process(*comm_io, config, stats, recvBuffer, recvDataLen);
+        } while (comm_io->recv_pending());
+    }
+    px4_standin_print_summary(stats, config, px4_standin_now_usec());
+    comm_io->close();
+    delete comm_io;
+    return (stats.steps > 0) ? 0 : 1;
+}
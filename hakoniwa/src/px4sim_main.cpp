@@ -4,6 +4,7 @@
 #include "modules/hako_bypass.hpp"
 #include "modules/hako_phys.hpp"
 #include "modules/hako_sim.hpp"
+#include "modules/hako_resim.hpp"
 #include "utils/hako_params.hpp"
 #include "config/drone_config.hpp"
 
@@ -12,7 +13,7 @@ class DroneConfig drone_config;
 int main(int argc, char* argv[]) 
 {
     if(argc != 4) {
-        std::cerr << "Usage: " << argv[0] << " <server_ip> <server_port> <mode={sim|wsim|bypass|phys}> "  << std::endl;
+        std::cerr << "Usage: " << argv[0] << " <server_ip> <server_port> <mode={sim|wsim|bypass|phys|resim}> "  << std::endl;
         return -1;
     }
     const char* serverIp = argv[1];
@@ -38,6 +39,10 @@ int main(int argc, char* argv[])
         //not returned function.
         //do not pass
     }
+    else if (strcmp("resim", arg_mode) == 0) {
+        hako_resim_main();
+        return 0;
+    }
     else if ((strcmp("sim", arg_mode) == 0) ||  (strcmp("wsim", arg_mode) == 0)) {
         bool master = true;
         if  (strcmp("wsim", arg_mode) == 0) {
@@ -0,0 +1,213 @@
+#include "px4sim_thread_reactor.hpp"
+#include "px4sim_thread_receiver.hpp"
+#include "../hako/pdu/hako_pdu_data.hpp"
+#include "utils/hako_profile.hpp"
+#include <iostream>
+#include <poll.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <string.h>
+
+static void px4sim_reactor_update_max(std::atomic<uint64_t> &max_value, uint64_t value)
+{
+    uint64_t current = max_value.load(std::memory_order_relaxed);
+    while ((value > current) && !max_value.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        ;
+    }
+}
+
+static bool px4sim_reactor_init(Px4simReactorType &reactor)
+{
+    reactor.sleeping = false;
+    reactor.tx_frames = 0;
+    reactor.tx_dropped = 0;
+    reactor.tx_failed = 0;
+    reactor.tx_max_depth = 0;
+    reactor.rx_frames = 0;
+    reactor.wakeups = 0;
+    if (pipe(reactor.wakeup_fd) < 0) {
+        std::cerr << "ERROR: Failed to create reactor wakeup pipe: " << strerror(errno) << std::endl;
+        return false;
+    }
+    for (int i = 0; i < 2; i++) {
+        int flags = fcntl(reactor.wakeup_fd[i], F_GETFL, 0);
+        (void)fcntl(reactor.wakeup_fd[i], F_SETFL, flags | O_NONBLOCK);
+    }
+    return true;
+}
+
+static void px4sim_reactor_fini(Px4simReactorType &reactor)
+{
+    ::close(reactor.wakeup_fd[0]);
+    ::close(reactor.wakeup_fd[1]);
+}
+
+bool px4sim_reactor_enqueue(Px4simReactorType &reactor, const char *data, int datalen)
+{
+    if ((datalen <= 0) || (datalen > MAVLINK_MAX_PACKET_LEN)) {
+        return false;
+    }
+    Px4simReactorFrameType frame;
+    frame.len = datalen;
+    memcpy(frame.data, data, datalen);
+    if (!reactor.tx_queue.push(frame)) {
+        reactor.tx_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    px4sim_reactor_update_max(reactor.tx_max_depth, reactor.tx_queue.size());
+    return true;
+}
+
+void px4sim_reactor_notify(Px4simReactorType &reactor)
+{
+    /*
+     * リアクタ側は sleeping を立ててからキューを確認するので、
+     * キューに積んだ後に sleeping を見れば起こし損ねることはない。
+     */
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (reactor.sleeping.load(std::memory_order_relaxed)) {
+        char c = 0;
+        if (::write(reactor.wakeup_fd[1], &c, 1) == 1) {
+            reactor.wakeups.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+void px4sim_reactor_get_stats(Px4simReactorType &reactor, Px4simReactorStatsType &stats)
+{
+    stats.tx_frames = reactor.tx_frames.load(std::memory_order_relaxed);
+    stats.tx_dropped = reactor.tx_dropped.load(std::memory_order_relaxed);
+    stats.tx_failed = reactor.tx_failed.load(std::memory_order_relaxed);
+    stats.tx_max_depth = reactor.tx_max_depth.load(std::memory_order_relaxed);
+    stats.rx_frames = reactor.rx_frames.load(std::memory_order_relaxed);
+    stats.wakeups = reactor.wakeups.load(std::memory_order_relaxed);
+}
+
+/*
+ * 送信キューに積まれたフレームを、最大 PX4SIM_REACTOR_TX_BATCH_NUM 個ずつ send_batch() する。
+ * キューの要素はコピーせずに参照し、送信し終えてから解放する。
+ */
+static void px4sim_reactor_flush(Px4simReactorType &reactor, hako::px4::comm::ICommIO &comm_io)
+{
+    if (reactor.tx_queue.empty()) {
+        return;
+    }
+    HAKO_PROFILE_SCOPE("px4sim_reactor_flush");
+    while (!reactor.tx_queue.empty()) {
+        const char *data[PX4SIM_REACTOR_TX_BATCH_NUM];
+        int datalen[PX4SIM_REACTOR_TX_BATCH_NUM];
+        int num = 0;
+        Px4simReactorFrameType *frame;
+        while ((num < PX4SIM_REACTOR_TX_BATCH_NUM) && ((frame = reactor.tx_queue.peek(num)) != nullptr)) {
+            data[num] = frame->data;
+            datalen[num] = frame->len;
+            num++;
+        }
+        int sent_num = 0;
+        bool ret = comm_io.send_batch(data, datalen, num, &sent_num);
+        reactor.tx_queue.discard(num);
+        reactor.tx_frames.fetch_add(sent_num, std::memory_order_relaxed);
+        if (!ret) {
+            reactor.tx_failed.fetch_add(num - sent_num, std::memory_order_relaxed);
+            std::cerr << "Failed to send MAVLink message" << std::endl;
+            if (!comm_io.is_connected()) {
+                return;
+            }
+        }
+    }
+}
+
+static void px4sim_reactor_drain_wakeup(Px4simReactorType &reactor)
+{
+    char buf[64];
+    while (::read(reactor.wakeup_fd[0], buf, sizeof(buf)) > 0) {
+        ;
+    }
+}
+
+static void px4sim_reactor_print_stats(Px4simReactorType &reactor)
+{
+    Px4simReactorStatsType stats;
+    px4sim_reactor_get_stats(reactor, stats);
+    HakoPduQueueStatsType actuator_stats;
+    hako_get_hil_actuator_controls_stats(actuator_stats);
+    std::cout << "INFO: px4 reactor tx: frames=" << stats.tx_frames
+              << " dropped=" << stats.tx_dropped
+              << " failed=" << stats.tx_failed
+              << " max_depth=" << stats.tx_max_depth
+              << " wakeups=" << stats.wakeups << std::endl;
+    std::cout << "INFO: px4 reactor rx: frames=" << stats.rx_frames
+              << " actuator written=" << actuator_stats.write_count
+              << " coalesced=" << actuator_stats.coalesced_count
+              << " max_depth=" << actuator_stats.max_queue_depth << std::endl;
+}
+
+void *px4sim_thread_reactor(void *arg)
+{
+    std::cout << "INFO: px4 reactor start" << std::endl;
+    HAKO_PROFILE_THREAD_NAME("px4 reactor");
+    hako::px4::comm::ICommIO *comm_io = static_cast<hako::px4::comm::ICommIO *>(arg);
+    Px4simReactorType *reactor = new Px4simReactorType();
+    if (!px4sim_reactor_init(*reactor)) {
+        delete reactor;
+        return NULL;
+    }
+    Px4simRecvSessionType session;
+    px4sim_receiver_session_begin(session, comm_io, reactor);
+    /*
+     * poll() の中で recv() が1フレームそろうまで待つと送信が止まるため、受信はノンブロッキングにする。
+     * 途中まで受信したフレームは comm_io 側で保持される。
+     */
+    (void)comm_io->set_nonblocking(true);
+
+    struct pollfd fds[2];
+    fds[0].fd = comm_io->get_fd();
+    fds[0].events = POLLIN;
+    fds[1].fd = reactor->wakeup_fd[0];
+    fds[1].events = POLLIN;
+    while (comm_io->is_connected()) {
+        px4sim_reactor_flush(*reactor, *comm_io);
+
+        /*
+         * px4sim_reactor_notify() と対になる。sleeping を立ててからキューを確認する。
+         */
+        reactor->sleeping.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!reactor->tx_queue.empty()) {
+            reactor->sleeping.store(false, std::memory_order_relaxed);
+            continue;
+        }
+        int ret = ::poll(fds, 2, PX4SIM_REACTOR_POLL_TIMEOUT_MSEC);
+        reactor->sleeping.store(false, std::memory_order_relaxed);
+        if (ret < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cerr << "ERROR: px4 reactor poll failed: " << strerror(errno) << std::endl;
+            break;
+        }
+        if (fds[1].revents & POLLIN) {
+            px4sim_reactor_drain_wakeup(*reactor);
+        }
+        if (fds[0].revents & (POLLIN | POLLHUP | POLLERR)) {
+            do {
+                char recvBuffer[1024];
+                int recvDataLen;
+                if (!comm_io->recv(recvBuffer, sizeof(recvBuffer), &recvDataLen)) {
+                    break;
+                }
+                reactor->rx_frames.fetch_add(1, std::memory_order_relaxed);
+                px4sim_receiver_session_process(session, recvBuffer, recvDataLen);
+            } while (comm_io->recv_pending());
+        }
+    }
+    /*
+     * detach した後はアセットスレッドがこのリアクタに積むことはない。
+     */
+    px4sim_receiver_session_end(session);
+    px4sim_reactor_print_stats(*reactor);
+    px4sim_reactor_fini(*reactor);
+    delete reactor;
+    return NULL;
+}
@@ -0,0 +1,70 @@
+#ifndef _PX4SIM_THREAD_REACTOR_HPP_
+#define _PX4SIM_THREAD_REACTOR_HPP_
+
+#include "mavlink.h"
+#include "../comm/icomm_connector.hpp"
+#include "utils/spsc_queue.hpp"
+#include <atomic>
+#include <cstdint>
+
+/*
+ * PX4 との1つの接続を、1つの I/O スレッド（リアクタ）で送受信する。
+ *
+ * リアクタだけがソケットを読み書きする。アセットスレッドは送信フレームを
+ * tx_queue に積んで px4sim_reactor_notify() を呼ぶだけで、ソケットに触れない。
+ * リアクタは poll() でソケットと起床用パイプを待ち、送信キューを send_batch() でまとめて
+ * 送り、受信したフレームを受信スレッドと同じ処理（px4sim_receiver_session_process）に渡す。
+ * 起床用パイプへの書き込みは、リアクタが poll() で寝ているときだけ行う。
+ */
+#define PX4SIM_REACTOR_TX_QUEUE_SIZE        64  /* 2のべき乗 */
+#define PX4SIM_REACTOR_TX_BATCH_NUM         16
+#define PX4SIM_REACTOR_POLL_TIMEOUT_MSEC    100
+
+typedef struct {
+    int len;
+    char data[MAVLINK_MAX_PACKET_LEN];
+} Px4simReactorFrameType;
+
+/*
+ * 背圧の状況を確認するための統計情報
+ */
+typedef struct {
+    uint64_t tx_frames;         // 送信したフレーム数
+    uint64_t tx_dropped;        // 送信キューが満杯で捨てたフレーム数
+    uint64_t tx_failed;         // 送信に失敗したフレーム数
+    uint64_t tx_max_depth;      // 送信キューの最大滞留数
+    uint64_t rx_frames;         // 受信したフレーム数
+    uint64_t wakeups;           // 起床用パイプで起こした回数
+} Px4simReactorStatsType;
+
+struct Px4simReactor {
+    SpscQueue<Px4simReactorFrameType, PX4SIM_REACTOR_TX_QUEUE_SIZE> tx_queue;
+    int wakeup_fd[2];
+    std::atomic<bool> sleeping;
+    std::atomic<uint64_t> tx_frames;
+    std::atomic<uint64_t> tx_dropped;
+    std::atomic<uint64_t> tx_failed;
+    std::atomic<uint64_t> tx_max_depth;
+    std::atomic<uint64_t> rx_frames;
+    std::atomic<uint64_t> wakeups;
+};
+typedef struct Px4simReactor Px4simReactorType;
+
+/*
+ * 送信フレームを積む（アセットスレッドから呼ぶ）。
+ * キューが満杯のときは捨てて false を返す。
+ */
+extern bool px4sim_reactor_enqueue(Px4simReactorType &reactor, const char *data, int datalen);
+/*
+ * 積んだフレームの送信をリアクタに依頼する（アセットスレッドから呼ぶ）。
+ */
+extern void px4sim_reactor_notify(Px4simReactorType &reactor);
+extern void px4sim_reactor_get_stats(Px4simReactorType &reactor, Px4simReactorStatsType &stats);
+
+/*
+ * arg は ICommIO*。切断を検出したら終了する。接続の解放は、スレッドを join した呼び出し側が行う。
+ * get_fd() が -1 を返す ICommIO では使えない。
+ */
+extern void *px4sim_thread_reactor(void *arg);
+
+#endif /* _PX4SIM_THREAD_REACTOR_HPP_ */
@@ -7,6 +7,12 @@
 #include "../hako/pdu/hako_pdu_data.hpp"
 #include "config/drone_config.hpp"
 #include <iostream>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include "utils/latency_histogram.hpp"
+#include "utils/hako_profile.hpp"
+#include "../comm/comm_socket_options.hpp"
 
 #include "../mavlink/mavlink_msg_types.hpp"
 #include "utils/csv_logger.hpp"
@@ -18,10 +24,30 @@ static MavlinkLogHilActuatorControls log_hil_actuator_controls;
 
 hako_time_t hako_px4_asset_time = 0;
 static uint64_t px4_boot_time = 0;
+static int px4_io_cpu_affinity = -1;
+/*
+ * HIL_SENSOR 送信から HIL_ACTUATOR_CONTROLS 受信までの往復時間
+ */
+static LatencyHistogram px4_actuator_latency;
+
+static void hako_mavlink_record_latency(void)
+{
+    uint64_t sent_time_usec = px4sim_sender_get_sensor_sent_time_usec();
+    if (sent_time_usec == 0) {
+        return;
+    }
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    uint64_t now_usec = std::chrono::duration_cast<std::chrono::microseconds>(now).count();
+    if (now_usec >= sent_time_usec) {
+        px4_actuator_latency.record(now_usec - sent_time_usec);
+    }
+}
+
 static void hako_mavlink_write_data(MavlinkDecodedMessage &message)
 {
     switch (message.type) {
         case MAVLINK_MSG_TYPE_HIL_ACTUATOR_CONTROLS:
+            hako_mavlink_record_latency();
             log_hil_actuator_controls.set_data(message.data.hil_actuator_controls);
             logger_recv.run();
             hako_mavlink_write_hil_actuator_controls(message.data.hil_actuator_controls);
@@ -51,37 +77,115 @@ static void hako_mavlink_write_data(MavlinkDecodedMessage &message)
     }    
 }
 
+void px4sim_receiver_init(int io_cpu_affinity)
+{
+    px4_io_cpu_affinity = io_cpu_affinity;
+    if (drone_config.isMSimavlinkLogEnabled("hil_actuator_controls")) {
+        logger_recv.add_entry(log_hil_actuator_controls, drone_config.getSimLogFullPath("log_comm_hil_actuator_controls.csv"));
+    }
+}
+
+/*
+ * 同時に複数の PX4 が接続してもパース状態が混ざらないように、接続ごとに MAVLink チャネルを割り当てる。
+ */
+static std::atomic<uint32_t> px4_recv_channel_count(0);
+
+/*
+ * アクチュエータの書き込みは attach 中の接続だけが行う。
+ * 再接続で置き換えられた接続の受信スレッドは、終了するまでの間も書き込まない。
+ */
+static std::mutex px4_actuator_mutex;
+static hako::px4::comm::ICommIO *px4_actuator_writer = nullptr;
+
+void px4sim_receiver_session_begin(Px4simRecvSessionType &session, hako::px4::comm::ICommIO *comm_io, struct Px4simReactor *reactor)
+{
+    (void)hako::px4::comm::comm_thread_set_cpu_affinity(px4_io_cpu_affinity);
+    session.comm_io = comm_io;
+    session.reactor = reactor;
+    session.chan = (uint8_t)(px4_recv_channel_count.fetch_add(1) % MAVLINK_COMM_NUM_BUFFERS);
+    session.is_attached = false;
+    session.is_target = false;
+}
+
+void px4sim_receiver_session_process(Px4simRecvSessionType &session, const char *data, int datalen)
+{
+    //std::cout << "Received data with length: " << datalen << std::endl;
+    HAKO_PROFILE_SCOPE("px4sim_receiver_session_process");
+    mavlink_message_t msg;
+    bool ret = mavlink_decode(session.chan, data, datalen, &msg);
+    if (ret)
+    {
+        MavlinkDecodedMessage message;
+        ret = mavlink_get_message(&msg, &message);
+        if (ret) {
+#ifdef DRONE_PX4_RX_DEBUG_ENABLE
+            mavlink_msg_dump(msg);
+            mavlink_message_dump(message);
+#endif
+            if (!session.is_attached) {
+                session.is_attached = true;
+                std::cout << "INFO: PX4 system id = " << (int)msg.sysid << std::endl;
+                session.is_target = px4sim_sender_attach(msg.sysid, session.comm_io, session.reactor);
+                if (!session.is_target) {
+                    // どの機体にも対応付かない接続は閉じる
+                    session.comm_io->shutdown();
+                    return;
+                }
+                std::lock_guard<std::mutex> lock(px4_actuator_mutex);
+                px4_actuator_writer = session.comm_io;
+                px4_boot_time = 0;
+                px4_actuator_latency.reset();
+            }
+            if (message.type == MAVLINK_MSG_TYPE_LONG) {
+                px4sim_send_dummy_command_long_ack(*session.comm_io);
+            }
+            if (session.is_target) {
+                std::lock_guard<std::mutex> lock(px4_actuator_mutex);
+                if (px4_actuator_writer == session.comm_io) {
+                    hako_mavlink_write_data(message);
+                }
+            }
+        }
+    }
+}
+
+void px4sim_receiver_session_end(Px4simRecvSessionType &session)
+{
+    std::cout << "INFO: px4 reciver end: connection closed" << std::endl;
+    if (session.is_target) {
+        std::lock_guard<std::mutex> lock(px4_actuator_mutex);
+        if (px4_actuator_writer == session.comm_io) {
+            px4_actuator_writer = nullptr;
+            px4_actuator_latency.print(std::cout, "HIL_ACTUATOR_CONTROLS RTT");
+            px4_actuator_latency.print_distribution(std::cout);
+        }
+    }
+    px4sim_sender_detach(session.comm_io);
+}
+
+/*
+ * 接続ごとに1スレッドで動作し、切断を検出したら終了する。
+ * 接続の解放は、スレッドを join した呼び出し側が行う。
+ */
 void *px4sim_thread_receiver(void *arg)
 {
     std::cout << "INFO: px4 reciver start" << std::endl;
-    logger_recv.add_entry(log_hil_actuator_controls, drone_config.getSimLogFullPath("log_comm_hil_actuator_controls.csv"));
+    HAKO_PROFILE_THREAD_NAME("px4 receiver");
     hako::px4::comm::ICommIO *clientConnector = static_cast<hako::px4::comm::ICommIO *>(arg);
+    Px4simRecvSessionType session;
+    px4sim_receiver_session_begin(session, clientConnector, nullptr);
     while (true) {
         char recvBuffer[1024];
         int recvDataLen;
         if (clientConnector->recv(recvBuffer, sizeof(recvBuffer), &recvDataLen)) 
         {
-            //std::cout << "Received data with length: " << recvDataLen << std::endl;
-            mavlink_message_t msg;
-            bool ret = mavlink_decode(MAVLINK_CONFIG_CHAN_0, recvBuffer, recvDataLen, &msg);
-            if (ret)
-            {
-                MavlinkDecodedMessage message;
-                ret = mavlink_get_message(&msg, &message);
-                if (ret) {
-#ifdef DRONE_PX4_RX_DEBUG_ENABLE
-                    mavlink_msg_dump(msg);
-                    mavlink_message_dump(message);
-#endif
-                    if (message.type == MAVLINK_MSG_TYPE_LONG) {
-                        px4sim_send_dummy_command_long_ack(*clientConnector);
-                    }
-                    hako_mavlink_write_data(message);
-                }
-            }
+            px4sim_receiver_session_process(session, recvBuffer, recvDataLen);
+        } else if (!clientConnector->is_connected()) {
+            break;
         } else {
             //std::cerr << "Failed to receive data" << std::endl;
         }
     }
+    px4sim_receiver_session_end(session);
     return NULL;
-}
\ No newline at end of file
+}
@@ -2,10 +2,30 @@
 #define _PX4SIM_THREAD_RECEIVER_HPP_
 
 #include "hako_capi.h"
+#include "../comm/icomm_connector.hpp"
+#include <cstdint>
 
 extern hako_time_t hako_px4_asset_time;
 extern hako_time_t hako_asset_time;
 
+struct Px4simReactor;
+
+/*
+ * PX4 との1つの接続の受信状態。
+ * 受信スレッド(px4sim_thread_receiver)とリアクタ(px4sim_thread_reactor)の両方から使う。
+ */
+typedef struct {
+    hako::px4::comm::ICommIO *comm_io;
+    struct Px4simReactor *reactor;  // リアクタ経由で送信する場合のみ設定する
+    uint8_t chan;
+    bool is_attached;
+    bool is_target;
+} Px4simRecvSessionType;
+
+extern void px4sim_receiver_init(int io_cpu_affinity);
+extern void px4sim_receiver_session_begin(Px4simRecvSessionType &session, hako::px4::comm::ICommIO *comm_io, struct Px4simReactor *reactor);
+extern void px4sim_receiver_session_process(Px4simRecvSessionType &session, const char *data, int datalen);
+extern void px4sim_receiver_session_end(Px4simRecvSessionType &session);
 extern void *px4sim_thread_receiver(void *arg);
 
 #endif /* _PX4SIM_THREAD_RECEIVER_HPP_ */
\ No newline at end of file
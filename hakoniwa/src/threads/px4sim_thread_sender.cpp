@@ -11,11 +11,52 @@
 #include "config/drone_config.hpp"
 #include "../mavlink/mavlink_msg_types.hpp"
 #include "hako/runner/hako_px4_master.hpp"
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include "utils/step_stats.hpp"
+#include "utils/hako_profile.hpp"
 
-static void px4sim_send_hil_gps(hako::px4::comm::ICommIO &clientConnector, uint64_t time_usec);
-static void px4sim_send_sensor(hako::px4::comm::ICommIO &clientConnector, uint64_t time_usec);
+/*
+ * 1ステップで送信するメッセージをまとめて send_batch() で送る
+ */
+#define PX4SIM_SEND_BATCH_NUM   4
+typedef struct {
+    char packet[PX4SIM_SEND_BATCH_NUM][MAVLINK_MAX_PACKET_LEN];
+    const char* data[PX4SIM_SEND_BATCH_NUM];
+    int datalen[PX4SIM_SEND_BATCH_NUM];
+    int num;
+} Px4simSendBatchType;
 
-static hako::px4::comm::ICommIO *px4_comm_io;
+static bool px4sim_batch_add_message(Px4simSendBatchType &batch, MavlinkDecodedMessage &message);
+static void px4sim_send_batch(hako::px4::comm::ICommIO &clientConnector, Px4simSendBatchType &batch);
+static void px4sim_build_hil_gps(Px4simSendBatchType &batch, uint64_t time_usec);
+static void px4sim_build_sensor(Px4simSendBatchType &batch, uint64_t time_usec);
+static void px4sim_build_battery_status(Px4simSendBatchType &batch);
+
+static hako::px4::comm::ICommIO *px4_comm_io = nullptr;
+static Px4simReactorType *px4_reactor = nullptr;
+static uint8_t px4_system_id = 1;
+static uint32_t px4_session_id = 0;
+/*
+ * px4_comm_mutex: px4_comm_io の付け替えを排他する
+ * px4_send_mutex: 同じソケットへの複数スレッドからの書き込みを排他する
+ *
+ * アセットスレッドは px4_comm_mutex の中で px4_comm_io を取り出して参照数(px4_send_refs)を増やし、
+ * 送信は px4_comm_mutex を離してから行う。detach は参照数が 0 になるまで待つので、
+ * detach から戻った後に接続やリアクタが解放されても、送信中に使われることはない。
+ */
+static std::mutex px4_comm_mutex;
+static std::mutex px4_send_mutex;
+static std::condition_variable px4_send_refs_cond;
+static int px4_send_refs = 0;
+static std::atomic<uint64_t> px4_sensor_sent_time_usec(0);
+
+uint64_t px4sim_sender_get_sensor_sent_time_usec(void)
+{
+    return px4_sensor_sent_time_usec.load(std::memory_order_relaxed);
+}
 
 using hako::assets::drone::mavlink::log::MavlinkLogHilSensor;
 using hako::assets::drone::mavlink::log::MavlinkLogHilGps;
@@ -24,51 +65,190 @@ static MavlinkLogHilSensor log_hil_sensor;
 static CsvLogger logger_hil_gps;
 static MavlinkLogHilGps log_hil_gps;
 
-void px4sim_sender_init(hako::px4::comm::ICommIO *comm_io)
+void px4sim_sender_init(uint8_t system_id)
 {
-    px4_comm_io = comm_io;
-    logger_hil_sensor.add_entry(log_hil_sensor, drone_config.getSimLogFullPath("log_comm_hil_sensor.csv"));
-    logger_hil_gps.add_entry(log_hil_gps, drone_config.getSimLogFullPath("log_comm_hil_gps.csv"));
+    px4_system_id = system_id;
+    if (drone_config.isMSimavlinkLogEnabled("hil_sensor")) {
+        logger_hil_sensor.add_entry(log_hil_sensor, drone_config.getSimLogFullPath("log_comm_hil_sensor.csv"));
+    }
+    if (drone_config.isMSimavlinkLogEnabled("hil_gps")) {
+        logger_hil_gps.add_entry(log_hil_gps, drone_config.getSimLogFullPath("log_comm_hil_gps.csv"));
+    }
     return;
 }
 
-void px4sim_send_sensor_data(Hako_uint64 time_usec, Hako_uint64 boot_time_usec)
+bool px4sim_sender_attach(uint8_t system_id, hako::px4::comm::ICommIO *comm_io, Px4simReactorType *reactor)
 {
-    static int count = 0;
-    (void)boot_time_usec;
+    if (system_id != px4_system_id) {
+        std::cout << "WARNING: PX4 system id " << (int)system_id << " is not mapped to any aircraft" << std::endl;
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(px4_comm_mutex);
+    if ((px4_comm_io != nullptr) && (px4_comm_io != comm_io)) {
+        /*
+         * 前の接続は止めるだけにする。前の受信スレッドは切断を検出して終了し、
+         * 接続の解放はそのスレッドを join した呼び出し側が行う。
+         */
+        std::cout << "INFO: PX4 system id " << (int)system_id << " reconnected, switching connection" << std::endl;
+        px4_comm_io->shutdown();
+    }
+    px4_comm_io = comm_io;
+    px4_reactor = reactor;
+    px4_session_id++;
+    return true;
+}
+
+void px4sim_sender_detach(hako::px4::comm::ICommIO *comm_io)
+{
+    std::unique_lock<std::mutex> lock(px4_comm_mutex);
+    if (px4_comm_io == comm_io) {
+        px4_comm_io = nullptr;
+        px4_reactor = nullptr;
+    }
+    // 付け替えられた接続も、アセットスレッドが送信中の場合がある
+    px4_send_refs_cond.wait(lock, [] { return px4_send_refs == 0; });
+}
+
+static bool px4sim_sender_acquire(hako::px4::comm::ICommIO *&comm_io, Px4simReactorType *&reactor)
+{
+    std::lock_guard<std::mutex> lock(px4_comm_mutex);
     if (px4_comm_io == nullptr) {
+        return false;
+    }
+    comm_io = px4_comm_io;
+    reactor = px4_reactor;
+    px4_send_refs++;
+    return true;
+}
+
+static void px4sim_sender_release(void)
+{
+    std::lock_guard<std::mutex> lock(px4_comm_mutex);
+    px4_send_refs--;
+    if (px4_send_refs == 0) {
+        px4_send_refs_cond.notify_all();
+    }
+}
+
+bool px4sim_sender_is_connected(void)
+{
+    std::lock_guard<std::mutex> lock(px4_comm_mutex);
+    return px4_comm_io != nullptr;
+}
+
+uint32_t px4sim_sender_session_id(void)
+{
+    std::lock_guard<std::mutex> lock(px4_comm_mutex);
+    return px4_session_id;
+}
+
+void px4sim_send_sensor_data(Hako_uint64 time_usec, Hako_uint64 boot_time_usec, const MavlinkTxScheduler &scheduler)
+{
+    (void)boot_time_usec;
+    HAKO_PROFILE_SCOPE("px4sim_send_sensor_data");
+    hako::px4::comm::ICommIO *comm_io = nullptr;
+    Px4simReactorType *reactor = nullptr;
+    if (!px4sim_sender_acquire(comm_io, reactor)) {
+        return;
+    }
+    Px4simSendBatchType batch;
+    batch.num = 0;
+    {
+        StepStatsScope scope(STEP_PHASE_ENCODE);
+        if (scheduler.is_due(MAVLINK_TX_HIL_SENSOR)) {
+            px4sim_build_sensor(batch, time_usec);
+        }
+        if (scheduler.is_due(MAVLINK_TX_HIL_GPS)) {
+            px4sim_build_hil_gps(batch, time_usec);
+        }
+        if (scheduler.is_due(MAVLINK_TX_BATTERY_STATUS)) {
+            px4sim_build_battery_status(batch);
+        }
+    }
+    if (batch.num == 0) {
+        px4sim_sender_release();
         return;
     }
-    px4sim_send_sensor(*px4_comm_io, time_usec);
-    if ((count % 10) == 0) {
-        px4sim_send_hil_gps(*px4_comm_io, time_usec);
+    {
+        StepStatsScope scope(STEP_PHASE_SEND);
+        if (reactor != nullptr) {
+            for (int i = 0; i < batch.num; i++) {
+                (void)px4sim_reactor_enqueue(*reactor, batch.data[i], batch.datalen[i]);
+            }
+            px4sim_reactor_notify(*reactor);
+        }
+        else {
+            px4sim_send_batch(*comm_io, batch);
+        }
+    }
+    px4sim_sender_release();
+    if (scheduler.is_due(MAVLINK_TX_HIL_SENSOR)) {
+        auto now = std::chrono::steady_clock::now().time_since_epoch();
+        px4_sensor_sent_time_usec.store(std::chrono::duration_cast<std::chrono::microseconds>(now).count(), std::memory_order_relaxed);
     }
-    count++;
     return;
 }
 
-
-void px4sim_send_message(hako::px4::comm::ICommIO &clientConnector, MavlinkDecodedMessage &message)
+static int px4sim_encode_message(MavlinkDecodedMessage &message, char* packet, int packet_size)
 {
     mavlink_message_t mavlinkMsg;
     if (mavlink_encode_message(&mavlinkMsg, &message)) 
     {
-        int sentDataLen = 0;
-        char packet[MAVLINK_MAX_PACKET_LEN];
-        int packetLen = mavlink_get_packet(packet, sizeof(packet), &mavlinkMsg);
-        if (packetLen > 0) 
+        return mavlink_get_packet(packet, packet_size, &mavlinkMsg);
+    }
+    return 0;
+}
+
+static bool px4sim_batch_add_message(Px4simSendBatchType &batch, MavlinkDecodedMessage &message)
+{
+    if (batch.num >= PX4SIM_SEND_BATCH_NUM) {
+        return false;
+    }
+    int packetLen = px4sim_encode_message(message, batch.packet[batch.num], MAVLINK_MAX_PACKET_LEN);
+    if (packetLen <= 0) {
+        return false;
+    }
+    batch.data[batch.num] = batch.packet[batch.num];
+    batch.datalen[batch.num] = packetLen;
+    batch.num++;
+#ifdef DRONE_PX4_TX_DEBUG_ENABLE
+    mavlink_message_dump(message);
+#endif
+    return true;
+}
+
+static void px4sim_send_batch(hako::px4::comm::ICommIO &clientConnector, Px4simSendBatchType &batch)
+{
+    if (batch.num == 0) {
+        return;
+    }
+    int sent_num = 0;
+    std::lock_guard<std::mutex> lock(px4_send_mutex);
+    if (!clientConnector.send_batch(batch.data, batch.datalen, batch.num, &sent_num)) {
+        std::cerr << "Failed to send MAVLink message" << std::endl;
+    }
+}
+
+
+void px4sim_send_message(hako::px4::comm::ICommIO &clientConnector, MavlinkDecodedMessage &message)
+{
+    HAKO_PROFILE_SCOPE("px4sim_send_message");
+    int sentDataLen = 0;
+    char packet[MAVLINK_MAX_PACKET_LEN];
+    int packetLen = px4sim_encode_message(message, packet, sizeof(packet));
+    if (packetLen > 0) 
+    {
+        std::lock_guard<std::mutex> lock(px4_send_mutex);
+        if (clientConnector.send(packet, packetLen, &sentDataLen)) 
         {
-            if (clientConnector.send(packet, packetLen, &sentDataLen)) 
-            {
-                //std::cout << "Sent MAVLink message with length: " << sentDataLen << std::endl;
+            //std::cout << "Sent MAVLink message with length: " << sentDataLen << std::endl;
 #ifdef DRONE_PX4_TX_DEBUG_ENABLE
-                mavlink_message_dump(message);
+            mavlink_message_dump(message);
 #endif
-            } 
-            else 
-            {
-                std::cerr << "Failed to send MAVLink message" << std::endl;
-            }
+        } 
+        else 
+        {
+            std::cerr << "Failed to send MAVLink message" << std::endl;
         }
     }
 }
@@ -131,7 +311,7 @@ void px4sim_send_dummy_heartbeat(hako::px4::comm::ICommIO &clientConnector)
 }
 
 
-static void px4sim_send_hil_gps(hako::px4::comm::ICommIO &clientConnector, uint64_t time_usec)
+static void px4sim_build_hil_gps(Px4simSendBatchType &batch, uint64_t time_usec)
 {
     static bool is_initialized = false;
     MavlinkDecodedMessage message;
@@ -144,11 +324,11 @@ static void px4sim_send_hil_gps(hako::px4::comm::ICommIO &clientConnector, uint6
         message.data.hil_gps.time_usec = time_usec;
         log_hil_gps.set_data(message.data.hil_gps);
         logger_hil_gps.run();
-        px4sim_send_message(clientConnector, message);
+        (void)px4sim_batch_add_message(batch, message);
     }
 }
 
-static void px4sim_send_sensor(hako::px4::comm::ICommIO &clientConnector, uint64_t time_usec)
+static void px4sim_build_sensor(Px4simSendBatchType &batch, uint64_t time_usec)
 {
     static bool is_initialized = false;
     MavlinkDecodedMessage message;
@@ -161,6 +341,18 @@ static void px4sim_send_sensor(hako::px4::comm::ICommIO &clientConnector, uint64
         message.data.sensor.time_usec = time_usec;
         log_hil_sensor.set_data(message.data.sensor);
         logger_hil_sensor.run();
-        px4sim_send_message(clientConnector, message);
+        (void)px4sim_batch_add_message(batch, message);
+    }
+}
+
+/*
+ * バッテリがない機体では書き込まれないので送信しない
+ */
+static void px4sim_build_battery_status(Px4simSendBatchType &batch)
+{
+    MavlinkDecodedMessage message;
+    message.type = MAVLINK_MSG_TYPE_BATTERY_STATUS;
+    if (hako_mavlink_read_battery_status(message.data.battery_status)) {
+        (void)px4sim_batch_add_message(batch, message);
     }
 }
@@ -4,10 +4,30 @@
 #include "../comm/icomm_connector.hpp"
 #include "../mavlink/mavlink_msg_types.hpp"
 #include "hako/pdu/hako_pdu_data.hpp"
+#include "px4sim_thread_reactor.hpp"
+#include "../mavlink/mavlink_tx_scheduler.hpp"
 
-extern void px4sim_sender_init(hako::px4::comm::ICommIO *comm_io);
+/*
+ * PX4 との接続は MAVLink のシステムIDで機体に対応付ける。
+ * 受信スレッドが最初のメッセージでシステムIDを知ったときに attach し、
+ * 切断時に detach する。同じシステムIDで再接続された場合は新しい接続に置き換わり、前の接続は shutdown() する。
+ * どの機体にも対応付かないシステムIDの場合、attach は false を返す。
+ * reactor を指定した場合、センサデータはソケットに直接書かずにリアクタの送信キューに積む。
+ */
+extern void px4sim_sender_init(uint8_t system_id);
+extern bool px4sim_sender_attach(uint8_t system_id, hako::px4::comm::ICommIO *comm_io, Px4simReactorType *reactor = nullptr);
+extern void px4sim_sender_detach(hako::px4::comm::ICommIO *comm_io);
+extern bool px4sim_sender_is_connected(void);
+extern uint32_t px4sim_sender_session_id(void);
+/*
+ * 最後に HIL_SENSOR を送信した時刻(steady_clock, usec)
+ */
+extern uint64_t px4sim_sender_get_sensor_sent_time_usec(void);
 extern void px4sim_sender_do_task(void);
-extern void px4sim_send_sensor_data(Hako_uint64 time_usec, Hako_uint64 boot_time_usec);
+/*
+ * scheduler がこのステップで送信するとしたメッセージだけをエンコードして送信する
+ */
+extern void px4sim_send_sensor_data(Hako_uint64 time_usec, Hako_uint64 boot_time_usec, const MavlinkTxScheduler &scheduler);
 
 extern void px4sim_send_message(hako::px4::comm::ICommIO &clientConnector, MavlinkDecodedMessage &message);
 extern void px4sim_send_dummy_command_long(hako::px4::comm::ICommIO &clientConnector);
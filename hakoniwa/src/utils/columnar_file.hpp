@@ -0,0 +1,280 @@
+#ifndef _COLUMNAR_FILE_HPP_
+#define _COLUMNAR_FILE_HPP_
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+/*
+ * ログ解析用の列指向のバイナリファイル。
+ *
+ * 列ごとに値を連続して格納し、末尾のフッタに列名・型・格納位置・統計値を置く（Parquet と同様の配置）。
+ * 解析側はフッタだけを読んで必要な列を選び、その列を1回の read でそのまま配列として読み込める。
+ * 数値はすべてリトルエンディアンの 8 バイトで、欠損値は float64 列の NaN で表す。
+ *
+ *   file   := magic | column data ... | footer | footer_size(u64) | magic
+ *   magic  := "HAKOCOL1"
+ *   footer := version(u32) | column_num(u32) | row_num(u64) | column ...
+ *   column := type(u32) | name_len(u32) | name | offset(u64) | null_count(u64) | min(f64) | max(f64) | mean(f64) | stddev(f64)
+ */
+#define COLUMNAR_FILE_MAGIC     "HAKOCOL1"
+#define COLUMNAR_FILE_MAGIC_LEN 8
+#define COLUMNAR_FILE_VERSION   1
+
+typedef enum {
+    COLUMNAR_TYPE_INT64 = 1,
+    COLUMNAR_TYPE_FLOAT64 = 2,
+} ColumnarType;
+
+typedef struct {
+    uint64_t count;         // 欠損値を除く個数
+    uint64_t null_count;
+    double min;
+    double max;
+    double mean;
+    double stddev;
+} ColumnarStatsType;
+
+typedef struct {
+    std::string name;
+    ColumnarType type;
+    uint64_t offset;
+    ColumnarStatsType stats;
+} ColumnarColumnInfoType;
+
+template <typename T>
+static inline ColumnarStatsType columnar_compute_stats(const T* values, size_t num)
+{
+    ColumnarStatsType stats = { 0, 0, std::numeric_limits<double>::quiet_NaN(),
+        std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN() };
+    // Welford 法（1パスで桁落ちしにくい）
+    double mean = 0;
+    double m2 = 0;
+    for (size_t i = 0; i < num; i++) {
+        double value = (double)values[i];
+        if (std::isnan(value)) {
+            stats.null_count++;
+            continue;
+        }
+        if (stats.count == 0) {
+            stats.min = value;
+            stats.max = value;
+        }
+        else {
+            stats.min = (value < stats.min) ? value : stats.min;
+            stats.max = (value > stats.max) ? value : stats.max;
+        }
+        stats.count++;
+        double delta = value - mean;
+        mean += delta / (double)stats.count;
+        m2 += delta * (value - mean);
+    }
+    if (stats.count > 0) {
+        stats.mean = mean;
+        stats.stddev = std::sqrt(m2 / (double)stats.count);
+    }
+    return stats;
+}
+
+class ColumnarFileWriter {
+private:
+    std::ofstream ofs;
+    std::vector<ColumnarColumnInfoType> columns;
+    uint64_t row_num;
+    uint64_t offset;
+
+    template <typename T>
+    void put(const T& value)
+    {
+        ofs.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+    template <typename T>
+    bool write_values(const std::string& name, ColumnarType type, const std::vector<T>& values)
+    {
+        if (!ofs.is_open()) {
+            return false;
+        }
+        if (columns.empty()) {
+            row_num = values.size();
+        }
+        else if (values.size() != row_num) {
+            std::cerr << "ERROR: column " << name << " has " << values.size() << " rows, expected " << row_num << std::endl;
+            return false;
+        }
+        ColumnarColumnInfoType column;
+        column.name = name;
+        column.type = type;
+        column.offset = offset;
+        column.stats = columnar_compute_stats(values.data(), values.size());
+        ofs.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+        offset += values.size() * sizeof(T);
+        columns.push_back(column);
+        return ofs.good();
+    }
+
+public:
+    ColumnarFileWriter() : row_num(0), offset(0) {}
+    virtual ~ColumnarFileWriter()
+    {
+        if (ofs.is_open()) {
+            (void)close();
+        }
+    }
+    bool open(const std::string& filepath)
+    {
+        ofs.open(filepath, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!ofs.is_open()) {
+            std::cerr << "ERROR: can not open columnar file: " << filepath << std::endl;
+            return false;
+        }
+        columns.clear();
+        row_num = 0;
+        ofs.write(COLUMNAR_FILE_MAGIC, COLUMNAR_FILE_MAGIC_LEN);
+        offset = COLUMNAR_FILE_MAGIC_LEN;
+        return ofs.good();
+    }
+    bool write_column(const std::string& name, const std::vector<int64_t>& values)
+    {
+        return write_values(name, COLUMNAR_TYPE_INT64, values);
+    }
+    bool write_column(const std::string& name, const std::vector<double>& values)
+    {
+        return write_values(name, COLUMNAR_TYPE_FLOAT64, values);
+    }
+    const std::vector<ColumnarColumnInfoType>& get_columns() const
+    {
+        return columns;
+    }
+    /*
+     * フッタを書き込んで閉じる
+     */
+    bool close()
+    {
+        if (!ofs.is_open()) {
+            return false;
+        }
+        uint64_t footer_start = offset;
+        put((uint32_t)COLUMNAR_FILE_VERSION);
+        put((uint32_t)columns.size());
+        put(row_num);
+        for (auto& column : columns) {
+            put((uint32_t)column.type);
+            put((uint32_t)column.name.size());
+            ofs.write(column.name.data(), column.name.size());
+            put(column.offset);
+            put(column.stats.null_count);
+            put(column.stats.min);
+            put(column.stats.max);
+            put(column.stats.mean);
+            put(column.stats.stddev);
+        }
+        uint64_t footer_size = (uint64_t)ofs.tellp() - footer_start;
+        put(footer_size);
+        ofs.write(COLUMNAR_FILE_MAGIC, COLUMNAR_FILE_MAGIC_LEN);
+        bool ret = ofs.good();
+        ofs.close();
+        return ret;
+    }
+};
+
+class ColumnarFileReader {
+private:
+    std::ifstream ifs;
+    std::vector<ColumnarColumnInfoType> columns;
+    uint64_t row_num;
+
+    template <typename T>
+    bool get(T& value)
+    {
+        ifs.read(reinterpret_cast<char*>(&value), sizeof(value));
+        return ifs.good();
+    }
+    template <typename T>
+    bool read_values(size_t index, ColumnarType type, std::vector<T>& values)
+    {
+        if ((index >= columns.size()) || (columns[index].type != type)) {
+            return false;
+        }
+        values.resize(row_num);
+        ifs.seekg(columns[index].offset);
+        ifs.read(reinterpret_cast<char*>(values.data()), row_num * sizeof(T));
+        return ifs.good();
+    }
+
+public:
+    ColumnarFileReader() : row_num(0) {}
+    virtual ~ColumnarFileReader() {}
+    bool open(const std::string& filepath)
+    {
+        ifs.open(filepath, std::ios::in | std::ios::binary);
+        if (!ifs.is_open()) {
+            std::cerr << "ERROR: can not open columnar file: " << filepath << std::endl;
+            return false;
+        }
+        char magic[COLUMNAR_FILE_MAGIC_LEN];
+        uint64_t footer_size = 0;
+        ifs.seekg(-(std::streamoff)(sizeof(footer_size) + COLUMNAR_FILE_MAGIC_LEN), std::ios::end);
+        if (!get(footer_size) || !ifs.read(magic, COLUMNAR_FILE_MAGIC_LEN) || (memcmp(magic, COLUMNAR_FILE_MAGIC, COLUMNAR_FILE_MAGIC_LEN) != 0)) {
+            std::cerr << "ERROR: not a columnar file: " << filepath << std::endl;
+            return false;
+        }
+        ifs.seekg(-(std::streamoff)(footer_size + sizeof(footer_size) + COLUMNAR_FILE_MAGIC_LEN), std::ios::end);
+        uint32_t version = 0;
+        uint32_t column_num = 0;
+        if (!get(version) || (version != COLUMNAR_FILE_VERSION) || !get(column_num) || !get(row_num)) {
+            std::cerr << "ERROR: unsupported columnar file: " << filepath << std::endl;
+            return false;
+        }
+        columns.clear();
+        for (uint32_t i = 0; i < column_num; i++) {
+            ColumnarColumnInfoType column;
+            uint32_t type = 0;
+            uint32_t name_len = 0;
+            if (!get(type) || !get(name_len)) {
+                return false;
+            }
+            column.type = (ColumnarType)type;
+            column.name.resize(name_len);
+            ifs.read(&column.name[0], name_len);
+            if (!get(column.offset) || !get(column.stats.null_count) || !get(column.stats.min)
+                || !get(column.stats.max) || !get(column.stats.mean) || !get(column.stats.stddev)) {
+                return false;
+            }
+            column.stats.count = row_num - column.stats.null_count;
+            columns.push_back(column);
+        }
+        return true;
+    }
+    uint64_t get_row_num() const
+    {
+        return row_num;
+    }
+    const std::vector<ColumnarColumnInfoType>& get_columns() const
+    {
+        return columns;
+    }
+    int find_column(const std::string& name) const
+    {
+        for (size_t i = 0; i < columns.size(); i++) {
+            if (columns[i].name == name) {
+                return (int)i;
+            }
+        }
+        return -1;
+    }
+    bool read_column(size_t index, std::vector<int64_t>& values)
+    {
+        return read_values(index, COLUMNAR_TYPE_INT64, values);
+    }
+    bool read_column(size_t index, std::vector<double>& values)
+    {
+        return read_values(index, COLUMNAR_TYPE_FLOAT64, values);
+    }
+};
+
+#endif /* _COLUMNAR_FILE_HPP_ */
@@ -5,6 +5,7 @@
 #include <fstream>
 #include <vector>
 #include <string>
+#include "log_record.hpp"
 
 class CsvData {
 private:
@@ -29,6 +30,10 @@ public:
         }
         csv_file << "\n";
     }
+    void write(const LogRecord& record) {
+        csv_file.write(record.data(), record.size());
+        csv_file.put('\n');
+    }
 
     // ファイルのフラッシュ
     void flush() {
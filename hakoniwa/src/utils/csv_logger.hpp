@@ -13,6 +13,7 @@ typedef struct {
 class CsvLogger {
 private:
     std::vector<CsvLogEntryType> entries;
+    LogRecord record;
     int write_count;
     static bool enable_flag;
     static uint64_t time_usec;
@@ -45,13 +46,18 @@ public:
     {
         enable_flag = false;
     }
+    static bool is_enabled()
+    {
+        return enable_flag;
+    }
     void run() {
         if (enable_flag == false) {
             return;
         }
         for (auto& entry : entries) {
-            auto log_data = entry.log->log_data();
-            entry.csv_data->write(log_data);
+            record.clear();
+            entry.log->log_fields(record);
+            entry.csv_data->write(record);
         }
         if (++write_count >= MAX_WRITE_COUNT) {
             for (auto& entry : entries) {
@@ -13,7 +13,7 @@ typedef struct {
     int value;
 } HakoParamIntegerType;
 
-#define HAKO_PARAM_STRING_NUM 4
+#define HAKO_PARAM_STRING_NUM 5
 static HakoParamStringType hako_param_string[HAKO_PARAM_STRING_NUM] = {
     {
        HAKO_CAPTURE_SAVE_FILEPATH,
@@ -31,6 +31,10 @@ static HakoParamStringType hako_param_string[HAKO_PARAM_STRING_NUM] = {
         DRONE_CONFIG_PATH,
         "../config/drone_config.json"
     },
+    {
+        HAKO_JOURNAL_FILEPATH,
+        "./hako_journal.bin"
+    },
 };
 #define HAKO_PARAM_INTEGER_NUM 1
 static HakoParamIntegerType hako_param_integer[HAKO_PARAM_INTEGER_NUM] = {
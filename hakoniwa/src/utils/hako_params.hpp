@@ -8,6 +8,7 @@
 #define HAKO_BYPASS_IPADDR "HAKO_BYPASS_IPADDR"
 #define HAKO_CUSTOM_JSON_PATH   "HAKO_CUSTOM_JSON_PATH"
 #define DRONE_CONFIG_PATH "DRONE_CONFIG_PATH"
+#define HAKO_JOURNAL_FILEPATH "HAKO_JOURNAL_FILEPATH"
 
 /*
  * integer params
@@ -0,0 +1,186 @@
+#include "utils/hako_profile.hpp"
+
+#ifdef HAKO_PROFILE_ENABLE
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <signal.h>
+#include <unistd.h>
+
+namespace hako::profile {
+
+#define HAKO_PROFILE_DEFAULT_FILEPATH   "hako_profile_trace.json"
+#define HAKO_PROFILE_DEFAULT_MAX_EVENTS (1024 * 1024)
+
+typedef struct {
+    const char* name;
+    uint64_t begin_usec;
+    uint64_t duration_usec;
+} ProfileEventType;
+
+/*
+ * 書き込むのは所有スレッドだけ。count を release で更新するので、
+ * profile_dump() は count までの要素をロックなしで読める。
+ */
+typedef struct {
+    uint32_t tid;
+    std::string name;
+    ProfileEventType* events;
+    size_t capacity;
+    std::atomic<size_t> count;
+    std::atomic<uint64_t> dropped;
+} ProfileThreadBufferType;
+
+static std::mutex profile_mutex;
+// スレッドが終了しても dump できるように、バッファは解放しない
+static std::vector<ProfileThreadBufferType*> profile_buffers;
+static thread_local ProfileThreadBufferType* profile_buffer = nullptr;
+static uint32_t profile_thread_count = 0;
+
+static size_t profile_max_events(void)
+{
+    const char* value = getenv("HAKO_PROFILE_MAX_EVENTS");
+    if (value != nullptr) {
+        long n = atol(value);
+        if (n > 0) {
+            return (size_t)n;
+        }
+    }
+    return HAKO_PROFILE_DEFAULT_MAX_EVENTS;
+}
+
+static ProfileThreadBufferType* profile_get_buffer(void)
+{
+    if (profile_buffer != nullptr) {
+        return profile_buffer;
+    }
+    ProfileThreadBufferType* buffer = new ProfileThreadBufferType();
+    buffer->capacity = profile_max_events();
+    buffer->events = new ProfileEventType[buffer->capacity];
+    buffer->count = 0;
+    buffer->dropped = 0;
+    std::lock_guard<std::mutex> lock(profile_mutex);
+    if (profile_buffers.empty()) {
+        atexit(profile_dump);
+    }
+    buffer->tid = ++profile_thread_count;
+    buffer->name = "thread-" + std::to_string(buffer->tid);
+    profile_buffers.push_back(buffer);
+    profile_buffer = buffer;
+    return buffer;
+}
+
+uint64_t profile_now_usec(void)
+{
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::microseconds>(now).count();
+}
+
+void profile_record(const char* name, uint64_t begin_usec, uint64_t end_usec)
+{
+    ProfileThreadBufferType* buffer = profile_get_buffer();
+    size_t index = buffer->count.load(std::memory_order_relaxed);
+    if (index >= buffer->capacity) {
+        buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    buffer->events[index].name = name;
+    buffer->events[index].begin_usec = begin_usec;
+    buffer->events[index].duration_usec = end_usec - begin_usec;
+    buffer->count.store(index + 1, std::memory_order_release);
+}
+
+void profile_set_thread_name(const char* name)
+{
+    ProfileThreadBufferType* buffer = profile_get_buffer();
+    std::lock_guard<std::mutex> lock(profile_mutex);
+    buffer->name = name;
+}
+
+static void profile_write_string(std::ostream& os, const char* str)
+{
+    os << '"';
+    for (const char* p = str; *p != '\0'; p++) {
+        if ((*p == '"') || (*p == '\\')) {
+            os << '\\';
+        }
+        os << *p;
+    }
+    os << '"';
+}
+
+void profile_dump(void)
+{
+    const char* filepath = getenv("HAKO_PROFILE_FILEPATH");
+    if (filepath == nullptr) {
+        filepath = HAKO_PROFILE_DEFAULT_FILEPATH;
+    }
+    std::ofstream ofs(filepath);
+    if (!ofs) {
+        std::cerr << "ERROR: can not open profile file: " << filepath << std::endl;
+        return;
+    }
+    int pid = (int)getpid();
+    std::lock_guard<std::mutex> lock(profile_mutex);
+    ofs << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[" << std::endl;
+    bool is_first = true;
+    for (auto buffer : profile_buffers) {
+        ofs << (is_first ? "" : ",\n") << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":" << pid
+            << ",\"tid\":" << buffer->tid << ",\"args\":{\"name\":";
+        profile_write_string(ofs, buffer->name.c_str());
+        ofs << "}}";
+        is_first = false;
+        size_t count = buffer->count.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; i++) {
+            const ProfileEventType& event = buffer->events[i];
+            ofs << ",\n{\"ph\":\"X\",\"name\":";
+            profile_write_string(ofs, event.name);
+            ofs << ",\"pid\":" << pid << ",\"tid\":" << buffer->tid
+                << ",\"ts\":" << event.begin_usec << ",\"dur\":" << event.duration_usec << "}";
+        }
+        uint64_t dropped = buffer->dropped.load(std::memory_order_relaxed);
+        if (dropped > 0) {
+            std::cout << "WARNING: profile events dropped on " << buffer->name << ": " << dropped << std::endl;
+        }
+    }
+    ofs << "\n]}" << std::endl;
+    std::cout << "INFO: profile trace written to " << filepath << std::endl;
+}
+
+static std::atomic<int> profile_signal(0);
+
+static void profile_signal_handler(int sig)
+{
+    // ループが止まっていて出力できない場合に備えて、2回目のシグナルでは待たずに終了する
+    if (profile_signal.exchange(sig, std::memory_order_relaxed) != 0) {
+        signal(sig, SIG_DFL);
+        raise(sig);
+    }
+}
+
+void profile_signal_init(void)
+{
+    signal(SIGINT, profile_signal_handler);
+    signal(SIGTERM, profile_signal_handler);
+}
+
+void profile_signal_poll(void)
+{
+    int sig = profile_signal.load(std::memory_order_relaxed);
+    if (sig == 0) {
+        return;
+    }
+    profile_dump();
+    signal(sig, SIG_DFL);
+    raise(sig);
+}
+
+}
+
+#endif /* HAKO_PROFILE_ENABLE */
@@ -0,0 +1,62 @@
+#ifndef _HAKO_PROFILE_HPP_
+#define _HAKO_PROFILE_HPP_
+
+/*
+ * 処理区間の計測（Chrome trace / Perfetto 形式のタイムライン出力）。
+ *
+ * HAKO_PROFILE_ENABLE を定義してビルドした場合のみ有効になる（cmake -DHAKO_PROFILE=ON）。
+ * 無効のときは HAKO_PROFILE_SCOPE などのマクロは何も生成しない。
+ *
+ * 有効のとき、スコープの開始時刻と処理時間をスレッドごとのバッファに記録し、
+ * プロセス終了時に環境変数 HAKO_PROFILE_FILEPATH のファイル（省略時は hako_profile_trace.json）へ出力する。
+ * SIGINT/SIGTERM では atexit が呼ばれないため、HAKO_PROFILE_SIGNAL_INIT() でフラグを立てるハンドラを登録し、
+ * ループで HAKO_PROFILE_SIGNAL_POLL() を呼ぶと、出力してから元のシグナルで終了する。
+ * 出力したファイルは chrome://tracing や https://ui.perfetto.dev で表示できる。
+ * バッファが一杯になったスレッドはそれ以降の記録を捨てる（HAKO_PROFILE_MAX_EVENTS で件数を変更できる）。
+ */
+#ifdef HAKO_PROFILE_ENABLE
+
+#include <cstdint>
+
+namespace hako::profile {
+
+extern uint64_t profile_now_usec(void);
+extern void profile_record(const char* name, uint64_t begin_usec, uint64_t end_usec);
+extern void profile_set_thread_name(const char* name);
+extern void profile_dump(void);
+extern void profile_signal_init(void);
+extern void profile_signal_poll(void);
+
+class ProfileScope {
+private:
+    const char* name;
+    uint64_t begin_usec;
+public:
+    explicit ProfileScope(const char* name) : name(name), begin_usec(profile_now_usec()) {}
+    ~ProfileScope()
+    {
+        profile_record(name, begin_usec, profile_now_usec());
+    }
+};
+
+}
+
+#define HAKO_PROFILE_CONCAT_(a, b)      a##b
+#define HAKO_PROFILE_CONCAT(a, b)       HAKO_PROFILE_CONCAT_(a, b)
+#define HAKO_PROFILE_SCOPE(name)        hako::profile::ProfileScope HAKO_PROFILE_CONCAT(hako_profile_scope_, __LINE__)(name)
+#define HAKO_PROFILE_THREAD_NAME(name)  hako::profile::profile_set_thread_name(name)
+#define HAKO_PROFILE_DUMP()             hako::profile::profile_dump()
+#define HAKO_PROFILE_SIGNAL_INIT()      hako::profile::profile_signal_init()
+#define HAKO_PROFILE_SIGNAL_POLL()      hako::profile::profile_signal_poll()
+
+#else
+
+#define HAKO_PROFILE_SCOPE(name)        do { } while (0)
+#define HAKO_PROFILE_THREAD_NAME(name)  do { } while (0)
+#define HAKO_PROFILE_DUMP()             do { } while (0)
+#define HAKO_PROFILE_SIGNAL_INIT()      do { } while (0)
+#define HAKO_PROFILE_SIGNAL_POLL()      do { } while (0)
+
+#endif /* HAKO_PROFILE_ENABLE */
+
+#endif /* _HAKO_PROFILE_HPP_ */
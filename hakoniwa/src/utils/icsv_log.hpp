@@ -3,12 +3,25 @@
 
 #include <string>
 #include <vector>
+#include "log_record.hpp"
 
 class ICsvLog {
 public:
     virtual ~ICsvLog() {}
     virtual const std::vector<std::string> log_head() = 0;
-    virtual const std::vector<std::string> log_data() = 0;
+    /*
+     * 1行分の値を record に書き込む。CsvLogger からステップごとに呼び出される。
+     */
+    virtual void log_fields(LogRecord& record) = 0;
+    /*
+     * log_fields() の結果を1項目ずつの文字列で返す（ヒープ確保が発生するので、テストやデバッグ用）
+     */
+    const std::vector<std::string> log_data()
+    {
+        LogRecord record;
+        log_fields(record);
+        return record.to_strings();
+    }
 };
 
-#endif /* _ICSV_LOG_HPP_ */
\ No newline at end of file
+#endif /* _ICSV_LOG_HPP_ */
@@ -0,0 +1,161 @@
+#ifndef _LATENCY_HISTOGRAM_HPP_
+#define _LATENCY_HISTOGRAM_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+/*
+ * 対数線形バケットのヒストグラム（HDR Histogram と同じ考え方）。
+ * 2のべき乗ごとに LATENCY_HISTOGRAM_SUB_BUCKET_HALF 個のバケットに分けるので、
+ * 相対誤差は約 3% に収まる。
+ * record() はロックを使わないので、計測スレッドから呼び出しつつ、別スレッドから参照できる。
+ */
+#define LATENCY_HISTOGRAM_SUB_BUCKET_BITS   5
+#define LATENCY_HISTOGRAM_SUB_BUCKET_COUNT  (1 << LATENCY_HISTOGRAM_SUB_BUCKET_BITS)
+#define LATENCY_HISTOGRAM_SUB_BUCKET_HALF   (LATENCY_HISTOGRAM_SUB_BUCKET_COUNT / 2)
+#define LATENCY_HISTOGRAM_MAX_BITS          40
+#define LATENCY_HISTOGRAM_BUCKET_NUM        \
+    (LATENCY_HISTOGRAM_SUB_BUCKET_COUNT + (LATENCY_HISTOGRAM_MAX_BITS - LATENCY_HISTOGRAM_SUB_BUCKET_BITS) * LATENCY_HISTOGRAM_SUB_BUCKET_HALF)
+
+class LatencyHistogram {
+private:
+    std::atomic<uint64_t> counts[LATENCY_HISTOGRAM_BUCKET_NUM];
+    std::atomic<uint64_t> total_count;
+    std::atomic<uint64_t> total_sum;
+    std::atomic<uint64_t> max_value;
+
+    static int msb(uint64_t value)
+    {
+        int bit = 0;
+        while (value >>= 1) {
+            bit++;
+        }
+        return bit;
+    }
+    static int bucket_index(uint64_t value)
+    {
+        if (value < LATENCY_HISTOGRAM_SUB_BUCKET_COUNT) {
+            return (int)value;
+        }
+        int shift = msb(value) - (LATENCY_HISTOGRAM_SUB_BUCKET_BITS - 1);
+        int index = LATENCY_HISTOGRAM_SUB_BUCKET_COUNT
+                  + (shift - 1) * LATENCY_HISTOGRAM_SUB_BUCKET_HALF
+                  + (int)((value >> shift) - LATENCY_HISTOGRAM_SUB_BUCKET_HALF);
+        if (index >= LATENCY_HISTOGRAM_BUCKET_NUM) {
+            return LATENCY_HISTOGRAM_BUCKET_NUM - 1;
+        }
+        return index;
+    }
+    // バケットに入る値の上限（この値未満がバケットに入る）
+    static uint64_t bucket_upper_value(int index)
+    {
+        if (index < LATENCY_HISTOGRAM_SUB_BUCKET_COUNT) {
+            return (uint64_t)index + 1;
+        }
+        int shift = (index - LATENCY_HISTOGRAM_SUB_BUCKET_COUNT) / LATENCY_HISTOGRAM_SUB_BUCKET_HALF + 1;
+        uint64_t sub = (uint64_t)((index - LATENCY_HISTOGRAM_SUB_BUCKET_COUNT) % LATENCY_HISTOGRAM_SUB_BUCKET_HALF)
+                     + LATENCY_HISTOGRAM_SUB_BUCKET_HALF;
+        return (sub + 1) << shift;
+    }
+public:
+    LatencyHistogram()
+    {
+        reset();
+    }
+    void reset()
+    {
+        for (auto& count : counts) {
+            count.store(0, std::memory_order_relaxed);
+        }
+        total_count.store(0, std::memory_order_relaxed);
+        total_sum.store(0, std::memory_order_relaxed);
+        max_value.store(0, std::memory_order_relaxed);
+    }
+    void record(uint64_t value)
+    {
+        counts[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+        total_count.fetch_add(1, std::memory_order_relaxed);
+        total_sum.fetch_add(value, std::memory_order_relaxed);
+        uint64_t prev = max_value.load(std::memory_order_relaxed);
+        while ((prev < value) && !max_value.compare_exchange_weak(prev, value, std::memory_order_relaxed)) {
+        }
+    }
+    uint64_t count() const
+    {
+        return total_count.load(std::memory_order_relaxed);
+    }
+    uint64_t max() const
+    {
+        return max_value.load(std::memory_order_relaxed);
+    }
+    double mean() const
+    {
+        uint64_t n = count();
+        return (n == 0) ? 0.0 : (double)total_sum.load(std::memory_order_relaxed) / (double)n;
+    }
+    /*
+     * percentile: 0.0 - 100.0
+     * 該当するバケットの上限値を返す（最大値を超えない）
+     */
+    uint64_t percentile(double percentile) const
+    {
+        uint64_t n = count();
+        if (n == 0) {
+            return 0;
+        }
+        uint64_t target = (uint64_t)((percentile / 100.0) * (double)n + 0.5);
+        if (target < 1) {
+            target = 1;
+        }
+        uint64_t sum = 0;
+        for (int i = 0; i < LATENCY_HISTOGRAM_BUCKET_NUM; i++) {
+            sum += counts[i].load(std::memory_order_relaxed);
+            if (sum >= target) {
+                uint64_t value = bucket_upper_value(i) - 1;
+                return (value < max()) ? value : max();
+            }
+        }
+        return max();
+    }
+    void print(std::ostream& os, const std::string& name, const std::string& unit = "usec") const
+    {
+        os << std::left << std::setw(24) << name << std::right
+           << " count=" << count()
+           << " mean=" << std::fixed << std::setprecision(1) << mean()
+           << " p50=" << percentile(50.0)
+           << " p90=" << percentile(90.0)
+           << " p99=" << percentile(99.0)
+           << " p999=" << percentile(99.9)
+           << " max=" << max()
+           << " [" << unit << "]" << std::endl;
+    }
+    // 2のべき乗ごとにまとめた分布を表示する
+    void print_distribution(std::ostream& os, const std::string& unit = "usec") const
+    {
+        uint64_t n = count();
+        if (n == 0) {
+            return;
+        }
+        uint64_t range_counts[LATENCY_HISTOGRAM_MAX_BITS + 1] = {};
+        for (int i = 0; i < LATENCY_HISTOGRAM_BUCKET_NUM; i++) {
+            uint64_t c = counts[i].load(std::memory_order_relaxed);
+            if (c > 0) {
+                range_counts[msb(bucket_upper_value(i) - 1)] += c;
+            }
+        }
+        for (int bit = 0; bit <= LATENCY_HISTOGRAM_MAX_BITS; bit++) {
+            if (range_counts[bit] == 0) {
+                continue;
+            }
+            double ratio = (double)range_counts[bit] / (double)n;
+            os << "  < " << std::setw(10) << ((uint64_t)1 << (bit + 1)) << " " << unit << ": "
+               << std::setw(10) << range_counts[bit] << " "
+               << std::string((size_t)(ratio * 50.0 + 0.5), '#') << std::endl;
+        }
+    }
+};
+
+#endif /* _LATENCY_HISTOGRAM_HPP_ */
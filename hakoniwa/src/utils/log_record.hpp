@@ -0,0 +1,129 @@
+#ifndef _LOG_RECORD_HPP_
+#define _LOG_RECORD_HPP_
+
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/*
+ * CSV の1行分のバッファ。
+ *
+ * ICsvLog::log_fields() は add() で値をカンマ区切りのテキストとして書き込む。
+ * 固定長のバッファに std::to_chars で直接書き込むので、ヒープ確保は発生しない。
+ * CsvLogger はエントリごとに1つの LogRecord を clear() して使い回す。
+ * 浮動小数点数は読み戻すと同じ値になる最短の表現で出力する。
+ */
+#define LOG_RECORD_BUFFER_SIZE  1024
+
+class LogRecord {
+private:
+    char buffer[LOG_RECORD_BUFFER_SIZE];
+    size_t length;
+    int fields;
+    bool overflow;
+
+    /*
+     * 区切りのカンマを書き込み、値を書き込む位置を返す
+     */
+    char* begin_field()
+    {
+        if ((fields > 0) && (length < LOG_RECORD_BUFFER_SIZE)) {
+            buffer[length++] = ',';
+        }
+        return buffer + length;
+    }
+    LogRecord& end_field(const std::to_chars_result& result)
+    {
+        if (result.ec != std::errc()) {
+            overflow = true;
+        }
+        else {
+            length = result.ptr - buffer;
+        }
+        fields++;
+        return *this;
+    }
+    template <typename T>
+    LogRecord& add_floating(T value)
+    {
+        char* first = begin_field();
+        char* last = buffer + LOG_RECORD_BUFFER_SIZE;
+#if defined(__cpp_lib_to_chars)
+        return end_field(std::to_chars(first, last, value));
+#else
+        // 浮動小数点数の to_chars を持たない標準ライブラリ向け
+        int len = snprintf(first, last - first, "%.*g", std::is_same<T, float>::value ? 9 : 17, (double)value);
+        std::to_chars_result result = { last, std::errc::value_too_large };
+        if ((len >= 0) && (len < (last - first))) {
+            result = { first + len, std::errc() };
+        }
+        return end_field(result);
+#endif
+    }
+
+public:
+    LogRecord() : length(0), fields(0), overflow(false) {}
+
+    void clear()
+    {
+        length = 0;
+        fields = 0;
+        overflow = false;
+    }
+    LogRecord& add(double value)
+    {
+        return add_floating(value);
+    }
+    LogRecord& add(float value)
+    {
+        return add_floating(value);
+    }
+    template <typename T, typename std::enable_if<std::is_integral<T>::value, int>::type = 0>
+    LogRecord& add(T value)
+    {
+        char* first = begin_field();
+        return end_field(std::to_chars(first, buffer + LOG_RECORD_BUFFER_SIZE, value));
+    }
+    const char* data() const
+    {
+        return buffer;
+    }
+    size_t size() const
+    {
+        return length;
+    }
+    int field_count() const
+    {
+        return fields;
+    }
+    /*
+     * バッファに収まらなかった値があれば true（その値は出力されない）
+     */
+    bool is_overflow() const
+    {
+        return overflow;
+    }
+    /*
+     * 1項目ずつの文字列に分割する（テストやデバッグ用。ヒープ確保が発生する）
+     */
+    std::vector<std::string> to_strings() const
+    {
+        std::vector<std::string> values;
+        size_t start = 0;
+        for (size_t i = 0; i <= length; i++) {
+            if ((i == length) || (buffer[i] == ',')) {
+                values.emplace_back(buffer + start, i - start);
+                start = i + 1;
+            }
+        }
+        if (fields == 0) {
+            values.clear();
+        }
+        return values;
+    }
+};
+
+#endif /* _LOG_RECORD_HPP_ */
@@ -0,0 +1,295 @@
+#ifndef _LOG_TABLE_HPP_
+#define _LOG_TABLE_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * CsvLogger が出力した CSV を列ごとの配列として読み込み、時刻で揃えるための処理。
+ *
+ * CSV の先頭列は時刻（timestamp, usec）とする。小数を含む場合は秒として扱う（旧形式の drone_dynamics.csv）。
+ * 大きなファイルは改行位置で分割し、複数のスレッドで並列に解析する。
+ */
+#define LOG_TABLE_CHUNK_MIN_SIZE    (1024 * 1024)
+
+typedef struct {
+    std::string name;
+    std::vector<std::string> columns;       // 先頭の時刻列を除く列名
+    std::vector<int64_t> time_usec;
+    std::vector<std::vector<double>> values; // values[列][行]
+    uint64_t bad_lines;                     // 列数が合わずに読み飛ばした行数
+} LogTableType;
+
+/*
+ * [0, num) を threads 個のスレッドで分担して func(index) を呼び出す
+ */
+template <typename Func>
+static inline void log_table_parallel_for(size_t num, unsigned threads, Func func)
+{
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = (unsigned)std::min<size_t>(threads, num);
+    if (threads <= 1) {
+        for (size_t i = 0; i < num; i++) {
+            func(i);
+        }
+        return;
+    }
+    std::atomic<size_t> next(0);
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; t++) {
+        workers.emplace_back([&]() {
+            for (size_t i = next++; i < num; i = next++) {
+                func(i);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+static inline bool log_table_parse_time(const char* first, const char* last, int64_t& time_usec)
+{
+    auto result = std::from_chars(first, last, time_usec);
+    if ((result.ec == std::errc()) && (result.ptr == last)) {
+        return true;
+    }
+    char* end = nullptr;
+    std::string text(first, last);
+    double sec = std::strtod(text.c_str(), &end);
+    if ((end == text.c_str()) || (*end != '\0')) {
+        return false;
+    }
+    time_usec = (int64_t)std::llround(sec * 1000000.0);
+    return true;
+}
+
+static inline double log_table_parse_value(const char* first, const char* last)
+{
+    double value;
+#if defined(__cpp_lib_to_chars)
+    auto result = std::from_chars(first, last, value);
+    if ((result.ec == std::errc()) && (result.ptr == last)) {
+        return value;
+    }
+#else
+    std::string text(first, last);
+    char* end = nullptr;
+    value = std::strtod(text.c_str(), &end);
+    if ((end != text.c_str()) && (*end == '\0')) {
+        return value;
+    }
+#endif
+    return std::numeric_limits<double>::quiet_NaN();
+}
+
+/*
+ * [first, last) の行を解析して table に追加する
+ */
+static inline void log_table_parse_lines(const char* first, const char* last, LogTableType& table)
+{
+    size_t column_num = table.columns.size();
+    while (first < last) {
+        const char* eol = std::find(first, last, '\n');
+        const char* line_end = ((eol > first) && (*(eol - 1) == '\r')) ? eol - 1 : eol;
+        if (line_end > first) {
+            size_t row = table.time_usec.size();
+            size_t index = 0;
+            bool ok = true;
+            const char* p = first;
+            while (ok) {
+                const char* comma = std::find(p, line_end, ',');
+                if (index == 0) {
+                    int64_t time_usec;
+                    ok = log_table_parse_time(p, comma, time_usec);
+                    if (ok) {
+                        table.time_usec.push_back(time_usec);
+                    }
+                }
+                else if (index <= column_num) {
+                    table.values[index - 1].push_back(log_table_parse_value(p, comma));
+                }
+                else {
+                    ok = false;
+                }
+                index++;
+                if (comma == line_end) {
+                    break;
+                }
+                p = comma + 1;
+            }
+            if (!ok || (index != (column_num + 1))) {
+                // 途中まで追加した値を取り消す
+                table.time_usec.resize(row);
+                for (auto& column : table.values) {
+                    column.resize(row);
+                }
+                table.bad_lines++;
+            }
+        }
+        first = (eol == last) ? last : eol + 1;
+    }
+}
+
+/*
+ * 時刻順に並んでいない行（PX4 の再起動などで時刻が戻った場合）があれば、時刻で安定ソートする
+ */
+static inline void log_table_sort(LogTableType& table)
+{
+    if (std::is_sorted(table.time_usec.begin(), table.time_usec.end())) {
+        return;
+    }
+    std::vector<size_t> order(table.time_usec.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return table.time_usec[a] < table.time_usec[b];
+    });
+    std::vector<int64_t> time_usec(order.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        time_usec[i] = table.time_usec[order[i]];
+    }
+    table.time_usec.swap(time_usec);
+    for (auto& column : table.values) {
+        std::vector<double> sorted(order.size());
+        for (size_t i = 0; i < order.size(); i++) {
+            sorted[i] = column[order[i]];
+        }
+        column.swap(sorted);
+    }
+}
+
+/*
+ * text: CSV ファイルの内容（先頭行はヘッダ）
+ * threads: 解析に使うスレッド数（0 の場合は CPU 数）
+ */
+static inline bool log_table_parse_csv(const std::string& text, LogTableType& table, unsigned threads = 0)
+{
+    table.columns.clear();
+    table.time_usec.clear();
+    table.values.clear();
+    table.bad_lines = 0;
+
+    size_t header_end = text.find('\n');
+    std::string header = text.substr(0, header_end);
+    if (!header.empty() && (header.back() == '\r')) {
+        header.pop_back();
+    }
+    if (header.empty()) {
+        return false;
+    }
+    size_t pos = header.find(',');
+    while (pos != std::string::npos) {
+        size_t next = header.find(',', pos + 1);
+        table.columns.push_back(header.substr(pos + 1, (next == std::string::npos) ? std::string::npos : next - pos - 1));
+        pos = next;
+    }
+    table.values.resize(table.columns.size());
+    if (header_end == std::string::npos) {
+        return true;
+    }
+
+    // データ部を改行位置で分割する
+    const char* begin = text.data() + header_end + 1;
+    const char* end = text.data() + text.size();
+    size_t chunk_num = 1;
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if ((size_t)(end - begin) >= (2 * LOG_TABLE_CHUNK_MIN_SIZE)) {
+        chunk_num = std::min<size_t>(threads, (end - begin) / LOG_TABLE_CHUNK_MIN_SIZE);
+    }
+    std::vector<const char*> bounds = { begin };
+    for (size_t i = 1; i < chunk_num; i++) {
+        const char* p = begin + (end - begin) * i / chunk_num;
+        p = std::find(std::max(p, bounds.back()), end, '\n');
+        bounds.push_back((p == end) ? end : p + 1);
+    }
+    bounds.push_back(end);
+
+    std::vector<LogTableType> chunks(chunk_num);
+    log_table_parallel_for(chunk_num, threads, [&](size_t i) {
+        chunks[i].columns = table.columns;
+        chunks[i].values.resize(table.columns.size());
+        chunks[i].bad_lines = 0;
+        log_table_parse_lines(bounds[i], bounds[i + 1], chunks[i]);
+    });
+    for (auto& chunk : chunks) {
+        table.time_usec.insert(table.time_usec.end(), chunk.time_usec.begin(), chunk.time_usec.end());
+        for (size_t c = 0; c < table.values.size(); c++) {
+            table.values[c].insert(table.values[c].end(), chunk.values[c].begin(), chunk.values[c].end());
+        }
+        table.bad_lines += chunk.bad_lines;
+    }
+    log_table_sort(table);
+    return true;
+}
+
+static inline bool log_table_load(const std::string& filepath, LogTableType& table, unsigned threads = 0)
+{
+    std::ifstream ifs(filepath, std::ios::in | std::ios::binary);
+    if (!ifs.is_open()) {
+        std::cerr << "ERROR: can not open log file: " << filepath << std::endl;
+        return false;
+    }
+    ifs.seekg(0, std::ios::end);
+    std::string text((size_t)ifs.tellg(), '\0');
+    ifs.seekg(0, std::ios::beg);
+    ifs.read(&text[0], text.size());
+    if (!ifs.good() && !ifs.eof()) {
+        std::cerr << "ERROR: can not read log file: " << filepath << std::endl;
+        return false;
+    }
+    return log_table_parse_csv(text, table, threads);
+}
+
+/*
+ * 全テーブルの時刻の和集合（昇順・重複なし）
+ */
+static inline std::vector<int64_t> log_table_timeline(const std::vector<LogTableType>& tables)
+{
+    std::vector<int64_t> timeline;
+    for (auto& table : tables) {
+        std::vector<int64_t> merged;
+        merged.reserve(timeline.size() + table.time_usec.size());
+        std::set_union(timeline.begin(), timeline.end(), table.time_usec.begin(), table.time_usec.end(), std::back_inserter(merged));
+        timeline.swap(merged);
+    }
+    timeline.erase(std::unique(timeline.begin(), timeline.end()), timeline.end());
+    return timeline;
+}
+
+/*
+ * table の column 列を timeline の各時刻に揃える。
+ * 各時刻の値は、その時刻以前で最後の行の値とする（ゼロ次ホールド）。最初の行より前は NaN とする。
+ */
+static inline std::vector<double> log_table_align(const LogTableType& table, size_t column, const std::vector<int64_t>& timeline)
+{
+    std::vector<double> aligned(timeline.size(), std::numeric_limits<double>::quiet_NaN());
+    const std::vector<double>& values = table.values[column];
+    size_t row = 0;
+    size_t row_num = table.time_usec.size();
+    for (size_t i = 0; i < timeline.size(); i++) {
+        while ((row < row_num) && (table.time_usec[row] <= timeline[i])) {
+            row++;
+        }
+        if (row > 0) {
+            aligned[i] = values[row - 1];
+        }
+    }
+    return aligned;
+}
+
+#endif /* _LOG_TABLE_HPP_ */
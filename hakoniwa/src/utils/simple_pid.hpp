@@ -2,9 +2,10 @@
 #define _SIMPLE_PID_HPP_
 
 #include <iostream>
+#include "state_snapshot.hpp"
 #define SIMPLE_PID_INUM 10
 
-class PID {
+class PID : public IStateSnapshot {
 private:
     double Kp; // 比例ゲイン
     double Ki; // 積分ゲイン
@@ -54,6 +55,21 @@ public:
     void reset_integral() {
         integral = 0.0;
     }
+
+    // 目標値・積分値・前回の誤差の保存と復元
+    void save_state(StateSnapshot& snapshot) const override {
+        snapshot.put(setpoint);
+        snapshot.put(integral);
+        snapshot.put(prev_error);
+        snapshot.put(first_time);
+        snapshot.put(i_inx);
+        snapshot.put(i_num);
+        snapshot.put(i_values);
+    }
+    bool restore_state(StateSnapshot& snapshot) override {
+        return snapshot.get(setpoint) && snapshot.get(integral) && snapshot.get(prev_error)
+            && snapshot.get(first_time) && snapshot.get(i_inx) && snapshot.get(i_num) && snapshot.get(i_values);
+    }
 };
 
 
@@ -0,0 +1,84 @@
+#ifndef _SPSC_QUEUE_HPP_
+#define _SPSC_QUEUE_HPP_
+
+#include <atomic>
+#include <cstddef>
+
+/*
+ * 書き手1つ・読み手1つのロックフリーなリングキュー。
+ * 書き手と読み手が別スレッドであればロックなしで push/pop できる。
+ * N は2のべき乗であること。
+ */
+template <typename T, size_t N>
+class SpscQueue {
+    static_assert((N > 0) && ((N & (N - 1)) == 0), "SpscQueue size must be a power of 2");
+private:
+    alignas(64) std::atomic<size_t> head;   // 読み手が進める
+    alignas(64) std::atomic<size_t> tail;   // 書き手が進める
+    alignas(64) T items[N];
+public:
+    SpscQueue() : head(0), tail(0) {}
+
+    bool push(const T& item)
+    {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if ((t - head.load(std::memory_order_acquire)) >= N) {
+            return false;
+        }
+        items[t & (N - 1)] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+    bool pop(T& item)
+    {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = items[h & (N - 1)];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+    // 先頭の要素を取り出さずに参照する（読み手のみ）
+    T* front()
+    {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return &items[h & (N - 1)];
+    }
+    void pop_front()
+    {
+        discard(1);
+    }
+    // 先頭から index 番目の要素を取り出さずに参照する（読み手のみ）
+    T* peek(size_t index)
+    {
+        size_t h = head.load(std::memory_order_relaxed);
+        if ((tail.load(std::memory_order_acquire) - h) <= index) {
+            return nullptr;
+        }
+        return &items[(h + index) & (N - 1)];
+    }
+    // 先頭から num 個の要素を解放する（読み手のみ。peek() で参照済みであること）
+    void discard(size_t num)
+    {
+        head.store(head.load(std::memory_order_relaxed) + num, std::memory_order_release);
+    }
+    size_t size() const
+    {
+        size_t h = head.load(std::memory_order_acquire);
+        return tail.load(std::memory_order_acquire) - h;
+    }
+    bool empty() const
+    {
+        return size() == 0;
+    }
+    static constexpr size_t capacity()
+    {
+        return N;
+    }
+};
+
+#endif /* _SPSC_QUEUE_HPP_ */
@@ -0,0 +1,154 @@
+#ifndef _STATE_SNAPSHOT_HPP_
+#define _STATE_SNAPSHOT_HPP_
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/*
+ * シミュレーション状態のスナップショット。
+ *
+ * 各コンポーネントは IStateSnapshot::save_state() で内部状態を put() で順に書き込み、
+ * restore_state() で同じ順に get() で読み戻す。値はメモリ上の表現のままコピーするので、
+ * ファイルに保存したスナップショットは、同じビルド・同じ機体設定の hako-px4sim でのみ復元できる。
+ */
+#define STATE_SNAPSHOT_MAGIC        "HAKOSNP1"
+#define STATE_SNAPSHOT_MAGIC_LEN    8
+
+class StateSnapshot {
+private:
+    std::vector<char> buffer;
+    size_t read_pos;
+    bool error;
+
+    bool read(void* dest, size_t len)
+    {
+        if (error || ((read_pos + len) > buffer.size())) {
+            error = true;
+            return false;
+        }
+        memcpy(dest, buffer.data() + read_pos, len);
+        read_pos += len;
+        return true;
+    }
+
+public:
+    StateSnapshot() : read_pos(0), error(false) {}
+
+    void clear()
+    {
+        buffer.clear();
+        read_pos = 0;
+        error = false;
+    }
+    /*
+     * 先頭から読み直す
+     */
+    void rewind()
+    {
+        read_pos = 0;
+        error = false;
+    }
+    template <typename T>
+    void put(const T& value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "StateSnapshot::put() requires a trivially copyable type");
+        const char* p = reinterpret_cast<const char*>(&value);
+        buffer.insert(buffer.end(), p, p + sizeof(T));
+    }
+    template <typename T>
+    bool get(T& value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "StateSnapshot::get() requires a trivially copyable type");
+        return read(&value, sizeof(T));
+    }
+    template <typename T>
+    void put(const std::vector<T>& values)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "StateSnapshot::put() requires a trivially copyable type");
+        put((uint64_t)values.size());
+        const char* p = reinterpret_cast<const char*>(values.data());
+        buffer.insert(buffer.end(), p, p + (values.size() * sizeof(T)));
+    }
+    template <typename T>
+    bool get(std::vector<T>& values)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "StateSnapshot::get() requires a trivially copyable type");
+        uint64_t num = 0;
+        if (!get(num) || ((read_pos + (num * sizeof(T))) > buffer.size())) {
+            error = true;
+            return false;
+        }
+        values.resize(num);
+        return read(values.data(), num * sizeof(T));
+    }
+    /*
+     * 書き込んだ内容を全て読み終えていれば true
+     */
+    bool is_consumed() const
+    {
+        return !error && (read_pos == buffer.size());
+    }
+    bool is_error() const
+    {
+        return error;
+    }
+    size_t size() const
+    {
+        return buffer.size();
+    }
+    bool save_file(const std::string& filepath) const
+    {
+        std::ofstream ofs(filepath, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!ofs.is_open()) {
+            std::cerr << "ERROR: can not open snapshot file: " << filepath << std::endl;
+            return false;
+        }
+        uint64_t len = buffer.size();
+        ofs.write(STATE_SNAPSHOT_MAGIC, STATE_SNAPSHOT_MAGIC_LEN);
+        ofs.write(reinterpret_cast<const char*>(&len), sizeof(len));
+        ofs.write(buffer.data(), buffer.size());
+        return ofs.good();
+    }
+    bool load_file(const std::string& filepath)
+    {
+        std::ifstream ifs(filepath, std::ios::in | std::ios::binary);
+        if (!ifs.is_open()) {
+            std::cerr << "ERROR: can not open snapshot file: " << filepath << std::endl;
+            return false;
+        }
+        char magic[STATE_SNAPSHOT_MAGIC_LEN];
+        uint64_t len = 0;
+        ifs.read(magic, STATE_SNAPSHOT_MAGIC_LEN);
+        ifs.read(reinterpret_cast<char*>(&len), sizeof(len));
+        if (!ifs.good() || (memcmp(magic, STATE_SNAPSHOT_MAGIC, STATE_SNAPSHOT_MAGIC_LEN) != 0)) {
+            std::cerr << "ERROR: not a snapshot file: " << filepath << std::endl;
+            return false;
+        }
+        clear();
+        buffer.resize(len);
+        ifs.read(buffer.data(), len);
+        if ((uint64_t)ifs.gcount() != len) {
+            std::cerr << "ERROR: snapshot file is truncated: " << filepath << std::endl;
+            clear();
+            return false;
+        }
+        return true;
+    }
+};
+
+class IStateSnapshot {
+public:
+    virtual ~IStateSnapshot() {}
+    virtual void save_state(StateSnapshot& snapshot) const = 0;
+    /*
+     * save_state() と同じ順に読み戻す。読み込みに失敗した場合は false
+     */
+    virtual bool restore_state(StateSnapshot& snapshot) = 0;
+};
+
+#endif /* _STATE_SNAPSHOT_HPP_ */
@@ -0,0 +1,198 @@
+#ifndef _STEP_STATS_HPP_
+#define _STEP_STATS_HPP_
+
+#include "utils/latency_histogram.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+/*
+ * シミュレーションの1ステップの内訳の計測。
+ *
+ * 各区間の処理時間を LatencyHistogram に記録し、dump() で p50/p99/p999 と
+ * 実時間比(シミュレーション時間/実時間)を出力する。
+ * dump() は request_dump() で予約しておき、計測しているスレッドが poll_dump() で行う。
+ * request_dump() はロックを使わないので、シグナルハンドラから呼び出せる。
+ */
+typedef enum {
+    STEP_PHASE_WAIT_ACTUATOR = 0,   // HIL_ACTUATOR_CONTROLS の受信待ち
+    STEP_PHASE_RUNNER_STEP,         // hako_asset_runner_step()
+    STEP_PHASE_AIRCRAFT_RUN,        // IAirCraft::run()（RUNNER_STEP の内数）
+    STEP_PHASE_SENSOR_BUILD,        // センサ値の PDU への書き込み
+    STEP_PHASE_ENCODE,              // MAVLink メッセージの作成とエンコード（ログ出力を含む）
+    STEP_PHASE_SEND,                // ソケットへの送信（リアクタ使用時はキューへの投入）
+    STEP_PHASE_TOTAL,               // 1ステップ全体
+    STEP_PHASE_NUM,
+} StepPhaseType;
+
+class StepStats {
+private:
+    LatencyHistogram histograms[STEP_PHASE_NUM];
+    std::atomic<bool> enabled;
+    std::atomic<bool> dump_requested;
+    uint64_t step_usec;
+    uint64_t dump_period_usec;
+    std::string filepath;
+    uint64_t deadline_miss_count;
+    uint64_t start_usec;
+    uint64_t start_sim_usec;
+    uint64_t last_dump_usec;
+    uint64_t last_dump_sim_usec;
+    uint64_t sim_usec;
+
+    static const char* phase_name(int phase)
+    {
+        static const char* names[STEP_PHASE_NUM] = {
+            "wait_actuator",
+            "runner_step",
+            "aircraft_run",
+            "sensor_build",
+            "encode",
+            "send",
+            "total",
+        };
+        return names[phase];
+    }
+    static double real_time_factor(uint64_t sim_usec, uint64_t wall_usec)
+    {
+        return (wall_usec == 0) ? 0.0 : (double)sim_usec / (double)wall_usec;
+    }
+    StepStats() : enabled(false), dump_requested(false), step_usec(0), dump_period_usec(0),
+        deadline_miss_count(0), start_usec(0), start_sim_usec(0), last_dump_usec(0), last_dump_sim_usec(0), sim_usec(0) {}
+
+public:
+    static StepStats& instance()
+    {
+        static StepStats stats;
+        return stats;
+    }
+    static uint64_t now_usec()
+    {
+        auto now = std::chrono::steady_clock::now().time_since_epoch();
+        return std::chrono::duration_cast<std::chrono::microseconds>(now).count();
+    }
+    /*
+     * step_usec: 1ステップの時間。TOTAL がこれを超えたステップを deadline miss として数える。
+     * dump_period_sec: 0 以外なら、この周期で dump() する。
+     * filepath: 空なら標準出力に、それ以外はファイルに追記する。
+     */
+    void init(uint64_t step_usec, double dump_period_sec, const std::string& filepath)
+    {
+        this->step_usec = step_usec;
+        this->dump_period_usec = (uint64_t)(dump_period_sec * 1000000.0);
+        this->filepath = filepath;
+        enabled.store(true, std::memory_order_relaxed);
+    }
+    bool is_enabled() const
+    {
+        return enabled.load(std::memory_order_relaxed);
+    }
+    /*
+     * シミュレーションの開始（または再開）時に呼び出す
+     */
+    void reset(uint64_t sim_usec)
+    {
+        for (auto& histogram : histograms) {
+            histogram.reset();
+        }
+        deadline_miss_count = 0;
+        start_usec = now_usec();
+        last_dump_usec = start_usec;
+        this->sim_usec = sim_usec;
+        start_sim_usec = sim_usec;
+        last_dump_sim_usec = sim_usec;
+    }
+    void record(StepPhaseType phase, uint64_t usec)
+    {
+        if (is_enabled()) {
+            histograms[phase].record(usec);
+        }
+    }
+    /*
+     * 1ステップの終わりに呼び出す
+     */
+    void end_step(uint64_t total_usec, uint64_t sim_usec)
+    {
+        if (!is_enabled()) {
+            return;
+        }
+        histograms[STEP_PHASE_TOTAL].record(total_usec);
+        if ((step_usec > 0) && (total_usec > step_usec)) {
+            deadline_miss_count++;
+        }
+        this->sim_usec = sim_usec;
+    }
+    void request_dump()
+    {
+        dump_requested.store(true, std::memory_order_relaxed);
+    }
+    void poll_dump()
+    {
+        if (!is_enabled()) {
+            return;
+        }
+        bool requested = dump_requested.exchange(false, std::memory_order_relaxed);
+        if (!requested && ((dump_period_usec == 0) || ((now_usec() - last_dump_usec) < dump_period_usec))) {
+            return;
+        }
+        dump();
+    }
+    void dump()
+    {
+        if (filepath.empty()) {
+            print(std::cout);
+            return;
+        }
+        std::ofstream ofs(filepath, std::ios::app);
+        if (!ofs) {
+            std::cerr << "ERROR: can not open step stats file: " << filepath << std::endl;
+            return;
+        }
+        print(ofs);
+    }
+    void print(std::ostream& os)
+    {
+        uint64_t now = now_usec();
+        uint64_t steps = histograms[STEP_PHASE_TOTAL].count();
+        os << "INFO: step stats: steps=" << steps
+           << " deadline_miss=" << deadline_miss_count
+           << " sim_time=" << std::fixed << std::setprecision(3) << (double)(sim_usec - start_sim_usec) / 1000000.0
+           << " wall_time=" << (double)(now - start_usec) / 1000000.0
+           << " rtf=" << real_time_factor(sim_usec - start_sim_usec, now - start_usec)
+           << " rtf(interval)=" << real_time_factor(sim_usec - last_dump_sim_usec, now - last_dump_usec)
+           << std::endl;
+        for (int phase = 0; phase < STEP_PHASE_NUM; phase++) {
+            histograms[phase].print(os, std::string("  ") + phase_name(phase));
+        }
+        last_dump_usec = now;
+        last_dump_sim_usec = sim_usec;
+    }
+};
+
+/*
+ * スコープの処理時間を記録する
+ */
+class StepStatsScope {
+private:
+    StepPhaseType phase;
+    uint64_t start_usec;
+public:
+    explicit StepStatsScope(StepPhaseType phase) : phase(phase), start_usec(0)
+    {
+        if (StepStats::instance().is_enabled()) {
+            start_usec = StepStats::now_usec();
+        }
+    }
+    ~StepStatsScope()
+    {
+        if (start_usec != 0) {
+            StepStats::instance().record(phase, StepStats::now_usec() - start_usec);
+        }
+    }
+};
+
+#endif /* _STEP_STATS_HPP_ */
@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+#include <iostream>
+#include <cmath>
+#include "battery/battery_model.hpp"
+#include "rotor/rotor_bank.hpp"
+
+class BatteryModelTest : public ::testing::Test {
+protected:
+    static void SetUpTestCase()
+    {
+    }
+    static void TearDownTestCase()
+    {
+    }
+    virtual void SetUp()
+    {
+    }
+    virtual void TearDown()
+    {
+    }
+
+};
+using hako::assets::drone::BatteryModel;
+using hako::assets::drone::BatteryParamType;
+using hako::assets::drone::DroneBatteryStatusType;
+using hako::assets::drone::RotorBank;
+using hako::assets::drone::RotorMotorParamType;
+using hako::assets::drone::ROTOR_BANK_MODEL_FIRST_ORDER;
+
+TEST_F(BatteryModelTest, BatteryModel_001)
+{
+    // 放電曲線の点ではその電圧（セル数倍）、点の間は線形補間
+    BatteryModel battery(0.01);
+    EXPECT_TRUE(battery.set_discharge_curve({ 0.0, 0.5, 1.0 }, { 3.0, 3.7, 4.2 }));
+    BatteryParamType param = battery.get_params();
+    param.cells = 3;
+    EXPECT_TRUE(battery.set_params(param));
+    EXPECT_NEAR(9.0, battery.get_open_circuit_voltage(0.0), 1e-9);
+    EXPECT_NEAR(11.1, battery.get_open_circuit_voltage(0.5), 1e-9);
+    EXPECT_NEAR(12.6, battery.get_open_circuit_voltage(1.0), 1e-9);
+    EXPECT_NEAR(12.6, battery.get_reference_voltage(), 1e-9);
+    EXPECT_NEAR((11.1 + 12.6) / 2, battery.get_open_circuit_voltage(0.75), 1e-9);
+    EXPECT_NEAR(9.0, battery.get_open_circuit_voltage(-1.0), 1e-9);
+    EXPECT_NEAR(12.6, battery.get_status().voltage, 1e-9);
+
+    // 端子電圧は V = OCV - I R で、V I が負荷の電力になる
+    battery.run(100.0);
+    const DroneBatteryStatusType& status = battery.get_status();
+    double ocv = battery.get_open_circuit_voltage(1.0);
+    EXPECT_NEAR(100.0, status.voltage * status.current, 1e-9);
+    EXPECT_NEAR(ocv - status.current * param.internal_resistance, status.voltage, 1e-9);
+    EXPECT_LT(status.voltage, ocv);
+
+    // 取り出せる最大電力を超える場合は OCV / 2
+    BatteryModel overload(0.01);
+    overload.run(1e6);
+    EXPECT_NEAR(overload.get_reference_voltage() / 2, overload.get_status().voltage, 1e-9);
+
+    EXPECT_FALSE(battery.set_discharge_curve({ 0.0, 1.0 }, { 3.0 }));
+    EXPECT_FALSE(battery.set_discharge_curve({ 0.1, 1.0 }, { 3.0, 4.2 }));
+    EXPECT_FALSE(battery.set_discharge_curve({ 0.0, 0.6, 0.5, 1.0 }, { 3.0, 3.5, 3.6, 4.2 }));
+    param.initial_remaining = 1.5;
+    EXPECT_FALSE(battery.set_params(param));
+}
+
+TEST_F(BatteryModelTest, BatteryModel_002)
+{
+    // 一定電流に近い負荷で、容量どおりの時間で空になる
+    const double dt = 0.01;
+    BatteryModel battery(dt);
+    BatteryParamType param = battery.get_params();
+    param.capacity_mah = 1000;
+    param.internal_resistance = 0.0;
+    param.heat_transfer = 0.0;
+    EXPECT_TRUE(battery.set_params(param));
+    EXPECT_TRUE(battery.set_discharge_curve({ 0.0, 1.0 }, { 4.0, 4.0 }));
+    // 16V, 10A で 1000mAh は 360 秒
+    int steps = 0;
+    while ((battery.get_status().remaining > 0) && (steps < 100000)) {
+        battery.run(160.0);
+        steps++;
+    }
+    EXPECT_NEAR(360.0, steps * dt, 0.02);
+    EXPECT_NEAR(1000.0, battery.get_status().consumed_mah, 0.5);
+    EXPECT_NEAR(160.0 * 360.0, battery.get_status().consumed_energy, 160.0 * 0.02);
+}
+
+TEST_F(BatteryModelTest, BatteryModel_003)
+{
+    // 発熱 I^2 R と放熱 h (T - Ta) が釣り合う温度に近づき、温度が上がると内部抵抗が下がる
+    const double dt = 0.1;
+    BatteryModel battery(dt);
+    BatteryParamType param = battery.get_params();
+    param.capacity_mah = 1e9;
+    param.heat_capacity = 10.0;
+    param.heat_transfer = 2.0;
+    EXPECT_TRUE(battery.set_params(param));
+    for (int i = 0; i < 1000; i++) {
+        battery.run(300.0);
+    }
+    const DroneBatteryStatusType& status = battery.get_status();
+    double ocv = battery.get_open_circuit_voltage(status.remaining);
+    double r = (ocv - status.voltage) / status.current;
+    EXPECT_LT(r, param.internal_resistance);
+    EXPECT_NEAR(param.ambient_temperature + status.current * status.current * r / param.heat_transfer, status.temperature, 0.1);
+    EXPECT_GT(status.time_remaining, 0);
+
+    // スナップショットで元に戻る
+    StateSnapshot snapshot;
+    battery.save_state(snapshot);
+    battery.run(300.0);
+    double voltage = battery.get_status().voltage;
+    battery.run(300.0);
+    snapshot.rewind();
+    EXPECT_TRUE(battery.restore_state(snapshot));
+    battery.run(300.0);
+    EXPECT_EQ(voltage, battery.get_status().voltage);
+}
+
+TEST_F(BatteryModelTest, BatteryModel_004)
+{
+    // 電源電圧が半分になると回転数も半分になり、モータの電力は回転数から計算される
+    const double dt = 0.001;
+    RotorBank full(dt, 4, ROTOR_BANK_MODEL_FIRST_ORDER);
+    RotorBank half(dt, 4, ROTOR_BANK_MODEL_FIRST_ORDER);
+    RotorMotorParamType motor = { 1000.0, 0.1, 0.5, 1e-8, 0.9 };
+    for (RotorBank *bank : { &full, &half }) {
+        bank->set_params(10000, 0.05, 6000);
+        EXPECT_TRUE(bank->set_motor_params(motor));
+    }
+    EXPECT_EQ(0.0, full.get_load_power());
+    half.set_supply_voltage_ratio(0.5);
+    double controls[4] = { 0.5, 0.5, 0.5, 0.5 };
+    for (int i = 0; i < 2000; i++) {
+        full.run(controls);
+        half.run(controls);
+    }
+    EXPECT_NEAR(3000.0, full.get_rotor_speeds()[0].data, 1e-3);
+    EXPECT_NEAR(1500.0, half.get_rotor_speeds()[0].data, 1e-3);
+
+    double rpm = full.get_rotor_speeds()[0].data;
+    double kt = 60.0 / (2.0 * M_PI * motor.kv);
+    double current = motor.torque_coefficient * rpm * rpm / kt + motor.no_load_current;
+    EXPECT_NEAR(current, full.get_motor_currents()[0], 1e-9);
+    EXPECT_NEAR(4 * (rpm / motor.kv + current * motor.resistance) * current / motor.esc_efficiency, full.get_load_power(), 1e-9);
+    EXPECT_LT(half.get_load_power(), full.get_load_power());
+
+    motor.esc_efficiency = 0.0;
+    EXPECT_FALSE(full.set_motor_params(motor));
+}
@@ -0,0 +1,254 @@
+#include <gtest/gtest.h>
+#include <iostream>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <vector>
+#include "collision/collision_world.hpp"
+#include "body_frame/drone_dynamics_body_frame.hpp"
+#include "body_frame_rk4/drone_dynamics_body_frame_rk4.hpp"
+#include "ground_frame/drone_dynamics_ground_frame.hpp"
+
+class CollisionWorldTest : public ::testing::Test {
+protected:
+    static void SetUpTestCase()
+    {
+    }
+    static void TearDownTestCase()
+    {
+    }
+    virtual void SetUp()
+    {
+    }
+    virtual void TearDown()
+    {
+    }
+
+};
+using hako::assets::drone::CollisionWorld;
+using hako::assets::drone::DroneDynamicsCollisionType;
+using hako::assets::drone::DronePositionType;
+using hako::assets::drone::DroneEulerType;
+using hako::assets::drone::DroneVelocityType;
+using hako::assets::drone::IDroneDynamics;
+using hako::assets::drone::DroneDynamicsBodyFrame;
+using hako::assets::drone::DroneDynamicsBodyFrameRK4;
+using hako::assets::drone::DroneDynamicsGroundFrame;
+using hako::assets::drone::DroneDynamicsInputType;
+
+static bool detect(const CollisionWorld& world, double x, double y, double z, double vx, double vy, double vz,
+                   DroneDynamicsCollisionType& collision, double yaw = 0)
+{
+    DronePositionType pos;
+    pos.data = { x, y, z };
+    DroneEulerType angle;
+    angle.data = { 0, 0, yaw };
+    DroneVelocityType vel;
+    vel.data = { vx, vy, vz };
+    return world.detect(pos, angle, vel, collision);
+}
+
+TEST_F(CollisionWorldTest, test_01)
+{
+    // 地面（NED なので上向きの法線は -z）
+    CollisionWorld world;
+    world.set_body_size(0.2, 0.2, 0.1);
+    world.set_restitution_coefficient(0.3);
+    EXPECT_TRUE(world.add_plane({ 0, 0, 0 }, { 0, 0, -2 }));
+    EXPECT_FALSE(world.add_plane({ 0, 0, 0 }, { 0, 0, 0 }));
+    world.build();
+
+    DroneDynamicsCollisionType collision;
+    EXPECT_FALSE(detect(world, 0, 0, -0.06, 0, 0, 1, collision));
+    EXPECT_FALSE(collision.collision);
+
+    EXPECT_TRUE(detect(world, 1, 2, -0.04, 0, 0, 1, collision));
+    EXPECT_EQ(1, collision.contact_num);
+    EXPECT_DOUBLE_EQ(1.0, collision.contact_position[0].x);
+    EXPECT_DOUBLE_EQ(2.0, collision.contact_position[0].y);
+    EXPECT_NEAR(0.0, collision.contact_position[0].z, 1e-12);
+    EXPECT_EQ(0.3, collision.restitution_coefficient);
+
+    // 離れていく場合は接触にしない
+    EXPECT_FALSE(detect(world, 1, 2, -0.04, 0, 0, -1, collision));
+
+    // 傾くと頂点が地面に入る
+    CollisionWorld tilted;
+    tilted.set_body_size(1.0, 1.0, 0.1);
+    tilted.add_plane({ 0, 0, 0 }, { 0, 0, -1 });
+    DronePositionType pos;
+    pos.data = { 0, 0, -0.1 };
+    DroneEulerType angle;
+    angle.data = { 0.0, 0.0, 0.0 };
+    DroneVelocityType vel;
+    vel.data = { 0, 0, 1 };
+    EXPECT_FALSE(tilted.detect(pos, angle, vel, collision));
+    angle.data = { 0.3, 0.0, 0.0 };
+    EXPECT_TRUE(tilted.detect(pos, angle, vel, collision));
+}
+
+TEST_F(CollisionWorldTest, test_02)
+{
+    // 壁（x = 1.5 の面）
+    CollisionWorld world;
+    world.set_body_size(0.2, 0.2, 0.1);
+    EXPECT_TRUE(world.add_box({ 2, 0, -1 }, { 1, 4, 2 }));
+    world.build();
+
+    DroneDynamicsCollisionType collision;
+    EXPECT_FALSE(detect(world, 1.35, 0, -1, 1, 0, 0, collision));
+    EXPECT_TRUE(detect(world, 1.45, 0.5, -1, 1, 0, 0, collision));
+    EXPECT_EQ(1, collision.contact_num);
+    EXPECT_DOUBLE_EQ(1.5, collision.contact_position[0].x);
+    EXPECT_DOUBLE_EQ(0.5, collision.contact_position[0].y);
+    EXPECT_DOUBLE_EQ(-1.0, collision.contact_position[0].z);
+
+    // 45度回転すると角が壁に届く
+    EXPECT_FALSE(detect(world, 1.38, 0, -1, 1, 0, 0, collision));
+    EXPECT_TRUE(detect(world, 1.38, 0, -1, 1, 0, 0, collision, M_PI / 4));
+
+    // 壁の中に入り込んでいても押し出す向きの接触点になる
+    EXPECT_TRUE(detect(world, 1.6, 0, -1, 1, 0, 0, collision));
+    EXPECT_DOUBLE_EQ(1.5, collision.contact_position[0].x);
+}
+
+TEST_F(CollisionWorldTest, test_03)
+{
+    // メッシュ（x = 1.5 の四角形）
+    const std::string filepath = "collision_world_test.obj";
+    {
+        std::ofstream ofs(filepath);
+        ofs << "# quad" << std::endl;
+        ofs << "v 1.5 -1.0 -2.0" << std::endl;
+        ofs << "v 1.5  1.0 -2.0" << std::endl;
+        ofs << "v 1.5  1.0  0.0" << std::endl;
+        ofs << "v 1.5 -1.0  0.0" << std::endl;
+        ofs << "vn -1 0 0" << std::endl;
+        ofs << "f 1//1 2//1 3//1 -1//1" << std::endl;
+    }
+    CollisionWorld world;
+    world.set_body_size(0.2, 0.2, 0.1);
+    EXPECT_TRUE(world.load_obj(filepath, { 0.0, 10.0, 0.0 }));
+    EXPECT_EQ(2, world.get_triangle_num());
+    world.build();
+
+    DroneDynamicsCollisionType collision;
+    EXPECT_FALSE(detect(world, 1.45, 0, -1, 1, 0, 0, collision));
+    EXPECT_TRUE(detect(world, 1.45, 10.5, -1, 1, 0, 0, collision));
+    EXPECT_NEAR(1.5, collision.contact_position[0].x, 1e-12);
+    EXPECT_NEAR(10.5, collision.contact_position[0].y, 1e-12);
+    EXPECT_NEAR(-1.0, collision.contact_position[0].z, 1e-12);
+
+    {
+        std::ofstream ofs(filepath);
+        ofs << "v 0 0 0" << std::endl;
+        ofs << "f 1 2 3" << std::endl;
+    }
+    CollisionWorld invalid;
+    EXPECT_FALSE(invalid.load_obj(filepath, { 0, 0, 0 }));
+    EXPECT_FALSE(invalid.load_obj("not_exist.obj", { 0, 0, 0 }));
+    std::remove(filepath.c_str());
+}
+
+TEST_F(CollisionWorldTest, test_04)
+{
+    // BVH を使っても全部調べた場合と同じ結果になる
+    std::mt19937 gen(1234);
+    std::uniform_real_distribution<double> pos_dist(-50.0, 50.0);
+    std::uniform_real_distribution<double> size_dist(0.1, 3.0);
+    std::uniform_real_distribution<double> unit_dist(-1.0, 1.0);
+    CollisionWorld bvh;
+    CollisionWorld linear;
+    for (auto world : { &bvh, &linear }) {
+        world->set_body_size(1.0, 1.0, 0.5);
+    }
+    for (int i = 0; i < 2000; i++) {
+        hako::drone_physics::VectorType center = { pos_dist(gen), pos_dist(gen), pos_dist(gen) / 10.0 };
+        hako::drone_physics::VectorType size = { size_dist(gen), size_dist(gen), size_dist(gen) };
+        bvh.add_box(center, size);
+        linear.add_box(center, size);
+        hako::drone_physics::VectorType a = { pos_dist(gen), pos_dist(gen), pos_dist(gen) / 10.0 };
+        hako::drone_physics::VectorType b = { a.x + unit_dist(gen), a.y + unit_dist(gen), a.z + unit_dist(gen) };
+        hako::drone_physics::VectorType c = { a.x + unit_dist(gen), a.y + unit_dist(gen), a.z + unit_dist(gen) };
+        bvh.add_triangle(a, b, c);
+        linear.add_triangle(a, b, c);
+    }
+    bvh.build();
+    EXPECT_GT(bvh.get_node_num(), 0);
+    EXPECT_EQ(0, linear.get_node_num());
+
+    int hit = 0;
+    for (int i = 0; i < 2000; i++) {
+        double x = pos_dist(gen), y = pos_dist(gen), z = pos_dist(gen) / 10.0;
+        double vx = unit_dist(gen), vy = unit_dist(gen), vz = unit_dist(gen);
+        double yaw = unit_dist(gen) * M_PI;
+        DroneDynamicsCollisionType c1, c2;
+        bool r1 = detect(bvh, x, y, z, vx, vy, vz, c1, yaw);
+        bool r2 = detect(linear, x, y, z, vx, vy, vz, c2, yaw);
+        ASSERT_EQ(r2, r1);
+        if (r1) {
+            hit++;
+            ASSERT_EQ(c2.contact_num, c1.contact_num);
+            for (int j = 0; j < c1.contact_num; j++) {
+                EXPECT_EQ(c2.contact_position[j].x, c1.contact_position[j].x);
+                EXPECT_EQ(c2.contact_position[j].y, c1.contact_position[j].y);
+                EXPECT_EQ(c2.contact_position[j].z, c1.contact_position[j].z);
+            }
+        }
+    }
+    EXPECT_GT(hit, 0);
+}
+
+TEST_F(CollisionWorldTest, test_05)
+{
+    // 接触点は近い順で、MAX_CONTAT_NUM 個まで
+    CollisionWorld world;
+    world.set_body_size(10.0, 10.0, 1.0);
+    for (int i = 0; i < MAX_CONTAT_NUM + 5; i++) {
+        world.add_box({ 0.5 + 0.2 * i, 0, 0 }, { 0.1, 0.1, 0.1 });
+    }
+    world.build();
+    DroneDynamicsCollisionType collision;
+    EXPECT_TRUE(detect(world, 0, 0, 0, 1, 0, 0, collision));
+    EXPECT_EQ(MAX_CONTAT_NUM, collision.contact_num);
+    for (int i = 0; i < collision.contact_num; i++) {
+        EXPECT_NEAR(0.45 + 0.2 * i, collision.contact_position[i].x, 1e-12);
+    }
+}
+
+TEST_F(CollisionWorldTest, test_06)
+{
+    // どの機体モデルでも、衝突の入力で接触点に向かう速度が反発係数に従って反転する
+    const double dt = 0.001;
+    DroneDynamicsBodyFrame body_frame(dt);
+    DroneDynamicsBodyFrameRK4 body_frame_rk4(dt);
+    DroneDynamicsGroundFrame ground_frame(dt);
+    for (IDroneDynamics *dynamics : std::vector<IDroneDynamics*>{ &body_frame, &body_frame_rk4, &ground_frame }) {
+        dynamics->set_collision_detection(true);
+        dynamics->set_drag(0.0, 0.0);
+        DronePositionType pos;
+        pos.data = { 0.0, 0.0, -10.0 };
+        dynamics->set_pos(pos);
+        // 自由落下で下向きの速度をつける
+        DroneDynamicsInputType input = {};
+        for (int i = 0; i < 100; i++) {
+            dynamics->run(input);
+        }
+        double vz = dynamics->get_vel().data.z;
+        EXPECT_GT(vz, 0.9);
+        // 真下の床に接触する
+        input.collision.collision = true;
+        input.collision.contact_num = 1;
+        input.collision.contact_position[0] = { 0.0, 0.0, dynamics->get_pos().data.z + 0.5 };
+        input.collision.restitution_coefficient = 0.5;
+        dynamics->run(input);
+        EXPECT_NEAR(-0.5 * (vz + hako::assets::drone::GRAVITY * dt), dynamics->get_vel().data.z, 1e-6);
+        EXPECT_NEAR(0.0, dynamics->get_vel().data.x, 1e-9);
+
+        // 衝突の入力がなければ落下を続ける
+        vz = dynamics->get_vel().data.z;
+        input.collision.collision = false;
+        dynamics->run(input);
+        EXPECT_NEAR(vz + hako::assets::drone::GRAVITY * dt, dynamics->get_vel().data.z, 1e-6);
+    }
+}
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+#include <iostream>
+#include <vector>
+#include "rotor/rotor_bank.hpp"
+#include "rotor/rotor_dynamics.hpp"
+#include "rotor/rotor_dynamics_jmavsim.hpp"
+
+class RotorBankTest : public ::testing::Test {
+protected:
+    static void SetUpTestCase()
+    {
+    }
+    static void TearDownTestCase()
+    {
+    }
+    virtual void SetUp()
+    {
+    }
+    virtual void TearDown()
+    {
+    }
+
+};
+using hako::assets::drone::RotorBank;
+using hako::assets::drone::RotorDynamics;
+using hako::assets::drone::RotorDynamicsJmavsim;
+using hako::assets::drone::DroneRotorSpeedType;
+using hako::assets::drone::ROTOR_BANK_MODEL_FIRST_ORDER;
+using hako::assets::drone::ROTOR_BANK_MODEL_JMAVSIM;
+
+#define DELTA_TIME_SEC 0.001
+#define BANK_ROTOR_NUM 6
+
+TEST_F(RotorBankTest, test_01)
+{
+    // 1つずつ計算した RotorDynamics と同じ応答になる
+    RotorBank bank(DELTA_TIME_SEC, BANK_ROTOR_NUM, ROTOR_BANK_MODEL_FIRST_ORDER);
+    bank.set_params(1000, 0.1, 1200);
+    std::vector<RotorDynamics> rotors(BANK_ROTOR_NUM, RotorDynamics(DELTA_TIME_SEC));
+    for (auto& rotor : rotors) {
+        rotor.set_params(1000, 0.1, 1200);
+    }
+    EXPECT_EQ(BANK_ROTOR_NUM, bank.get_rotor_num());
+    double controls[BANK_ROTOR_NUM];
+    for (int step = 0; step < 2000; step++) {
+        for (int i = 0; i < BANK_ROTOR_NUM; i++) {
+            controls[i] = (step < 1000) ? 0.2 * i : -0.1;
+            rotors[i].run(controls[i]);
+        }
+        bank.run(controls);
+        for (int i = 0; i < BANK_ROTOR_NUM; i++) {
+            EXPECT_NEAR(rotors[i].get_rotor_speed().data, bank.get_rotor_speeds()[i].data, 1e-9);
+        }
+    }
+    // 0〜rpmMax に制限する
+    EXPECT_EQ(0, bank.get_rotor_speeds()[0].data);
+}
+
+TEST_F(RotorBankTest, test_02)
+{
+    // jMAVSim モデルは RotorDynamicsJmavsim と同じ値になる
+    RotorBank bank(DELTA_TIME_SEC, BANK_ROTOR_NUM, ROTOR_BANK_MODEL_JMAVSIM);
+    bank.set_params(6000, 0.05, 6000);
+    std::vector<RotorDynamicsJmavsim> rotors(BANK_ROTOR_NUM, RotorDynamicsJmavsim(DELTA_TIME_SEC));
+    for (auto& rotor : rotors) {
+        rotor.set_params(6000, 0.05, 6000);
+    }
+    double controls[BANK_ROTOR_NUM];
+    for (int step = 0; step < 500; step++) {
+        for (int i = 0; i < BANK_ROTOR_NUM; i++) {
+            controls[i] = 0.1 * (i + 1);
+            rotors[i].run(controls[i]);
+        }
+        bank.run(controls);
+    }
+    for (int i = 0; i < BANK_ROTOR_NUM; i++) {
+        EXPECT_EQ(rotors[i].get_rotor_speed().data, bank.get_rotor_speeds()[i].data);
+    }
+}
+
+TEST_F(RotorBankTest, test_03)
+{
+    RotorBank bank(DELTA_TIME_SEC, 4);
+    bank.set_params(1000, 1.0, 1.0);
+    DroneRotorSpeedType speed = { 0.5 };
+    bank.set_rotor_speed(2, speed);
+    EXPECT_EQ(0.5, bank.get_rotor_speeds()[2].data);
+
+    StateSnapshot snapshot;
+    bank.save_state(snapshot);
+    double controls[4] = { 1.0, 1.0, 1.0, 1.0 };
+    bank.run(controls);
+    EXPECT_NE(0.5, bank.get_rotor_speeds()[2].data);
+    EXPECT_TRUE(bank.restore_state(snapshot));
+    EXPECT_EQ(0.5, bank.get_rotor_speeds()[2].data);
+
+    // ロータ数が異なる場合は復元できない
+    RotorBank other(DELTA_TIME_SEC, 8);
+    snapshot.rewind();
+    EXPECT_FALSE(other.restore_state(snapshot));
+}
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include <iostream>
+#include <vector>
+#include "utils/csv_logger.hpp"
+#include "thruster/thrust_mixer.hpp"
+#include "thruster/airframe.hpp"
+#include "thruster/thrust_dynamics_nonlinear.hpp"
+#include "rotor_physics.hpp"
+
+class ThrustMixerTest : public ::testing::Test {
+protected:
+    static void SetUpTestCase()
+    {
+    }
+    static void TearDownTestCase()
+    {
+    }
+    virtual void SetUp()
+    {
+    }
+    virtual void TearDown()
+    {
+    }
+
+};
+using hako::assets::drone::ThrustMixer;
+using hako::assets::drone::ThrustDynamicsNonLinear;
+using hako::assets::drone::RotorConfigType;
+using hako::assets::drone::DroneRotorSpeedType;
+using hako::assets::drone::DroneThrustType;
+using hako::assets::drone::DroneTorqueType;
+using hako::assets::drone::airframe_rotor_config;
+
+#define PARAM_A     0.0000001
+#define PARAM_B     0.00000001
+#define PARAM_JR    0.000001
+
+TEST_F(ThrustMixerTest, test_01)
+{
+    // drone_physics の body_thrust/body_torque と同じ推力・トルクになる
+    std::vector<RotorConfigType> rotor_config;
+    EXPECT_TRUE(airframe_rotor_config("quad_x", 0.3, 0.0, rotor_config));
+    ASSERT_EQ(4U, rotor_config.size());
+    ThrustMixer mixer;
+    mixer.init(rotor_config, PARAM_A, PARAM_B, PARAM_JR);
+
+    double omega[4] = { 3000, 3100, 3200, 3300 };
+    double omega_acc[4] = { 10, -20, 30, -40 };
+    hako::drone_physics::VectorType position[4];
+    double ccw[4];
+    for (int i = 0; i < 4; i++) {
+        position[i] = { rotor_config[i].data.x, rotor_config[i].data.y, rotor_config[i].data.z };
+        ccw[i] = rotor_config[i].ccw;
+    }
+    DroneThrustType thrust;
+    DroneTorqueType torque;
+    mixer.mix(omega, omega_acc, thrust, torque);
+
+    double expected_thrust = hako::drone_physics::body_thrust(PARAM_A, 4, omega);
+    auto expected_torque = hako::drone_physics::body_torque(PARAM_A, PARAM_B, PARAM_JR, 4, position, ccw, omega, omega_acc);
+    EXPECT_NEAR(expected_thrust, thrust.data, 1e-12);
+    EXPECT_NEAR(expected_torque.x, torque.data.x, 1e-12);
+    EXPECT_NEAR(expected_torque.y, torque.data.y, 1e-12);
+    EXPECT_NEAR(expected_torque.z, torque.data.z, 1e-12);
+}
+
+TEST_F(ThrustMixerTest, test_02)
+{
+    // 機体形状のロータ数
+    std::vector<RotorConfigType> rotor_config;
+    const struct { const char* name; size_t rotor_num; } expected[] = {
+        { "quad_x", 4 }, { "quad_plus", 4 }, { "hexa_x", 6 }, { "hexa_plus", 6 },
+        { "octa_x", 8 }, { "octa_plus", 8 }, { "coaxial_x8", 8 },
+    };
+    for (auto& e : expected) {
+        EXPECT_TRUE(airframe_rotor_config(e.name, 0.3, 0.1, rotor_config)) << e.name;
+        EXPECT_EQ(e.rotor_num, rotor_config.size()) << e.name;
+    }
+    EXPECT_FALSE(airframe_rotor_config("tri_y", 0.3, 0.1, rotor_config));
+}
+
+TEST_F(ThrustMixerTest, test_03)
+{
+    // 同じ回転数でホバリングすると、どの機体形状もトルクは 0
+    const char* airframes[] = { "quad_x", "quad_plus", "hexa_x", "hexa_plus", "octa_x", "octa_plus", "coaxial_x8" };
+    for (auto name : airframes) {
+        std::vector<RotorConfigType> rotor_config;
+        EXPECT_TRUE(airframe_rotor_config(name, 0.3, 0.1, rotor_config));
+        ThrustMixer mixer;
+        mixer.init(rotor_config, PARAM_A, PARAM_B, PARAM_JR);
+        std::vector<double> omega(rotor_config.size(), 3000.0);
+        DroneThrustType thrust;
+        DroneTorqueType torque;
+        mixer.mix(omega.data(), nullptr, thrust, torque);
+        EXPECT_NEAR(PARAM_A * 3000.0 * 3000.0 * rotor_config.size(), thrust.data, 1e-9) << name;
+        EXPECT_NEAR(0.0, torque.data.x, 1e-12) << name;
+        EXPECT_NEAR(0.0, torque.data.y, 1e-12) << name;
+        EXPECT_NEAR(0.0, torque.data.z, 1e-12) << name;
+    }
+}
+
+TEST_F(ThrustMixerTest, test_04)
+{
+    // ヘキサコプタで推力計算できる
+    std::vector<RotorConfigType> rotor_config;
+    EXPECT_TRUE(airframe_rotor_config("hexa_x", 0.3, 0.0, rotor_config));
+    ThrustDynamicsNonLinear thrust(0.001);
+    thrust.set_params(PARAM_A, PARAM_B, PARAM_JR);
+    thrust.set_rotor_config(rotor_config.data(), (int)rotor_config.size());
+    EXPECT_EQ(6, thrust.get_rotor_num());
+
+    std::vector<DroneRotorSpeedType> rotor_speed(6);
+    for (auto& speed : rotor_speed) {
+        speed.data = 3000;
+    }
+    thrust.run(rotor_speed.data());
+    thrust.run(rotor_speed.data());
+    EXPECT_NEAR(6 * PARAM_A * 3000 * 3000, thrust.get_thrust().data, 1e-9);
+    EXPECT_NEAR(0.0, thrust.get_torque().data.z, 1e-12);
+}
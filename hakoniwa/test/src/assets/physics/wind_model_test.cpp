@@ -0,0 +1,204 @@
+#include <gtest/gtest.h>
+#include <iostream>
+#include <cmath>
+#include <vector>
+#include "wind/wind_model.hpp"
+#include "body_frame/drone_dynamics_body_frame.hpp"
+#include "body_frame_rk4/drone_dynamics_body_frame_rk4.hpp"
+#include "ground_frame/drone_dynamics_ground_frame.hpp"
+
+class WindModelTest : public ::testing::Test {
+protected:
+    static void SetUpTestCase()
+    {
+    }
+    static void TearDownTestCase()
+    {
+    }
+    virtual void SetUp()
+    {
+    }
+    virtual void TearDown()
+    {
+    }
+
+};
+using hako::assets::drone::WindModel;
+using hako::assets::drone::WindGustType;
+using hako::assets::drone::WindTurbulenceParamType;
+using hako::assets::drone::DroneVelocityType;
+using hako::assets::drone::IDroneDynamics;
+using hako::assets::drone::DroneDynamicsBodyFrame;
+using hako::assets::drone::DroneDynamicsBodyFrameRK4;
+using hako::assets::drone::DroneDynamicsGroundFrame;
+using hako::assets::drone::DroneDynamicsInputType;
+using hako::assets::drone::DronePositionType;
+using hako::assets::drone::DroneEulerType;
+
+static double component(const DroneVelocityType& v, int axis)
+{
+    return (axis == 0) ? v.data.x : ((axis == 1) ? v.data.y : v.data.z);
+}
+
+static WindTurbulenceParamType make_turbulence(hako::assets::drone::WindTurbulenceModel model)
+{
+    WindTurbulenceParamType param;
+    param.model = model;
+    param.intensity[0] = 1.0;
+    param.intensity[1] = 0.5;
+    param.intensity[2] = 0.25;
+    param.length_scale[0] = 20.0;
+    param.length_scale[1] = 20.0;
+    param.length_scale[2] = 5.0;
+    param.airspeed = 5.0;
+    param.samples = 1 << 14;
+    return param;
+}
+
+TEST_F(WindModelTest, WindModel_001)
+{
+    // 一定の風と 1-cos 型の突風
+    WindModel wind(0.01);
+    DroneVelocityType constant;
+    constant.data = { 3.0, -1.0, 0.0 };
+    wind.set_constant(constant);
+    WindGustType gust;
+    gust.start_sec = 1.0;
+    gust.duration_sec = 2.0;
+    gust.amplitude.data = { 0.0, 4.0, 0.0 };
+    EXPECT_TRUE(wind.add_gust(gust));
+    gust.duration_sec = 0.0;
+    EXPECT_FALSE(wind.add_gust(gust));
+
+    std::vector<DroneVelocityType> values;
+    for (int i = 0; i < 400; i++) {
+        values.push_back(wind.run());
+    }
+    EXPECT_DOUBLE_EQ(3.0, values[0].data.x);
+    EXPECT_DOUBLE_EQ(-1.0, values[0].data.y);
+    EXPECT_DOUBLE_EQ(-1.0, values[100].data.y);
+    EXPECT_NEAR(1.0, values[150].data.y, 1e-9);
+    EXPECT_NEAR(3.0, values[200].data.y, 1e-9);
+    EXPECT_NEAR(-1.0, values[300].data.y, 1e-9);
+    EXPECT_DOUBLE_EQ(3.0, values[200].data.x);
+}
+
+TEST_F(WindModelTest, WindModel_002)
+{
+    // 乱流の各成分は平均 0、標準偏差 intensity で、近い時刻ほど相関が強い
+    for (auto model : { hako::assets::drone::WIND_TURBULENCE_DRYDEN, hako::assets::drone::WIND_TURBULENCE_VON_KARMAN }) {
+        WindModel wind(0.01);
+        WindTurbulenceParamType param = make_turbulence(model);
+        EXPECT_TRUE(wind.init_turbulence(param, 1234));
+        EXPECT_EQ((size_t)param.samples, wind.get_turbulence_samples());
+        std::vector<DroneVelocityType> values;
+        for (int i = 0; i < param.samples; i++) {
+            values.push_back(wind.run());
+        }
+        for (int axis = 0; axis < 3; axis++) {
+            double sum = 0, sum2 = 0, lag1 = 0, lag_long = 0;
+            const int n = param.samples;
+            const int long_lag = 1000;  // 10 秒 = 50m
+            for (int i = 0; i < n; i++) {
+                double v = component(values[i], axis);
+                sum += v;
+                sum2 += v * v;
+                lag1 += v * component(values[(i + 1) % n], axis);
+                lag_long += v * component(values[(i + long_lag) % n], axis);
+            }
+            double var = sum2 / n;
+            EXPECT_NEAR(0.0, sum / n, 1e-9);
+            EXPECT_NEAR(param.intensity[axis], std::sqrt(var), 1e-9);
+            EXPECT_GT(lag1 / n / var, 0.9);
+            EXPECT_LT(std::fabs(lag_long / n / var), 0.5);
+        }
+        // 表の終わりで先頭に戻る
+        DroneVelocityType first = wind.run();
+        EXPECT_DOUBLE_EQ(values[0].data.x, first.data.x);
+    }
+
+    // 同じシードなら同じ乱流
+    WindModel a(0.01), b(0.01), c(0.01);
+    EXPECT_TRUE(a.init_turbulence(make_turbulence(hako::assets::drone::WIND_TURBULENCE_DRYDEN), 1));
+    EXPECT_TRUE(b.init_turbulence(make_turbulence(hako::assets::drone::WIND_TURBULENCE_DRYDEN), 1));
+    EXPECT_TRUE(c.init_turbulence(make_turbulence(hako::assets::drone::WIND_TURBULENCE_DRYDEN), 2));
+    DroneVelocityType va = a.run(), vb = b.run(), vc = c.run();
+    EXPECT_EQ(va.data.x, vb.data.x);
+    EXPECT_NE(va.data.x, vc.data.x);
+
+    // スナップショットで時刻が戻る
+    StateSnapshot snapshot;
+    a.save_state(snapshot);
+    DroneVelocityType next = a.run();
+    snapshot.rewind();
+    EXPECT_TRUE(a.restore_state(snapshot));
+    EXPECT_EQ(next.data.x, a.run().data.x);
+
+    WindTurbulenceParamType invalid = make_turbulence(hako::assets::drone::WIND_TURBULENCE_DRYDEN);
+    invalid.samples = 1000;
+    EXPECT_FALSE(a.init_turbulence(invalid, 1));
+}
+
+TEST_F(WindModelTest, WindModel_003)
+{
+    // 空気抵抗は対気速度にかかるので、止まっている機体は風下に流され、やがて風と同じ速さになる
+    const double dt = 0.001;
+    DroneDynamicsBodyFrame body_frame(dt);
+    DroneDynamicsBodyFrameRK4 body_frame_rk4(dt);
+    DroneDynamicsGroundFrame ground_frame(dt);
+    for (IDroneDynamics *dynamics : std::vector<IDroneDynamics*>{ &body_frame, &body_frame_rk4, &ground_frame }) {
+        dynamics->set_mass(1.0);
+        dynamics->set_drag(2.0, 0.0);
+        dynamics->set_torque_constants(1.0, 1.0, 1.0);
+        DronePositionType pos;
+        pos.data = { 0.0, 0.0, -100.0 };
+        dynamics->set_pos(pos);
+        DroneEulerType angle;
+        angle.data = { 0.0, 0.0, M_PI / 3 };
+        dynamics->set_angle(angle);
+        DroneVelocityType wind;
+        wind.data = { 2.0, -1.0, 0.0 };
+        dynamics->set_wind(wind);
+        DroneDynamicsInputType input = {};
+        // 推力で重力を打ち消す
+        input.thrust.data = 1.0 * hako::assets::drone::GRAVITY;
+        for (int i = 0; i < 5000; i++) {
+            dynamics->run(input);
+        }
+        EXPECT_NEAR(2.0, dynamics->get_vel().data.x, 1e-3);
+        EXPECT_NEAR(-1.0, dynamics->get_vel().data.y, 1e-3);
+        EXPECT_NEAR(0.0, dynamics->get_vel().data.z, 1e-3);
+    }
+}
+
+TEST_F(WindModelTest, WindModel_004)
+{
+    // 乱流の縦成分は一定の風の向きに沿う（東向きの風なら y が縦、x が横）
+    WindModel wind(0.01);
+    DroneVelocityType constant;
+    constant.data = { 0.0, 3.0, 0.0 };
+    wind.set_constant(constant);
+    WindTurbulenceParamType param = make_turbulence(hako::assets::drone::WIND_TURBULENCE_DRYDEN);
+    EXPECT_TRUE(wind.init_turbulence(param, 1234));
+    double sum2[3] = { 0, 0, 0 };
+    for (int i = 0; i < param.samples; i++) {
+        DroneVelocityType v = wind.run();
+        sum2[0] += v.data.x * v.data.x;
+        sum2[1] += (v.data.y - 3.0) * (v.data.y - 3.0);
+        sum2[2] += v.data.z * v.data.z;
+    }
+    EXPECT_NEAR(param.intensity[1], std::sqrt(sum2[0] / param.samples), 1e-9);
+    EXPECT_NEAR(param.intensity[0], std::sqrt(sum2[1] / param.samples), 1e-9);
+    EXPECT_NEAR(param.intensity[2], std::sqrt(sum2[2] / param.samples), 1e-9);
+
+    // 一定の風がなければ x が縦
+    WindModel calm(0.01);
+    EXPECT_TRUE(calm.init_turbulence(param, 1234));
+    wind.set_constant(DroneVelocityType());
+    for (int i = 0; i < 10; i++) {
+        DroneVelocityType a = calm.run();
+        DroneVelocityType b = wind.run();
+        EXPECT_DOUBLE_EQ(a.data.x, b.data.x);
+        EXPECT_DOUBLE_EQ(a.data.y, b.data.y);
+    }
+}
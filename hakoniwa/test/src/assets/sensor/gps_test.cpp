@@ -27,7 +27,7 @@ using hako::assets::drone::DroneGpsDataType;
 
 TEST_F(GpsTest, SensorGps_001) 
 {
-    SensorGps gps(0.001, 3);
+    SensorGps gps(0.001);
     double ref_lat = 35.6895;
     double ref_lon = 139.6917;
     double ref_alt = 10;
@@ -66,7 +66,7 @@ TEST_F(GpsTest, SensorGps_001)
 
 TEST_F(GpsTest, SensorGps_002) 
 {
-    SensorGps gps(0.001, 3);
+    SensorGps gps(0.001);
     SensorNoise noise(0.01);
     double ref_lat = 35.6895;
     double ref_lon = 139.6917;
@@ -111,3 +111,130 @@ TEST_F(GpsTest, SensorGps_002)
     EXPECT_GT(result.cog, 45 - 0.02);
     EXPECT_LT(result.cog, 45 + 0.02);
 }
+
+using hako::assets::drone::GpsParamType;
+
+TEST_F(GpsTest, SensorGps_003)
+{
+    // WGS84 の緯度・経度への変換（ECEF を経由した厳密な値と比べる）
+    SensorGps gps(0.001);
+    gps.init_pos(35.6895, 139.6917, 10);
+    DronePositionType pos;
+    DroneVelocityType vel;
+    vel.data = { 0, 0, 0 };
+
+    // 北に 10km: 子午線の曲率半径 M = a(1-e^2)/(1-e^2 sin^2)^1.5 で、ほぼ 10000 / M
+    pos.data = { 10000, 0, 0 };
+    gps.run(pos, vel);
+    DroneGpsDataType result = gps.sensor_value();
+    double a = 6378137.0;
+    double e2 = (1.0 / 298.257223563) * (2.0 - 1.0 / 298.257223563);
+    double s = std::sin(35.6895 * M_PI / 180.0);
+    double m = a * (1 - e2) / std::pow(1 - e2 * s * s, 1.5);
+    EXPECT_NEAR(35.6895 + (10000.0 / m) * 180.0 / M_PI, result.lat, 2e-6);
+    EXPECT_NEAR(139.6917, result.lon, 1e-9);
+    EXPECT_EQ(10.0, result.alt);
+
+    // 東に 1km: 卯酉線の曲率半径 N cos(lat) で割る（接平面と緯線の差は数 mm）
+    pos.data = { 0, 1000, -5 };
+    gps.run(pos, vel);
+    result = gps.sensor_value();
+    double n = a / std::sqrt(1 - e2 * s * s);
+    EXPECT_NEAR(139.6917 + (1000.0 / (n * std::cos(35.6895 * M_PI / 180.0))) * 180.0 / M_PI, result.lon, 1e-7);
+    EXPECT_NEAR(35.6895, result.lat, 1e-6);
+    EXPECT_EQ(15.0, result.alt);
+
+    // 以前の 1 / 111000 の近似は 10km で数メートルずれる
+    EXPECT_GT(std::fabs((35.6895 + 10000.0 / 111000.0) - (35.6895 + (10000.0 / m) * 180.0 / M_PI)) * m * M_PI / 180.0, 3.0);
+}
+
+TEST_F(GpsTest, SensorGps_004)
+{
+    // 10Hz で測位し、latency_sec 前の測位を出力する
+    const double dt = 0.001;
+    SensorGps gps(dt);
+    gps.init_pos(35.6895, 139.6917, 0);
+    GpsParamType param = gps.get_params();
+    param.update_rate_hz = 10;
+    param.latency_sec = 0.2;
+    EXPECT_TRUE(gps.set_params(param));
+    DronePositionType pos;
+    DroneVelocityType vel;
+    pos.data = { 0, 0, 0 };
+    int fixes = 0;
+    for (int step = 1; step <= 1000; step++) {
+        vel.data = { step * dt, 0, 0 };
+        gps.run(pos, vel);
+        if (gps.has_new_fix()) {
+            fixes++;
+            EXPECT_EQ(0, step % 100) << "step=" << step;
+            // 2 回前の測位（0.2 秒前の速度）
+            EXPECT_NEAR((step - 200) * dt, gps.sensor_value().vn, 1e-9);
+        }
+    }
+    // 最初の 2 回の測位は遅延線を満たすだけ
+    EXPECT_EQ(8, fixes);
+
+    param.satellites_min = 0;
+    EXPECT_FALSE(gps.set_params(param));
+}
+
+TEST_F(GpsTest, SensorGps_005)
+{
+    // 捕捉衛星数が変わると DOP も変わり、位置の誤差の標準偏差は UERE * HDOP
+    const double dt = 0.01;
+    SensorGps gps(dt, 1);
+    gps.init_pos(0, 0, 0);
+    GpsParamType param = gps.get_params();
+    param.update_rate_hz = 10;
+    param.uere = 2.0;
+    param.error_correlation_sec = 1.0;
+    param.hdop = 1.0;
+    param.vdop = 1.5;
+    param.satellites_min = 6;
+    param.satellites_max = 12;
+    param.satellite_change_sec = 5.0;
+    EXPECT_TRUE(gps.set_params(param));
+    DronePositionType pos;
+    DroneVelocityType vel;
+    pos.data = { 0, 0, 0 };
+    vel.data = { 0, 0, 0 };
+    int sat_min = 100;
+    int sat_max = 0;
+    double sq = 0;
+    double expected = 0;
+    int n = 0;
+    for (int step = 0; step < 200000; step++) {
+        gps.run(pos, vel);
+        if (!gps.has_new_fix()) {
+            continue;
+        }
+        DroneGpsDataType result = gps.sensor_value();
+        sat_min = std::min(sat_min, result.num_satelites_visible);
+        sat_max = std::max(sat_max, result.num_satelites_visible);
+        EXPECT_NEAR(param.hdop * std::sqrt(12.0 / result.num_satelites_visible), result.eph, 1e-9);
+        EXPECT_NEAR(result.eph * 1.5, result.epv, 1e-9);
+        double north = result.lat * M_PI / 180.0 * 6335439.0;
+        sq += north * north;
+        expected += std::pow(param.uere * result.eph, 2);
+        n++;
+    }
+    EXPECT_EQ(6, sat_min);
+    EXPECT_EQ(12, sat_max);
+    EXPECT_NEAR(std::sqrt(expected / n), std::sqrt(sq / n), std::sqrt(expected / n) * 0.1);
+
+    // スナップショットで元に戻る
+    StateSnapshot snapshot;
+    gps.save_state(snapshot);
+    for (int i = 0; i < 10; i++) {
+        gps.run(pos, vel);
+    }
+    double lat = gps.sensor_value().lat;
+    gps.run(pos, vel);
+    snapshot.rewind();
+    EXPECT_TRUE(gps.restore_state(snapshot));
+    for (int i = 0; i < 10; i++) {
+        gps.run(pos, vel);
+    }
+    EXPECT_EQ(lat, gps.sensor_value().lat);
+}
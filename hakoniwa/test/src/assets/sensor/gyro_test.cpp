@@ -77,3 +77,34 @@ TEST_F(GyroTest, SensorGyro_002)
     EXPECT_GT(result.data.z, 3.980);
     EXPECT_LT(result.data.z, 4.020);
 }
+
+TEST_F(GyroTest, SensorGyro_003) 
+{
+    SensorGyro gyro(0.001, 1);
+    SensorNoise noise(0.01);
+    gyro.set_noise(&noise);
+    DroneAngularVelocityBodyFrameType value;
+    value.data.x = 1;
+    value.data.y = 2;
+    value.data.z = 3;
+    gyro.run(value);
+
+    // 同じステップの間はノイズを含めて同じ値を返し、ログにも同じ値を出力する
+    DroneAngularVelocityBodyFrameType first = gyro.sensor_value();
+    DroneAngularVelocityBodyFrameType second = gyro.sensor_value();
+    EXPECT_EQ(first.data.x, second.data.x);
+    EXPECT_EQ(first.data.y, second.data.y);
+    EXPECT_EQ(first.data.z, second.data.z);
+    std::vector<std::string> log = gyro.log_data();
+    ASSERT_EQ(4u, log.size());
+    EXPECT_EQ(first.data.x, std::stod(log[1]));
+    EXPECT_EQ(first.data.y, std::stod(log[2]));
+    EXPECT_EQ(first.data.z, std::stod(log[3]));
+
+    // run() で次のステップに進むと計算し直す
+    uint64_t stamp = gyro.get_step_stamp();
+    gyro.run(value);
+    EXPECT_EQ(stamp + 1, gyro.get_step_stamp());
+    DroneAngularVelocityBodyFrameType next = gyro.sensor_value();
+    EXPECT_NE(first.data.x, next.data.x);
+}
@@ -0,0 +1,182 @@
+#include <gtest/gtest.h>
+#include <iostream>
+#include <cmath>
+#include <vector>
+#include "sensors/imu/sensor_imu.hpp"
+#include "body_frame/drone_dynamics_body_frame.hpp"
+#include "body_frame_rk4/drone_dynamics_body_frame_rk4.hpp"
+#include "ground_frame/drone_dynamics_ground_frame.hpp"
+
+class ImuTest : public ::testing::Test {
+protected:
+    static void SetUpTestCase()
+    {
+    }
+    static void TearDownTestCase()
+    {
+    }
+    virtual void SetUp()
+    {
+    }
+    virtual void TearDown()
+    {
+    }
+
+};
+using hako::assets::drone::SensorImu;
+using hako::assets::drone::ImuNoiseParamType;
+using hako::assets::drone::ImuVibrationParamType;
+using hako::assets::drone::IDroneDynamics;
+using hako::assets::drone::DroneDynamicsBodyFrame;
+using hako::assets::drone::DroneDynamicsBodyFrameRK4;
+using hako::assets::drone::DroneDynamicsGroundFrame;
+using hako::assets::drone::DroneDynamicsInputType;
+using hako::assets::drone::DronePositionType;
+using hako::assets::drone::DroneEulerType;
+using hako::assets::drone::DroneAccelerationBodyFrameType;
+using hako::assets::drone::DroneAngularVelocityBodyFrameType;
+using hako::assets::drone::DroneRotorSpeedType;
+using hako::assets::drone::GRAVITY;
+
+TEST_F(ImuTest, SensorImu_001)
+{
+    // 比力は姿勢によらず推力 / 質量（機体の -z 方向）、自由落下では 0
+    const double dt = 0.001;
+    DroneDynamicsBodyFrame body_frame(dt);
+    DroneDynamicsBodyFrameRK4 body_frame_rk4(dt);
+    DroneDynamicsGroundFrame ground_frame(dt);
+    for (IDroneDynamics *dynamics : std::vector<IDroneDynamics*>{ &body_frame, &body_frame_rk4, &ground_frame }) {
+        EXPECT_NEAR(-GRAVITY, dynamics->get_specific_force().data.z, 1e-9);
+        dynamics->set_mass(2.0);
+        dynamics->set_drag(0.0, 0.0);
+        dynamics->set_torque_constants(1.0, 1.0, 1.0);
+        DronePositionType pos;
+        pos.data = { 0.0, 0.0, -100.0 };
+        dynamics->set_pos(pos);
+        DroneEulerType angle;
+        angle.data = { 0.3, -0.2, 1.0 };
+        dynamics->set_angle(angle);
+        DroneDynamicsInputType input = {};
+        input.thrust.data = 5.0;
+        for (int i = 0; i < 100; i++) {
+            dynamics->run(input);
+        }
+        DroneAccelerationBodyFrameType f = dynamics->get_specific_force();
+        EXPECT_NEAR(0.0, f.data.x, 1e-6);
+        EXPECT_NEAR(0.0, f.data.y, 1e-6);
+        EXPECT_NEAR(-2.5, f.data.z, 1e-6);
+
+        input.thrust.data = 0.0;
+        dynamics->run(input);
+        f = dynamics->get_specific_force();
+        EXPECT_NEAR(0.0, f.data.x, 1e-6);
+        EXPECT_NEAR(0.0, f.data.y, 1e-6);
+        EXPECT_NEAR(0.0, f.data.z, 1e-6);
+    }
+}
+
+TEST_F(ImuTest, SensorImu_002)
+{
+    // ノイズがなければ真値をそのまま出力する。サンプルのないステップは前の値を保持する
+    const double dt = 0.001;
+    DroneAccelerationBodyFrameType f;
+    DroneAngularVelocityBodyFrameType w;
+    SensorImu fast(dt, 4000);
+    SensorImu slow(dt, 250);
+    for (int i = 0; i < 8; i++) {
+        f.data = { 1.0 * i, 2.0, -GRAVITY };
+        w.data = { 0.1, 0.2, 0.01 * i };
+        fast.run(f, w, nullptr, 0);
+        slow.run(f, w, nullptr, 0);
+        EXPECT_EQ(4, fast.get_sample_count());
+        EXPECT_EQ(1.0 * i, fast.acc_value().data.x);
+        EXPECT_EQ(0.01 * i, fast.gyro_value().data.z);
+        // 250Hz は 4 ステップに 1 回
+        int last = ((i + 1) / 4) * 4 - 1;
+        EXPECT_EQ((i % 4 == 3) ? 1 : 0, slow.get_sample_count());
+        EXPECT_EQ((last >= 0) ? 1.0 * last : 0.0, slow.acc_value().data.x);
+    }
+}
+
+TEST_F(ImuTest, SensorImu_003)
+{
+    // ロータの振動の閉じた形の和は、サンプルごとに足した平均と一致する
+    const double dt = 0.001;
+    const double rate = 4000;
+    SensorImu imu(dt, rate);
+    ImuNoiseParamType zero = { 0, 0, 0, 0 };
+    ImuVibrationParamType vibration = { 2.0, 0.1, 6000, 0.5 };
+    EXPECT_TRUE(imu.set_params(zero, zero, vibration));
+    DroneRotorSpeedType rpm[4] = { { 6000 }, { 7000 }, { 5000 }, { 6000 } };
+    DroneAccelerationBodyFrameType f;
+    f.data = { 0, 0, -GRAVITY };
+    DroneAngularVelocityBodyFrameType w;
+    w.data = { 0, 0, 0 };
+    std::vector<double> phase = { 0, M_PI / 2, M_PI, 3 * M_PI / 2 };
+    for (int step = 0; step < 50; step++) {
+        imu.run(f, w, rpm, 4);
+        double acc[3] = { 0, 0, -GRAVITY * 4 };
+        double gyro[3] = { 0, 0, 0 };
+        for (int k = 0; k < 4; k++) {
+            for (int i = 0; i < 4; i++) {
+                double ratio = rpm[i].data / vibration.reference_rpm;
+                double a = vibration.acc_amplitude * ratio * ratio;
+                double g = vibration.gyro_amplitude * ratio * ratio;
+                acc[0] += a * std::cos(phase[i]);
+                acc[1] += a * std::sin(phase[i]);
+                acc[2] += a * vibration.axial_ratio * std::cos(phase[i]);
+                gyro[0] += g * std::sin(phase[i]);
+                gyro[1] += g * std::cos(phase[i]);
+                gyro[2] += g * vibration.axial_ratio * std::sin(phase[i]);
+                phase[i] += M_PI * 2.0 * (rpm[i].data / 60.0) / rate;
+            }
+        }
+        EXPECT_NEAR(acc[0] / 4, imu.acc_value().data.x, 1e-9);
+        EXPECT_NEAR(acc[1] / 4, imu.acc_value().data.y, 1e-9);
+        EXPECT_NEAR(acc[2] / 4, imu.acc_value().data.z, 1e-9);
+        EXPECT_NEAR(gyro[0] / 4, imu.gyro_value().data.x, 1e-9);
+        EXPECT_NEAR(gyro[1] / 4, imu.gyro_value().data.y, 1e-9);
+        EXPECT_NEAR(gyro[2] / 4, imu.gyro_value().data.z, 1e-9);
+    }
+    vibration.reference_rpm = 0;
+    EXPECT_FALSE(imu.set_params(zero, zero, vibration));
+}
+
+TEST_F(ImuTest, SensorImu_004)
+{
+    // デシメーションしたホワイトノイズの標準偏差は noise_density * sqrt(rate / サンプル数)、
+    // バイアス不安定性の定常的な標準偏差は 1.071 * bias_instability
+    const double dt = 0.001;
+    const double rate = 4000;
+    ImuNoiseParamType acc = { 0.01, 0, 0, 0 };
+    ImuNoiseParamType gyro = { 0, 0.02, 0.01, 0 };
+    ImuVibrationParamType vibration = { 0, 0, 6000, 1.0 };
+    SensorImu imu(dt, rate, 1);
+    EXPECT_TRUE(imu.set_params(acc, gyro, vibration));
+    DroneAccelerationBodyFrameType f;
+    f.data = { 0, 0, 0 };
+    DroneAngularVelocityBodyFrameType w;
+    w.data = { 0, 0, 0 };
+    const int n = 20000;
+    double acc_sq = 0;
+    double gyro_sq = 0;
+    for (int i = 0; i < n; i++) {
+        imu.run(f, w, nullptr, 0);
+        acc_sq += imu.acc_value().data.x * imu.acc_value().data.x;
+        gyro_sq += imu.gyro_value().data.x * imu.gyro_value().data.x;
+    }
+    EXPECT_NEAR(0.01 * std::sqrt(rate / 4), std::sqrt(acc_sq / n), 0.01 * std::sqrt(rate / 4) * 0.05);
+    EXPECT_NEAR(1.071 * 0.02, std::sqrt(gyro_sq / n), 1.071 * 0.02 * 0.05);
+
+    // スナップショットで元に戻る
+    StateSnapshot snapshot;
+    imu.save_state(snapshot);
+    imu.run(f, w, nullptr, 0);
+    double value = imu.acc_value().data.y;
+    imu.run(f, w, nullptr, 0);
+    (void)imu.acc_value();
+    snapshot.rewind();
+    EXPECT_TRUE(imu.restore_state(snapshot));
+    imu.run(f, w, nullptr, 0);
+    EXPECT_EQ(value, imu.acc_value().data.y);
+}
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include <iostream>
+#include "utils/atmosphere_model.hpp"
+#include "sensors/baro/sensor_baro.hpp"
+
+class AtmosphereModelTest : public ::testing::Test {
+protected:
+    static void SetUpTestCase()
+    {
+    }
+    static void TearDownTestCase()
+    {
+    }
+    virtual void SetUp()
+    {
+    }
+    virtual void TearDown()
+    {
+    }
+
+};
+using hako::assets::drone::AtmosphereModel;
+using hako::assets::drone::AtmosphereType;
+using hako::assets::drone::SensorBaro;
+using hako::assets::drone::DronePositionType;
+
+TEST_F(AtmosphereModelTest, AtmosphereModel_001)
+{
+    // 海面の標準大気
+    AtmosphereType value = AtmosphereModel::isa_atmosphere(0.0);
+    EXPECT_DOUBLE_EQ(101325.0, value.pressure);
+    EXPECT_DOUBLE_EQ(288.15, value.temperature);
+    EXPECT_NEAR(1.225, value.density, 0.001);
+    EXPECT_NEAR(22632.0, AtmosphereModel::isa_pressure(11000.0), 20.0);  // GRAVITY = 9.81
+    EXPECT_EQ(0.0, AtmosphereModel::isa_pressure(20001.0));
+}
+
+TEST_F(AtmosphereModelTest, AtmosphereModel_002)
+{
+    // 補間の誤差は指定した範囲に収まる
+    AtmosphereModel model;
+    EXPECT_TRUE(model.init(-500.0, 15000.0, 100.0, 0.05));
+    EXPECT_LE(model.get_max_error_pa(), 0.05);
+    EXPECT_LT(model.get_resolution(), 100.0);
+    for (double alt = -500.0; alt <= 15000.0; alt += 0.37) {
+        AtmosphereType expected = AtmosphereModel::isa_atmosphere(alt);
+        AtmosphereType actual = model.get_atmosphere(alt);
+        EXPECT_NEAR(expected.pressure, actual.pressure, 0.05);
+        EXPECT_NEAR(expected.temperature, actual.temperature, 0.01);
+        EXPECT_NEAR(expected.density, actual.density, 1e-5);
+        EXPECT_EQ(actual.pressure, model.get_pressure(alt));
+    }
+    // 表の範囲外は計算する
+    EXPECT_EQ(AtmosphereModel::isa_pressure(16000.0), model.get_pressure(16000.0));
+    EXPECT_EQ(AtmosphereModel::isa_pressure(-600.0), model.get_pressure(-600.0));
+
+    EXPECT_FALSE(model.init(100.0, 0.0, 10.0, 0.1));
+    EXPECT_FALSE(model.init(0.0, 100.0, 0.0, 0.1));
+}
+
+TEST_F(AtmosphereModelTest, AtmosphereModel_003)
+{
+    AtmosphereModel model;
+    EXPECT_TRUE(model.init(-1000.0, 11000.0, 10.0, 0.1));
+    SensorBaro exact(0.001, 1);
+    SensorBaro table(0.001, 1);
+    table.set_atmosphere(&model);
+    exact.init_pos(0, 0, 121.321);
+    table.init_pos(0, 0, 121.321);
+    DronePositionType value;
+    for (int i = 0; i < 100; i++) {
+        value.data = { 0, 0, -1.7 * i };
+        exact.run(value);
+        table.run(value);
+        EXPECT_NEAR(exact.sensor_value().abs_pressure, table.sensor_value().abs_pressure, 0.1);
+        EXPECT_EQ(exact.sensor_value().pressure_alt, table.sensor_value().pressure_alt);
+    }
+}
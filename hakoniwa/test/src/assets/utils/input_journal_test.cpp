@@ -0,0 +1,184 @@
+#include <gtest/gtest.h>
+#include <iostream>
+#include <cstdio>
+#include <vector>
+#include "utils/input_journal.hpp"
+#include "ithrust_dynamics.hpp"
+#include "utils/sensor_noise.hpp"
+#include "sensors/gyro/sensor_gyro.hpp"
+#include "body_frame/drone_dynamics_body_frame.hpp"
+
+class InputJournalTest : public ::testing::Test {
+protected:
+    static void SetUpTestCase()
+    {
+    }
+    static void TearDownTestCase()
+    {
+    }
+    virtual void SetUp()
+    {
+    }
+    virtual void TearDown()
+    {
+    }
+
+};
+using hako::assets::drone::InputJournalWriter;
+using hako::assets::drone::InputJournalReader;
+using hako::assets::drone::InputJournalRecordType;
+using hako::assets::drone::DroneDynamicsInputType;
+using hako::assets::drone::DroneDynamicsBodyFrame;
+using hako::assets::drone::DroneAngularVelocityBodyFrameType;
+using hako::assets::drone::SensorGyro;
+using hako::assets::drone::SensorNoise;
+using hako::assets::drone::ROTOR_NUM;
+
+TEST_F(InputJournalTest, InputJournal_001)
+{
+    const std::string filepath = "input_journal_test.bin";
+    InputJournalWriter writer;
+    // ヘキサコプタ
+    const int rotor_num = 6;
+    EXPECT_TRUE(writer.open(filepath, rotor_num, 1234, 3000));
+
+    DroneDynamicsInputType input = {};
+    for (int i = 0; i < rotor_num; i++) {
+        input.controls[i] = 0.1 * (i + 1);
+    }
+    writer.write_step(input, 3000, false);
+    input.collision.collision = true;
+    input.collision.contact_num = 1;
+    input.collision.contact_position[0] = { 1.0, 2.0, 3.0 };
+    input.collision.restitution_coefficient = 0.5;
+    input.manual.control = true;
+    input.manual.pos.data = { 4.0, 5.0, 6.0 };
+    writer.write_step(input, 6000, true);
+    writer.write_reset(9000);
+    EXPECT_EQ(3U, writer.get_record_count());
+    writer.close();
+
+    InputJournalReader reader;
+    EXPECT_TRUE(reader.open(filepath));
+    EXPECT_EQ(1234U, reader.get_header().noise_seed);
+    EXPECT_EQ((uint32_t)rotor_num, reader.get_header().rotor_num);
+    EXPECT_EQ(3000U, reader.get_header().delta_time_usec);
+
+    InputJournalRecordType record;
+    DroneDynamicsInputType read_input;
+    EXPECT_TRUE(reader.next(record, read_input));
+    EXPECT_EQ(hako::assets::drone::INPUT_JOURNAL_STEP, (int)record.kind);
+    EXPECT_EQ(3000U, record.time_usec);
+    EXPECT_EQ(0U, record.flags);
+    EXPECT_EQ(0.4, read_input.controls[3]);
+    EXPECT_EQ(input.controls[5], read_input.controls[5]);
+    EXPECT_FALSE(read_input.collision.collision);
+    EXPECT_FALSE(read_input.manual.control);
+
+    EXPECT_TRUE(reader.next(record, read_input));
+    EXPECT_TRUE(record.flags & INPUT_JOURNAL_FLAG_LOG_ENABLED);
+    EXPECT_TRUE(read_input.collision.collision);
+    EXPECT_EQ(1, read_input.collision.contact_num);
+    EXPECT_EQ(3.0, read_input.collision.contact_position[0].z);
+    EXPECT_EQ(0.5, read_input.collision.restitution_coefficient);
+    EXPECT_TRUE(read_input.manual.control);
+    EXPECT_EQ(6.0, read_input.manual.pos.data.z);
+
+    EXPECT_TRUE(reader.next(record, read_input));
+    EXPECT_EQ(hako::assets::drone::INPUT_JOURNAL_RESET, (int)record.kind);
+    EXPECT_EQ(9000U, record.time_usec);
+    EXPECT_FALSE(reader.next(record, read_input));
+    std::remove(filepath.c_str());
+}
+
+TEST_F(InputJournalTest, InputJournal_002)
+{
+    // 同じシードと同じ入力で再計算すると、結果はビット単位で一致する
+    const std::string filepath = "input_journal_test.bin";
+    const uint32_t seed = 42;
+    auto simulate = [](uint32_t noise_seed, const std::vector<DroneDynamicsInputType>& inputs, std::vector<double>& result) {
+        DroneDynamicsBodyFrame dynamics(0.003);
+        dynamics.set_mass(1.0);
+        dynamics.set_torque_constants(1.0, 1.0, 1.0);
+        SensorGyro gyro(0.003, 3);
+        SensorNoise noise(0.01, noise_seed);
+        gyro.set_noise(&noise);
+        for (auto input : inputs) {
+            // 推力とトルクはアクチュエータの入力から計算する（IAirCraft::run() と同じ）
+            input.thrust.data = 10.0 * (input.controls[0] + input.controls[1] + input.controls[2] + input.controls[3]);
+            input.torque.data = { 0.01 * (input.controls[0] - input.controls[1]), 0.0, 0.0 };
+            dynamics.run(input);
+            DroneAngularVelocityBodyFrameType value;
+            value.data = dynamics.get_angular_vel_body_frame().data;
+            gyro.run(value);
+            result.push_back(dynamics.get_pos().data.z);
+            result.push_back(gyro.sensor_value().data.x);
+        }
+    };
+
+    InputJournalWriter writer;
+    EXPECT_TRUE(writer.open(filepath, ROTOR_NUM, seed, 3000));
+    std::vector<DroneDynamicsInputType> inputs;
+    for (int i = 0; i < 200; i++) {
+        DroneDynamicsInputType input = {};
+        for (int j = 0; j < ROTOR_NUM; j++) {
+            input.controls[j] = 0.2 + 0.01 * ((i + j) % 7);
+        }
+        inputs.push_back(input);
+        writer.write_step(input, (uint64_t)i * 3000, true);
+    }
+    writer.close();
+    std::vector<double> expected;
+    simulate(seed, inputs, expected);
+
+    InputJournalReader reader;
+    EXPECT_TRUE(reader.open(filepath));
+    InputJournalRecordType record;
+    std::vector<DroneDynamicsInputType> replayed;
+    DroneDynamicsInputType input = {};
+    while (reader.next(record, input)) {
+        replayed.push_back(input);
+    }
+    EXPECT_EQ(inputs.size(), replayed.size());
+    std::vector<double> actual;
+    simulate(reader.get_header().noise_seed, replayed, actual);
+    EXPECT_EQ(expected, actual);
+    std::remove(filepath.c_str());
+}
+
+TEST_F(InputJournalTest, InputJournal_003)
+{
+    // 閉じる前でも、書き出し済みのレコードはヘッダのレコード数まで読める。後ろの書きかけは読まない
+    const std::string filepath = "input_journal_test.bin";
+    InputJournalWriter writer;
+    EXPECT_TRUE(writer.open(filepath, ROTOR_NUM, 1, 3000));
+    writer.set_flush_interval(4);
+    DroneDynamicsInputType input = {};
+    for (int i = 0; i < 10; i++) {
+        input.controls[0] = 0.1 * i;
+        writer.write_step(input, (uint64_t)i * 3000, true);
+    }
+    auto count_records = [&filepath]() {
+        InputJournalReader reader;
+        EXPECT_TRUE(reader.open(filepath));
+        InputJournalRecordType record;
+        DroneDynamicsInputType read_input = {};
+        int num = 0;
+        while (reader.next(record, read_input)) {
+            EXPECT_EQ(0.1 * num, read_input.controls[0]);
+            num++;
+        }
+        EXPECT_EQ((uint64_t)num, reader.get_header().record_count);
+        return num;
+    };
+    EXPECT_EQ(8, count_records());
+    writer.close();
+    EXPECT_EQ(10, count_records());
+
+    // 落ちたプロセスが書きかけたレコードの断片
+    std::ofstream ofs(filepath, std::ios::out | std::ios::binary | std::ios::app);
+    ofs.write("\x01\x00\x00", 3);
+    ofs.close();
+    EXPECT_EQ(10, count_records());
+    std::remove(filepath.c_str());
+}
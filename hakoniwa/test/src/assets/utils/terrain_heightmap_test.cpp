@@ -0,0 +1,196 @@
+#include <gtest/gtest.h>
+#include <iostream>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+#include "utils/terrain_heightmap.hpp"
+#include "body_frame/drone_dynamics_body_frame.hpp"
+#include "body_frame_rk4/drone_dynamics_body_frame_rk4.hpp"
+#include "ground_frame/drone_dynamics_ground_frame.hpp"
+
+class TerrainHeightmapTest : public ::testing::Test {
+protected:
+    static void SetUpTestCase()
+    {
+    }
+    static void TearDownTestCase()
+    {
+    }
+    virtual void SetUp()
+    {
+    }
+    virtual void TearDown()
+    {
+    }
+
+};
+using hako::assets::drone::TerrainHeightmap;
+using hako::assets::drone::TerrainHeightmapParamType;
+using hako::assets::drone::ITerrain;
+using hako::assets::drone::IDroneDynamics;
+using hako::assets::drone::DroneDynamicsBodyFrame;
+using hako::assets::drone::DroneDynamicsBodyFrameRK4;
+using hako::assets::drone::DroneDynamicsGroundFrame;
+using hako::assets::drone::DroneDynamicsInputType;
+using hako::assets::drone::DronePositionType;
+using hako::assets::drone::GroundContactParamType;
+using hako::assets::drone::GRAVITY;
+
+template <typename T>
+static void write_raw(const std::string& filepath, const std::vector<T>& samples)
+{
+    std::ofstream ofs(filepath, std::ios::out | std::ios::binary | std::ios::trunc);
+    ofs.write(reinterpret_cast<const char*>(samples.data()), samples.size() * sizeof(T));
+}
+
+static TerrainHeightmapParamType make_param(hako::assets::drone::TerrainFormat format, int width, int height)
+{
+    TerrainHeightmapParamType param;
+    param.format = format;
+    param.width = width;
+    param.height = height;
+    param.cell_size = 1.0;
+    param.origin_x = 0;
+    param.origin_y = 0;
+    param.height_scale = 1.0;
+    param.base_altitude = 0;
+    param.tile_size = TERRAIN_DEFAULT_TILE_SIZE;
+    param.max_tiles = TERRAIN_DEFAULT_MAX_TILES;
+    return param;
+}
+
+TEST_F(TerrainHeightmapTest, TerrainHeightmap_001)
+{
+    // 3行 x 4列、10m 間隔
+    const std::string filepath = "terrain_heightmap_test.raw";
+    write_raw<int16_t>(filepath, {
+        10, 20, 30, 40,
+        50, 60, 70, 80,
+        90, 100, TERRAIN_INT16_NODATA, 120,
+    });
+    TerrainHeightmapParamType param = make_param(hako::assets::drone::TERRAIN_FORMAT_INT16, 4, 3);
+    param.cell_size = 10.0;
+    param.origin_x = 100.0;
+    param.origin_y = -20.0;
+    param.height_scale = 0.5;
+    param.base_altitude = 5.0;
+    TerrainHeightmap terrain;
+    EXPECT_TRUE(terrain.open(filepath, param));
+
+    double altitude;
+    EXPECT_TRUE(terrain.get_altitude(100.0, -20.0, altitude));
+    EXPECT_DOUBLE_EQ(5.0, altitude);
+    EXPECT_TRUE(terrain.get_altitude(105.0, -15.0, altitude));
+    EXPECT_DOUBLE_EQ(0.5 * 35.0, altitude);
+    EXPECT_TRUE(terrain.get_altitude(110.0, 10.0, altitude));
+    EXPECT_DOUBLE_EQ(40.0, altitude);
+
+    // z は下向きなので、base_altitude より高い地面は負になる
+    double ground_z;
+    EXPECT_TRUE(terrain.get_ground_z(110.0, 10.0, ground_z));
+    EXPECT_DOUBLE_EQ(-35.0, ground_z);
+
+    // 範囲外・データなし
+    EXPECT_FALSE(terrain.get_ground_z(99.9, 0.0, ground_z));
+    EXPECT_FALSE(terrain.get_ground_z(100.0, 10.1, ground_z));
+    EXPECT_FALSE(terrain.get_ground_z(115.0, 5.0, ground_z));
+    EXPECT_TRUE(terrain.get_ground_z(105.0, 5.0, ground_z));
+
+    // ファイルが小さい
+    TerrainHeightmap invalid;
+    EXPECT_FALSE(invalid.open(filepath, make_param(hako::assets::drone::TERRAIN_FORMAT_INT16, 4, 4)));
+    EXPECT_FALSE(invalid.open("not_exist.raw", param));
+    EXPECT_FALSE(invalid.get_ground_z(0.0, 0.0, ground_z));
+    std::remove(filepath.c_str());
+}
+
+TEST_F(TerrainHeightmapTest, TerrainHeightmap_002)
+{
+    // 平面の標高なら、タイルの境界をまたいでも補間の結果は変わらない
+    const std::string filepath = "terrain_heightmap_test.raw";
+    const int width = 300;
+    const int height = 200;
+    std::vector<float> samples(width * height);
+    for (int r = 0; r < height; r++) {
+        for (int c = 0; c < width; c++) {
+            samples[r * width + c] = 0.5f * r + 0.25f * c;
+        }
+    }
+    write_raw<float>(filepath, samples);
+    TerrainHeightmapParamType param = make_param(hako::assets::drone::TERRAIN_FORMAT_FLOAT32, width, height);
+    param.tile_size = 32;
+    param.max_tiles = 4;
+    TerrainHeightmap terrain;
+    EXPECT_TRUE(terrain.open(filepath, param));
+
+    for (double x = 0; x <= height - 1; x += 0.7) {
+        double y = (x * 1.3);
+        double altitude;
+        ASSERT_TRUE(terrain.get_altitude(x, y, altitude));
+        EXPECT_NEAR(0.5 * x + 0.25 * y, altitude, 1e-4);
+        EXPECT_LE(terrain.get_loaded_tile_num(), 4);
+    }
+    // 同じタイルの中ではタイルを読み込まない
+    uint64_t count = terrain.get_tile_load_count();
+    double altitude;
+    for (int i = 0; i < 100; i++) {
+        EXPECT_TRUE(terrain.get_altitude(190.0 + 0.01 * i, 250.0, altitude));
+    }
+    EXPECT_EQ(count, terrain.get_tile_load_count());
+    // 捨てたタイルは読み直す
+    EXPECT_TRUE(terrain.get_altitude(0.0, 0.0, altitude));
+    EXPECT_EQ(count + 1, terrain.get_tile_load_count());
+    std::remove(filepath.c_str());
+}
+
+class StepTerrain : public ITerrain {
+public:
+    // x > 0 は高さ 10m の台地
+    bool get_ground_z(double x, double y, double& ground_z) override
+    {
+        (void)y;
+        ground_z = (x > 0) ? -10.0 : 0.0;
+        return true;
+    }
+};
+
+TEST_F(TerrainHeightmapTest, TerrainHeightmap_003)
+{
+    // 地形の上に落とすと、ばね・ダンパで地面の高さに止まる
+    const double dt = 0.001;
+    StepTerrain terrain;
+    GroundContactParamType contact = { 30.0, 1.0, 5.0 };
+    DroneDynamicsBodyFrame body_frame(dt);
+    DroneDynamicsBodyFrameRK4 body_frame_rk4(dt);
+    DroneDynamicsGroundFrame ground_frame(dt);
+    for (IDroneDynamics *dynamics : std::vector<IDroneDynamics*>{ &body_frame, &body_frame_rk4, &ground_frame }) {
+        dynamics->set_mass(1.0);
+        dynamics->set_drag(0.0, 0.0);
+        dynamics->set_torque_constants(1.0, 1.0, 1.0);
+        dynamics->set_terrain(&terrain, contact);
+        DronePositionType pos;
+        pos.data = { 1.0, 0.0, -12.0 };
+        dynamics->set_pos(pos);
+        DroneDynamicsInputType input = {};
+        for (int i = 0; i < 5000; i++) {
+            dynamics->run(input);
+        }
+        // 静止時のめり込みは g / w^2
+        EXPECT_NEAR(-10.0 + GRAVITY / (30.0 * 30.0), dynamics->get_pos().data.z, 1e-3);
+        EXPECT_NEAR(0.0, dynamics->get_vel().data.z, 1e-3);
+    }
+
+    // 地形がなければ今までどおり z = 0 で止まる
+    DroneDynamicsGroundFrame flat(dt);
+    flat.set_mass(1.0);
+    flat.set_drag(0.0, 0.0);
+    DronePositionType pos;
+    pos.data = { 1.0, 0.0, -1.0 };
+    flat.set_pos(pos);
+    DroneDynamicsInputType input = {};
+    for (int i = 0; i < 1000; i++) {
+        flat.run(input);
+    }
+    EXPECT_EQ(0.0, flat.get_pos().data.z);
+    EXPECT_EQ(nullptr, flat.get_terrain());
+}
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include <iostream>
+#include "mavlink/mavlink_tx_scheduler.hpp"
+
+class MavlinkTxSchedulerTest : public ::testing::Test {
+protected:
+    static void SetUpTestCase()
+    {
+    }
+    static void TearDownTestCase()
+    {
+    }
+    virtual void SetUp()
+    {
+    }
+    virtual void TearDown()
+    {
+    }
+
+};
+
+TEST_F(MavlinkTxSchedulerTest, MavlinkTxScheduler_001) 
+{
+    // 3msec ステップで HIL_SENSOR は毎ステップ、HIL_GPS は 30msec ごと
+    MavlinkTxScheduler scheduler;
+    scheduler.set_period_usec(MAVLINK_TX_HIL_SENSOR, 3000);
+    scheduler.set_period_usec(MAVLINK_TX_HIL_GPS, 30000);
+    uint64_t time_usec = 1700000000000000ULL;
+    for (int step = 0; step < 100; step++) {
+        time_usec += 3000;
+        scheduler.update(time_usec);
+        EXPECT_TRUE(scheduler.is_due(MAVLINK_TX_HIL_SENSOR));
+        EXPECT_EQ((step % 10) == 0, scheduler.is_due(MAVLINK_TX_HIL_GPS)) << "step=" << step;
+    }
+    EXPECT_EQ(100u, scheduler.get_due_count(MAVLINK_TX_HIL_SENSOR));
+    EXPECT_EQ(10u, scheduler.get_due_count(MAVLINK_TX_HIL_GPS));
+
+    // reset() 後の最初のステップは全メッセージを送信する
+    scheduler.reset();
+    time_usec += 3000;
+    scheduler.update(time_usec);
+    EXPECT_TRUE(scheduler.is_due(MAVLINK_TX_HIL_GPS));
+    EXPECT_EQ(1u, scheduler.get_due_count(MAVLINK_TX_HIL_GPS));
+}
+
+TEST_F(MavlinkTxSchedulerTest, MavlinkTxScheduler_002) 
+{
+    // 周期 0 は毎ステップ。周期がステップの倍数でなければ、周期を過ぎた最初のステップで送信する
+    MavlinkTxScheduler scheduler;
+    scheduler.set_period_usec(MAVLINK_TX_HIL_SENSOR, 0);
+    scheduler.set_period_usec(MAVLINK_TX_HIL_GPS, 4000);
+    int gps_count = 0;
+    for (uint64_t time_usec = 3000; time_usec <= 120000; time_usec += 3000) {
+        scheduler.update(time_usec);
+        EXPECT_TRUE(scheduler.is_due(MAVLINK_TX_HIL_SENSOR));
+        if (scheduler.is_due(MAVLINK_TX_HIL_GPS)) {
+            gps_count++;
+        }
+    }
+    // 平均の送信周期は 4msec（まとめて送らない）
+    EXPECT_NEAR(120000 / 4000, gps_count, 1);
+
+    // 大きく遅れても、遅れた分をまとめて送らない
+    scheduler.update(1000000);
+    EXPECT_TRUE(scheduler.is_due(MAVLINK_TX_HIL_GPS));
+    scheduler.update(1003000);
+    EXPECT_FALSE(scheduler.is_due(MAVLINK_TX_HIL_GPS));
+}
+
+TEST_F(MavlinkTxSchedulerTest, MavlinkTxScheduler_003)
+{
+    // イベント駆動のメッセージは周期によらず、trigger() したステップだけ送信する
+    MavlinkTxScheduler scheduler;
+    scheduler.set_period_usec(MAVLINK_TX_HIL_GPS, 30000);
+    scheduler.set_event_driven(MAVLINK_TX_HIL_GPS, true);
+    EXPECT_TRUE(scheduler.is_event_driven(MAVLINK_TX_HIL_GPS));
+    uint64_t time_usec = 0;
+    for (int step = 0; step < 100; step++) {
+        time_usec += 3000;
+        scheduler.update(time_usec);
+        if ((step % 33) == 5) {
+            scheduler.trigger(MAVLINK_TX_HIL_GPS);
+            scheduler.trigger(MAVLINK_TX_HIL_GPS);
+        }
+        EXPECT_EQ((step % 33) == 5, scheduler.is_due(MAVLINK_TX_HIL_GPS)) << "step=" << step;
+        EXPECT_TRUE(scheduler.is_due(MAVLINK_TX_HIL_SENSOR));
+    }
+    EXPECT_EQ(3u, scheduler.get_due_count(MAVLINK_TX_HIL_GPS));
+
+    // 周期で送信するメッセージは trigger() しても変わらない
+    scheduler.set_period_usec(MAVLINK_TX_BATTERY_STATUS, 1000000);
+    time_usec += 3000;
+    scheduler.update(time_usec);
+    time_usec += 3000;
+    scheduler.update(time_usec);
+    uint64_t count = scheduler.get_due_count(MAVLINK_TX_BATTERY_STATUS);
+    scheduler.trigger(MAVLINK_TX_BATTERY_STATUS);
+    EXPECT_FALSE(scheduler.is_due(MAVLINK_TX_BATTERY_STATUS));
+    EXPECT_EQ(count, scheduler.get_due_count(MAVLINK_TX_BATTERY_STATUS));
+}
@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include <iostream>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include "utils/columnar_file.hpp"
+#include "utils/log_table.hpp"
+
+class ColumnarFileTest : public ::testing::Test {
+protected:
+    static void SetUpTestCase()
+    {
+    }
+    static void TearDownTestCase()
+    {
+    }
+    virtual void SetUp()
+    {
+    }
+    virtual void TearDown()
+    {
+    }
+
+};
+
+TEST_F(ColumnarFileTest, ColumnarFile_001)
+{
+    const std::string filepath = "columnar_file_test.hkcol";
+    std::vector<int64_t> time_usec = { 1000, 2000, 3000, 4000 };
+    std::vector<double> x = { NAN, 1.0, 2.0, 3.0 };
+    {
+        ColumnarFileWriter writer;
+        ASSERT_TRUE(writer.open(filepath));
+        EXPECT_TRUE(writer.write_column("time_usec", time_usec));
+        EXPECT_TRUE(writer.write_column("dynamics.X", x));
+        // 行数が異なる列は書き込めない
+        EXPECT_FALSE(writer.write_column("bad", std::vector<double>{ 1.0 }));
+        EXPECT_TRUE(writer.close());
+    }
+    ColumnarFileReader reader;
+    ASSERT_TRUE(reader.open(filepath));
+    EXPECT_EQ(4u, reader.get_row_num());
+    ASSERT_EQ(2u, reader.get_columns().size());
+    EXPECT_EQ(-1, reader.find_column("bad"));
+
+    int index = reader.find_column("dynamics.X");
+    ASSERT_EQ(1, index);
+    const ColumnarStatsType& stats = reader.get_columns()[index].stats;
+    EXPECT_EQ(3u, stats.count);
+    EXPECT_EQ(1u, stats.null_count);
+    EXPECT_DOUBLE_EQ(1.0, stats.min);
+    EXPECT_DOUBLE_EQ(3.0, stats.max);
+    EXPECT_DOUBLE_EQ(2.0, stats.mean);
+    EXPECT_NEAR(std::sqrt(2.0 / 3.0), stats.stddev, 1e-12);
+
+    std::vector<double> x_read;
+    ASSERT_TRUE(reader.read_column(index, x_read));
+    ASSERT_EQ(4u, x_read.size());
+    EXPECT_TRUE(std::isnan(x_read[0]));
+    EXPECT_DOUBLE_EQ(3.0, x_read[3]);
+    // 型が異なる読み込みは失敗する
+    std::vector<int64_t> wrong_type;
+    EXPECT_FALSE(reader.read_column(index, wrong_type));
+
+    std::vector<int64_t> time_read;
+    ASSERT_TRUE(reader.read_column(0, time_read));
+    EXPECT_EQ(time_usec, time_read);
+    std::remove(filepath.c_str());
+}
+
+TEST_F(ColumnarFileTest, LogTable_001)
+{
+    LogTableType table;
+    // 列数が合わない行は読み飛ばし、時刻が戻った行は時刻順に並べ直す
+    ASSERT_TRUE(log_table_parse_csv("timestamp,X,Y\r\n3000,3,30\r\n1000,1,10\r\n2000,2\r\n", table));
+    ASSERT_EQ(2u, table.columns.size());
+    EXPECT_EQ("Y", table.columns[1]);
+    EXPECT_EQ(1u, table.bad_lines);
+    ASSERT_EQ(2u, table.time_usec.size());
+    EXPECT_EQ(1000, table.time_usec[0]);
+    EXPECT_DOUBLE_EQ(10.0, table.values[1][0]);
+    EXPECT_DOUBLE_EQ(3.0, table.values[0][1]);
+
+    // 小数の時刻は秒として扱う
+    ASSERT_TRUE(log_table_parse_csv("timestamp,X\n0.003,1\n", table));
+    ASSERT_EQ(1u, table.time_usec.size());
+    EXPECT_EQ(3000, table.time_usec[0]);
+}
+
+TEST_F(ColumnarFileTest, LogTable_002)
+{
+    // 複数のチャンクに分割して解析しても、1スレッドでの結果と同じになる
+    std::string text = "timestamp,X\n";
+    for (int i = 0; text.size() < (4 * LOG_TABLE_CHUNK_MIN_SIZE); i++) {
+        text += std::to_string(i * 1000) + "," + std::to_string(i) + ".5\n";
+    }
+    LogTableType single;
+    LogTableType parallel;
+    ASSERT_TRUE(log_table_parse_csv(text, single, 1));
+    ASSERT_TRUE(log_table_parse_csv(text, parallel, 4));
+    EXPECT_EQ(0u, parallel.bad_lines);
+    EXPECT_EQ(single.time_usec, parallel.time_usec);
+    EXPECT_EQ(single.values, parallel.values);
+}
+
+TEST_F(ColumnarFileTest, LogTable_003)
+{
+    std::vector<LogTableType> tables(2);
+    ASSERT_TRUE(log_table_parse_csv("timestamp,X\n1000,1\n3000,3\n", tables[0]));
+    ASSERT_TRUE(log_table_parse_csv("timestamp,Y\n2000,20\n3000,30\n4000,40\n", tables[1]));
+
+    std::vector<int64_t> timeline = log_table_timeline(tables);
+    ASSERT_EQ((std::vector<int64_t>{ 1000, 2000, 3000, 4000 }), timeline);
+
+    // その時刻以前で最後の値を使い、最初の行より前は NaN
+    std::vector<double> x = log_table_align(tables[0], 0, timeline);
+    EXPECT_DOUBLE_EQ(1.0, x[0]);
+    EXPECT_DOUBLE_EQ(1.0, x[1]);
+    EXPECT_DOUBLE_EQ(3.0, x[2]);
+    EXPECT_DOUBLE_EQ(3.0, x[3]);
+    std::vector<double> y = log_table_align(tables[1], 0, timeline);
+    EXPECT_TRUE(std::isnan(y[0]));
+    EXPECT_DOUBLE_EQ(20.0, y[1]);
+    EXPECT_DOUBLE_EQ(40.0, y[3]);
+}
@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+#include <iostream>
+#include "utils/latency_histogram.hpp"
+
+class LatencyHistogramTest : public ::testing::Test {
+protected:
+    static void SetUpTestCase()
+    {
+    }
+    static void TearDownTestCase()
+    {
+    }
+    virtual void SetUp()
+    {
+    }
+    virtual void TearDown()
+    {
+    }
+
+};
+
+TEST_F(LatencyHistogramTest, LatencyHistogram_001) 
+{
+    LatencyHistogram histogram;
+    EXPECT_EQ(0u, histogram.count());
+    EXPECT_EQ(0u, histogram.percentile(50.0));
+
+    // 小さい値はそのままのバケットに入る
+    for (uint64_t i = 1; i <= 10; i++) {
+        histogram.record(i);
+    }
+    EXPECT_EQ(10u, histogram.count());
+    EXPECT_EQ(10u, histogram.max());
+    EXPECT_DOUBLE_EQ(5.5, histogram.mean());
+    EXPECT_EQ(5u, histogram.percentile(50.0));
+    EXPECT_EQ(10u, histogram.percentile(100.0));
+}
+
+TEST_F(LatencyHistogramTest, LatencyHistogram_002) 
+{
+    LatencyHistogram histogram;
+    // 1..100000 の一様分布
+    for (uint64_t i = 1; i <= 100000; i++) {
+        histogram.record(i);
+    }
+    // 相対誤差は約 3% 以内
+    EXPECT_NEAR(50000.0, (double)histogram.percentile(50.0), 50000.0 * 0.04);
+    EXPECT_NEAR(99000.0, (double)histogram.percentile(99.0), 99000.0 * 0.04);
+    EXPECT_NEAR(99900.0, (double)histogram.percentile(99.9), 99900.0 * 0.04);
+    EXPECT_EQ(100000u, histogram.max());
+
+    histogram.reset();
+    EXPECT_EQ(0u, histogram.count());
+    EXPECT_EQ(0u, histogram.max());
+}
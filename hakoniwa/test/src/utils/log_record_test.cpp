@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include <iostream>
+#include <cstdlib>
+#include <string>
+#include "utils/log_record.hpp"
+#include "utils/icsv_log.hpp"
+
+class LogRecordTest : public ::testing::Test {
+protected:
+    static void SetUpTestCase()
+    {
+    }
+    static void TearDownTestCase()
+    {
+    }
+    virtual void SetUp()
+    {
+    }
+    virtual void TearDown()
+    {
+    }
+
+};
+
+class TestCsvLog : public ICsvLog {
+public:
+    const std::vector<std::string> log_head() override
+    {
+        return { "timestamp", "X", "count" };
+    }
+    void log_fields(LogRecord& record) override
+    {
+        record.add((uint64_t)3000).add(-1.5).add((int32_t)-7);
+    }
+};
+
+TEST_F(LogRecordTest, LogRecord_001) 
+{
+    LogRecord record;
+    EXPECT_EQ(0u, record.size());
+    EXPECT_EQ(0, record.field_count());
+    EXPECT_TRUE(record.to_strings().empty());
+
+    record.add((uint64_t)18446744073709551615ULL).add((uint8_t)12).add(0.25).add(-2.0f);
+    EXPECT_EQ(4, record.field_count());
+    EXPECT_FALSE(record.is_overflow());
+    EXPECT_EQ("18446744073709551615,12,0.25,-2", std::string(record.data(), record.size()));
+
+    // clear() で使い回せる
+    record.clear();
+    record.add(1);
+    EXPECT_EQ("1", std::string(record.data(), record.size()));
+}
+
+TEST_F(LogRecordTest, LogRecord_002) 
+{
+    // 浮動小数点数は読み戻すと同じ値になる
+    const double values[] = { 0.1, 1.0 / 3.0, -123456.789012345, 1e-9, 6.02214076e23 };
+    LogRecord record;
+    for (double value : values) {
+        record.add(value);
+    }
+    std::vector<std::string> strings = record.to_strings();
+    ASSERT_EQ(5u, strings.size());
+    for (size_t i = 0; i < strings.size(); i++) {
+        EXPECT_EQ(values[i], std::strtod(strings[i].c_str(), nullptr));
+    }
+}
+
+TEST_F(LogRecordTest, LogRecord_003) 
+{
+    // バッファに収まらない値は捨てて、溢れたことを記録する
+    LogRecord record;
+    for (int i = 0; i < LOG_RECORD_BUFFER_SIZE; i++) {
+        record.add(1.0 / 3.0);
+    }
+    EXPECT_TRUE(record.is_overflow());
+    EXPECT_LE(record.size(), (size_t)LOG_RECORD_BUFFER_SIZE);
+}
+
+TEST_F(LogRecordTest, LogRecord_004) 
+{
+    TestCsvLog log;
+    std::vector<std::string> data = log.log_data();
+    ASSERT_EQ(log.log_head().size(), data.size());
+    EXPECT_EQ("3000", data[0]);
+    EXPECT_EQ("-1.5", data[1]);
+    EXPECT_EQ("-7", data[2]);
+}
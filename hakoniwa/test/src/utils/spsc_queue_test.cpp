@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include <iostream>
+#include <thread>
+#include "utils/spsc_queue.hpp"
+
+class SpscQueueTest : public ::testing::Test {
+protected:
+    static void SetUpTestCase()
+    {
+    }
+    static void TearDownTestCase()
+    {
+    }
+    virtual void SetUp()
+    {
+    }
+    virtual void TearDown()
+    {
+    }
+
+};
+
+TEST_F(SpscQueueTest, SpscQueue_001) 
+{
+    SpscQueue<int, 4> queue;
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(4u, queue.capacity());
+
+    // 容量を超えた push は失敗する
+    for (int i = 0; i < 4; i++) {
+        EXPECT_TRUE(queue.push(i));
+    }
+    EXPECT_FALSE(queue.push(4));
+    EXPECT_EQ(4u, queue.size());
+
+    int value = -1;
+    EXPECT_TRUE(queue.pop(value));
+    EXPECT_EQ(0, value);
+    EXPECT_TRUE(queue.push(4));
+
+    // 先頭から順に取り出せる
+    for (int i = 1; i <= 4; i++) {
+        EXPECT_TRUE(queue.pop(value));
+        EXPECT_EQ(i, value);
+    }
+    EXPECT_FALSE(queue.pop(value));
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST_F(SpscQueueTest, SpscQueue_002) 
+{
+    SpscQueue<int, 8> queue;
+    for (int i = 0; i < 5; i++) {
+        EXPECT_TRUE(queue.push(i));
+    }
+    // peek は取り出さずに参照する
+    ASSERT_NE(nullptr, queue.front());
+    EXPECT_EQ(0, *queue.front());
+    for (int i = 0; i < 5; i++) {
+        ASSERT_NE(nullptr, queue.peek(i));
+        EXPECT_EQ(i, *queue.peek(i));
+    }
+    EXPECT_EQ(nullptr, queue.peek(5));
+
+    queue.discard(3);
+    EXPECT_EQ(2u, queue.size());
+    EXPECT_EQ(3, *queue.front());
+    queue.pop_front();
+    EXPECT_EQ(4, *queue.front());
+}
+
+TEST_F(SpscQueueTest, SpscQueue_003) 
+{
+    // 書き手と読み手を別スレッドにしても、順序どおりにすべて届く
+    const int num = 100000;
+    SpscQueue<int, 16> queue;
+    std::thread writer([&queue, num]() {
+        for (int i = 0; i < num; i++) {
+            while (!queue.push(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    int expected = 0;
+    while (expected < num) {
+        int value;
+        if (queue.pop(value)) {
+            ASSERT_EQ(expected, value);
+            expected++;
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+    writer.join();
+    EXPECT_TRUE(queue.empty());
+}
@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+#include <iostream>
+#include <cstdio>
+#include <vector>
+#include "utils/state_snapshot.hpp"
+#include "utils/csv_logger.hpp"
+#include "sensors/acc/sensor_acceleration.hpp"
+#include "sensors/gyro/sensor_gyro.hpp"
+#include "utils/sensor_noise.hpp"
+#include "rotor/rotor_dynamics.hpp"
+#include "body_frame/drone_dynamics_body_frame.hpp"
+
+class StateSnapshotTest : public ::testing::Test {
+protected:
+    static void SetUpTestCase()
+    {
+    }
+    static void TearDownTestCase()
+    {
+    }
+    virtual void SetUp()
+    {
+    }
+    virtual void TearDown()
+    {
+    }
+
+};
+using hako::assets::drone::SensorAcceleration;
+using hako::assets::drone::SensorGyro;
+using hako::assets::drone::SensorNoise;
+using hako::assets::drone::RotorDynamics;
+using hako::assets::drone::DroneDynamicsBodyFrame;
+using hako::assets::drone::DroneDynamicsInputType;
+using hako::assets::drone::DroneAngularVelocityBodyFrameType;
+using hako::assets::drone::DroneVelocityBodyFrameType;
+
+TEST_F(StateSnapshotTest, StateSnapshot_001)
+{
+    StateSnapshot snapshot;
+    snapshot.put((int32_t)-3);
+    snapshot.put(1.5);
+    snapshot.put(std::vector<double>{ 1.0, 2.0, 3.0 });
+
+    int32_t i = 0;
+    double d = 0;
+    std::vector<double> v;
+    EXPECT_TRUE(snapshot.get(i));
+    EXPECT_TRUE(snapshot.get(d));
+    EXPECT_TRUE(snapshot.get(v));
+    EXPECT_EQ(-3, i);
+    EXPECT_EQ(1.5, d);
+    EXPECT_EQ((std::vector<double>{ 1.0, 2.0, 3.0 }), v);
+    EXPECT_TRUE(snapshot.is_consumed());
+
+    // 書き込んだ以上は読めない
+    EXPECT_FALSE(snapshot.get(d));
+    EXPECT_TRUE(snapshot.is_error());
+    EXPECT_FALSE(snapshot.is_consumed());
+
+    const std::string filepath = "state_snapshot_test.bin";
+    EXPECT_TRUE(snapshot.save_file(filepath));
+    StateSnapshot loaded;
+    EXPECT_TRUE(loaded.load_file(filepath));
+    EXPECT_EQ(snapshot.size(), loaded.size());
+    EXPECT_TRUE(loaded.get(i));
+    EXPECT_EQ(-3, i);
+    std::remove(filepath.c_str());
+}
+
+TEST_F(StateSnapshotTest, StateSnapshot_002)
+{
+    // ノイズの乱数の状態を含めて復元すると、以降のセンサ値は同じになる
+    SensorGyro gyro(0.001, 3);
+    SensorNoise noise(0.01);
+    gyro.set_noise(&noise);
+    DroneAngularVelocityBodyFrameType value;
+    for (int i = 0; i < 10; i++) {
+        value.data = { i * 0.1, i * 0.2, i * 0.3 };
+        gyro.run(value);
+        (void)gyro.sensor_value();
+    }
+    StateSnapshot snapshot;
+    gyro.save_state(snapshot);
+
+    std::vector<double> expected;
+    for (int i = 0; i < 10; i++) {
+        value.data = { 1.0, 2.0, 3.0 };
+        gyro.run(value);
+        expected.push_back(gyro.sensor_value().data.x);
+    }
+    EXPECT_TRUE(gyro.restore_state(snapshot));
+    EXPECT_TRUE(snapshot.is_consumed());
+    for (int i = 0; i < 10; i++) {
+        value.data = { 1.0, 2.0, 3.0 };
+        gyro.run(value);
+        EXPECT_EQ(expected[i], gyro.sensor_value().data.x);
+    }
+
+    // ノイズの有無が異なるセンサには復元できない
+    SensorGyro no_noise(0.001, 3);
+    snapshot.rewind();
+    EXPECT_FALSE(no_noise.restore_state(snapshot));
+}
+
+TEST_F(StateSnapshotTest, StateSnapshot_003)
+{
+    DroneDynamicsBodyFrame dynamics(0.001);
+    dynamics.set_mass(1.0);
+    dynamics.set_torque_constants(1.0, 1.0, 1.0);
+    RotorDynamics rotor(0.001);
+    rotor.set_params(6000, 1.0, 1.0);
+
+    DroneDynamicsInputType input = {};
+    input.thrust.data = 12.0;
+    input.torque.data = { 0.01, 0.0, 0.0 };
+    for (int i = 0; i < 100; i++) {
+        dynamics.run(input);
+        rotor.run(0.5);
+    }
+    StateSnapshot snapshot;
+    dynamics.save_state(snapshot);
+    rotor.save_state(snapshot);
+    for (int i = 0; i < 100; i++) {
+        dynamics.run(input);
+        rotor.run(0.5);
+    }
+    auto pos = dynamics.get_pos();
+    auto angle = dynamics.get_angle();
+    auto speed = rotor.get_rotor_speed();
+
+    snapshot.rewind();
+    EXPECT_TRUE(dynamics.restore_state(snapshot));
+    EXPECT_TRUE(rotor.restore_state(snapshot));
+    EXPECT_TRUE(snapshot.is_consumed());
+    for (int i = 0; i < 100; i++) {
+        dynamics.run(input);
+        rotor.run(0.5);
+    }
+    EXPECT_EQ(pos.data.z, dynamics.get_pos().data.z);
+    EXPECT_EQ(angle.data.x, dynamics.get_angle().data.x);
+    EXPECT_EQ(speed.data, rotor.get_rotor_speed().data);
+}
+
+TEST_F(StateSnapshotTest, StateSnapshot_004)
+{
+    // 加速度センサは前のステップの速度との差を取るので、前の速度も復元する
+    SensorAcceleration acc(0.001, 1);
+    DroneVelocityBodyFrameType value;
+    for (int i = 0; i < 10; i++) {
+        value.data = { i * 0.001, 0.0, 0.0 };
+        acc.run(value);
+    }
+    StateSnapshot snapshot;
+    acc.save_state(snapshot);
+
+    std::vector<double> expected;
+    for (int i = 10; i < 20; i++) {
+        value.data = { i * 0.001, 0.0, 0.0 };
+        acc.run(value);
+        expected.push_back(acc.sensor_value().data.x);
+    }
+    // 復元する前に大きく違う速度にしておく
+    value.data = { 100.0, 0.0, 0.0 };
+    acc.run(value);
+
+    snapshot.rewind();
+    EXPECT_TRUE(acc.restore_state(snapshot));
+    EXPECT_TRUE(snapshot.is_consumed());
+    for (int i = 10; i < 20; i++) {
+        value.data = { i * 0.001, 0.0, 0.0 };
+        acc.run(value);
+        EXPECT_EQ(expected[i - 10], acc.sensor_value().data.x);
+    }
+    EXPECT_NEAR(1.0, expected[0], 1e-9);
+}
@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+#include <iostream>
+#include <sstream>
+#include "utils/step_stats.hpp"
+
+class StepStatsTest : public ::testing::Test {
+protected:
+    static void SetUpTestCase()
+    {
+    }
+    static void TearDownTestCase()
+    {
+    }
+    virtual void SetUp()
+    {
+    }
+    virtual void TearDown()
+    {
+    }
+
+};
+
+TEST_F(StepStatsTest, StepStats_001) 
+{
+    StepStats& stats = StepStats::instance();
+    stats.init(3000, 0.0, "");
+    EXPECT_TRUE(stats.is_enabled());
+    stats.reset(0);
+
+    // 3000usec を超えたステップだけが deadline miss になる
+    uint64_t sim_usec = 0;
+    for (int i = 0; i < 100; i++) {
+        stats.record(STEP_PHASE_RUNNER_STEP, 100);
+        sim_usec += 3000;
+        stats.end_step((i < 99) ? 1000 : 5000, sim_usec);
+    }
+    {
+        StepStatsScope scope(STEP_PHASE_SEND);
+    }
+    std::ostringstream os;
+    stats.print(os);
+    std::string out = os.str();
+    EXPECT_NE(std::string::npos, out.find("steps=100 "));
+    EXPECT_NE(std::string::npos, out.find("deadline_miss=1 "));
+    EXPECT_NE(std::string::npos, out.find("sim_time=0.300 "));
+    EXPECT_NE(std::string::npos, out.find("runner_step"));
+    EXPECT_NE(std::string::npos, out.find("send"));
+
+    // reset() で計測をやり直す
+    stats.reset(sim_usec);
+    std::ostringstream os2;
+    stats.print(os2);
+    EXPECT_NE(std::string::npos, os2.str().find("steps=0 "));
+    EXPECT_NE(std::string::npos, os2.str().find("deadline_miss=0 "));
+}
@@ -89,8 +89,55 @@ static void test_first_case() {
     /* assert_almost_equal(out_m.dv, expected.dv); */
 }
 
+/*
+ * drone_physics の RotorMixer による推力・トルク
+ */
+static mi_drone_thrust_torque_out_t drone_thrust_torque_by_physics(
+    const dp_rotor_mixer_t* mixer, const mi_drone_thrust_torque_in_t* in) {
+    dp_thrust_torque_t t = dp_rotor_mixer_thrust_torque(mixer, in->omega, in->omega_acceleration);
+    mi_drone_thrust_torque_out_t out = { t.thrust, t.torque.x, t.torque.y, t.torque.z };
+    return out;
+}
+static void test_thrust_torque() {
+    const dp_vector_t position[4] = { /* + shape */
+        {0.3, 0.0, 0}, {0.0, -0.3, 0}, {-0.3, 0.0, 0}, {0.0, 0.3, 0}
+    };
+    const double ccw[4] = {-1, 1, -1, 1};
+    const double A = 1, B = 0.5, Jr = 0.1;
+    dp_rotor_mixer_t* mixer = dp_rotor_mixer_create(A, B, Jr, 4, position, ccw);
+
+    /* matlab に渡す入力（行列は drone_physics で作ったもの） */
+    mi_drone_thrust_torque_in_t in;
+    in.n = dp_rotor_mixer_rotor_num(mixer);
+    for (unsigned int i = 0; i < in.n; i++) {
+        for (unsigned int r = 0; r < 4; r++) {
+            in.mixer[4 * i + r] = dp_rotor_mixer_get(mixer, r, i);
+        }
+        in.jr_ccw[i] = Jr * ccw[i];
+        in.omega[i] = 100;
+        in.omega_acceleration[i] = 0;
+    }
+    in.omega[0] = 200;
+    in.omega_acceleration[1] = 10;
+
+    mi_drone_thrust_torque_out_t out_p = drone_thrust_torque_by_physics(mixer, &in);
+
+    /* matlab のものも呼び出す
+    mi_drone_thrust_torque_out_t out_m = mi_drone_thrust_torque(&in);
+    */
+
+    assert_almost_equal(out_p.thrust, A * (200*200 + 3*100*100));
+    assert_almost_equal(out_p.torque_x, 0.0);
+    assert_almost_equal(out_p.torque_y, 0.3 * A * (200*200 - 100*100));
+    assert_almost_equal(out_p.torque_z, -B * (200*200 - 100*100) + Jr * 10);
+    /* assert_almost_equal(out_m.torque_y, out_p.torque_y); */
+
+    dp_rotor_mixer_destroy(mixer);
+}
+
 int main() {
     T(test_first_case);
+    T(test_thrust_torque);
     return 0;
 }
 
@@ -51,6 +51,37 @@ typedef struct mi_drone_acceleration_out_t {
 mi_drone_acceleration_out_t mi_drone_acceleration(
     const mi_drone_acceleration_in_t* in);
 
+/**
+ * Thrust and torque from the rotors by the mixing matrix.
+ * The matrix is built once from the rotor positions (dp_rotor_mixer_create() or RotorMixer),
+ * and stored column-major as matlab arrays, so that
+ *
+ *   [thrust; torque_x; torque_y; torque_z] = mixer * (omega.^2) + [0; 0; 0; jr_ccw' * omega_acceleration]
+ *
+ * The column i of mixer is [A; -A*y_i; A*x_i; ccw_i*B], and jr_ccw_i = Jr*ccw_i.
+ */
+#define MI_ROTOR_NUM_MAX 16
+
+typedef struct mi_drone_thrust_torque_in_t {
+    unsigned int n; /* number of rotors, <= MI_ROTOR_NUM_MAX */
+    double mixer[4 * MI_ROTOR_NUM_MAX]; /* 4 x n, column-major */
+    double jr_ccw[MI_ROTOR_NUM_MAX];
+
+    double omega[MI_ROTOR_NUM_MAX]; /* in rpm */
+    double omega_acceleration[MI_ROTOR_NUM_MAX]; /* in rpm/s */
+} mi_drone_thrust_torque_in_t;
+
+typedef struct mi_drone_thrust_torque_out_t {
+    double thrust;
+    double torque_x;
+    double torque_y;
+    double torque_z;
+} mi_drone_thrust_torque_out_t;
+
+/* Matlab function entry point */
+mi_drone_thrust_torque_out_t mi_drone_thrust_torque(
+    const mi_drone_thrust_torque_in_t* in);
+
 /***
 The Original function signatures are:
 
@@ -71,6 +102,12 @@ AngularAccelerationType angular_acceleration_in_body_frame(
     double I_xx, // in body frame, 0 is not allowed 
     double I_yy, // in body frame, 0 is not allowed 
     double I_zz // in body frame, 0 is not allowed );
+
+// thrust and torque from the rotors eq.(2.60)-(2.62)
+ThrustTorqueType RotorMixer::thrust_torque(
+    const double omega[], // in rpm
+    const double omega_acceleration[] // in rpm/s
+    ) const;
 */
 
 #endif /* _DRONE_PHYSICS_MATLAB_H_ */
\ No newline at end of file